@@ -35,13 +35,18 @@ see https://www.gnu.org/licenses/. */
 #include <boost/lexical_cast.hpp>
 #include <cstddef>
 #include <exception>
+#include <initializer_list>
 #include <iostream>
 #include <string>
 #include <utility>
 
 #include <piranha/detail/demangle.hpp>
+#include <piranha/hash_set.hpp>
 #include <piranha/integer.hpp>
+#include <piranha/kronecker_monomial.hpp>
+#include <piranha/polynomial.hpp>
 #include <piranha/settings.hpp>
+#include <piranha/tuning.hpp>
 
 #include "simple_timer.hpp"
 
@@ -126,3 +131,52 @@ BOOST_AUTO_TEST_CASE(memory_parallel_array_test)
         throw;
     }
 }
+
+// Compare the plain dynamic allocation of the nodes of hash_set with the node arena.
+BOOST_AUTO_TEST_CASE(memory_node_arena_test)
+{
+    using p_type = polynomial<integer, k_monomial>;
+    p_type x("x"), y("y"), z("z"), t("t");
+    auto f = x + y + z + t + 1;
+    const auto tmp(f);
+    for (auto i = 1; i < 20; ++i) {
+        f *= tmp;
+    }
+    const auto g = f + 1;
+    try {
+        for (const bool flag : {false, true}) {
+            tuning::set_node_arena(flag);
+            std::cout << "Testing node arena: " << (flag ? "on" : "off") << '\n';
+            std::cout << "hash_set insertion and destruction\n"
+                         "==================================\n";
+            {
+                simple_timer st;
+                // Use the low-level interface to reach a load factor of 4, so that most
+                // insertions allocate a new node.
+                const std::size_t size = alloc_size / 10u;
+                hash_set<integer> h(size / 4u);
+                for (std::size_t i = 0u; i < size; ++i) {
+                    const integer n(i);
+                    const auto idx = h._bucket(n);
+                    if (h._find(n, idx) == h.end()) {
+                        h._unique_insert(n, idx);
+                    }
+                }
+                h._update_size(size);
+            }
+            std::cout << "Polynomial multiplication and destruction\n"
+                         "=========================================\n";
+            {
+                simple_timer st;
+                const auto res = f * g;
+                BOOST_CHECK_EQUAL(res.size(), 135751u);
+            }
+        }
+    } catch (const std::exception &e) {
+        std::cerr << "Exception caught, type is '" << demangle(typeid(e)) << "', message is: " << e.what() << '\n';
+        std::cout << "Exception caught, type is '" << demangle(typeid(e)) << "', message is: " << e.what() << '\n';
+        tuning::reset_node_arena();
+        throw;
+    }
+    tuning::reset_node_arena();
+}
@@ -7,6 +7,13 @@ if(UNIX)
 	else()
 		message(STATUS "POSIX memalign not detected.")
 	endif()
+	check_cxx_symbol_exists("mmap" "sys/mman.h" _PIRANHA_MMAP_TEST)
+	if(_PIRANHA_MMAP_TEST)
+		message(STATUS "POSIX mmap detected.")
+		set(PIRANHA_MMAP "#define PIRANHA_HAVE_MMAP")
+	else()
+		message(STATUS "POSIX mmap not detected.")
+	endif()
 endif()
 
 # Setup for the machinery to detect cache line size in Windows. It's not supported everywhere, so we
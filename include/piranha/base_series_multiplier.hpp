@@ -33,11 +33,14 @@ see https://www.gnu.org/licenses/. */
 #include <array>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <iterator>
 #include <limits>
 #include <mutex>
 #include <random>
 #include <stdexcept>
+#include <string>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -50,7 +53,9 @@ see https://www.gnu.org/licenses/. */
 #include <piranha/detail/atomic_flag_array.hpp>
 #include <piranha/detail/atomic_lock_guard.hpp>
 #include <piranha/detail/init.hpp>
+#include <piranha/detail/kmv_sketch.hpp>
 #include <piranha/exceptions.hpp>
+#include <piranha/frozen_series.hpp>
 #include <piranha/integer.hpp>
 #include <piranha/key_is_multipliable.hpp>
 #include <piranha/math.hpp>
@@ -152,6 +157,14 @@ struct base_series_multiplier_impl {
         thread_wrapper(&c1, &v1);
         thread_wrapper(&c2, &v2);
     }
+    // The terms of a frozen series are already sorted, we just need to copy over the pointers.
+    template <typename Term>
+    void fill_term_pointers(const frozen_series<Series> &f1, const frozen_series<Series> &f2,
+                            std::vector<Term const *> &v1, std::vector<Term const *> &v2)
+    {
+        std::transform(f1.begin(), f1.end(), std::back_inserter(v1), [](const term_type &t) { return &t; });
+        std::transform(f2.begin(), f2.end(), std::back_inserter(v2), [](const term_type &t) { return &t; });
+    }
 };
 
 template <typename Series, typename Derived>
@@ -161,8 +174,10 @@ struct base_series_multiplier_impl<
     using term_type = typename Series::term_type;
     using rat_type = typename term_type::cf_type;
     using int_type = typename std::decay<decltype(std::declval<rat_type>().get_num())>::type;
-    using container_type = typename std::decay<decltype(std::declval<Series>()._container())>::type;
-    void fill_term_pointers(const container_type &c1, const container_type &c2, std::vector<term_type const *> &v1,
+    // NOTE: C is either the container type of Series or piranha::frozen_series, only the begin()/end()/size()
+    // interface is used here.
+    template <typename C>
+    void fill_term_pointers(const C &c1, const C &c2, std::vector<term_type const *> &v1,
                             std::vector<term_type const *> &v2)
     {
         // Compute the least common multiplier.
@@ -399,8 +414,70 @@ public:
                           : 1u;
         this->fill_term_pointers(*ctr1, *ctr2, m_v1, m_v2);
     }
+    /// Constructor from frozen series.
+    /**
+     * This constructor is equivalent to the constructor from \p Series, but the operands are instances of
+     * piranha::frozen_series. The protected members base_series_multiplier::m_v1 and base_series_multiplier::m_v2
+     * will store references to the sorted terms of \p f1 and \p f2 (or to their normalised copies, if the coefficient
+     * type of \p Series is an mp++ rational). Hence, a frozen series can be used as a multiplication operand without
+     * being thawed first.
+     *
+     * The frozen series must not be modified or destroyed while \p this is in use.
+     *
+     * @param f1 first frozen series.
+     * @param f2 second frozen series.
+     *
+     * @throws std::invalid_argument if the symbol sets of \p f1 and \p f2 differ.
+     * @throws unspecified any exception thrown by:
+     * - thread_pool::use_threads(),
+     * - memory allocation errors in standard containers,
+     * - the construction of the term, coefficient and key types of \p Series,
+     * - the public interface of piranha::hash_set and piranha::frozen_series.
+     */
+    explicit base_series_multiplier(const frozen_series<Series> &f1, const frozen_series<Series> &f2)
+        : m_ss(f1.get_symbol_set())
+    {
+        if (unlikely(f1.get_symbol_set() != f2.get_symbol_set())) {
+            piranha_throw(std::invalid_argument, "incompatible arguments sets");
+        }
+        // The largest series goes first.
+        const frozen_series<Series> *p1 = &f1, *p2 = &f2;
+        if (f1.size() < f2.size()) {
+            std::swap(p1, p2);
+        }
+        m_v1.reserve(static_cast<size_type>(p1->size()));
+        m_v2.reserve(static_cast<size_type>(p2->size()));
+        // NOTE: same as in the constructor from Series, but the zero factors are frozen series.
+        if (!zero_is_absorbing<Series>::value) {
+            if (p1->empty()) {
+                m_zero_fs1 = zero_frozen_series();
+                p1 = &m_zero_fs1;
+            }
+            if (p2->empty()) {
+                m_zero_fs2 = zero_frozen_series();
+                p2 = &m_zero_fs2;
+            }
+        }
+        m_n_threads = (p1->size() && p2->size())
+                          ? thread_pool::use_threads(integer(p1->size()) * p2->size(),
+                                                     integer(settings::get_min_work_per_thread()))
+                          : 1u;
+        this->fill_term_pointers(*p1, *p2, m_v1, m_v2);
+    }
 
 private:
+    // A frozen series consisting of a single term with zero coefficient.
+    frozen_series<Series> zero_frozen_series() const
+    {
+        using term_type = typename Series::term_type;
+        using cf_type = typename term_type::cf_type;
+        using key_type = typename term_type::key_type;
+        Series tmp;
+        tmp.set_symbol_set(m_ss);
+        // NOTE: insert directly into the container, as the series interface would discard a zero term.
+        tmp._container().insert(term_type{cf_type(0), key_type(m_ss)});
+        return frozen_series<Series>(tmp);
+    }
     base_series_multiplier() = delete;
     base_series_multiplier(const base_series_multiplier &) = delete;
     base_series_multiplier(base_series_multiplier &&) = delete;
@@ -546,6 +623,9 @@ protected:
      * in such a case, different instances of \p MultFunctor are constructed in different threads, but \p lf is
      * shared among all threads.
      *
+     * If \p LimitFunctor is base_series_multiplier::default_limit_functor (that is, if all the terms of the two
+     * series are multiplied), the estimate will be computed via cached_estimate().
+     *
      * @param lf the limit functor.
      *
      * @return the estimated size of the multiplication of the first series by the second, always at least 1.
@@ -562,6 +642,17 @@ protected:
      */
     template <std::size_t MultArity, typename MultFunctor, typename LimitFunctor>
     bucket_size_type estimate_final_series_size(const LimitFunctor &lf) const
+    {
+        if (std::is_same<LimitFunctor, default_limit_functor>::value) {
+            return cached_estimate(
+                [this, &lf]() { return this->template estimate_impl<MultArity, MultFunctor>(lf); });
+        }
+        return estimate_impl<MultArity, MultFunctor>(lf);
+    }
+
+private:
+    template <std::size_t MultArity, typename MultFunctor, typename LimitFunctor>
+    bucket_size_type estimate_impl(const LimitFunctor &lf) const
     {
         PIRANHA_TT_CHECK(is_function_object, MultFunctor, void, const size_type &, const size_type &);
         PIRANHA_TT_CHECK(std::is_constructible, MultFunctor, const base_series_multiplier &, Series &);
@@ -716,6 +807,108 @@ protected:
         // Return the mean.
         return static_cast<bucket_size_type>(c_estimate / n_trials);
     }
+    // Signature of a multiplication, used as a key in the cache of estimates. It contains the sizes of the two
+    // series, fingerprints of the symbol set and of the keys of the two series, an identifier of the estimator
+    // and the value of the tuning parameters which select the estimator.
+    // NOTE: the coefficients do not enter the signature. Both the trial and the sketch estimators count the distinct
+    // keys generated by the products of the terms: the coefficients could matter only via products of nonzero
+    // coefficients resulting in zero, which the estimators do not model anyway. Moreover, an estimate is only used to
+    // size the result, so reusing the estimate of a multiplication whose operands differ only in the coefficients
+    // can affect the performance but never the correctness of the multiplication.
+    using estimate_signature = std::array<std::size_t, 7u>;
+    // The cache of estimates. It holds a limited number of entries, which are replaced in round-robin order.
+    struct estimate_cache {
+        std::mutex m_mutex;
+        std::vector<std::pair<estimate_signature, bucket_size_type>> m_entries;
+        std::size_t m_next = 0u;
+    };
+    static estimate_cache &get_estimate_cache()
+    {
+        static estimate_cache cache;
+        return cache;
+    }
+    // Unique identifier of the estimator F. The estimators are function objects whose type depends on the estimation
+    // method and on its compile-time parameters (e.g., the arity and the functor of the trial estimator).
+    template <typename F>
+    static std::size_t estimator_id()
+    {
+        static const char tag = 0;
+        return static_cast<std::size_t>(reinterpret_cast<std::uintptr_t>(&tag));
+    }
+    template <typename F>
+    estimate_signature get_estimate_signature() const
+    {
+        // NOTE: the fingerprints are sums of mixed hash values, so that they do not depend on the order
+        // of the terms.
+        auto key_fingerprint = [](const v_ptr &v) {
+            std::uint64_t retval = 0u;
+            for (const auto &p : v) {
+                retval += detail::hash_mix64(static_cast<std::uint64_t>(p->hash()));
+            }
+            return static_cast<std::size_t>(retval);
+        };
+        std::uint64_t ss_fp = 0u;
+        for (const auto &name : m_ss) {
+            ss_fp = detail::hash_mix64(ss_fp + static_cast<std::uint64_t>(std::hash<std::string>{}(name)));
+        }
+        return estimate_signature{{static_cast<std::size_t>(m_v1.size()), static_cast<std::size_t>(m_v2.size()),
+                                   static_cast<std::size_t>(ss_fp), key_fingerprint(m_v1), key_fingerprint(m_v2),
+                                   estimator_id<F>(), static_cast<std::size_t>(tuning::get_sketch_estimation())}};
+    }
+
+protected:
+    /// Cached estimation of the size of series multiplication.
+    /**
+     * If the \p estimate_cache flag is not active (see piranha::tuning::get_estimate_cache()), this method will
+     * just return the output of <tt>f()</tt>.
+     *
+     * Otherwise, the multiplication will be identified via a signature built from the sizes of the two series,
+     * from fingerprints of their symbol set and of their keys, from the type \p F of the estimator and from
+     * the value of the \p sketch_estimation flag (see piranha::tuning::get_sketch_estimation()). If an estimate
+     * for the same signature is stored in a global cache (one for each type \p Series), it will be returned
+     * without calling \p f. Otherwise, the output of <tt>f()</tt> will be stored in the cache and returned.
+     * The coefficients of the series do not enter the signature, as the estimators count the distinct keys
+     * generated by the multiplication.
+     *
+     * This method is thread-safe.
+     *
+     * @param f a function object returning an estimate of the size of the result of the multiplication.
+     *
+     * @return an estimate of the size of the result of the multiplication.
+     *
+     * @throws unspecified any exception thrown by:
+     * - the call operator of \p f,
+     * - memory errors in standard containers,
+     * - failures in locking a mutex.
+     */
+    template <typename F>
+    bucket_size_type cached_estimate(const F &f) const
+    {
+        if (!tuning::get_estimate_cache()) {
+            return f();
+        }
+        // NOTE: tuning parameter, the maximum number of entries in the cache.
+        const std::size_t max_entries = 64u;
+        const auto sig = get_estimate_signature<F>();
+        auto &cache = get_estimate_cache();
+        {
+            std::lock_guard<std::mutex> lock(cache.m_mutex);
+            for (const auto &e : cache.m_entries) {
+                if (e.first == sig) {
+                    return e.second;
+                }
+            }
+        }
+        const bucket_size_type retval = f();
+        std::lock_guard<std::mutex> lock(cache.m_mutex);
+        if (cache.m_entries.size() < max_entries) {
+            cache.m_entries.emplace_back(sig, retval);
+        } else {
+            cache.m_entries[cache.m_next] = std::make_pair(sig, retval);
+            cache.m_next = (cache.m_next + 1u) % max_entries;
+        }
+        return retval;
+    }
     /// Estimate size of series multiplication (convenience overload)
     /**
      * @return the output of the other overload of estimate_final_series_size(), with a limit
@@ -728,6 +921,29 @@ protected:
     {
         return estimate_final_series_size<MultArity, MultFunctor>(default_limit_functor{*this});
     }
+    /// Default key multiplier.
+    /**
+     * This functor is the default key multiplier used by base_series_multiplier::plain_multiplier and
+     * base_series_multiplier::plain_multiplication(): its call operator will invoke the static <tt>multiply()</tt>
+     * method of the key type of \p Series. Custom key multipliers must be default-constructible and they must
+     * expose a const call operator with the same signature.
+     */
+    struct default_key_multiplier {
+        /// Call operator.
+        /**
+         * @param res the array of terms that will store the result of the multiplication.
+         * @param t1 first argument.
+         * @param t2 second argument.
+         * @param ss the reference piranha::symbol_fset.
+         *
+         * @throws unspecified any exception thrown by the <tt>multiply()</tt> method of the key type.
+         */
+        template <typename Res, typename Term>
+        void operator()(Res &res, const Term &t1, const Term &t2, const symbol_fset &ss) const
+        {
+            Term::key_type::multiply(res, t1, t2, ss);
+        }
+    };
     /// A plain multiplier functor.
     /**
      * \note
@@ -747,8 +963,11 @@ protected:
      * using the low-level interface of piranha::hash_set, otherwise the call operator will use
      * piranha::series::insert() for
      * term insertion.
+     *
+     * The term-by-term multiplications are performed via an instance of \p KeyMultiplier (see
+     * base_series_multiplier::default_key_multiplier).
      */
-    template <bool FastMode>
+    template <bool FastMode, typename KeyMultiplier = default_key_multiplier>
     class plain_multiplier
     {
         using term_type = typename Series::term_type;
@@ -795,7 +1014,7 @@ protected:
         void operator()(const size_type &i, const size_type &j) const
         {
             // First perform the multiplication.
-            key_type::multiply(m_tmp_t, *m_v1[i], *m_v2[j], m_retval.get_symbol_set());
+            KeyMultiplier{}(m_tmp_t, *m_v1[i], *m_v2[j], m_retval.get_symbol_set());
             for (std::size_t n = 0u; n < m_arity; ++n) {
                 auto &tmp_term = m_tmp_t[n];
                 if (FastMode) {
@@ -963,7 +1182,8 @@ protected:
      * either base_series_multiplier::plain_multiplier or a similar thread-safe multiplier for the term-by-term
      * multiplications.
      * The \p lf functor will be forwarded as limit functor to base_series_multiplier::blocked_multiplication()
-     * and base_series_multiplier::estimate_final_series_size().
+     * and base_series_multiplier::estimate_final_series_size(). The term-by-term multiplications are performed via
+     * instances of \p KeyMultiplier (see base_series_multiplier::default_key_multiplier).
      *
      * Note that, in multithreaded mode, \p lf will be shared among (and called concurrently from) all the threads.
      *
@@ -978,13 +1198,13 @@ protected:
      * - the public interface of piranha::hash_set,
      * - base_series_multiplier::blocked_multiplication(),
      * - base_series_multiplier::sanitise_series(),
-     * - the <tt>multiply()</tt> method of the key type of \p Series,
+     * - the call operator of \p KeyMultiplier,
      * - thread_pool::enqueue(),
      * - future_list::push_back(),
      * - the construction of terms,
      * - in-place addition of coefficients.
      */
-    template <typename LimitFunctor>
+    template <typename LimitFunctor, typename KeyMultiplier = default_key_multiplier>
     Series plain_multiplication(const LimitFunctor &lf) const
     {
         // Shortcuts.
@@ -1015,7 +1235,7 @@ protected:
         }
         if (estimate) {
             // Estimate and rehash.
-            const auto est = estimate_final_series_size<m_arity, plain_multiplier<false>>(lf);
+            const auto est = estimate_final_series_size<m_arity, plain_multiplier<false, KeyMultiplier>>(lf);
             // NOTE: use numeric cast here as safe_cast is expensive, going through an integer-double conversion,
             // and in this case the behaviour of numeric_cast is appropriate.
             const auto n_buckets = boost::numeric_cast<bucket_size_type>(
@@ -1031,11 +1251,11 @@ protected:
             try {
                 // Single-thread case.
                 if (estimate) {
-                    blocked_multiplication(plain_multiplier<true>(*this, retval), 0u, size1, lf);
+                    blocked_multiplication(plain_multiplier<true, KeyMultiplier>(*this, retval), 0u, size1, lf);
                     // If we estimated beforehand, we need to sanitise the series.
                     sanitise_series(retval, static_cast<unsigned>(n_threads));
                 } else {
-                    blocked_multiplication(plain_multiplier<false>(*this, retval), 0u, size1, lf);
+                    blocked_multiplication(plain_multiplier<false, KeyMultiplier>(*this, retval), 0u, size1, lf);
                 }
                 finalise_series(retval);
                 return retval;
@@ -1065,7 +1285,7 @@ protected:
                     // additionally.
                     auto f = [&c_end, &tmp_t, this, &retval, &sl_array](const size_type &i, const size_type &j) {
                         // Run the term multiplication.
-                        key_type::multiply(tmp_t, *(this->m_v1[i]), *(this->m_v2[j]), retval.get_symbol_set());
+                        KeyMultiplier{}(tmp_t, *(this->m_v1[i]), *(this->m_v2[j]), retval.get_symbol_set());
                         for (std::size_t n = 0u; n < key_type::multiply_arity; ++n) {
                             auto &container = retval._container();
                             auto &tmp_term = tmp_t[n];
@@ -1103,13 +1323,15 @@ protected:
     /// A plain series multiplication routine (convenience overload).
     /**
      * @return the output of the other overload of plain_multiplication(), with a limit
-     * functor whose call operator will always return the size of the second series unconditionally.
+     * functor whose call operator will always return the size of the second series unconditionally, and
+     * \p KeyMultiplier as key multiplier.
      *
      * @throws unspecified any exception thrown by the other overload of plain_multiplication().
      */
+    template <typename KeyMultiplier = default_key_multiplier>
     Series plain_multiplication() const
     {
-        return plain_multiplication(default_limit_functor{*this});
+        return plain_multiplication<default_limit_functor, KeyMultiplier>(default_limit_functor{*this});
     }
     /// Finalise series.
     /**
@@ -1149,6 +1371,8 @@ private:
     // See the constructor for an explanation.
     container_type m_zero_f1;
     container_type m_zero_f2;
+    frozen_series<Series> m_zero_fs1;
+    frozen_series<Series> m_zero_fs2;
 };
 }
 
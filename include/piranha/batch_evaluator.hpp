@@ -0,0 +1,414 @@
+/* Copyright 2009-2017 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#ifndef PIRANHA_BATCH_EVALUATOR_HPP
+#define PIRANHA_BATCH_EVALUATOR_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <piranha/config.hpp>
+#include <piranha/exceptions.hpp>
+#include <piranha/integer.hpp>
+#include <piranha/kronecker_monomial.hpp>
+#include <piranha/monomial.hpp>
+#include <piranha/safe_cast.hpp>
+#include <piranha/series.hpp>
+#include <piranha/settings.hpp>
+#include <piranha/symbol_utils.hpp>
+#include <piranha/thread_pool.hpp>
+#include <piranha/type_traits.hpp>
+
+namespace piranha
+{
+
+inline namespace impl
+{
+
+// Extraction of the integral exponents of a key, for the key types supported by the batch evaluator.
+template <typename Key, typename = void>
+struct batch_eval_key {
+};
+
+template <typename T>
+struct batch_eval_key<kronecker_monomial<T>> {
+    static void exponents(std::vector<int> &out, const kronecker_monomial<T> &k, const symbol_fset &ss)
+    {
+        const auto tmp = k.unpack(ss);
+        out.resize(0);
+        for (const auto &e : tmp) {
+            out.push_back(safe_cast<int>(e));
+        }
+    }
+};
+
+template <typename T, typename S>
+struct batch_eval_key<monomial<T, S>, enable_if_t<has_safe_cast<int, T>::value>> {
+    static void exponents(std::vector<int> &out, const monomial<T, S> &k, const symbol_fset &ss)
+    {
+        piranha_assert(k.size() == ss.size());
+        (void)ss;
+        out.resize(0);
+        for (const auto &e : k) {
+            out.push_back(safe_cast<int>(e));
+        }
+    }
+};
+
+template <typename Key>
+using batch_eval_key_t = decltype(batch_eval_key<Key>::exponents(
+    std::declval<std::vector<int> &>(), std::declval<const Key &>(), std::declval<const symbol_fset &>()));
+
+// NOTE: check first that Series is a series, so that the other checks are not instantiated otherwise.
+template <typename Series, typename T, typename = void>
+struct batch_evaluator_reqs : std::false_type {
+};
+
+template <typename Series, typename T>
+struct batch_evaluator_reqs<Series, T, enable_if_t<is_series<Series>::value>>
+    : conjunction<is_detected<batch_eval_key_t, typename Series::term_type::key_type>,
+                  std::is_constructible<T, const typename Series::term_type::cf_type &>,
+                  std::is_constructible<T, const int &>, std::is_copy_assignable<T>, is_addable_in_place<T>,
+                  is_multipliable_in_place<T>, is_multipliable<T>, is_divisible<T>> {
+};
+}
+
+/// Batch evaluator.
+/**
+ * This class allows to evaluate a series of type \p Series at many points at once. The points are
+ * expressed as values of type \p T, and they are passed to the call operator in a structure-of-arrays layout:
+ * for each symbol, an array with the values of that symbol at all the evaluation points.
+ *
+ * On construction, the coefficients of the series are converted to \p T and the integral exponents of the keys
+ * are unpacked once and for all. At evaluation time, the points are processed in blocks: for each block and for each
+ * symbol, a table of the powers of the symbol appearing in the series is computed via repeated multiplications,
+ * and the terms are then accumulated using only table lookups, multiplications and additions over contiguous
+ * arrays of values. With fundamental floating-point types, the inner loops are amenable to auto-vectorisation across
+ * the evaluation points. If the amount of work is large enough, the blocks of points are distributed among the
+ * threads of piranha::thread_pool.
+ *
+ * Because of the different ordering of the floating-point operations, the results may differ slightly
+ * from those of piranha::math::evaluate().
+ *
+ * ## Type requirements ##
+ *
+ * \p Series must be an instance of piranha::series whose key type is either piranha::kronecker_monomial or
+ * piranha::monomial with exponents safely convertible to \p int. \p T must be constructible from \p int and from
+ * the coefficient type of \p Series, copy-assignable, and it must support the basic arithmetic operations.
+ *
+ * ## Exception safety guarantee ##
+ *
+ * Unless otherwise specified, this class provides the strong exception safety guarantee for all operations.
+ *
+ * ## Move semantics ##
+ *
+ * Move construction and move assignment will leave the moved-from object in an unspecified but valid state.
+ */
+template <typename Series, typename T>
+class batch_evaluator
+{
+    static_assert(std::is_same<T, uncvref_t<T>>::value, "Invalid type.");
+    static_assert(batch_evaluator_reqs<Series, T>::value, "Invalid types.");
+
+public:
+    /// Size type.
+    using size_type = std::size_t;
+
+private:
+    // Number of evaluation points in a block.
+    // NOTE: this is a tuning parameter.
+    static const size_type block_size = 256u;
+    // Evaluate the points in the block range [b_begin, b_end), writing the results into out.
+    void evaluate_blocks(std::vector<T> &out, const std::vector<std::vector<T>> &values, size_type n_points,
+                         size_type b_begin, size_type b_end) const
+    {
+        // Tables of powers, accumulator and temporary storage for the evaluation of a term.
+        std::vector<T> tab(m_n_rows * block_size, T(0)), acc(block_size, T(0)), tmp(block_size, T(0));
+        for (auto b = b_begin; b < b_end; ++b) {
+            const auto p0 = b * block_size, bs = std::min(block_size, n_points - p0);
+            // Build the tables of powers.
+            for (decltype(m_syms.size()) i = 0u; i < m_syms.size(); ++i) {
+                const auto &sd = m_syms[i];
+                const T *x = values[sd.m_pos].data() + p0;
+                // NOTE: the row of the exponent e starts at tab[(sd.m_row + e) * block_size].
+                T *r0 = tab.data() + sd.m_row * block_size;
+                for (size_type p = 0u; p < bs; ++p) {
+                    r0[p] = T(1);
+                }
+                for (int e = 1; e <= sd.m_max; ++e) {
+                    T *r = r0 + static_cast<size_type>(e) * block_size;
+                    const T *r_prev = r - block_size;
+                    for (size_type p = 0u; p < bs; ++p) {
+                        r[p] = r_prev[p] * x[p];
+                    }
+                }
+                if (sd.m_min < 0) {
+                    T *r_inv = r0 - block_size;
+                    for (size_type p = 0u; p < bs; ++p) {
+                        r_inv[p] = T(1) / x[p];
+                    }
+                    for (int e = 2; e <= -sd.m_min; ++e) {
+                        T *r = r0 - static_cast<size_type>(e) * block_size;
+                        const T *r_prev = r + block_size;
+                        for (size_type p = 0u; p < bs; ++p) {
+                            r[p] = r_prev[p] * r_inv[p];
+                        }
+                    }
+                }
+            }
+            // Accumulate the terms.
+            T *a = acc.data(), *t = tmp.data();
+            for (size_type p = 0u; p < bs; ++p) {
+                a[p] = T(0);
+            }
+            for (decltype(m_cfs.size()) i = 0u; i < m_cfs.size(); ++i) {
+                const auto &cf = m_cfs[i];
+                const auto f_begin = m_term_offsets[i], f_end = m_term_offsets[i + 1u];
+                if (f_begin == f_end) {
+                    // Constant term.
+                    for (size_type p = 0u; p < bs; ++p) {
+                        a[p] += cf;
+                    }
+                    continue;
+                }
+                const T *r = tab.data() + m_rows[f_begin] * block_size;
+                for (size_type p = 0u; p < bs; ++p) {
+                    t[p] = cf * r[p];
+                }
+                for (auto j = f_begin + 1u; j < f_end; ++j) {
+                    r = tab.data() + m_rows[j] * block_size;
+                    for (size_type p = 0u; p < bs; ++p) {
+                        t[p] *= r[p];
+                    }
+                }
+                for (size_type p = 0u; p < bs; ++p) {
+                    a[p] += t[p];
+                }
+            }
+            std::copy(acc.begin(), acc.begin() + static_cast<std::ptrdiff_t>(bs),
+                      out.begin() + static_cast<std::ptrdiff_t>(p0));
+        }
+    }
+
+public:
+    /// Constructor.
+    /**
+     * The constructor will store the coefficients of \p s converted to \p T, and the exponents of the keys of \p s.
+     * \p names establishes the mapping between the symbols of \p s and the arrays of values that will be passed to
+     * the call operator: the <tt>i</tt>-th array will contain the values of the symbol <tt>names[i]</tt>. \p names
+     * may contain symbols which do not appear in \p s.
+     *
+     * @param s the series that will be evaluated.
+     * @param names the list of symbols to which the arrays of values passed to the call operator will be mapped.
+     *
+     * @throws std::invalid_argument if \p names contains duplicates, or if a symbol of \p s does not appear
+     * in \p names.
+     * @throws std::overflow_error if the exponents of \p s are too large.
+     * @throws unspecified any exception thrown by:
+     * - memory errors in standard containers,
+     * - the unpacking of the keys of \p s,
+     * - the constructors of \p T,
+     * - piranha::safe_cast().
+     */
+    explicit batch_evaluator(const Series &s, const std::vector<std::string> &names) : m_n_names(names.size())
+    {
+        // Check if there are duplicates.
+        auto names_copy(names);
+        std::sort(names_copy.begin(), names_copy.end());
+        if (std::unique(names_copy.begin(), names_copy.end()) != names_copy.end()) {
+            piranha_throw(std::invalid_argument, "the list of evaluation symbols contains duplicates");
+        }
+        // Locate the symbols of s in names.
+        const auto &ss = s.get_symbol_set();
+        for (const auto &sym : ss) {
+            const auto it = std::find(names.begin(), names.end(), sym);
+            if (unlikely(it == names.end())) {
+                piranha_throw(std::invalid_argument, "cannot evaluate series: the symbol '" + sym
+                                                         + "' is missing from the list of evaluation symbols");
+            }
+            m_syms.push_back(sym_data{static_cast<size_type>(it - names.begin()), 0, 0, 0u});
+        }
+        // Unpack the exponents, and determine the range of exponents for each symbol.
+        std::vector<std::vector<std::pair<size_type, int>>> factors;
+        std::vector<int> expos;
+        m_term_offsets.push_back(0u);
+        for (const auto &term : s._container()) {
+            batch_eval_key<typename Series::term_type::key_type>::exponents(expos, term.m_key, ss);
+            piranha_assert(expos.size() == m_syms.size());
+            std::vector<std::pair<size_type, int>> tf;
+            for (decltype(expos.size()) i = 0u; i < expos.size(); ++i) {
+                const auto e = expos[i];
+                if (e == 0) {
+                    continue;
+                }
+                if (unlikely(e == std::numeric_limits<int>::min())) {
+                    piranha_throw(std::overflow_error, "overflow in the exponents of a series in batch evaluation");
+                }
+                auto &sd = m_syms[i];
+                sd.m_min = std::min(sd.m_min, e);
+                sd.m_max = std::max(sd.m_max, e);
+                tf.emplace_back(static_cast<size_type>(i), e);
+            }
+            m_cfs.emplace_back(term.m_cf);
+            m_term_offsets.push_back(safe_cast<size_type>(m_term_offsets.back() + tf.size()));
+            factors.push_back(std::move(tf));
+        }
+        // Establish the layout of the tables of powers. Each symbol is assigned a set of rows, one for each
+        // exponent in the [min, max] range. m_row is the index of the row of the zero exponent.
+        size_type n_rows = 0u;
+        for (auto &sd : m_syms) {
+            const auto n = safe_cast<size_type>(integer(sd.m_max) - sd.m_min + 1);
+            sd.m_row = safe_cast<size_type>(integer(n_rows) - sd.m_min);
+            n_rows = safe_cast<size_type>(integer(n_rows) + n);
+        }
+        m_n_rows = n_rows;
+        // Check that the tables can be allocated.
+        safe_cast<size_type>(integer(m_n_rows) * block_size);
+        // Store the rows of the factors of each term.
+        for (const auto &tf : factors) {
+            for (const auto &f : tf) {
+                m_rows.push_back(safe_cast<size_type>(integer(m_syms[f.first].m_row) + f.second));
+            }
+        }
+    }
+    /// Defaulted copy constructor.
+    batch_evaluator(const batch_evaluator &) = default;
+    /// Defaulted move constructor.
+    batch_evaluator(batch_evaluator &&) = default;
+    /// Copy assignment operator.
+    /**
+     * @param other the assignment argument.
+     *
+     * @return a reference to \p this.
+     *
+     * @throws unspecified any exception thrown by the copy constructor.
+     */
+    batch_evaluator &operator=(const batch_evaluator &other)
+    {
+        if (likely(this != &other)) {
+            *this = batch_evaluator(other);
+        }
+        return *this;
+    }
+    /// Defaulted move assignment operator.
+    batch_evaluator &operator=(batch_evaluator &&) = default;
+    /// Batch evaluation.
+    /**
+     * The <tt>i</tt>-th element of \p values must contain the values of the <tt>i</tt>-th symbol in the list of
+     * names used during construction, at all the evaluation points. All the elements of \p values must thus have
+     * the same size, equal to the number of evaluation points.
+     *
+     * This method is thread-safe.
+     *
+     * @param values the values of the symbols at the evaluation points.
+     *
+     * @return a vector containing the result of the evaluation at each point.
+     *
+     * @throws std::invalid_argument if the size of \p values is not equal to the size of the list of names
+     * used during construction, or if the elements of \p values do not all have the same size.
+     * @throws unspecified any exception thrown by:
+     * - memory errors in standard containers,
+     * - the arithmetic operations and the constructors of \p T,
+     * - threading primitives,
+     * - thread_pool::use_threads().
+     */
+    std::vector<T> operator()(const std::vector<std::vector<T>> &values) const
+    {
+        if (unlikely(values.size() != m_n_names)) {
+            piranha_throw(std::invalid_argument, "the number of arrays of evaluation values does not "
+                                                 "match the size of the symbol list used during construction");
+        }
+        const auto n_points = values.empty() ? size_type(0) : safe_cast<size_type>(values[0].size());
+        if (unlikely(std::any_of(values.begin(), values.end(),
+                                 [n_points](const std::vector<T> &v) { return v.size() != n_points; }))) {
+            piranha_throw(std::invalid_argument, "the arrays of evaluation values must all have the same size");
+        }
+        std::vector<T> retval(n_points, T(0));
+        if (!n_points) {
+            return retval;
+        }
+        const auto n_blocks
+            = static_cast<size_type>(n_points / block_size + static_cast<size_type>(n_points % block_size != 0u));
+        const auto work = integer(n_points) * std::max(m_cfs.size(), decltype(m_cfs.size())(1u));
+        const auto n_threads = static_cast<size_type>(
+            std::min(integer(thread_pool::use_threads(work, integer(settings::get_min_work_per_thread()))),
+                     integer(n_blocks)));
+        if (n_threads == 1u) {
+            evaluate_blocks(retval, values, n_points, 0u, n_blocks);
+            return retval;
+        }
+        // Distribute the blocks among the threads.
+        const auto bpt = n_blocks / n_threads;
+        future_list<void> ft_list;
+        try {
+            for (size_type i = 0u; i < n_threads; ++i) {
+                const auto b_begin = i * bpt, b_end = (i == n_threads - 1u) ? n_blocks : (i + 1u) * bpt;
+                ft_list.push_back(thread_pool::enqueue(static_cast<unsigned>(i), [this, &retval, &values, n_points,
+                                                                                   b_begin, b_end]() {
+                    this->evaluate_blocks(retval, values, n_points, b_begin, b_end);
+                }));
+            }
+            ft_list.wait_all();
+            ft_list.get_all();
+        } catch (...) {
+            ft_list.wait_all();
+            throw;
+        }
+        return retval;
+    }
+
+private:
+    // Data about a symbol of the series: position in the list of names, range of the exponents
+    // and index of the row of the zero exponent in the tables of powers.
+    struct sym_data {
+        size_type m_pos;
+        int m_min;
+        int m_max;
+        size_type m_row;
+    };
+    size_type m_n_names;
+    std::vector<sym_data> m_syms;
+    size_type m_n_rows = 0u;
+    // Coefficients of the terms.
+    std::vector<T> m_cfs;
+    // The factors of the i-th term are the rows m_rows[m_term_offsets[i]], ..., m_rows[m_term_offsets[i + 1] - 1].
+    std::vector<size_type> m_term_offsets;
+    std::vector<size_type> m_rows;
+};
+
+template <typename Series, typename T>
+const typename batch_evaluator<Series, T>::size_type batch_evaluator<Series, T>::block_size;
+}
+
+#endif
@@ -0,0 +1,721 @@
+/* Copyright 2009-2017 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#ifndef PIRANHA_CHUNKED_S11N_HPP
+#define PIRANHA_CHUNKED_S11N_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <ios>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <piranha/config.hpp>
+
+#if defined(PIRANHA_WITH_BZIP2) || defined(PIRANHA_WITH_ZLIB)
+
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+
+#endif
+
+#if defined(PIRANHA_WITH_BZIP2)
+
+#include <boost/iostreams/filter/bzip2.hpp>
+
+#endif
+
+#if defined(PIRANHA_WITH_ZLIB)
+
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filter/zlib.hpp>
+
+#endif
+
+#include <piranha/detail/demangle.hpp>
+#include <piranha/exceptions.hpp>
+#include <piranha/s11n.hpp>
+#include <piranha/safe_cast.hpp>
+#include <piranha/series.hpp>
+#include <piranha/settings.hpp>
+#include <piranha/symbol_utils.hpp>
+#include <piranha/thread_pool.hpp>
+#include <piranha/type_traits.hpp>
+
+namespace piranha
+{
+
+inline namespace impl
+{
+
+// Description of a chunk: the range of buckets of the original series,
+// the number of terms and the size in bytes of the payload.
+struct chunked_descriptor {
+    std::uint64_t m_begin;
+    std::uint64_t m_end;
+    std::uint64_t m_n_terms;
+    std::uint64_t m_size;
+};
+
+// The integers in the header of a chunked file are stored in little-endian order.
+inline void chunked_write_u64(std::string &out, std::uint64_t n)
+{
+    for (unsigned i = 0u; i < 8u; ++i) {
+        out.push_back(static_cast<char>(static_cast<unsigned char>((n >> (8u * i)) & 255u)));
+    }
+}
+
+inline std::uint64_t chunked_read_u64(std::istream &in, const std::string &filename)
+{
+    unsigned char buffer[8];
+    in.read(reinterpret_cast<char *>(buffer), 8);
+    if (unlikely(!in.good())) {
+        piranha_throw(std::invalid_argument, "the file '" + filename + "' is not a valid chunked file");
+    }
+    std::uint64_t retval = 0u;
+    for (unsigned i = 0u; i < 8u; ++i) {
+        retval |= static_cast<std::uint64_t>(buffer[i]) << (8u * i);
+    }
+    return retval;
+}
+
+inline const char *chunked_magic()
+{
+    // NOTE: 7 characters plus the terminator.
+    return "PIRCHNK";
+}
+
+inline std::uint64_t chunked_version()
+{
+    return 1u;
+}
+
+#if defined(PIRANHA_WITH_BZIP2) || defined(PIRANHA_WITH_ZLIB)
+
+// Run a chunk payload through a (dual-use) compression or decompression filter.
+template <typename Filter>
+inline std::string chunked_filter(const std::string &s)
+{
+    boost::iostreams::filtering_istream in;
+    in.push(Filter{});
+    in.push(boost::iostreams::array_source(s.data(), s.size()));
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+#endif
+
+inline std::string chunked_compress(std::string s, compression c)
+{
+    switch (c) {
+        case compression::bzip2:
+#if defined(PIRANHA_WITH_BZIP2)
+            return chunked_filter<boost::iostreams::bzip2_compressor>(s);
+#else
+            piranha_throw(not_implemented_error, "bzip2 support is not enabled");
+#endif
+        case compression::gzip:
+#if defined(PIRANHA_WITH_ZLIB)
+            return chunked_filter<boost::iostreams::gzip_compressor>(s);
+#else
+            piranha_throw(not_implemented_error, "zlib support is not enabled");
+#endif
+        case compression::zlib:
+#if defined(PIRANHA_WITH_ZLIB)
+            return chunked_filter<boost::iostreams::zlib_compressor>(s);
+#else
+            piranha_throw(not_implemented_error, "zlib support is not enabled");
+#endif
+        case compression::none:
+            break;
+    }
+    return s;
+}
+
+inline std::string chunked_decompress(std::string s, compression c)
+{
+    switch (c) {
+        case compression::bzip2:
+#if defined(PIRANHA_WITH_BZIP2)
+            return chunked_filter<boost::iostreams::bzip2_decompressor>(s);
+#else
+            piranha_throw(not_implemented_error, "bzip2 support is not enabled");
+#endif
+        case compression::gzip:
+#if defined(PIRANHA_WITH_ZLIB)
+            return chunked_filter<boost::iostreams::gzip_decompressor>(s);
+#else
+            piranha_throw(not_implemented_error, "zlib support is not enabled");
+#endif
+        case compression::zlib:
+#if defined(PIRANHA_WITH_ZLIB)
+            return chunked_filter<boost::iostreams::zlib_decompressor>(s);
+#else
+            piranha_throw(not_implemented_error, "zlib support is not enabled");
+#endif
+        case compression::none:
+            break;
+    }
+    return s;
+}
+
+// Check the number of terms decoded from a chunk.
+inline void chunked_check_n_terms(std::uint64_t n, const chunked_descriptor &d)
+{
+    if (unlikely(n != d.m_n_terms)) {
+        piranha_throw(std::invalid_argument, "the number of terms in a chunk is inconsistent with the chunk header");
+    }
+}
+
+#if defined(PIRANHA_WITH_BOOST_S11N)
+
+template <typename Series>
+using chunked_has_boost = conjunction<
+    has_boost_save<boost::archive::binary_oarchive, typename Series::term_type::cf_type>,
+    has_boost_save<boost::archive::text_oarchive, typename Series::term_type::cf_type>,
+    has_boost_save<boost::archive::binary_oarchive, boost_s11n_key_wrapper<typename Series::term_type::key_type>>,
+    has_boost_save<boost::archive::text_oarchive, boost_s11n_key_wrapper<typename Series::term_type::key_type>>,
+    has_boost_load<boost::archive::binary_iarchive, typename Series::term_type::cf_type>,
+    has_boost_load<boost::archive::text_iarchive, typename Series::term_type::cf_type>,
+    has_boost_load<boost::archive::binary_iarchive, boost_s11n_key_wrapper<typename Series::term_type::key_type>>,
+    has_boost_load<boost::archive::text_iarchive, boost_s11n_key_wrapper<typename Series::term_type::key_type>>>;
+
+template <typename Archive, typename Series>
+inline void chunked_boost_save_terms(Archive &ar, const Series &s, const chunked_descriptor &d)
+{
+    using key_type = typename Series::term_type::key_type;
+    using b_size_t = decltype(s._container().bucket_count());
+    boost_save(ar, static_cast<unsigned long long>(d.m_n_terms));
+    for (auto i = static_cast<b_size_t>(d.m_begin); i < static_cast<b_size_t>(d.m_end); ++i) {
+        for (const auto &t : s._container()._get_bucket_list(i)) {
+            boost_save(ar, t.m_cf);
+            boost_save(ar, boost_s11n_key_wrapper<key_type>{t.m_key, s.get_symbol_set()});
+        }
+    }
+}
+
+template <typename Series, enable_if_t<chunked_has_boost<Series>::value, int> = 0>
+inline std::string chunked_encode_boost(const Series &s, const chunked_descriptor &d, data_format f)
+{
+    std::ostringstream oss(std::ios::out | std::ios::binary);
+    {
+        if (f == data_format::boost_binary) {
+            boost::archive::binary_oarchive oa(oss);
+            chunked_boost_save_terms(oa, s, d);
+        } else {
+            boost::archive::text_oarchive oa(oss);
+            chunked_boost_save_terms(oa, s, d);
+        }
+    }
+    return oss.str();
+}
+
+template <typename Series, enable_if_t<!chunked_has_boost<Series>::value, int> = 0>
+inline std::string chunked_encode_boost(const Series &, const chunked_descriptor &, data_format)
+{
+    piranha_throw(not_implemented_error,
+                  "type '" + demangle<Series>() + "' does not support serialization via Boost");
+}
+
+template <typename Series, typename Archive, typename Sink>
+inline void chunked_boost_load_terms(Archive &ar, const symbol_fset &ss, const chunked_descriptor &d, Sink &sink)
+{
+    using term_type = typename Series::term_type;
+    using key_type = typename term_type::key_type;
+    unsigned long long n;
+    boost_load(ar, n);
+    chunked_check_n_terms(n, d);
+    for (unsigned long long i = 0u; i < n; ++i) {
+        term_type t;
+        boost_load(ar, t.m_cf);
+        boost_s11n_key_wrapper<key_type> w{t.m_key, ss};
+        boost_load(ar, w);
+        sink(std::move(t));
+    }
+}
+
+template <typename Series, typename Sink, enable_if_t<chunked_has_boost<Series>::value, int> = 0>
+inline void chunked_decode_boost(const std::string &payload, const symbol_fset &ss, const chunked_descriptor &d,
+                                 data_format f, Sink &sink)
+{
+    std::istringstream iss(payload, std::ios::in | std::ios::binary);
+    if (f == data_format::boost_binary) {
+        boost::archive::binary_iarchive ia(iss);
+        chunked_boost_load_terms<Series>(ia, ss, d, sink);
+    } else {
+        boost::archive::text_iarchive ia(iss);
+        chunked_boost_load_terms<Series>(ia, ss, d, sink);
+    }
+}
+
+template <typename Series, typename Sink, enable_if_t<!chunked_has_boost<Series>::value, int> = 0>
+inline void chunked_decode_boost(const std::string &, const symbol_fset &, const chunked_descriptor &, data_format,
+                                 Sink &)
+{
+    piranha_throw(not_implemented_error,
+                  "type '" + demangle<Series>() + "' does not support deserialization via Boost");
+}
+
+#else
+
+template <typename Series>
+inline std::string chunked_encode_boost(const Series &, const chunked_descriptor &, data_format)
+{
+    piranha_throw(not_implemented_error, "Boost serialization support is not enabled");
+}
+
+template <typename Series, typename Sink>
+inline void chunked_decode_boost(const std::string &, const symbol_fset &, const chunked_descriptor &, data_format,
+                                 Sink &)
+{
+    piranha_throw(not_implemented_error, "Boost serialization support is not enabled");
+}
+
+#endif
+
+#if defined(PIRANHA_WITH_MSGPACK)
+
+template <typename Series>
+using chunked_has_msgpack
+    = conjunction<has_msgpack_pack<msgpack::sbuffer, typename Series::term_type::cf_type>,
+                  key_has_msgpack_pack<msgpack::sbuffer, typename Series::term_type::key_type>,
+                  has_msgpack_convert<typename Series::term_type::cf_type>,
+                  key_has_msgpack_convert<typename Series::term_type::key_type>>;
+
+template <typename Series, enable_if_t<chunked_has_msgpack<Series>::value, int> = 0>
+inline std::string chunked_encode_msgpack(const Series &s, const chunked_descriptor &d, data_format f)
+{
+    using b_size_t = decltype(s._container().bucket_count());
+    const auto mf = (f == data_format::msgpack_binary) ? msgpack_format::binary : msgpack_format::portable;
+    msgpack::sbuffer sbuf;
+    msgpack::packer<msgpack::sbuffer> packer(sbuf);
+    // NOTE: same representation of the terms as in the msgpack serialization of series.
+    packer.pack_array(safe_cast<std::uint32_t>(d.m_n_terms));
+    for (auto i = static_cast<b_size_t>(d.m_begin); i < static_cast<b_size_t>(d.m_end); ++i) {
+        for (const auto &t : s._container()._get_bucket_list(i)) {
+            packer.pack_array(2u);
+            msgpack_pack(packer, t.m_cf, mf);
+            t.m_key.msgpack_pack(packer, mf, s.get_symbol_set());
+        }
+    }
+    return std::string(sbuf.data(), sbuf.size());
+}
+
+template <typename Series, enable_if_t<!chunked_has_msgpack<Series>::value, int> = 0>
+inline std::string chunked_encode_msgpack(const Series &, const chunked_descriptor &, data_format)
+{
+    piranha_throw(not_implemented_error,
+                  "type '" + demangle<Series>() + "' does not support serialization via msgpack");
+}
+
+template <typename Series, typename Sink, enable_if_t<chunked_has_msgpack<Series>::value, int> = 0>
+inline void chunked_decode_msgpack(const std::string &payload, const symbol_fset &ss, const chunked_descriptor &d,
+                                   data_format f, Sink &sink)
+{
+    using term_type = typename Series::term_type;
+    const auto mf = (f == data_format::msgpack_binary) ? msgpack_format::binary : msgpack_format::portable;
+    auto oh = msgpack::unpack(payload.data(), payload.size());
+    std::vector<msgpack::object> terms;
+    oh.get().convert(terms);
+    chunked_check_n_terms(safe_cast<std::uint64_t>(terms.size()), d);
+    for (const auto &o : terms) {
+        std::array<msgpack::object, 2> tmp;
+        o.convert(tmp);
+        term_type t;
+        msgpack_convert(t.m_cf, tmp[0], mf);
+        t.m_key.msgpack_convert(tmp[1], mf, ss);
+        sink(std::move(t));
+    }
+}
+
+template <typename Series, typename Sink, enable_if_t<!chunked_has_msgpack<Series>::value, int> = 0>
+inline void chunked_decode_msgpack(const std::string &, const symbol_fset &, const chunked_descriptor &, data_format,
+                                   Sink &)
+{
+    piranha_throw(not_implemented_error,
+                  "type '" + demangle<Series>() + "' does not support deserialization via msgpack");
+}
+
+#else
+
+template <typename Series>
+inline std::string chunked_encode_msgpack(const Series &, const chunked_descriptor &, data_format)
+{
+    piranha_throw(not_implemented_error, "msgpack support is not enabled");
+}
+
+template <typename Series, typename Sink>
+inline void chunked_decode_msgpack(const std::string &, const symbol_fset &, const chunked_descriptor &, data_format,
+                                   Sink &)
+{
+    piranha_throw(not_implemented_error, "msgpack support is not enabled");
+}
+
+#endif
+
+inline void chunked_check_format(data_format f)
+{
+    if (unlikely(f != data_format::boost_binary && f != data_format::boost_portable
+                 && f != data_format::msgpack_binary && f != data_format::msgpack_portable)) {
+        piranha_throw(not_implemented_error, "chunked serialization supports only the Boost and msgpack data formats");
+    }
+}
+
+// Run func(i) for each i in [0, n_chunks), using the threads in the thread pool.
+template <typename F>
+inline void chunked_parallel_for(std::uint64_t n_chunks, const F &func)
+{
+    if (!n_chunks) {
+        return;
+    }
+    const auto n_threads = thread_pool::use_threads(n_chunks, std::uint64_t(1u));
+    if (n_threads == 1u) {
+        for (std::uint64_t i = 0u; i < n_chunks; ++i) {
+            func(i);
+        }
+        return;
+    }
+    // NOTE: the chunks are assigned to the threads in a round-robin fashion.
+    auto thread_func = [n_threads, n_chunks, &func](unsigned thread_idx) {
+        for (std::uint64_t i = thread_idx; i < n_chunks; i += n_threads) {
+            func(i);
+        }
+    };
+    future_list<decltype(thread_func(0u))> f_list;
+    try {
+        for (unsigned i = 0u; i < n_threads; ++i) {
+            f_list.push_back(thread_pool::enqueue(i, thread_func, i));
+        }
+        f_list.wait_all();
+        f_list.get_all();
+    } catch (...) {
+        f_list.wait_all();
+        throw;
+    }
+}
+
+template <typename Series>
+using chunked_s11n_enabler = enable_if_t<is_series<Series>::value, int>;
+}
+
+/// Save series to file in chunks.
+/**
+ * \note
+ * This function is enabled only if \p Series satisfies piranha::is_series.
+ *
+ * This function will save the series \p s into the file \p filename using a chunked layout. The buckets of the
+ * container of \p s are partitioned into contiguous ranges, and the terms in each range are serialized (and
+ * optionally compressed) into an independent chunk. The chunks are produced in parallel by the threads in
+ * piranha::thread_pool. The number of chunks depends on the size of \p s, on the number of threads and
+ * on piranha::settings::get_min_work_per_thread().
+ *
+ * The file starts with a header containing the symbol set of \p s, the data format, the compression method and the
+ * description of each chunk, followed by the chunks. The data format \p f is used to serialize the terms within each
+ * chunk, and it must be one of the Boost or msgpack formats. The compression method \p c is applied to each chunk
+ * separately. The file can be loaded back via piranha::load_file_chunked().
+ *
+ * @param s the series to be saved.
+ * @param filename the name of the output file.
+ * @param f the data format.
+ * @param c the compression format.
+ *
+ * @throws piranha::not_implemented_error if \p f is piranha::data_format::flat_binary, if the terms of \p Series do
+ * not support the serialization method selected by \p f, or if a necessary optional third-party library is not
+ * available on the host platform.
+ * @throws std::runtime_error if the file cannot be opened for writing, or if an error occurs while writing into it.
+ * @throws unspecified any exception thrown by:
+ * - the low-level serialization functions of the coefficients and keys,
+ * - piranha::thread_pool::enqueue() and piranha::future_list::push_back(),
+ * - the public interface of the Boost iostreams library,
+ * - memory errors in standard containers,
+ * - piranha::safe_cast().
+ */
+template <typename Series, chunked_s11n_enabler<Series> = 0>
+inline void save_file_chunked(const Series &s, const std::string &filename, data_format f, compression c)
+{
+    chunked_check_format(f);
+    const auto &container = s._container();
+    const auto b_count = safe_cast<std::uint64_t>(container.bucket_count());
+    // Determine the number of chunks. We want at least min_work_per_thread terms per chunk, and a few
+    // chunks per thread, so that the load can be balanced when loading with a different number of threads.
+    std::uint64_t n_chunks = 0u;
+    if (s.size()) {
+        const auto size = safe_cast<std::uint64_t>(s.size());
+        const auto max_chunks = safe_cast<std::uint64_t>(settings::get_n_threads()) * 4u;
+        const auto min_work = safe_cast<std::uint64_t>(settings::get_min_work_per_thread());
+        n_chunks = std::min(b_count, std::max(std::uint64_t(1u), std::min(size / min_work, max_chunks)));
+    }
+    std::vector<chunked_descriptor> descs(safe_cast<std::vector<chunked_descriptor>::size_type>(n_chunks));
+    std::vector<std::string> payloads(safe_cast<std::vector<std::string>::size_type>(n_chunks));
+    for (std::uint64_t i = 0u; i < n_chunks; ++i) {
+        auto &d = descs[static_cast<std::vector<chunked_descriptor>::size_type>(i)];
+        d.m_begin = (b_count / n_chunks) * i;
+        d.m_end = (i == n_chunks - 1u) ? b_count : (b_count / n_chunks) * (i + 1u);
+    }
+    // Serialize the chunks in parallel.
+    chunked_parallel_for(n_chunks, [&s, &descs, &payloads, f, c](std::uint64_t i) {
+        auto &d = descs[static_cast<std::vector<chunked_descriptor>::size_type>(i)];
+        d.m_n_terms = 0u;
+        for (auto j = d.m_begin; j < d.m_end; ++j) {
+            const auto &bl = s._container()._get_bucket_list(static_cast<decltype(s._container().bucket_count())>(j));
+            d.m_n_terms += static_cast<std::uint64_t>(std::distance(bl.begin(), bl.end()));
+        }
+        auto &payload = payloads[static_cast<std::vector<std::string>::size_type>(i)];
+        if (f == data_format::boost_binary || f == data_format::boost_portable) {
+            payload = chunked_encode_boost(s, d, f);
+        } else {
+            payload = chunked_encode_msgpack(s, d, f);
+        }
+        payload = chunked_compress(std::move(payload), c);
+        d.m_size = safe_cast<std::uint64_t>(payload.size());
+    });
+    // Assemble the header.
+    std::string header(chunked_magic(), 8u);
+    chunked_write_u64(header, chunked_version());
+    chunked_write_u64(header, static_cast<std::uint64_t>(f));
+    chunked_write_u64(header, static_cast<std::uint64_t>(c));
+    chunked_write_u64(header, safe_cast<std::uint64_t>(s.get_symbol_set().size()));
+    for (const auto &sym : s.get_symbol_set()) {
+        chunked_write_u64(header, safe_cast<std::uint64_t>(sym.size()));
+        header += sym;
+    }
+    chunked_write_u64(header, b_count);
+    chunked_write_u64(header, safe_cast<std::uint64_t>(s.size()));
+    chunked_write_u64(header, n_chunks);
+    for (const auto &d : descs) {
+        chunked_write_u64(header, d.m_begin);
+        chunked_write_u64(header, d.m_end);
+        chunked_write_u64(header, d.m_n_terms);
+        chunked_write_u64(header, d.m_size);
+    }
+    // Write everything.
+    std::ofstream ofile(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (unlikely(!ofile.good())) {
+        piranha_throw(std::runtime_error, "file '" + filename + "' could not be opened for saving");
+    }
+    ofile.write(header.data(), safe_cast<std::streamsize>(header.size()));
+    for (const auto &p : payloads) {
+        ofile.write(p.data(), safe_cast<std::streamsize>(p.size()));
+    }
+    if (unlikely(!ofile.good())) {
+        piranha_throw(std::runtime_error, "an error occurred while writing to the file '" + filename + "'");
+    }
+}
+
+/// Load series from a chunked file.
+/**
+ * \note
+ * This function is enabled only if \p Series satisfies piranha::is_series.
+ *
+ * This function will load into \p s the content of the file \p filename, which must have been created by
+ * piranha::save_file_chunked(). The data format and the compression method are read from the file.
+ *
+ * The container of the return value is first rehashed (in parallel) to the number of buckets of the original series.
+ * The chunks are then read, decompressed and deserialized in parallel by the threads in piranha::thread_pool, and
+ * each thread inserts the terms of its chunks directly into the range of buckets covered by the chunk. Terms which
+ * do not belong to the bucket range of their chunk (e.g., because the hash values differ on the host platform) are
+ * inserted serially at the end.
+ *
+ * The strong exception safety guarantee is provided.
+ *
+ * @param s the target series.
+ * @param filename the name of the input file.
+ *
+ * @throws std::runtime_error if the file cannot be opened for reading.
+ * @throws std::invalid_argument if the file is not a valid chunked file, or if it contains incompatible or
+ * duplicate terms.
+ * @throws piranha::not_implemented_error if the terms of \p Series do not support the serialization method used
+ * in the file, or if a necessary optional third-party library is not available on the host platform.
+ * @throws unspecified any exception thrown by:
+ * - the low-level deserialization functions of the coefficients and keys,
+ * - the public interface of piranha::series and piranha::hash_set,
+ * - piranha::thread_pool::enqueue() and piranha::future_list::push_back(),
+ * - the public interface of the Boost iostreams library,
+ * - memory errors in standard containers,
+ * - piranha::safe_cast().
+ */
+template <typename Series, chunked_s11n_enabler<Series> = 0>
+inline void load_file_chunked(Series &s, const std::string &filename)
+{
+    using term_type = typename Series::term_type;
+    using b_size_t = decltype(s._container().bucket_count());
+    std::ifstream ifile(filename, std::ios::in | std::ios::binary);
+    if (unlikely(!ifile.good())) {
+        piranha_throw(std::runtime_error, "file '" + filename + "' could not be opened for loading");
+    }
+    auto invalid_file = [&filename]() {
+        piranha_throw(std::invalid_argument, "the file '" + filename + "' is not a valid chunked file");
+    };
+    // Read the header.
+    char magic[8];
+    ifile.read(magic, 8);
+    if (unlikely(!ifile.good() || std::string(magic, 8u) != std::string(chunked_magic(), 8u)
+                 || chunked_read_u64(ifile, filename) != chunked_version())) {
+        invalid_file();
+    }
+    const auto f_value = chunked_read_u64(ifile, filename), c_value = chunked_read_u64(ifile, filename);
+    if (unlikely(f_value > static_cast<std::uint64_t>(data_format::msgpack_portable)
+                 || c_value > static_cast<std::uint64_t>(compression::zlib))) {
+        invalid_file();
+    }
+    const auto f = static_cast<data_format>(f_value);
+    const auto c = static_cast<compression>(c_value);
+    std::vector<std::string> vs;
+    const auto n_symbols = chunked_read_u64(ifile, filename);
+    for (std::uint64_t i = 0u; i < n_symbols; ++i) {
+        std::string sym(safe_cast<std::string::size_type>(chunked_read_u64(ifile, filename)), '\0');
+        ifile.read(&sym[0], safe_cast<std::streamsize>(sym.size()));
+        if (unlikely(!ifile.good())) {
+            invalid_file();
+        }
+        vs.push_back(std::move(sym));
+    }
+    const symbol_fset ss(vs.begin(), vs.end());
+    if (unlikely(ss.size() != vs.size())) {
+        invalid_file();
+    }
+    const auto b_count = chunked_read_u64(ifile, filename), size = chunked_read_u64(ifile, filename),
+               n_chunks = chunked_read_u64(ifile, filename);
+    std::vector<chunked_descriptor> descs;
+    // The offsets of the chunks in the file.
+    std::vector<std::uint64_t> offsets;
+    std::uint64_t tot_terms = 0u, prev_end = 0u;
+    for (std::uint64_t i = 0u; i < n_chunks; ++i) {
+        chunked_descriptor d;
+        d.m_begin = chunked_read_u64(ifile, filename);
+        d.m_end = chunked_read_u64(ifile, filename);
+        d.m_n_terms = chunked_read_u64(ifile, filename);
+        d.m_size = chunked_read_u64(ifile, filename);
+        // NOTE: the bucket ranges must be sorted and disjoint, as the threads will insert
+        // concurrently into them.
+        if (unlikely(d.m_begin < prev_end || d.m_end < d.m_begin || d.m_end > b_count
+                     || d.m_n_terms > size - tot_terms)) {
+            invalid_file();
+        }
+        prev_end = d.m_end;
+        tot_terms += d.m_n_terms;
+        descs.push_back(d);
+    }
+    if (unlikely(tot_terms != size || (size && !b_count))) {
+        invalid_file();
+    }
+    // Check that the sizes of the chunks are consistent with the size of the file.
+    auto cur_offset = static_cast<std::uint64_t>(static_cast<std::streamoff>(ifile.tellg()));
+    ifile.seekg(0, std::ios::end);
+    const auto file_size = static_cast<std::uint64_t>(static_cast<std::streamoff>(ifile.tellg()));
+    for (const auto &d : descs) {
+        if (unlikely(d.m_size > file_size - cur_offset)) {
+            invalid_file();
+        }
+        offsets.push_back(cur_offset);
+        cur_offset += d.m_size;
+    }
+    if (unlikely(cur_offset != file_size)) {
+        invalid_file();
+    }
+    ifile.close();
+    // Prepare the return value.
+    Series retval;
+    retval.set_symbol_set(ss);
+    if (!size) {
+        s = std::move(retval);
+        return;
+    }
+    auto &container = retval._container();
+    container.rehash(safe_cast<b_size_t>(b_count), thread_pool::use_threads(n_chunks, std::uint64_t(1u)));
+    // Per-chunk counters and lists of misplaced terms.
+    std::vector<std::uint64_t> counts(safe_cast<std::vector<std::uint64_t>::size_type>(n_chunks), 0u);
+    using mp_size_t = typename std::vector<std::vector<term_type>>::size_type;
+    std::vector<std::vector<term_type>> misplaced(safe_cast<mp_size_t>(n_chunks));
+    try {
+        chunked_parallel_for(n_chunks, [&](std::uint64_t i) {
+            const auto idx = static_cast<std::vector<chunked_descriptor>::size_type>(i);
+            const auto &d = descs[idx];
+            auto &count = counts[idx];
+            auto &mp = misplaced[idx];
+            // Read the payload.
+            std::ifstream in(filename, std::ios::in | std::ios::binary);
+            in.seekg(safe_cast<std::streamoff>(offsets[idx]));
+            std::string payload(safe_cast<std::string::size_type>(d.m_size), '\0');
+            in.read(&payload[0], safe_cast<std::streamsize>(payload.size()));
+            if (unlikely(!in.good())) {
+                piranha_throw(std::runtime_error, "an error occurred while reading the file '" + filename + "'");
+            }
+            payload = chunked_decompress(std::move(payload), c);
+            // Insert the terms in the range of buckets of the chunk.
+            auto sink = [&](term_type &&t) {
+                if (unlikely(!t.is_compatible(ss))) {
+                    piranha_throw(std::invalid_argument, "cannot load an incompatible term from a chunked file");
+                }
+                if (unlikely(t.is_zero(ss))) {
+                    return;
+                }
+                const auto b = container._bucket(t);
+                if (unlikely(b < d.m_begin || b >= d.m_end)) {
+                    mp.push_back(std::move(t));
+                    return;
+                }
+                if (unlikely(container._find(t, b) != container.end())) {
+                    piranha_throw(std::invalid_argument, "cannot load a duplicate term from a chunked file");
+                }
+                container._unique_insert(std::move(t), b);
+                ++count;
+            };
+            if (f == data_format::boost_binary || f == data_format::boost_portable) {
+                chunked_decode_boost<Series>(payload, ss, d, f, sink);
+            } else {
+                chunked_decode_msgpack<Series>(payload, ss, d, f, sink);
+            }
+        });
+        std::uint64_t tot = 0u;
+        for (const auto &n : counts) {
+            tot += n;
+        }
+        container._update_size(safe_cast<b_size_t>(tot));
+    } catch (...) {
+        container.clear();
+        throw;
+    }
+    // Insert the misplaced terms.
+    for (auto &v : misplaced) {
+        for (auto &t : v) {
+            retval.insert(std::move(t));
+        }
+    }
+    s = std::move(retval);
+}
+}
+
+#endif
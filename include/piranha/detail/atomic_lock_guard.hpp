@@ -30,6 +30,7 @@ see https://www.gnu.org/licenses/. */
 #define PIRANHA_DETAIL_ATOMIC_LOCK_GUARD_HPP
 
 #include <atomic>
+#include <mutex>
 
 namespace piranha
 {
@@ -48,6 +49,8 @@ struct atomic_lock_guard {
         while (m_af.test_and_set(std::memory_order_acquire)) {
         }
     }
+    // Adopt a flag which was already acquired by the calling thread (e.g., via a successful test_and_set()).
+    explicit atomic_lock_guard(std::atomic_flag &af, std::adopt_lock_t) : m_af(af) {}
     ~atomic_lock_guard()
     {
         m_af.clear(std::memory_order_release);
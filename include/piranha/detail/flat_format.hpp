@@ -0,0 +1,483 @@
+/* Copyright 2009-2017 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#ifndef PIRANHA_DETAIL_FLAT_FORMAT_HPP
+#define PIRANHA_DETAIL_FLAT_FORMAT_HPP
+
+#include <climits>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <ios>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/numeric/conversion/cast.hpp>
+
+#include <piranha/config.hpp>
+
+#if defined(PIRANHA_HAVE_MMAP)
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#endif
+
+#include <piranha/exceptions.hpp>
+#include <piranha/safe_cast.hpp>
+#include <piranha/symbol_utils.hpp>
+
+namespace piranha
+{
+
+inline namespace impl
+{
+
+// Flat representation of the keys. Specialisations must provide the packed type (which must be trivially
+// copyable), a tag identifying uniquely the key type among the supported ones, and the pack()/unpack()
+// functions. The specialisations live in the headers of the key types.
+template <typename Key>
+struct flat_key {
+};
+
+template <typename Key>
+using flat_key_packed_t = typename flat_key<Key>::packed_type;
+
+// Tag identifying a fixed-width arithmetic type in the flat format.
+template <typename T>
+inline std::uint64_t flat_type_tag()
+{
+    return static_cast<std::uint64_t>(sizeof(T)) | (static_cast<std::uint64_t>(std::is_floating_point<T>::value) << 16)
+           | (static_cast<std::uint64_t>(std::is_signed<T>::value) << 17);
+}
+
+template <typename Key>
+inline std::uint64_t flat_key_tag()
+{
+    return (flat_key<Key>::tag() << 32) | flat_type_tag<typename Key::value_type>();
+}
+
+// Tag identifying the byte order and the width of the fundamental integral types. The low 32 bits contain
+// the bytes 1, 2, 3 and 4 in the native byte order, so that a file written on a platform with a different
+// byte order results in a byte-swapped tag.
+inline std::uint64_t flat_arch_tag()
+{
+    return std::uint64_t(0x04030201ul) | (static_cast<std::uint64_t>(CHAR_BIT) << 32)
+           | (static_cast<std::uint64_t>(sizeof(int)) << 40) | (static_cast<std::uint64_t>(sizeof(long)) << 48)
+           | (static_cast<std::uint64_t>(sizeof(long long)) << 56);
+}
+
+// The header of a flat file. The layout of the file is:
+// - the header,
+// - the symbols, each one stored as a 64-bit length followed by the characters,
+// - the packed keys,
+// - the coefficients,
+// with the arrays of keys and coefficients aligned to 64 bytes.
+struct flat_header {
+    char m_magic[8];
+    std::uint64_t m_arch_tag;
+    std::uint64_t m_version;
+    std::uint64_t m_cf_tag;
+    std::uint64_t m_key_tag;
+    std::uint64_t m_n_symbols;
+    std::uint64_t m_symbols_size;
+    std::uint64_t m_n_terms;
+};
+
+inline const char *flat_magic()
+{
+    // NOTE: 7 characters plus the terminator.
+    return "PIRFLAT";
+}
+
+inline std::uint64_t flat_version()
+{
+    return 2u;
+}
+
+inline std::uint64_t flat_add(std::uint64_t a, std::uint64_t b)
+{
+    if (unlikely(a > std::numeric_limits<std::uint64_t>::max() - b)) {
+        piranha_throw(std::overflow_error, "overflow in the computation of the layout of a flat file");
+    }
+    return a + b;
+}
+
+inline std::uint64_t flat_mul(std::uint64_t a, std::uint64_t b)
+{
+    if (unlikely(b && a > std::numeric_limits<std::uint64_t>::max() / b)) {
+        piranha_throw(std::overflow_error, "overflow in the computation of the layout of a flat file");
+    }
+    return a * b;
+}
+
+inline std::uint64_t flat_align(std::uint64_t n)
+{
+    return flat_add(n, 63u) & ~std::uint64_t(63u);
+}
+
+struct flat_layout {
+    std::uint64_t m_keys_offset;
+    std::uint64_t m_cfs_offset;
+    std::uint64_t m_size;
+};
+
+template <typename Packed, typename Cf>
+inline flat_layout flat_compute_layout(std::uint64_t symbols_size, std::uint64_t n_terms)
+{
+    flat_layout retval;
+    retval.m_keys_offset = flat_align(flat_add(sizeof(flat_header), symbols_size));
+    retval.m_cfs_offset = flat_align(flat_add(retval.m_keys_offset, flat_mul(n_terms, sizeof(Packed))));
+    retval.m_size = flat_add(retval.m_cfs_offset, flat_mul(n_terms, sizeof(Cf)));
+    return retval;
+}
+
+// Read-only view of the content of a file. If mmap() is available, the file is mapped in memory,
+// otherwise its content is read into a buffer.
+class flat_file_view
+{
+#if defined(PIRANHA_HAVE_MMAP)
+    struct fd_closer {
+        ~fd_closer()
+        {
+            ::close(m_fd);
+        }
+        int m_fd;
+    };
+#endif
+
+public:
+    explicit flat_file_view(const std::string &filename) : m_data(nullptr), m_size(0u)
+    {
+#if defined(PIRANHA_HAVE_MMAP)
+        const int fd = ::open(filename.c_str(), O_RDONLY);
+        if (unlikely(fd == -1)) {
+            piranha_throw(std::runtime_error, "file '" + filename + "' could not be opened for loading");
+        }
+        // NOTE: the mapping stays valid after the file descriptor is closed.
+        fd_closer closer{fd};
+        struct ::stat st;
+        if (unlikely(::fstat(fd, &st) == -1)) {
+            piranha_throw(std::runtime_error, "the size of the file '" + filename + "' could not be determined");
+        }
+        m_size = safe_cast<std::size_t>(st.st_size);
+        if (m_size) {
+            void *ptr = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (unlikely(ptr == MAP_FAILED)) {
+                piranha_throw(std::runtime_error, "file '" + filename + "' could not be mapped into memory");
+            }
+            m_data = static_cast<const char *>(ptr);
+        }
+#else
+        std::ifstream ifile(filename, std::ios::in | std::ios::binary | std::ios::ate);
+        if (unlikely(!ifile.good())) {
+            piranha_throw(std::runtime_error, "file '" + filename + "' could not be opened for loading");
+        }
+        m_size = safe_cast<std::size_t>(static_cast<std::streamoff>(ifile.tellg()));
+        ifile.seekg(0);
+        // NOTE: use max_align_t as storage type, so that the arrays in the file are suitably aligned.
+        m_buffer.reset(new std::max_align_t[m_size / sizeof(std::max_align_t) + 1u]);
+        ifile.read(reinterpret_cast<char *>(m_buffer.get()), safe_cast<std::streamsize>(m_size));
+        if (unlikely(!ifile.good())) {
+            piranha_throw(std::runtime_error, "an error occurred while reading the file '" + filename + "'");
+        }
+        m_data = reinterpret_cast<const char *>(m_buffer.get());
+#endif
+    }
+    flat_file_view(const flat_file_view &) = delete;
+    flat_file_view(flat_file_view &&) = delete;
+    flat_file_view &operator=(const flat_file_view &) = delete;
+    flat_file_view &operator=(flat_file_view &&) = delete;
+    ~flat_file_view()
+    {
+#if defined(PIRANHA_HAVE_MMAP)
+        if (m_data) {
+            ::munmap(const_cast<char *>(m_data), m_size);
+        }
+#endif
+    }
+    const char *data() const
+    {
+        return m_data;
+    }
+    std::size_t size() const
+    {
+        return m_size;
+    }
+
+private:
+    const char *m_data;
+    std::size_t m_size;
+#if !defined(PIRANHA_HAVE_MMAP)
+    std::unique_ptr<std::max_align_t[]> m_buffer;
+#endif
+};
+
+// Helper to write raw data into a flat file, keeping track of the current offset.
+class flat_file_writer
+{
+public:
+    explicit flat_file_writer(const std::string &filename)
+        : m_filename(filename), m_ofile(filename, std::ios::out | std::ios::binary | std::ios::trunc), m_offset(0u)
+    {
+        if (unlikely(!m_ofile.good())) {
+            piranha_throw(std::runtime_error, "file '" + filename + "' could not be opened for saving");
+        }
+    }
+    void write(const void *ptr, std::size_t size)
+    {
+        m_ofile.write(static_cast<const char *>(ptr), safe_cast<std::streamsize>(size));
+        if (unlikely(!m_ofile.good())) {
+            piranha_throw(std::runtime_error, "an error occurred while writing to the file '" + m_filename + "'");
+        }
+        m_offset = flat_add(m_offset, size);
+    }
+    // Write zeroes until the offset reaches n.
+    void pad(std::uint64_t n)
+    {
+        piranha_assert(n >= m_offset && n - m_offset < 64u);
+        const char zeroes[64] = {};
+        write(zeroes, static_cast<std::size_t>(n - m_offset));
+    }
+    // Write the elements of an array of packed objects generated by f from the terms of a series.
+    template <typename T, typename Series, typename F>
+    void write_array(const Series &s, const F &f)
+    {
+        std::vector<T> buffer;
+        const std::size_t chunk_size = 4096u;
+        buffer.reserve(chunk_size);
+        for (const auto &t : s._container()) {
+            buffer.push_back(f(t));
+            if (buffer.size() == chunk_size) {
+                write(buffer.data(), sizeof(T) * buffer.size());
+                buffer.clear();
+            }
+        }
+        write(buffer.data(), sizeof(T) * buffer.size());
+    }
+    std::uint64_t offset() const
+    {
+        return m_offset;
+    }
+
+private:
+    const std::string m_filename;
+    std::ofstream m_ofile;
+    std::uint64_t m_offset;
+};
+
+// Write the series s into the file filename.
+template <typename Series>
+inline void flat_save(const Series &s, const std::string &filename)
+{
+    using term_type = typename Series::term_type;
+    using cf_type = typename term_type::cf_type;
+    using key_type = typename term_type::key_type;
+    using packed_type = flat_key_packed_t<key_type>;
+    // Assemble the symbol set.
+    std::vector<char> symbols;
+    for (const auto &sym : s.get_symbol_set()) {
+        const auto len = safe_cast<std::uint64_t>(sym.size());
+        char buffer[sizeof(len)];
+        std::memcpy(buffer, static_cast<const void *>(&len), sizeof(len));
+        symbols.insert(symbols.end(), buffer, buffer + sizeof(len));
+        symbols.insert(symbols.end(), sym.begin(), sym.end());
+    }
+    // Assemble the header.
+    flat_header h;
+    std::memcpy(h.m_magic, flat_magic(), sizeof(h.m_magic));
+    h.m_arch_tag = flat_arch_tag();
+    h.m_version = flat_version();
+    h.m_cf_tag = flat_type_tag<cf_type>();
+    h.m_key_tag = flat_key_tag<key_type>();
+    h.m_n_symbols = safe_cast<std::uint64_t>(s.get_symbol_set().size());
+    h.m_symbols_size = safe_cast<std::uint64_t>(symbols.size());
+    h.m_n_terms = safe_cast<std::uint64_t>(s.size());
+    const auto layout = flat_compute_layout<packed_type, cf_type>(h.m_symbols_size, h.m_n_terms);
+    // Write everything.
+    flat_file_writer w(filename);
+    w.write(&h, sizeof(flat_header));
+    w.write(symbols.data(), symbols.size());
+    w.pad(layout.m_keys_offset);
+    w.write_array<packed_type>(s, [](const term_type &t) { return flat_key<key_type>::pack(t.m_key); });
+    w.pad(layout.m_cfs_offset);
+    w.write_array<cf_type>(s, [](const term_type &t) { return t.m_cf; });
+    piranha_assert(w.offset() == layout.m_size);
+}
+
+// The content of a flat file: the symbol set, the number of terms and the pointers to the arrays of keys
+// and coefficients within the view of the file.
+struct flat_content {
+    symbol_fset m_symbol_set;
+    std::size_t m_size;
+    const char *m_keys;
+    const char *m_cfs;
+};
+
+[[noreturn]] inline void flat_invalid_file(const std::string &filename, const std::string &reason)
+{
+    piranha_throw(std::invalid_argument, "the file '" + filename + "' is not a valid flat file: " + reason);
+}
+
+// Parse the view of a flat file which is expected to contain a series with key type Key and coefficient type Cf.
+template <typename Key, typename Cf>
+inline flat_content flat_parse(const flat_file_view &view, const std::string &filename)
+{
+    using packed_type = flat_key_packed_t<Key>;
+    const char *data = view.data();
+    const auto fsize = view.size();
+    if (unlikely(fsize < sizeof(flat_header))) {
+        flat_invalid_file(filename, "the file is too small");
+    }
+    flat_header h;
+    std::memcpy(static_cast<void *>(&h), data, sizeof(flat_header));
+    if (unlikely(std::memcmp(h.m_magic, flat_magic(), sizeof(h.m_magic)))) {
+        flat_invalid_file(filename, "the header is not valid");
+    }
+    // NOTE: check the architecture before anything else, as the other fields of the header
+    // are meaningless if the byte order is different.
+    if (unlikely(h.m_arch_tag != flat_arch_tag())) {
+        flat_invalid_file(filename, "the file was created on a platform with a different byte order or with "
+                                    "different widths of the integral types");
+    }
+    if (unlikely(h.m_version != flat_version())) {
+        flat_invalid_file(filename, "the file was created with an incompatible version of the flat format");
+    }
+    if (unlikely(h.m_cf_tag != flat_type_tag<Cf>() || h.m_key_tag != flat_key_tag<Key>())) {
+        flat_invalid_file(filename, "the file was created from a series with different coefficient or key types");
+    }
+    if (unlikely(h.m_symbols_size > fsize - sizeof(flat_header))) {
+        flat_invalid_file(filename, "the size of the symbol set is not consistent with the size of the file");
+    }
+    flat_layout layout{};
+    try {
+        layout = flat_compute_layout<packed_type, Cf>(h.m_symbols_size, h.m_n_terms);
+    } catch (const std::overflow_error &) {
+        // NOTE: a number of terms this large cannot be consistent with the size of any file.
+        flat_invalid_file(filename, "the number of terms is not consistent with the size of the file");
+    }
+    if (unlikely(layout.m_size != fsize)) {
+        flat_invalid_file(filename, "the number of terms is not consistent with the size of the file");
+    }
+    // Recover the symbol set.
+    std::vector<std::string> vs;
+    const char *ptr = data + sizeof(flat_header);
+    auto remaining = h.m_symbols_size;
+    for (std::uint64_t i = 0; i < h.m_n_symbols; ++i) {
+        std::uint64_t len;
+        if (unlikely(remaining < sizeof(len))) {
+            flat_invalid_file(filename, "the symbol set is not valid");
+        }
+        std::memcpy(static_cast<void *>(&len), ptr, sizeof(len));
+        ptr += sizeof(len);
+        remaining -= sizeof(len);
+        if (unlikely(len > remaining)) {
+            flat_invalid_file(filename, "the symbol set is not valid");
+        }
+        vs.emplace_back(ptr, static_cast<std::size_t>(len));
+        ptr += len;
+        remaining -= len;
+    }
+    symbol_fset ss(vs.begin(), vs.end());
+    if (unlikely(remaining || ss.size() != vs.size())) {
+        flat_invalid_file(filename, "the symbol set is not valid");
+    }
+    // NOTE: all the offsets are within the file, hence they fit in size_t.
+    return flat_content{std::move(ss), static_cast<std::size_t>(h.m_n_terms),
+                        data + static_cast<std::size_t>(layout.m_keys_offset),
+                        data + static_cast<std::size_t>(layout.m_cfs_offset)};
+}
+
+// Decode the i-th term of the content of a flat file.
+template <typename Term>
+inline Term flat_term_at(const flat_content &c, std::size_t i)
+{
+    using cf_type = typename Term::cf_type;
+    using key_type = typename Term::key_type;
+    using packed_type = flat_key_packed_t<key_type>;
+    piranha_assert(i < c.m_size);
+    // NOTE: go through memcpy() in order to avoid aliasing and alignment issues.
+    packed_type p;
+    std::memcpy(static_cast<void *>(&p), c.m_keys + i * sizeof(packed_type), sizeof(packed_type));
+    cf_type cf;
+    std::memcpy(static_cast<void *>(&cf), c.m_cfs + i * sizeof(cf_type), sizeof(cf_type));
+    return Term(cf, flat_key<key_type>::unpack(p));
+}
+
+// Build a series from the content of a flat file.
+template <typename Series>
+inline Series flat_thaw(const flat_content &c)
+{
+    Series retval;
+    retval.set_symbol_set(c.m_symbol_set);
+    if (!c.m_size) {
+        return retval;
+    }
+    auto &container = retval._container();
+    container.rehash(boost::numeric_cast<typename Series::size_type>(
+        std::ceil(static_cast<double>(c.m_size) / container.max_load_factor())));
+    // NOTE: the file could have been corrupted or tampered with after having been written from a series,
+    // hence the terms are validated before being inserted (as in the loading of chunked files).
+    const auto &ss = retval.get_symbol_set();
+    typename Series::size_type count = 0u;
+    try {
+        for (std::size_t i = 0; i < c.m_size; ++i) {
+            auto t = flat_term_at<typename Series::term_type>(c, i);
+            if (unlikely(!t.is_compatible(ss))) {
+                piranha_throw(std::invalid_argument, "cannot load an incompatible term from a flat file");
+            }
+            if (unlikely(t.is_zero(ss))) {
+                continue;
+            }
+            const auto b = container._bucket(t);
+            if (unlikely(container._find(t, b) != container.end())) {
+                piranha_throw(std::invalid_argument, "cannot load a duplicate term from a flat file");
+            }
+            container._unique_insert(std::move(t), b);
+            ++count;
+        }
+        container._update_size(count);
+    } catch (...) {
+        container.clear();
+        throw;
+    }
+    return retval;
+}
+}
+}
+
+#endif
@@ -0,0 +1,121 @@
+/* Copyright 2009-2017 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#ifndef PIRANHA_DETAIL_KMV_SKETCH_HPP
+#define PIRANHA_DETAIL_KMV_SKETCH_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <piranha/config.hpp>
+
+namespace piranha
+{
+
+namespace detail
+{
+
+// Mixing of 64-bit hash values. This is the finaliser of the 64-bit MurmurHash3, which maps
+// structured inputs (e.g., consecutive integers) to well-distributed outputs.
+inline std::uint64_t hash_mix64(std::uint64_t x)
+{
+    x ^= x >> 33u;
+    x *= 0xff51afd7ed558ccdull;
+    x ^= x >> 33u;
+    x *= 0xc4ceb9fe1a85ec53ull;
+    x ^= x >> 33u;
+    return x;
+}
+
+// A K-minimum values sketch for the estimation of the number of distinct elements in a multiset.
+// The sketch keeps the k smallest distinct hash values of the elements added to it: if the hash values
+// are uniformly distributed, the number of distinct elements is estimated as (k - 1) / x, where x is the
+// k-th smallest hash value normalised to the [0, 1) range. The relative standard error of the estimate is
+// about 1 / sqrt(k - 2).
+// NOTE: hash values are buffered and compacted periodically, so that adding a value which does not
+// belong to the sketch costs just one comparison.
+class kmv_sketch
+{
+public:
+    explicit kmv_sketch(std::size_t k) : m_k(k), m_thr(std::numeric_limits<std::uint64_t>::max())
+    {
+        piranha_assert(k > 1u);
+        m_buffer.reserve(m_k * 4u);
+    }
+    void add(std::uint64_t h)
+    {
+        if (h < m_thr) {
+            m_buffer.push_back(h);
+            if (m_buffer.size() >= m_k * 4u) {
+                compact();
+            }
+        }
+    }
+    void merge(const kmv_sketch &other)
+    {
+        for (const auto &h : other.m_buffer) {
+            add(h);
+        }
+    }
+    double estimate()
+    {
+        compact();
+        if (m_buffer.size() < m_k) {
+            // Less than k distinct values: the count is exact.
+            return static_cast<double>(m_buffer.size());
+        }
+        // NOTE: 2**64 as a double.
+        const double norm = 18446744073709551616.;
+        return static_cast<double>(m_k - 1u) / (static_cast<double>(m_thr) / norm);
+    }
+
+private:
+    void compact()
+    {
+        std::sort(m_buffer.begin(), m_buffer.end());
+        m_buffer.erase(std::unique(m_buffer.begin(), m_buffer.end()), m_buffer.end());
+        if (m_buffer.size() > m_k) {
+            m_buffer.resize(m_k);
+        }
+        if (m_buffer.size() == m_k) {
+            m_thr = m_buffer.back();
+        }
+    }
+
+private:
+    std::size_t m_k;
+    std::uint64_t m_thr;
+    std::vector<std::uint64_t> m_buffer;
+};
+}
+}
+
+#endif
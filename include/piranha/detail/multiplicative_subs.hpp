@@ -0,0 +1,51 @@
+/* Copyright 2009-2017 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#ifndef PIRANHA_DETAIL_MULTIPLICATIVE_SUBS_HPP
+#define PIRANHA_DETAIL_MULTIPLICATIVE_SUBS_HPP
+
+#include <type_traits>
+
+namespace piranha
+{
+
+inline namespace impl
+{
+
+// Detect keys with multiplicative substitution. For these key types, the subs() and ipow_subs() methods return
+// a vector containing a single pair, whose first element depends only on the exponents of the substituted
+// symbols, and whose second element (the key after the substitution) does not depend on the values being
+// substituted. Series can thus group the terms whose keys have the same exponents for the substituted symbols,
+// and compute the value of the substitution once per group. Key types opt in by specialising this class.
+template <typename Key>
+struct key_has_multiplicative_subs : std::false_type {
+};
+}
+}
+
+#endif
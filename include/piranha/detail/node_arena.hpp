@@ -0,0 +1,153 @@
+/* Copyright 2009-2017 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#ifndef PIRANHA_DETAIL_NODE_ARENA_HPP
+#define PIRANHA_DETAIL_NODE_ARENA_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <piranha/detail/atomic_lock_guard.hpp>
+
+namespace piranha
+{
+
+namespace detail
+{
+
+// Arena for the allocation of objects of type T, such as the nodes of the bucket lists of hash_set.
+// Memory is carved out of slabs of increasing size, and it is returned to the system only when the arena
+// is destroyed. Deallocated objects are recycled via free lists. In order to avoid contention when multiple
+// threads allocate at the same time (e.g., in a parallel multiplication), the arena is subdivided into lanes,
+// each with its own slab and free list: each thread always operates on the same lane, selected via
+// a thread-local index.
+// NOTE: the arena provides only raw storage, it is up to the user to construct and destroy the objects.
+template <typename T>
+class node_arena
+{
+    // A slot either stores an object or, if free, the link to the next free slot.
+    union slot {
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type m_storage;
+        slot *m_next;
+    };
+    struct lane {
+        lane() : m_cur(nullptr), m_end(nullptr), m_free(nullptr)
+        {
+            m_flag.clear();
+        }
+        std::atomic_flag m_flag;
+        // Range of the current slab still available for allocation.
+        slot *m_cur;
+        slot *m_end;
+        // Head of the free list.
+        slot *m_free;
+    };
+    // NOTE: these are tuning parameters. The slabs start small, so that arenas associated to small
+    // containers do not waste memory, and their size doubles up to a maximum.
+    static const unsigned n_lanes = 16u;
+    static const std::size_t min_slab_size = 64u;
+    static const std::size_t max_slab_size = 65536u;
+    static unsigned lane_idx()
+    {
+        static std::atomic<unsigned> counter(0u);
+        static thread_local const unsigned idx = counter++ % n_lanes;
+        return idx;
+    }
+    // Create a new slab, and return the range of slots it contains.
+    std::pair<slot *, slot *> new_slab()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const auto size = m_slab_size;
+        std::unique_ptr<slot[]> s(new slot[size]);
+        m_slabs.push_back(std::move(s));
+        if (m_slab_size < max_slab_size) {
+            m_slab_size *= 2u;
+        }
+        const auto ptr = m_slabs.back().get();
+        return std::make_pair(ptr, ptr + size);
+    }
+
+public:
+    node_arena() : m_slab_size(min_slab_size) {}
+    node_arena(const node_arena &) = delete;
+    node_arena(node_arena &&) = delete;
+    node_arena &operator=(const node_arena &) = delete;
+    node_arena &operator=(node_arena &&) = delete;
+    // Get storage for an object of type T. Thread-safe.
+    void *allocate()
+    {
+        auto &l = m_lanes[lane_idx()];
+        atomic_lock_guard lock(l.m_flag);
+        if (l.m_free) {
+            const auto retval = l.m_free;
+            l.m_free = retval->m_next;
+            return retval;
+        }
+        if (l.m_cur == l.m_end) {
+            const auto r = new_slab();
+            l.m_cur = r.first;
+            l.m_end = r.second;
+        }
+        return l.m_cur++;
+    }
+    // Return to the arena the storage of an object previously obtained via allocate(). The object
+    // must have been destroyed already. Thread-safe.
+    void deallocate(void *p)
+    {
+        const auto s = static_cast<slot *>(p);
+        auto &l = m_lanes[lane_idx()];
+        atomic_lock_guard lock(l.m_flag);
+        s->m_next = l.m_free;
+        l.m_free = s;
+    }
+
+private:
+    std::array<lane, n_lanes> m_lanes;
+    std::mutex m_mutex;
+    std::size_t m_slab_size;
+    std::vector<std::unique_ptr<slot[]>> m_slabs;
+};
+
+template <typename T>
+const unsigned node_arena<T>::n_lanes;
+
+template <typename T>
+const std::size_t node_arena<T>::min_slab_size;
+
+template <typename T>
+const std::size_t node_arena<T>::max_slab_size;
+}
+}
+
+#endif
@@ -0,0 +1,278 @@
+/* Copyright 2009-2017 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#ifndef PIRANHA_DETAIL_POW_CACHE_HPP
+#define PIRANHA_DETAIL_POW_CACHE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <piranha/config.hpp>
+
+namespace piranha
+{
+
+/// Statistics of the cache of natural powers of series.
+/**
+ * @see piranha::series::get_pow_cache_stats().
+ */
+struct pow_cache_stats {
+    /// Number of exponentiations whose result was already in the cache (or being computed by another thread).
+    unsigned long long hits;
+    /// Number of exponentiations which required the computation of at least one new power.
+    unsigned long long misses;
+    /// Number of series whose powers were evicted from the cache because of the memory limit.
+    unsigned long long evictions;
+    /// Number of series whose powers are currently stored in the cache.
+    std::size_t entries;
+    /// Estimate of the memory currently used by the cached powers, in bytes.
+    std::size_t memory;
+};
+
+namespace detail
+{
+
+// Concurrent cache of the natural powers of objects of type Key. The powers are of type Value, and
+// the power of index i + 1 is computed as (power of index i) * base. Powers computed elsewhere (e.g., via
+// specialised algorithms which do not need the previous powers) can also be stored in the cache via insert(),
+// and looked up via find().
+//
+// For each base the cache stores a vector of shared futures, the i-th future representing the i-th power
+// of the base. The global mutex protects only the map from the bases to their entries, the LRU list
+// and the memory accounting, and it is never held while computing: the thread which needs a power
+// that is not in the cache yet appends a future to the vector of the entry, releases the entry's mutex
+// and computes the power, while threads requesting the same power wait on the future. Threads working
+// on different bases never wait for each other.
+//
+// The memory used by the powers is estimated via a user-supplied functor. After each new power has been
+// computed, the least recently used entries are evicted until the estimated memory is below the limit.
+// Evicted entries which are still being used by other threads stay alive until the last user is done.
+template <typename Key, typename Value, typename Hash, typename Equal>
+class pow_cache
+{
+    struct entry {
+        // Protects m_powers.
+        std::mutex m_mutex;
+        std::vector<std::shared_future<Value>> m_powers;
+        // Powers which were not computed from the previous one, indexed by exponent.
+        std::unordered_map<std::size_t, std::shared_future<Value>> m_direct;
+        // These are protected by the global mutex.
+        std::size_t m_memory = 0u;
+        bool m_evicted = false;
+        typename std::list<const Key *>::iterator m_lru_it;
+    };
+    using entry_ptr = std::shared_ptr<entry>;
+
+public:
+    pow_cache() : m_memory(0u), m_hits(0u), m_misses(0u), m_evictions(0u) {}
+    pow_cache(const pow_cache &) = delete;
+    pow_cache &operator=(const pow_cache &) = delete;
+    // Get the n-th power of x. one is a nullary functor returning the zeroth power, mem_f returns the
+    // estimated memory usage (in bytes) of a power, and max_memory is the memory limit.
+    template <typename One, typename MemF>
+    Value get(const Key &x, std::size_t n, const One &one, const MemF &mem_f, std::size_t max_memory)
+    {
+        const auto e = fetch_entry(x);
+        bool miss = false;
+        while (true) {
+            std::promise<Value> prom;
+            std::shared_future<Value> prev, found;
+            std::size_t k = 0u;
+            {
+                std::lock_guard<std::mutex> lock(e->m_mutex);
+                if (e->m_powers.empty()) {
+                    std::promise<Value> p0;
+                    p0.set_value(one());
+                    e->m_powers.push_back(p0.get_future().share());
+                }
+                const auto d_it = e->m_direct.find(n);
+                if (n < e->m_powers.size()) {
+                    found = e->m_powers[n];
+                } else if (d_it != e->m_direct.end()) {
+                    found = d_it->second;
+                } else {
+                    // Reserve the next power: we will compute it from the previous one.
+                    k = e->m_powers.size();
+                    prev = e->m_powers.back();
+                    e->m_powers.push_back(prom.get_future().share());
+                }
+            }
+            if (found.valid()) {
+                // NOTE: wait outside the lock, as the power might still be being computed by another thread.
+                ++(miss ? m_misses : m_hits);
+                return found.get();
+            }
+            miss = true;
+            std::size_t mem;
+            try {
+                Value v = prev.get() * x;
+                mem = mem_f(v);
+                prom.set_value(std::move(v));
+            } catch (...) {
+                // Remove the failed power (and any power depending on it) from the cache, so that
+                // it will be recomputed by the next caller, and propagate the error to the waiters.
+                {
+                    std::lock_guard<std::mutex> lock(e->m_mutex);
+                    if (e->m_powers.size() > k) {
+                        e->m_powers.erase(e->m_powers.begin() + static_cast<std::ptrdiff_t>(k), e->m_powers.end());
+                    }
+                }
+                prom.set_exception(std::current_exception());
+                throw;
+            }
+            account(e, mem, max_memory);
+        }
+    }
+    // Look up the n-th power of x, without computing it. If the power is in the cache, it is assigned to out
+    // and true is returned.
+    bool find(const Key &x, std::size_t n, Value &out)
+    {
+        entry_ptr e;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            const auto it = m_map.find(x);
+            if (it == m_map.end()) {
+                return false;
+            }
+            m_lru.splice(m_lru.begin(), m_lru, it->second->m_lru_it);
+            e = it->second;
+        }
+        std::shared_future<Value> found;
+        {
+            std::lock_guard<std::mutex> lock(e->m_mutex);
+            const auto d_it = e->m_direct.find(n);
+            if (n < e->m_powers.size()) {
+                found = e->m_powers[n];
+            } else if (d_it != e->m_direct.end()) {
+                found = d_it->second;
+            } else {
+                return false;
+            }
+        }
+        out = found.get();
+        ++m_hits;
+        return true;
+    }
+    // Store v as the n-th power of x. If the power is already in the cache (e.g., because it was computed
+    // concurrently by another thread), the cache is not modified.
+    template <typename MemF>
+    void insert(const Key &x, std::size_t n, const Value &v, const MemF &mem_f, std::size_t max_memory)
+    {
+        const auto mem = mem_f(v);
+        const auto e = fetch_entry(x);
+        {
+            std::lock_guard<std::mutex> lock(e->m_mutex);
+            if (n < e->m_powers.size() || e->m_direct.count(n)) {
+                return;
+            }
+            std::promise<Value> prom;
+            prom.set_value(v);
+            e->m_direct.emplace(n, prom.get_future().share());
+        }
+        ++m_misses;
+        account(e, mem, max_memory);
+    }
+    // Remove all the entries from the cache and reset the statistics.
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto &p : m_map) {
+            p.second->m_evicted = true;
+        }
+        m_lru.clear();
+        m_map.clear();
+        m_memory = 0u;
+        m_hits.store(0u);
+        m_misses.store(0u);
+        m_evictions.store(0u);
+    }
+    pow_cache_stats stats()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return pow_cache_stats{m_hits.load(), m_misses.load(), m_evictions.load(),
+                               static_cast<std::size_t>(m_map.size()), m_memory};
+    }
+
+private:
+    // Locate (or create) the entry of x, and mark it as the most recently used.
+    entry_ptr fetch_entry(const Key &x)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_map.find(x);
+        if (it == m_map.end()) {
+            it = m_map.emplace(x, std::make_shared<entry>()).first;
+            // NOTE: the references to the elements of an unordered_map are stable.
+            m_lru.push_front(&it->first);
+            it->second->m_lru_it = m_lru.begin();
+        } else {
+            m_lru.splice(m_lru.begin(), m_lru, it->second->m_lru_it);
+        }
+        return it->second;
+    }
+    // Account for a new power of size mem stored in e, and evict the least recently used
+    // entries if the memory limit is exceeded.
+    void account(const entry_ptr &e, std::size_t mem, std::size_t max_memory)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!e->m_evicted) {
+            e->m_memory += mem;
+            m_memory += mem;
+        }
+        while (m_memory > max_memory && !m_lru.empty()) {
+            const auto it = m_map.find(*m_lru.back());
+            piranha_assert(it != m_map.end());
+            it->second->m_evicted = true;
+            piranha_assert(m_memory >= it->second->m_memory);
+            m_memory -= it->second->m_memory;
+            m_lru.pop_back();
+            m_map.erase(it);
+            ++m_evictions;
+        }
+    }
+
+private:
+    std::mutex m_mutex;
+    std::unordered_map<Key, entry_ptr, Hash, Equal> m_map;
+    std::list<const Key *> m_lru;
+    std::size_t m_memory;
+    std::atomic<unsigned long long> m_hits;
+    std::atomic<unsigned long long> m_misses;
+    std::atomic<unsigned long long> m_evictions;
+};
+}
+}
+
+#endif
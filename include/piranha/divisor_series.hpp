@@ -57,6 +57,7 @@ see https://www.gnu.org/licenses/. */
 #include <piranha/math.hpp>
 #include <piranha/math/gcd3.hpp>
 #include <piranha/math/is_zero.hpp>
+#include <piranha/packed_divisor.hpp>
 #include <piranha/power_series.hpp>
 #include <piranha/safe_cast.hpp>
 #include <piranha/series.hpp>
@@ -85,6 +86,20 @@ struct is_divisor_series_key<divisor<T>> {
     static const bool value = true;
 };
 
+template <typename T>
+struct is_divisor_series_key<packed_divisor<T>> {
+    static const bool value = true;
+};
+
+// Detect packed divisor keys.
+template <typename T>
+struct is_packed_divisor_key : std::false_type {
+};
+
+template <typename T>
+struct is_packed_divisor_key<packed_divisor<T>> : std::true_type {
+};
+
 // See the workaround description below.
 template <typename T>
 struct base_getter {
@@ -97,10 +112,13 @@ struct base_getter {
  * This class represents series in which the keys are divisor (see piranha::divisor) and the coefficient type
  * is generic. This class satisfies the piranha::is_series and piranha::is_cf type traits.
  *
+ * piranha::packed_divisor can be used as an alternative key type. It represents the same divisors with a compact,
+ * allocation-free layout, which is preferable for series with a large number of terms.
+ *
  * ## Type requirements ##
  *
  * \p Cf must be suitable for use in piranha::series as first template argument, \p Key must be an instance
- * of piranha::divisor.
+ * of piranha::divisor or piranha::packed_divisor.
  *
  * ## Exception safety guarantee ##
  *
@@ -161,6 +179,47 @@ class divisor_series
     {
         return -(n * m);
     }
+    // Type of the multipliers in the derivative of a divisor.
+    using d_mult_type = decltype(safe_mult(std::declval<const dv_type &>(), std::declval<const dv_type &>()));
+    // Call f(m, k) for each term m*k of the partial derivative of key with respect to the symbol at position p.
+    // Each factor depending on the symbol contributes a copy of key with the exponent e of the factor increased by
+    // one, times -e*a, where a is the multiplier of the symbol in the factor.
+    template <typename T, typename F>
+    void key_partial(const divisor<T> &key, const symbol_idx &p, const F &f) const
+    {
+        const auto it_f = key.m_container.end();
+        for (auto it = key.m_container.begin(); it != it_f; ++it) {
+            using size_type = decltype(it->v.size());
+            piranha_assert(p < it->v.size());
+            const auto &a = it->v[static_cast<size_type>(p)];
+            if (piranha::is_zero(a)) {
+                continue;
+            }
+            divisor<T> new_key(key);
+            const auto new_it = new_key.m_container.find(*it);
+            piranha_assert(new_it != new_key.m_container.end());
+            expo_increase(new_it->e);
+            f(safe_mult(it->e, a), std::move(new_key));
+        }
+    }
+    template <typename T, typename F>
+    void key_partial(const packed_divisor<T> &key, const symbol_idx &p, const F &f) const
+    {
+        using size_type = typename packed_divisor<T>::size_type;
+        for (size_type i = 0u; i < key.size(); ++i) {
+            const auto &factor = key.m_container[i];
+            const auto v = packed_divisor<T>::unpack_factor(factor, this->m_symbol_set);
+            piranha_assert(p < v.size());
+            const auto &a = v[static_cast<decltype(v.size())>(p)];
+            if (a == 0) {
+                continue;
+            }
+            packed_divisor<T> new_key(key);
+            // NOTE: the code of the factor does not change, so the ordering is preserved.
+            expo_increase(new_key.m_container[i].e);
+            f(safe_mult(factor.e, a), std::move(new_key));
+        }
+    }
     // This is the first stage - the second part of the chain rule for each term.
     template <typename T>
     using d_partial_type_0
@@ -173,7 +232,8 @@ class divisor_series
         conjunction<std::is_constructible<d_partial_type_1<T>, d_partial_type_0<T>>,
                     std::is_constructible<d_partial_type_1<T>, int>, is_addable_in_place<d_partial_type_1<T>>>::value,
         d_partial_type_1<T>>;
-    template <typename T = divisor_series>
+    template <typename T = divisor_series,
+              enable_if_t<!detail::is_packed_divisor_key<typename T::term_type::key_type>::value, int> = 0>
     d_partial_type<T> d_partial_impl(typename T::term_type::key_type &key, const symbol_idx &p) const
     {
         using term_type = typename base::term_type;
@@ -220,6 +280,41 @@ class divisor_series
         }
         return retval;
     }
+    // Same as above, for packed keys. The factors are sorted by code, and bumping the exponent
+    // of the first factor does not alter the ordering, so we can work on the key in place.
+    template <typename T = divisor_series,
+              enable_if_t<detail::is_packed_divisor_key<typename T::term_type::key_type>::value, int> = 0>
+    d_partial_type<T> d_partial_impl(typename T::term_type::key_type &key, const symbol_idx &p) const
+    {
+        using term_type = typename base::term_type;
+        using cf_type = typename term_type::cf_type;
+        using key_type = typename term_type::key_type;
+        piranha_assert(key.size() != 0u);
+        const auto first = key.m_container[0u];
+        const auto v = key_type::unpack_factor(first, this->m_symbol_set);
+        // Extract from the first dependent term the aij and the exponent, and multiply+negate them.
+        const auto mult = safe_mult(first.e, v[static_cast<decltype(v.size())>(p)]);
+        // Build the first part of the derivative, with the exponent of the first term increased by one.
+        key_type tmp_div(key);
+        expo_increase(tmp_div.m_container[0u].e);
+        divisor_series tmp_ds;
+        tmp_ds.set_symbol_set(this->m_symbol_set);
+        tmp_ds.insert(term_type(cf_type(1), std::move(tmp_div)));
+        d_partial_type<T> retval(mult * tmp_ds);
+        // Now the second part of the derivative, if appropriate.
+        if (key.size() > 1u) {
+            // Build a series with only the first dependent term and unitary coefficient.
+            key_type tmp_div_01;
+            tmp_div_01.m_container.push_back(first);
+            divisor_series tmp_ds_01;
+            tmp_ds_01.set_symbol_set(this->m_symbol_set);
+            tmp_ds_01.insert(term_type(cf_type(1), std::move(tmp_div_01)));
+            // Remove the first term from the original key and recurse.
+            key.m_container.erase(key.m_container.begin());
+            retval += tmp_ds_01 * d_partial_impl(key, p);
+        }
+        return retval;
+    }
     template <typename T = divisor_series>
     d_partial_type<T> divisor_partial(const typename T::term_type &term, const symbol_idx &p) const
     {
@@ -252,7 +347,93 @@ class divisor_series
     using partial_type = enable_if_t<
         conjunction<std::is_constructible<partial_type_<T>, int>, is_addable_in_place<partial_type_<T>>>::value,
         partial_type_<T>>;
+    // Enabler for the bulk implementation of partial(): the derivative must be a divisor_series with the same
+    // coefficient type.
+    template <typename T, typename = void>
+    struct has_bulk_partial {
+        static constexpr bool value = false;
+    };
+    template <typename T>
+    struct has_bulk_partial<
+        T, enable_if_t<conjunction<
+               std::is_same<partial_type<T>, T>,
+               std::is_same<decltype(math::partial(std::declval<const typename T::term_type::cf_type &>(),
+                                                   std::declval<const std::string &>())),
+                            typename T::term_type::cf_type>,
+               std::is_constructible<typename T::term_type::cf_type,
+                                     decltype(std::declval<const typename T::term_type::cf_type &>()
+                                              * std::declval<const d_mult_type &>())>>::value>> {
+        static constexpr bool value = true;
+    };
+    // Bulk implementation: the derivatives of the coefficients and of the keys of all terms are computed
+    // (in parallel, for large series) and inserted directly into the return value.
+    template <typename T = divisor_series, enable_if_t<has_bulk_partial<T>::value, int> = 0>
+    partial_type<T> partial_impl(const std::string &name) const
+    {
+        using term_type = typename base::term_type;
+        using cf_type = typename term_type::cf_type;
+        using key_type = typename term_type::key_type;
+        const auto idx = ss_index_of(this->m_symbol_set, name);
+        const bool in_ss = idx < this->m_symbol_set.size();
+        return this->termwise_transform([this, &name, idx, in_ss](const term_type &t, std::vector<term_type> &out) {
+            // NOTE: the keys in this are unique, so these terms never need to be accumulated with each other.
+            out.emplace_back(math::partial(t.m_cf, name), t.m_key);
+            if (in_ss) {
+                this->key_partial(t.m_key, idx, [&t, &out](const d_mult_type &m, key_type &&k) {
+#if defined(PIRANHA_COMPILER_IS_GCC)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wconversion"
+#endif
+                    out.emplace_back(cf_type(t.m_cf * m), std::move(k));
+#if defined(PIRANHA_COMPILER_IS_GCC)
+#pragma GCC diagnostic pop
+#endif
+                });
+            }
+        });
+    }
+    // General implementation, via series arithmetics.
+    template <typename T = divisor_series, enable_if_t<!has_bulk_partial<T>::value, int> = 0>
+    partial_type<T> partial_impl(const std::string &name) const
+    {
+        using term_type = typename base::term_type;
+        using cf_type = typename term_type::cf_type;
+        const auto idx = ss_index_of(this->m_symbol_set, name);
+        return this->template termwise_accumulate<partial_type<T>>(
+            [this, &name, idx](const term_type &t) -> partial_type<T> {
+                divisor_series tmp;
+                tmp.set_symbol_set(this->m_symbol_set);
+                tmp.insert(term_type(cf_type(1), t.m_key));
+                return math::partial(t.m_cf, name) * tmp + this->divisor_partial(t, idx);
+            });
+    }
     // Integrate utils.
+    // Check if a key depends on the symbol at position p.
+    template <typename T>
+    bool key_depends_on(const divisor<T> &key, const symbol_idx &p) const
+    {
+        const auto it_f = key.m_container.end();
+        for (auto it = key.m_container.begin(); it != it_f; ++it) {
+            using size_type = decltype(it->v.size());
+            piranha_assert(p < it->v.size());
+            if (it->v[static_cast<size_type>(p)] != 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+    template <typename T>
+    bool key_depends_on(const packed_divisor<T> &key, const symbol_idx &p) const
+    {
+        for (const auto &f : key.m_container) {
+            const auto v = packed_divisor<T>::unpack_factor(f, this->m_symbol_set);
+            piranha_assert(p < v.size());
+            if (v[static_cast<decltype(v.size())>(p)] != 0) {
+                return true;
+            }
+        }
+        return false;
+    }
     template <typename T>
     using integrate_type_ = decltype(
         math::integrate(std::declval<const typename T::term_type::cf_type &>(), std::declval<const std::string &>())
@@ -261,6 +442,61 @@ class divisor_series
     using integrate_type = enable_if_t<
         conjunction<std::is_constructible<integrate_type_<T>, int>, is_addable_in_place<integrate_type_<T>>>::value,
         integrate_type_<T>>;
+    // Enabler for the bulk implementation of integrate(): the antiderivative must be a divisor_series with the same
+    // coefficient type.
+    template <typename T, typename = void>
+    struct has_bulk_integrate {
+        static constexpr bool value = false;
+    };
+    template <typename T>
+    struct has_bulk_integrate<
+        T, enable_if_t<conjunction<
+               std::is_same<integrate_type<T>, T>,
+               std::is_same<decltype(math::integrate(std::declval<const typename T::term_type::cf_type &>(),
+                                                     std::declval<const std::string &>())),
+                            typename T::term_type::cf_type>>::value>> {
+        static constexpr bool value = true;
+    };
+    // Throw if the key depends on the integration variable.
+    template <typename K>
+    void integrate_check(const K &key, const symbol_idx &idx) const
+    {
+        // If the variable is in the symbol set, then we need to make sure
+        // that each multiplier associated to it is zero. Otherwise, the divisor
+        // depends on the variable and we cannot perform the integration.
+        if (idx < this->m_symbol_set.size() && unlikely(key_depends_on(key, idx))) {
+            piranha_throw(std::invalid_argument, "unable to integrate with respect to divisor variables");
+        }
+    }
+    // Bulk implementation: the integrals of the coefficients are computed (in parallel, for large series) and
+    // inserted directly into the return value.
+    template <typename T = divisor_series, enable_if_t<has_bulk_integrate<T>::value, int> = 0>
+    integrate_type<T> integrate_impl(const std::string &name) const
+    {
+        using term_type = typename base::term_type;
+        const auto idx = ss_index_of(this->m_symbol_set, name);
+        return this->termwise_transform([this, &name, idx](const term_type &t, std::vector<term_type> &out) {
+            this->integrate_check(t.m_key, idx);
+            // NOTE: the keys are not modified, so these terms never need to be accumulated with each other.
+            out.emplace_back(math::integrate(t.m_cf, name), t.m_key);
+        });
+    }
+    // General implementation, via series arithmetics.
+    template <typename T = divisor_series, enable_if_t<!has_bulk_integrate<T>::value, int> = 0>
+    integrate_type<T> integrate_impl(const std::string &name) const
+    {
+        using term_type = typename base::term_type;
+        using cf_type = typename term_type::cf_type;
+        const auto idx = ss_index_of(this->m_symbol_set, name);
+        return this->template termwise_accumulate<integrate_type<T>>(
+            [this, &name, idx](const term_type &t) -> integrate_type<T> {
+                this->integrate_check(t.m_key, idx);
+                divisor_series tmp;
+                tmp.set_symbol_set(this->m_symbol_set);
+                tmp.insert(term_type(cf_type(1), t.m_key));
+                return math::integrate(t.m_cf, name) * tmp;
+            });
+    }
     // Invert utils.
     // Type coming out of invert() for the base type. This will also be the final type.
     template <typename T>
@@ -475,6 +711,10 @@ public:
      * The derivative is computed via differentiation of the coefficients and the application of the product
      * rule.
      *
+     * If the derivative has the same type as \p this, the derivatives of the coefficients and of the divisors of all
+     * terms are computed in bulk and inserted directly into the return value, without intermediate series
+     * arithmetics. Large series are processed in parallel (see piranha::settings::set_n_threads()).
+     *
      * @param name name of the variable with respect to which the differentiation will be computed.
      *
      * @return the partial derivative of \p this with respect to \p name.
@@ -494,18 +734,7 @@ public:
     template <typename T = divisor_series>
     partial_type<T> partial(const std::string &name) const
     {
-        using term_type = typename base::term_type;
-        using cf_type = typename term_type::cf_type;
-        partial_type<T> retval(0);
-        const auto it_f = this->m_container.end();
-        const auto idx = ss_index_of(this->m_symbol_set, name);
-        for (auto it = this->m_container.begin(); it != it_f; ++it) {
-            divisor_series tmp;
-            tmp.set_symbol_set(this->m_symbol_set);
-            tmp.insert(term_type(cf_type(1), it->m_key));
-            retval += math::partial(it->m_cf, name) * tmp + divisor_partial(*it, idx);
-        }
-        return retval;
+        return partial_impl<T>(name);
     }
     /// Integration.
     /**
@@ -516,6 +745,10 @@ public:
      * Integration for divisor series is supported only if the coefficient is integrable and no divisor in the calling
      * series depends on the integration variable.
      *
+     * If the antiderivative has the same type as \p this, the coefficients of all terms are integrated in bulk and
+     * inserted directly into the return value. Large series are processed in parallel
+     * (see piranha::settings::set_n_threads()).
+     *
      * @param name name of the variable with respect to which the integration will be performed.
      *
      * @return the antiderivative of \p this with respect to \p name.
@@ -530,32 +763,7 @@ public:
     template <typename T = divisor_series>
     integrate_type<T> integrate(const std::string &name) const
     {
-        using term_type = typename base::term_type;
-        using cf_type = typename term_type::cf_type;
-        integrate_type<T> retval(0);
-        const auto it_f = this->m_container.end();
-        // Turn name into symbol position.
-        const auto idx = ss_index_of(this->m_symbol_set, name);
-        for (auto it = this->m_container.begin(); it != it_f; ++it) {
-            if (idx < this->m_symbol_set.size()) {
-                // If the variable is in the symbol set, then we need to make sure
-                // that each multiplier associated to it is zero. Otherwise, the divisor
-                // depends on the variable and we cannot perform the integration.
-                const auto it2_f = it->m_key.m_container.end();
-                for (auto it2 = it->m_key.m_container.begin(); it2 != it2_f; ++it2) {
-                    using size_type = decltype(it2->v.size());
-                    piranha_assert(idx < it2->v.size());
-                    if (unlikely(it2->v[static_cast<size_type>(idx)] != 0)) {
-                        piranha_throw(std::invalid_argument, "unable to integrate with respect to divisor variables");
-                    }
-                }
-            }
-            divisor_series tmp;
-            tmp.set_symbol_set(this->m_symbol_set);
-            tmp.insert(term_type(cf_type(1), it->m_key));
-            retval += math::integrate(it->m_cf, name) * tmp;
-        }
-        return retval;
+        return integrate_impl<T>(name);
     }
 };
 
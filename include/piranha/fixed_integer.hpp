@@ -0,0 +1,885 @@
+/* Copyright 2009-2017 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#ifndef PIRANHA_FIXED_INTEGER_HPP
+#define PIRANHA_FIXED_INTEGER_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include <mp++/exceptions.hpp>
+#include <mp++/integer.hpp>
+
+#include <piranha/config.hpp>
+#include <piranha/detail/init.hpp>
+#include <piranha/detail/safe_integral_arith.hpp>
+#include <piranha/exceptions.hpp>
+#include <piranha/integer.hpp>
+#include <piranha/math/pow.hpp>
+#include <piranha/s11n.hpp>
+#include <piranha/safe_cast.hpp>
+#include <piranha/type_traits.hpp>
+
+// The 128-bit fixed integer needs both the 128-bit integral types and the integer overflow builtins.
+#if defined(PIRANHA_HAVE_GCC_INT128) && defined(PIRANHA_HAVE_INTEGER_OVERFLOW_BUILTINS)
+
+#define PIRANHA_HAVE_FIXED_INTEGER_128
+
+#endif
+
+namespace piranha
+{
+
+inline namespace impl
+{
+
+#if defined(PIRANHA_HAVE_FIXED_INTEGER_128)
+
+__extension__ typedef __int128 fixed_int128_t;
+__extension__ typedef unsigned __int128 fixed_uint128_t;
+
+#endif
+
+// Storage of a fixed integer with N 64-bit limbs.
+template <std::size_t N>
+struct fixed_integer_storage {
+};
+
+template <>
+struct fixed_integer_storage<1u> {
+    using type = std::int_least64_t;
+    using utype = std::uint_least64_t;
+};
+
+#if defined(PIRANHA_HAVE_FIXED_INTEGER_128)
+
+template <>
+struct fixed_integer_storage<2u> {
+    using type = fixed_int128_t;
+    using utype = fixed_uint128_t;
+};
+
+#endif
+
+// The integral types that can be converted to/from fixed integers: all the C++ integral types except bool,
+// and the 128-bit integral types, if available.
+template <typename T>
+struct is_fixed_integer_interoperable
+    : conjunction<std::is_integral<T>, negation<std::is_same<T, bool>>> {
+};
+
+#if defined(PIRANHA_HAVE_FIXED_INTEGER_128)
+
+template <>
+struct is_fixed_integer_interoperable<fixed_int128_t> : std::true_type {
+};
+
+template <>
+struct is_fixed_integer_interoperable<fixed_uint128_t> : std::true_type {
+};
+
+#endif
+
+// Convert the integral value n to the integral type To, throwing if the value of n
+// cannot be represented by To.
+template <typename To, typename From>
+inline To fixed_integer_cast(const From &n)
+{
+#if defined(PIRANHA_HAVE_INTEGER_OVERFLOW_BUILTINS)
+    To retval;
+    if (unlikely(__builtin_add_overflow(n, From(0), &retval))) {
+        piranha_throw(std::overflow_error, "overflow in the conversion of an integral value involving a fixed "
+                                           "integer: the value cannot be represented by the target type");
+    }
+    return retval;
+#else
+    try {
+        return safe_cast<To>(n);
+    } catch (const safe_cast_failure &) {
+        piranha_throw(std::overflow_error, "overflow in the conversion of an integral value involving a fixed "
+                                           "integer: the value cannot be represented by the target type");
+    }
+#endif
+}
+
+// Overflow-checked arithmetic on the storage of fixed integers. The functions return true in case
+// of overflow.
+// NOTE: without the builtins, the storage type is always std::int_least64_t.
+template <typename T>
+inline bool fixed_integer_add_overflow(T &out, const T &a, const T &b)
+{
+#if defined(PIRANHA_HAVE_INTEGER_OVERFLOW_BUILTINS)
+    return __builtin_add_overflow(a, b, &out);
+#else
+    if ((b > 0 && a > std::numeric_limits<T>::max() - b) || (b < 0 && a < std::numeric_limits<T>::min() - b)) {
+        return true;
+    }
+    out = static_cast<T>(a + b);
+    return false;
+#endif
+}
+
+template <typename T>
+inline bool fixed_integer_sub_overflow(T &out, const T &a, const T &b)
+{
+#if defined(PIRANHA_HAVE_INTEGER_OVERFLOW_BUILTINS)
+    return __builtin_sub_overflow(a, b, &out);
+#else
+    if ((b < 0 && a > std::numeric_limits<T>::max() + b) || (b > 0 && a < std::numeric_limits<T>::min() + b)) {
+        return true;
+    }
+    out = static_cast<T>(a - b);
+    return false;
+#endif
+}
+
+template <typename T>
+inline bool fixed_integer_mul_overflow(T &out, const T &a, const T &b)
+{
+#if defined(PIRANHA_HAVE_INTEGER_OVERFLOW_BUILTINS)
+    return __builtin_mul_overflow(a, b, &out);
+#else
+    const auto max = std::numeric_limits<T>::max(), min = std::numeric_limits<T>::min();
+    if (a > 0) {
+        if ((b > 0 && a > max / b) || (b <= 0 && b < min / a)) {
+            return true;
+        }
+    } else if (a < 0) {
+        if ((b > 0 && a < min / b) || (b < 0 && b < max / a)) {
+            return true;
+        }
+    }
+    out = static_cast<T>(a * b);
+    return false;
+#endif
+}
+}
+
+/// Fixed-size integer.
+/**
+ * This class represents a signed integer stored in \p N 64-bit limbs, that is, in a 64-bit integral type
+ * (if \p N is 1) or in a 128-bit integral type (if \p N is 2). The 128-bit version is available only if the compiler
+ * supports 128-bit integers and the integer overflow builtins.
+ *
+ * Contrary to piranha::integer, which can switch between inline and dynamically-allocated storage and which needs
+ * to keep track of its own size, this class is a thin wrapper around a machine integer. It is thus smaller than
+ * piranha::integer (e.g., 8 bytes instead of 16 when \p N is 1), and its arithmetic operations compile down to a
+ * few machine instructions. The intended use is as a coefficient type for series whose coefficients are known to be
+ * bounded, such as large polynomials with integral coefficients of moderate size: the memory footprint of each
+ * term is reduced, and the multiplication routines of piranha::polynomial can accumulate the coefficients of
+ * a product in machine integers.
+ *
+ * All arithmetic operations are checked for overflow: if the result of an operation cannot be represented, an
+ * \p std::overflow_error is raised. Client code can thus attempt a computation with fixed integers, and fall back
+ * to piranha::integer if the computation fails. Division truncates towards zero, as in C++.
+ *
+ * Fixed integers are implicitly constructible from, and comparable with, all C++ integral types (except \p bool).
+ *
+ * ## Exception safety guarantee ##
+ *
+ * This class provides the strong exception safety guarantee for all operations.
+ *
+ * ## Move semantics ##
+ *
+ * Move semantics is equivalent to copy semantics.
+ *
+ * ## Serialization ##
+ *
+ * This class supports serialization via Boost and msgpack. The value is saved as \p N unsigned 64-bit limbs
+ * representing the two's complement binary representation of the integer, least significant limb first.
+ */
+template <std::size_t N = 1u>
+class fixed_integer
+{
+#if defined(PIRANHA_HAVE_FIXED_INTEGER_128)
+    static_assert(N == 1u || N == 2u, "The number of limbs of a fixed integer must be 1 or 2.");
+#else
+    static_assert(N == 1u, "The number of limbs of a fixed integer must be 1 (128-bit integers are not supported).");
+#endif
+    template <typename T>
+    using interop_enabler = enable_if_t<is_fixed_integer_interoperable<T>::value, int>;
+
+public:
+    /// The underlying integral type.
+    using value_type = typename fixed_integer_storage<N>::type;
+
+private:
+    using uvalue_type = typename fixed_integer_storage<N>::utype;
+    // Absolute value as an unsigned integer (this is well defined also for the minimum value).
+    uvalue_type abs_value() const
+    {
+        return (m_value < 0) ? static_cast<uvalue_type>(uvalue_type(0) - static_cast<uvalue_type>(m_value))
+                             : static_cast<uvalue_type>(m_value);
+    }
+
+public:
+    /// Default constructor.
+    /**
+     * The value is initialised to zero.
+     */
+    fixed_integer() : m_value(0) {}
+    /// Defaulted copy constructor.
+    fixed_integer(const fixed_integer &) = default;
+    /// Defaulted move constructor.
+    fixed_integer(fixed_integer &&) = default;
+    /// Generic constructor from integral types.
+    /**
+     * \note
+     * This constructor is enabled only if \p T is a C++ integral type other than \p bool, or a 128-bit integral
+     * type.
+     *
+     * @param n the construction value.
+     *
+     * @throws std::overflow_error if \p n cannot be represented by the underlying integral type.
+     */
+    template <typename T, interop_enabler<T> = 0>
+    fixed_integer(const T &n) : m_value(fixed_integer_cast<value_type>(n))
+    {
+    }
+    /// Constructor from piranha::integer.
+    /**
+     * @param n the construction value.
+     *
+     * @throws std::overflow_error if \p n cannot be represented by the underlying integral type.
+     */
+    explicit fixed_integer(const integer &n) : m_value(static_cast<value_type>(n)) {}
+    /// Defaulted copy assignment operator.
+    /**
+     * @return a reference to \p this.
+     */
+    fixed_integer &operator=(const fixed_integer &) = default;
+    /// Defaulted move assignment operator.
+    /**
+     * @return a reference to \p this.
+     */
+    fixed_integer &operator=(fixed_integer &&) = default;
+    /// Conversion to integral types.
+    /**
+     * \note
+     * This operator is enabled only if \p T is a C++ integral type other than \p bool, or a 128-bit integral type.
+     *
+     * @return the value of \p this converted to \p T.
+     *
+     * @throws std::overflow_error if the value of \p this cannot be represented by \p T.
+     */
+    template <typename T, interop_enabler<T> = 0>
+    explicit operator T() const
+    {
+        return fixed_integer_cast<T>(m_value);
+    }
+    /// Conversion to piranha::integer.
+    /**
+     * @return the value of \p this as a piranha::integer.
+     */
+    explicit operator integer() const
+    {
+        return integer(m_value);
+    }
+    /// Get the underlying value.
+    /**
+     * @return a const reference to the underlying integral value.
+     */
+    const value_type &get() const
+    {
+        return m_value;
+    }
+    /// Number of bits.
+    /**
+     * @return the number of bits needed to represent the absolute value of \p this (zero if \p this is zero).
+     */
+    std::size_t nbits() const
+    {
+        std::size_t retval = 0u;
+        for (auto u = abs_value(); u; u = static_cast<uvalue_type>(u >> 1)) {
+            ++retval;
+        }
+        return retval;
+    }
+    /// Sign.
+    /**
+     * @return 1 if \p this is positive, -1 if \p this is negative, 0 if \p this is zero.
+     */
+    int sgn() const
+    {
+        return (m_value > 0) ? 1 : ((m_value < 0) ? -1 : 0);
+    }
+    /// Decimal string representation.
+    /**
+     * @return the base-10 representation of \p this.
+     *
+     * @throws unspecified any exception thrown by memory errors in standard containers.
+     */
+    std::string to_string() const
+    {
+        if (!m_value) {
+            return "0";
+        }
+        std::string retval;
+        for (auto u = abs_value(); u; u = static_cast<uvalue_type>(u / 10u)) {
+            retval.push_back(static_cast<char>('0' + static_cast<int>(u % 10u)));
+        }
+        if (m_value < 0) {
+            retval.push_back('-');
+        }
+        std::reverse(retval.begin(), retval.end());
+        return retval;
+    }
+    /// Identity operator.
+    /**
+     * @return a copy of \p this.
+     */
+    fixed_integer operator+() const
+    {
+        return *this;
+    }
+    /// Negation operator.
+    /**
+     * @return the opposite of \p this.
+     *
+     * @throws std::overflow_error if \p this is the minimum representable value.
+     */
+    fixed_integer operator-() const
+    {
+        fixed_integer retval;
+        if (unlikely(fixed_integer_sub_overflow(retval.m_value, value_type(0), m_value))) {
+            piranha_throw(std::overflow_error, "overflow in the negation of a fixed integer");
+        }
+        return retval;
+    }
+    /// In-place addition.
+    /**
+     * @param other the addend.
+     *
+     * @return a reference to \p this.
+     *
+     * @throws std::overflow_error in case of overflow.
+     */
+    fixed_integer &operator+=(const fixed_integer &other)
+    {
+        value_type tmp;
+        if (unlikely(fixed_integer_add_overflow(tmp, m_value, other.m_value))) {
+            piranha_throw(std::overflow_error, "overflow in the addition of fixed integers");
+        }
+        m_value = tmp;
+        return *this;
+    }
+    /// In-place subtraction.
+    /**
+     * @param other the subtrahend.
+     *
+     * @return a reference to \p this.
+     *
+     * @throws std::overflow_error in case of overflow.
+     */
+    fixed_integer &operator-=(const fixed_integer &other)
+    {
+        value_type tmp;
+        if (unlikely(fixed_integer_sub_overflow(tmp, m_value, other.m_value))) {
+            piranha_throw(std::overflow_error, "overflow in the subtraction of fixed integers");
+        }
+        m_value = tmp;
+        return *this;
+    }
+    /// In-place multiplication.
+    /**
+     * @param other the multiplicand.
+     *
+     * @return a reference to \p this.
+     *
+     * @throws std::overflow_error in case of overflow.
+     */
+    fixed_integer &operator*=(const fixed_integer &other)
+    {
+        value_type tmp;
+        if (unlikely(fixed_integer_mul_overflow(tmp, m_value, other.m_value))) {
+            piranha_throw(std::overflow_error, "overflow in the multiplication of fixed integers");
+        }
+        m_value = tmp;
+        return *this;
+    }
+    /// In-place truncated division.
+    /**
+     * @param other the divisor.
+     *
+     * @return a reference to \p this.
+     *
+     * @throws mppp::zero_division_error if \p other is zero.
+     * @throws std::overflow_error if \p this is the minimum representable value and \p other is -1.
+     */
+    fixed_integer &operator/=(const fixed_integer &other)
+    {
+        check_division(other);
+        m_value = static_cast<value_type>(m_value / other.m_value);
+        return *this;
+    }
+    /// In-place truncated remainder.
+    /**
+     * @param other the divisor.
+     *
+     * @return a reference to \p this.
+     *
+     * @throws mppp::zero_division_error if \p other is zero.
+     * @throws std::overflow_error if \p this is the minimum representable value and \p other is -1.
+     */
+    fixed_integer &operator%=(const fixed_integer &other)
+    {
+        check_division(other);
+        m_value = static_cast<value_type>(m_value % other.m_value);
+        return *this;
+    }
+    /// Binary addition.
+    /**
+     * @param a the first operand.
+     * @param b the second operand.
+     *
+     * @return <tt>a + b</tt>.
+     *
+     * @throws std::overflow_error in case of overflow.
+     */
+    friend fixed_integer operator+(const fixed_integer &a, const fixed_integer &b)
+    {
+        fixed_integer retval(a);
+        retval += b;
+        return retval;
+    }
+    /// Binary subtraction.
+    /**
+     * @param a the first operand.
+     * @param b the second operand.
+     *
+     * @return <tt>a - b</tt>.
+     *
+     * @throws std::overflow_error in case of overflow.
+     */
+    friend fixed_integer operator-(const fixed_integer &a, const fixed_integer &b)
+    {
+        fixed_integer retval(a);
+        retval -= b;
+        return retval;
+    }
+    /// Binary multiplication.
+    /**
+     * @param a the first operand.
+     * @param b the second operand.
+     *
+     * @return <tt>a * b</tt>.
+     *
+     * @throws std::overflow_error in case of overflow.
+     */
+    friend fixed_integer operator*(const fixed_integer &a, const fixed_integer &b)
+    {
+        fixed_integer retval(a);
+        retval *= b;
+        return retval;
+    }
+    /// Binary truncated division.
+    /**
+     * @param a the dividend.
+     * @param b the divisor.
+     *
+     * @return <tt>a / b</tt>.
+     *
+     * @throws unspecified any exception thrown by operator/=().
+     */
+    friend fixed_integer operator/(const fixed_integer &a, const fixed_integer &b)
+    {
+        fixed_integer retval(a);
+        retval /= b;
+        return retval;
+    }
+    /// Binary truncated remainder.
+    /**
+     * @param a the dividend.
+     * @param b the divisor.
+     *
+     * @return <tt>a % b</tt>.
+     *
+     * @throws unspecified any exception thrown by operator%=().
+     */
+    friend fixed_integer operator%(const fixed_integer &a, const fixed_integer &b)
+    {
+        fixed_integer retval(a);
+        retval %= b;
+        return retval;
+    }
+    /// Equality operator.
+    /**
+     * @param a the first operand.
+     * @param b the second operand.
+     *
+     * @return \p true if \p a is equal to \p b, \p false otherwise.
+     */
+    friend bool operator==(const fixed_integer &a, const fixed_integer &b)
+    {
+        return a.m_value == b.m_value;
+    }
+    /// Inequality operator.
+    /**
+     * @param a the first operand.
+     * @param b the second operand.
+     *
+     * @return \p true if \p a is different from \p b, \p false otherwise.
+     */
+    friend bool operator!=(const fixed_integer &a, const fixed_integer &b)
+    {
+        return a.m_value != b.m_value;
+    }
+    /// Less-than operator.
+    /**
+     * @param a the first operand.
+     * @param b the second operand.
+     *
+     * @return \p true if \p a is less than \p b, \p false otherwise.
+     */
+    friend bool operator<(const fixed_integer &a, const fixed_integer &b)
+    {
+        return a.m_value < b.m_value;
+    }
+    /// Less-than or equal operator.
+    /**
+     * @param a the first operand.
+     * @param b the second operand.
+     *
+     * @return \p true if \p a is less than or equal to \p b, \p false otherwise.
+     */
+    friend bool operator<=(const fixed_integer &a, const fixed_integer &b)
+    {
+        return a.m_value <= b.m_value;
+    }
+    /// Greater-than operator.
+    /**
+     * @param a the first operand.
+     * @param b the second operand.
+     *
+     * @return \p true if \p a is greater than \p b, \p false otherwise.
+     */
+    friend bool operator>(const fixed_integer &a, const fixed_integer &b)
+    {
+        return a.m_value > b.m_value;
+    }
+    /// Greater-than or equal operator.
+    /**
+     * @param a the first operand.
+     * @param b the second operand.
+     *
+     * @return \p true if \p a is greater than or equal to \p b, \p false otherwise.
+     */
+    friend bool operator>=(const fixed_integer &a, const fixed_integer &b)
+    {
+        return a.m_value >= b.m_value;
+    }
+    /// Stream operator.
+    /**
+     * @param os the target stream.
+     * @param n the fixed integer to be printed.
+     *
+     * @return a reference to \p os.
+     *
+     * @throws unspecified any exception thrown by to_string() or by the stream.
+     */
+    friend std::ostream &operator<<(std::ostream &os, const fixed_integer &n)
+    {
+        return os << n.to_string();
+    }
+
+private:
+    void check_division(const fixed_integer &other) const
+    {
+        if (unlikely(!other.m_value)) {
+            piranha_throw(mppp::zero_division_error, "division of a fixed integer by zero");
+        }
+        if (unlikely(m_value == std::numeric_limits<value_type>::min() && other.m_value == -1)) {
+            piranha_throw(std::overflow_error, "overflow in the division of fixed integers");
+        }
+    }
+
+private:
+    value_type m_value;
+};
+
+/// Detect fixed integers.
+/**
+ * This type trait will be \p true if \p T is an instance of piranha::fixed_integer, \p false otherwise.
+ */
+template <typename T>
+struct is_fixed_integer : std::false_type {
+};
+
+template <std::size_t N>
+struct is_fixed_integer<fixed_integer<N>> : std::true_type {
+};
+
+inline namespace impl
+{
+
+template <typename U>
+using fixed_integer_pow_enabler = enable_if_t<conjunction<std::is_integral<U>, negation<std::is_same<U, bool>>>::value>;
+
+// Sign test for the exponent which does not trigger warnings for unsigned types.
+template <typename U, enable_if_t<std::is_signed<U>::value, int> = 0>
+inline bool fixed_integer_negative_exp(const U &e)
+{
+    return e < U(0);
+}
+
+template <typename U, enable_if_t<!std::is_signed<U>::value, int> = 0>
+inline bool fixed_integer_negative_exp(const U &)
+{
+    return false;
+}
+
+// The limbs of the two's complement representation of a fixed integer, least significant first.
+template <std::size_t N>
+using fixed_integer_limbs = std::array<unsigned long long, N>;
+
+template <std::size_t N>
+inline fixed_integer_limbs<N> fixed_integer_to_limbs(const fixed_integer<N> &n)
+{
+    fixed_integer_limbs<N> retval;
+    auto u = static_cast<typename fixed_integer_storage<N>::utype>(n.get());
+    for (std::size_t i = 0u; i < N; ++i) {
+        retval[i] = static_cast<unsigned long long>(u & 0xFFFFFFFFFFFFFFFFull);
+        // NOTE: two shifts, as the shift by the full width of the type would be undefined.
+        u = static_cast<decltype(u)>(u >> 32);
+        u = static_cast<decltype(u)>(u >> 32);
+    }
+    return retval;
+}
+
+template <std::size_t N>
+inline fixed_integer<N> fixed_integer_from_limbs(const fixed_integer_limbs<N> &limbs)
+{
+    using utype = typename fixed_integer_storage<N>::utype;
+    utype u(0);
+    for (std::size_t i = N; i > 0u; --i) {
+        u = static_cast<utype>(u << 32);
+        u = static_cast<utype>(u << 32);
+        u = static_cast<utype>(u | static_cast<utype>(limbs[i - 1u] & 0xFFFFFFFFFFFFFFFFull));
+    }
+    // NOTE: the conversion from unsigned to signed is implementation-defined (modular on all supported
+    // compilers), and it is guaranteed to fit.
+    return fixed_integer<N>(static_cast<typename fixed_integer_storage<N>::type>(u));
+}
+}
+
+/// Specialisation of the implementation of piranha::pow() for piranha::fixed_integer.
+/**
+ * \note
+ * This specialisation is enabled if \p U is a C++ integral type other than \p bool.
+ */
+template <std::size_t N, typename U>
+class pow_impl<fixed_integer<N>, U, fixed_integer_pow_enabler<U>>
+{
+public:
+    /// Call operator.
+    /**
+     * The exponentiation is computed via repeated squaring. Negative exponents are allowed only if the base
+     * is 1 or -1.
+     *
+     * @param b the base.
+     * @param e the exponent.
+     *
+     * @return <tt>b**e</tt>.
+     *
+     * @throws mppp::zero_division_error if \p b is zero and \p e is negative.
+     * @throws std::domain_error if \p e is negative and the absolute value of \p b is greater than one.
+     * @throws std::overflow_error if the result cannot be represented.
+     */
+    fixed_integer<N> operator()(const fixed_integer<N> &b, const U &e) const
+    {
+        if (fixed_integer_negative_exp(e)) {
+            if (unlikely(b == 0)) {
+                piranha_throw(mppp::zero_division_error, "cannot raise a zero fixed integer to a negative power");
+            }
+            if (unlikely(b != 1 && b != -1)) {
+                piranha_throw(std::domain_error, "cannot raise a fixed integer whose absolute value is greater than "
+                                                 "one to a negative power");
+            }
+            // (-1)**e is -1 if e is odd.
+            return (b == -1 && e % U(2) != U(0)) ? fixed_integer<N>(-1) : fixed_integer<N>(1);
+        }
+        fixed_integer<N> retval(1), base(b);
+        auto ue = static_cast<typename std::make_unsigned<U>::type>(e);
+        while (ue) {
+            if (ue & 1u) {
+                retval *= base;
+            }
+            ue = static_cast<decltype(ue)>(ue >> 1);
+            // NOTE: square the base only if there are more bits to process, so that
+            // we do not overflow when the result is representable.
+            if (ue) {
+                base *= base;
+            }
+        }
+        return retval;
+    }
+};
+
+#if defined(PIRANHA_WITH_BOOST_S11N)
+
+inline namespace impl
+{
+
+template <typename Archive>
+using fixed_integer_boost_save_enabler = enable_if_t<has_boost_save<Archive, unsigned long long>::value>;
+
+template <typename Archive>
+using fixed_integer_boost_load_enabler = enable_if_t<has_boost_load<Archive, unsigned long long>::value>;
+}
+
+/// Specialisation of piranha::boost_save() for piranha::fixed_integer.
+/**
+ * \note
+ * This specialisation is enabled only if <tt>unsigned long long</tt> satisfies piranha::has_boost_save.
+ */
+template <typename Archive, std::size_t N>
+struct boost_save_impl<Archive, fixed_integer<N>, fixed_integer_boost_save_enabler<Archive>> {
+    /// Call operator.
+    /**
+     * @param ar the target archive.
+     * @param n the fixed integer to be saved.
+     *
+     * @throws unspecified any exception thrown by piranha::boost_save().
+     */
+    void operator()(Archive &ar, const fixed_integer<N> &n) const
+    {
+        for (const auto &l : fixed_integer_to_limbs(n)) {
+            boost_save(ar, l);
+        }
+    }
+};
+
+/// Specialisation of piranha::boost_load() for piranha::fixed_integer.
+/**
+ * \note
+ * This specialisation is enabled only if <tt>unsigned long long</tt> satisfies piranha::has_boost_load.
+ */
+template <typename Archive, std::size_t N>
+struct boost_load_impl<Archive, fixed_integer<N>, fixed_integer_boost_load_enabler<Archive>> {
+    /// Call operator.
+    /**
+     * @param ar the source archive.
+     * @param n the fixed integer into which the archive will be loaded.
+     *
+     * @throws unspecified any exception thrown by piranha::boost_load().
+     */
+    void operator()(Archive &ar, fixed_integer<N> &n) const
+    {
+        fixed_integer_limbs<N> limbs;
+        for (auto &l : limbs) {
+            boost_load(ar, l);
+        }
+        n = fixed_integer_from_limbs(limbs);
+    }
+};
+
+#endif
+
+#if defined(PIRANHA_WITH_MSGPACK)
+
+inline namespace impl
+{
+
+template <typename Stream>
+using fixed_integer_msgpack_pack_enabler
+    = enable_if_t<conjunction<is_msgpack_stream<Stream>, has_msgpack_pack<Stream, unsigned long long>>::value>;
+
+template <std::size_t N>
+using fixed_integer_msgpack_convert_enabler
+    = enable_if_t<has_msgpack_convert<typename fixed_integer_limbs<N>::value_type>::value>;
+}
+
+/// Specialisation of piranha::msgpack_pack() for piranha::fixed_integer.
+/**
+ * \note
+ * This specialisation is enabled only if \p Stream satisfies piranha::is_msgpack_stream and
+ * <tt>unsigned long long</tt> satisfies piranha::has_msgpack_pack.
+ */
+template <typename Stream, std::size_t N>
+struct msgpack_pack_impl<Stream, fixed_integer<N>, fixed_integer_msgpack_pack_enabler<Stream>> {
+    /// Call operator.
+    /**
+     * The fixed integer is packed as an array of limbs.
+     *
+     * @param p the target <tt>msgpack::packer</tt>.
+     * @param n the input fixed integer.
+     * @param f the desired piranha::msgpack_format.
+     *
+     * @throws unspecified any exception thrown by:
+     * - the public interface of <tt>msgpack::packer</tt>,
+     * - piranha::msgpack_pack().
+     */
+    void operator()(msgpack::packer<Stream> &p, const fixed_integer<N> &n, msgpack_format f) const
+    {
+        p.pack_array(static_cast<std::uint32_t>(N));
+        for (const auto &l : fixed_integer_to_limbs(n)) {
+            piranha::msgpack_pack(p, l, f);
+        }
+    }
+};
+
+/// Specialisation of piranha::msgpack_convert() for piranha::fixed_integer.
+/**
+ * \note
+ * This specialisation is enabled only if <tt>unsigned long long</tt> satisfies piranha::has_msgpack_convert.
+ */
+template <std::size_t N>
+struct msgpack_convert_impl<fixed_integer<N>, fixed_integer_msgpack_convert_enabler<N>> {
+    /// Call operator.
+    /**
+     * @param n the output fixed integer.
+     * @param o the source <tt>msgpack::object</tt>.
+     * @param f the desired piranha::msgpack_format.
+     *
+     * @throws unspecified any exception thrown by:
+     * - the public interface of <tt>msgpack::object</tt>,
+     * - piranha::msgpack_convert().
+     */
+    void operator()(fixed_integer<N> &n, const msgpack::object &o, msgpack_format f) const
+    {
+        PIRANHA_MAYBE_TLS std::array<msgpack::object, N> v;
+        o.convert(v);
+        fixed_integer_limbs<N> limbs;
+        for (std::size_t i = 0u; i < N; ++i) {
+            piranha::msgpack_convert(limbs[i], v[i], f);
+        }
+        n = fixed_integer_from_limbs(limbs);
+    }
+};
+
+#endif
+}
+
+#endif
@@ -0,0 +1,382 @@
+/* Copyright 2009-2017 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#ifndef PIRANHA_FROZEN_SERIES_HPP
+#define PIRANHA_FROZEN_SERIES_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/numeric/conversion/cast.hpp>
+
+#include <piranha/config.hpp>
+#include <piranha/exceptions.hpp>
+#include <piranha/math.hpp>
+#include <piranha/s11n.hpp>
+#include <piranha/safe_cast.hpp>
+#include <piranha/series.hpp>
+#include <piranha/symbol_utils.hpp>
+#include <piranha/type_traits.hpp>
+
+namespace piranha
+{
+
+/// Frozen series.
+/**
+ * This class stores the terms of a series of type \p Series in a contiguous vector, sorted according to the
+ * keys of the terms. If the key type is less-than comparable, the ordering is the one induced by the key's
+ * less-than operator, otherwise the terms are sorted according to the hash values of their keys.
+ *
+ * A frozen series is an immutable, read-only snapshot of a series: it can be constructed from a series (freeze),
+ * converted back into a series via thaw(), iterated over, searched, evaluated and serialized. Compared to
+ * piranha::hash_set, the storage is compact (there are no buckets and no per-bucket list nodes) and iteration
+ * visits the terms in sequential memory order. A frozen series is thus a convenient representation for large
+ * series which are computed once and then read many times (e.g., evaluated or saved repeatedly).
+ *
+ * A frozen series can also be used directly as an operand of piranha::series_multiplier (see the constructors
+ * of piranha::base_series_multiplier from frozen series), without being thawed first.
+ *
+ * ## Type requirements ##
+ *
+ * \p Series must satisfy piranha::is_series.
+ *
+ * ## Exception safety guarantee ##
+ *
+ * Unless otherwise specified, this class provides the strong exception safety guarantee for all operations.
+ *
+ * ## Move semantics ##
+ *
+ * Move construction and move assignment will leave the moved-from object in an unspecified but valid state.
+ *
+ * ## Serialization ##
+ *
+ * This class supports serialization via Boost. The layout of the archive is the same as the layout of
+ * an archive of \p Series, so that a frozen series can be loaded into a series and vice versa.
+ */
+template <typename Series>
+class frozen_series
+{
+    PIRANHA_TT_CHECK(is_series, Series);
+
+public:
+    /// Alias for the series type.
+    using series_type = Series;
+    /// Alias for the term type.
+    using term_type = typename Series::term_type;
+
+private:
+    using container_type = std::vector<term_type>;
+    using key_type = typename term_type::key_type;
+    // Ordering of the terms.
+    static bool term_less(const term_type &t1, const term_type &t2, const std::true_type &)
+    {
+        return t1.m_key < t2.m_key;
+    }
+    static bool term_less(const term_type &t1, const term_type &t2, const std::false_type &)
+    {
+        return t1.hash() < t2.hash();
+    }
+    static bool term_less(const term_type &t1, const term_type &t2)
+    {
+        return term_less(t1, t2, std::integral_constant<bool, is_less_than_comparable<key_type>::value>{});
+    }
+    // Sort the terms after they have been copied/moved into m_terms.
+    void sort_terms()
+    {
+        std::sort(m_terms.begin(), m_terms.end(),
+                  [](const term_type &t1, const term_type &t2) { return term_less(t1, t2); });
+    }
+
+public:
+    /// Size type.
+    using size_type = typename container_type::size_type;
+    /// Const iterator type.
+    using const_iterator = typename container_type::const_iterator;
+    /// Defaulted default constructor.
+    /**
+     * The frozen series will be empty and with an empty symbol set.
+     */
+    frozen_series() = default;
+    /// Defaulted copy constructor.
+    frozen_series(const frozen_series &) = default;
+    /// Defaulted move constructor.
+    frozen_series(frozen_series &&) = default;
+    /// Constructor from series.
+    /**
+     * This constructor will copy the symbol set and the terms of \p s into \p this, and it will then sort
+     * the terms.
+     *
+     * @param s the series that will be frozen.
+     *
+     * @throws unspecified any exception thrown by:
+     * - memory errors in standard containers,
+     * - the copy constructor of the term type,
+     * - the comparison operator or the hash function of the key type.
+     */
+    explicit frozen_series(const Series &s) : m_symbol_set(s.get_symbol_set())
+    {
+        m_terms.reserve(static_cast<size_type>(s.size()));
+        std::copy(s._container().begin(), s._container().end(), std::back_inserter(m_terms));
+        sort_terms();
+    }
+    /// Copy assignment operator.
+    /**
+     * @param other the assignment argument.
+     *
+     * @return a reference to \p this.
+     *
+     * @throws unspecified any exception thrown by the copy constructor.
+     */
+    frozen_series &operator=(const frozen_series &other)
+    {
+        if (likely(this != &other)) {
+            *this = frozen_series(other);
+        }
+        return *this;
+    }
+    /// Defaulted move assignment operator.
+    frozen_series &operator=(frozen_series &&) = default;
+    /// Thaw.
+    /**
+     * @return a series containing the same symbol set and terms as \p this.
+     *
+     * @throws unspecified any exception thrown by:
+     * - the public interface of piranha::series and piranha::hash_set,
+     * - the copy constructor of the term type,
+     * - <tt>boost::numeric_cast()</tt>.
+     */
+    Series thaw() const
+    {
+        Series retval;
+        retval.set_symbol_set(m_symbol_set);
+        if (m_terms.empty()) {
+            return retval;
+        }
+        auto &container = retval._container();
+        container.rehash(boost::numeric_cast<typename Series::size_type>(
+            std::ceil(static_cast<double>(m_terms.size()) / container.max_load_factor())));
+        // NOTE: the terms in a frozen series are unique and compatible with the symbol set (this is
+        // guaranteed by construction from a series or by loading), so we can use the low-level interface
+        // of hash_set.
+        try {
+            for (const auto &t : m_terms) {
+                container._unique_insert(t, container._bucket(t));
+            }
+            container._update_size(safe_cast<typename Series::size_type>(m_terms.size()));
+        } catch (...) {
+            container.clear();
+            throw;
+        }
+        return retval;
+    }
+    /// Symbol set getter.
+    /**
+     * @return a const reference to the symbol set of \p this.
+     */
+    const symbol_fset &get_symbol_set() const
+    {
+        return m_symbol_set;
+    }
+    /// Size.
+    /**
+     * @return the number of terms in \p this.
+     */
+    size_type size() const
+    {
+        return m_terms.size();
+    }
+    /// Empty test.
+    /**
+     * @return \p true if \p this does not contain any term, \p false otherwise.
+     */
+    bool empty() const
+    {
+        return m_terms.empty();
+    }
+    /// Begin iterator.
+    /**
+     * @return an iterator to the first term of \p this.
+     */
+    const_iterator begin() const
+    {
+        return m_terms.begin();
+    }
+    /// End iterator.
+    /**
+     * @return an iterator to the end of the range of terms of \p this.
+     */
+    const_iterator end() const
+    {
+        return m_terms.end();
+    }
+    /// Find term.
+    /**
+     * The lookup is performed via a binary search, and it has logarithmic complexity.
+     *
+     * @param t the term to be searched for.
+     *
+     * @return an iterator to the term of \p this whose key is equal to the key of \p t, or end() if no such
+     * term exists.
+     *
+     * @throws unspecified any exception thrown by the comparison operator or the hash function of the key type.
+     */
+    const_iterator find(const term_type &t) const
+    {
+        auto it = std::lower_bound(m_terms.begin(), m_terms.end(), t,
+                                   [](const term_type &t1, const term_type &t2) { return term_less(t1, t2); });
+        // NOTE: if the ordering is based on hashes, there might be multiple terms with the same hash
+        // value, hence we need to check all the terms equivalent to t.
+        for (; it != m_terms.end() && !term_less(t, *it); ++it) {
+            if (*it == t) {
+                return it;
+            }
+        }
+        return m_terms.end();
+    }
+    /// Evaluation.
+    /**
+     * \note
+     * This method is enabled only if \p Series is evaluable with objects of type \p T.
+     *
+     * The semantics of this method are the same as those of piranha::math::evaluate() for \p Series.
+     *
+     * @param dict the dictionary that will be used for evaluation.
+     *
+     * @return the result of evaluating \p this according to \p dict.
+     *
+     * @throws unspecified any exception thrown by piranha::math::evaluate() for \p Series.
+     */
+    template <typename T, enable_if_t<is_evaluable<Series, T>::value, int> = 0>
+    auto evaluate(const symbol_fmap<T> &dict) const
+        -> decltype(math::evaluate_impl<Series, T>{}.evaluate_terms(std::declval<const symbol_fset &>(),
+                                                                    std::declval<const container_type &>(), dict))
+    {
+        return math::evaluate_impl<Series, T>{}.evaluate_terms(m_symbol_set, m_terms, dict);
+    }
+
+private:
+#if defined(PIRANHA_WITH_BOOST_S11N)
+    // Boost serialization support.
+    // NOTE: this mirrors the implementation in piranha::series.
+    friend class boost::serialization::access;
+    template <class Archive>
+    void save(Archive &ar, unsigned) const
+    {
+        boost_save(ar, m_symbol_set.size());
+        for (const auto &sym : m_symbol_set) {
+            boost_save(ar, sym);
+        }
+        boost_save(ar, safe_cast<typename Series::size_type>(m_terms.size()));
+        for (const auto &t : m_terms) {
+            boost_save(ar, t.m_cf);
+            boost_save(ar, boost_s11n_key_wrapper<key_type>{t.m_key, m_symbol_set});
+        }
+    }
+    template <class Archive>
+    void load(Archive &ar, unsigned)
+    {
+        // NOTE: the terms are loaded into a series first, so that duplicates and incompatible
+        // keys are handled as in piranha::series.
+        Series tmp;
+        boost_load(ar, tmp);
+        *this = frozen_series(tmp);
+    }
+    BOOST_SERIALIZATION_SPLIT_MEMBER()
+#endif
+
+private:
+    symbol_fset m_symbol_set;
+    container_type m_terms;
+};
+
+inline namespace impl
+{
+
+template <typename>
+struct is_frozen_series : std::false_type {
+};
+
+template <typename Series>
+struct is_frozen_series<frozen_series<Series>> : std::true_type {
+};
+}
+
+#if defined(PIRANHA_WITH_BOOST_S11N)
+
+inline namespace impl
+{
+
+template <typename Archive, typename FSeries>
+using frozen_series_boost_save_enabler
+    = enable_if_t<conjunction<is_frozen_series<FSeries>,
+                              has_boost_save<Archive, typename FSeries::series_type>>::value>;
+
+template <typename Archive, typename FSeries>
+using frozen_series_boost_load_enabler
+    = enable_if_t<conjunction<is_frozen_series<FSeries>,
+                              has_boost_load<Archive, typename FSeries::series_type>>::value>;
+}
+
+/// Specialisation of piranha::boost_save() for piranha::frozen_series.
+/**
+ * \note
+ * This specialisation is enabled only if \p FSeries is an instance of piranha::frozen_series whose series type
+ * satisfies piranha::has_boost_save.
+ *
+ * @throws unspecified any exception thrown by piranha::boost_save().
+ */
+template <typename Archive, typename FSeries>
+struct boost_save_impl<Archive, FSeries, frozen_series_boost_save_enabler<Archive, FSeries>>
+    : boost_save_via_boost_api<Archive, FSeries> {
+};
+
+/// Specialisation of piranha::boost_load() for piranha::frozen_series.
+/**
+ * \note
+ * This specialisation is enabled only if \p FSeries is an instance of piranha::frozen_series whose series type
+ * satisfies piranha::has_boost_load.
+ *
+ * The strong exception safety guarantee is provided.
+ *
+ * @throws unspecified any exception thrown by piranha::boost_load() and by the constructor of
+ * piranha::frozen_series from a series.
+ */
+template <typename Archive, typename FSeries>
+struct boost_load_impl<Archive, FSeries, frozen_series_boost_load_enabler<Archive, FSeries>>
+    : boost_load_via_boost_api<Archive, FSeries> {
+};
+
+#endif
+}
+
+#endif
@@ -50,10 +50,12 @@ see https://www.gnu.org/licenses/. */
 #include <piranha/config.hpp>
 #include <piranha/detail/debug_access.hpp>
 #include <piranha/detail/init.hpp>
+#include <piranha/detail/node_arena.hpp>
 #include <piranha/exceptions.hpp>
 #include <piranha/s11n.hpp>
 #include <piranha/safe_cast.hpp>
 #include <piranha/thread_pool.hpp>
+#include <piranha/tuning.hpp>
 #include <piranha/type_traits.hpp>
 
 namespace piranha
@@ -72,7 +74,9 @@ namespace piranha
  *
  * The implementation employs a separate chaining strategy consisting of an array of buckets, each one a singly linked
  * list with the first node stored directly within the array (so that the first insertion in a bucket does not require
- * any heap allocation).
+ * any heap allocation). If piranha::tuning::get_node_arena() is active, sets with a large number of buckets
+ * allocate the other nodes of the lists from an arena owned by the set, which is released in bulk when the set
+ * is cleared or destroyed.
  *
  * An additional set of low-level methods is provided: such methods are suitable for use in high-performance and
  * multi-threaded contexts, and, if misused, could lead to data corruption and other unpredictable errors.
@@ -167,7 +171,11 @@ class hash_set
         storage_type m_storage;
         node *m_next;
     };
+    // Arena for the nodes.
+    using arena_type = detail::node_arena<node>;
     // List constituting the bucket.
+    // NOTE: the nodes of the list past the first one are allocated either via new (if the arena pointer
+    // passed to the methods of the list is null) or from the arena of the set.
     // NOTE: in this list implementation the m_next pointer is used as a flag to signal if the current node
     // stores an item: the pointer is not null if it does contain something. The value of m_next pointer in a node is
     // set to a constant
@@ -225,7 +233,8 @@ class hash_set
         {
             steal_from_rvalue(std::move(other));
         }
-        list(const list &other) : m_node()
+        list(const list &other) : list(other, nullptr) {}
+        list(const list &other, arena_type *a) : m_node()
         {
             try {
                 auto cur = &m_node;
@@ -237,11 +246,10 @@ class hash_set
                         piranha_assert(cur->m_next == &terminator);
                         // Create a new node with content equal to other_cur
                         // and linking forward to the terminator.
-                        std::unique_ptr<node> new_node(::new node());
-                        ::new (static_cast<void *>(&new_node->m_storage)) T(*other_cur->ptr());
+                        const auto new_node = make_node(a, *other_cur->ptr());
                         new_node->m_next = &terminator;
                         // Link the new node.
-                        cur->m_next = new_node.release();
+                        cur->m_next = new_node;
                         cur = cur->m_next;
                     } else {
                         // This means this is the first node.
@@ -251,10 +259,12 @@ class hash_set
                     other_cur = other_cur->m_next;
                 }
             } catch (...) {
-                destroy();
+                destroy(a);
                 throw;
             }
         }
+        // NOTE: the assignment operators and the destructor deal only with lists whose nodes were allocated
+        // via new. The lists of a set with an arena are always destroyed explicitly via destroy().
         list &operator=(list &&other)
         {
             if (likely(this != &other)) {
@@ -291,17 +301,40 @@ class hash_set
             }
             piranha_assert(other.empty());
         }
+        // Create a new node, either via new or from the arena a, and construct its content from args.
+        // The m_next member of the new node is left null.
+        template <typename... Args>
+        static node *make_node(arena_type *a, Args &&... args)
+        {
+            node *retval = a ? ::new (a->allocate()) node() : ::new node();
+            try {
+                ::new (static_cast<void *>(&retval->m_storage)) T(std::forward<Args>(args)...);
+            } catch (...) {
+                free_node(a, retval);
+                throw;
+            }
+            return retval;
+        }
+        // Free a node whose content has already been destroyed.
+        static void free_node(arena_type *a, node *n)
+        {
+            if (a) {
+                n->~node();
+                a->deallocate(n);
+            } else {
+                ::delete n;
+            }
+        }
         template <typename U, enable_if_t<std::is_same<T, uncvref_t<U>>::value, int> = 0>
-        node *insert(U &&item)
+        node *insert(U &&item, arena_type *a = nullptr)
         {
             // NOTE: optimize with likely/unlikely?
             if (m_node.m_next) {
                 // Create the new node and forward-link it to the second node.
-                std::unique_ptr<node> new_node(::new node());
-                ::new (static_cast<void *>(&new_node->m_storage)) T(std::forward<U>(item));
+                const auto new_node = make_node(a, std::forward<U>(item));
                 new_node->m_next = m_node.m_next;
                 // Link first node to the new node.
-                m_node.m_next = new_node.release();
+                m_node.m_next = new_node;
                 return m_node.m_next;
             } else {
                 ::new (static_cast<void *>(&m_node.m_storage)) T(std::forward<U>(item));
@@ -329,7 +362,9 @@ class hash_set
         {
             return !m_node.m_next;
         }
-        void destroy()
+        // Destroy the content of the list. If the nodes were allocated from an arena, they are not
+        // returned to it individually: the arena is expected to be released in bulk afterwards.
+        void destroy(arena_type *a = nullptr)
         {
             node *cur = &m_node;
             while (cur->m_next) {
@@ -341,7 +376,7 @@ class hash_set
                 old->ptr()->~T();
                 old->m_next = nullptr;
                 // If the old node was not the initial one, delete it.
-                if (old != &m_node) {
+                if (old != &m_node && !a) {
                     ::delete old;
                 }
             }
@@ -472,6 +507,9 @@ private:
         }
         const size_type log2_size = get_log2_from_hint(n_buckets);
         const size_type size = size_type(1u) << log2_size;
+        // Create the arena for the nodes, if requested.
+        std::unique_ptr<arena_type> new_arena(
+            (size >= m_arena_min_buckets && tuning::get_node_arena()) ? ::new arena_type : nullptr);
         auto new_ptr = allocator().allocate(size);
         if (unlikely(!new_ptr)) {
             piranha_throw(std::bad_alloc, );
@@ -528,20 +566,24 @@ private:
         // Assign the members.
         ptr() = new_ptr;
         m_log2_size = log2_size;
+        m_arena = std::move(new_arena);
     }
-    // Destroy all elements and deallocate ptr().
+    // Destroy all elements and deallocate ptr() and the arena.
     void destroy_and_deallocate()
     {
         // Proceed to destroy all elements and deallocate only if the set is actually storing something.
         if (ptr()) {
             const size_type size = size_type(1u) << m_log2_size;
             for (size_type i = 0u; i < size; ++i) {
+                ptr()[i].destroy(m_arena.get());
                 allocator().destroy(&ptr()[i]);
             }
             allocator().deallocate(ptr(), size);
         } else {
             piranha_assert(!m_log2_size && !m_n_elements);
         }
+        // Release in one go the memory of the nodes allocated from the arena.
+        m_arena.reset();
     }
 #if defined(PIRANHA_WITH_BOOST_S11N)
     // Serialization support.
@@ -615,6 +657,10 @@ private:
     // in
     // the [2 ** 0, 2 ** (n-1)] range.
     static const size_type m_n_nonzero_sizes = static_cast<size_type>(std::numeric_limits<size_type>::digits);
+    // Minimum number of buckets for the creation of an arena for the nodes. Smaller sets (e.g., the series
+    // appearing as coefficients of other series) use plain dynamic allocation.
+    // NOTE: this is a tuning parameter.
+    static const size_type m_arena_min_buckets = 4096u;
     // Get log2 of set size at least equal to hint. To be used only when hint is not zero.
     static size_type get_log2_from_hint(const size_type &hint)
     {
@@ -698,7 +744,8 @@ public:
      * the copy constructor of the stored type, <tt>Hash</tt> or <tt>Pred</tt>.
      */
     hash_set(const hash_set &other)
-        : m_pack(nullptr, other.hash(), other.k_equal(), other.allocator()), m_log2_size(0u), m_n_elements(0u)
+        : m_pack(nullptr, other.hash(), other.k_equal(), other.allocator()), m_log2_size(0u), m_n_elements(0u),
+          m_arena(other.m_arena ? ::new arena_type : nullptr)
     {
         // Proceed to actual copy only if other has some content.
         if (other.ptr()) {
@@ -711,11 +758,12 @@ public:
             try {
                 // Copy-construct the elements of the array.
                 for (; i < size; ++i) {
-                    allocator().construct(&new_ptr[i], other.ptr()[i]);
+                    allocator().construct(&new_ptr[i], other.ptr()[i], m_arena.get());
                 }
             } catch (...) {
                 // Unwind the construction and deallocate, before re-throwing.
                 for (size_type j = 0u; j < i; ++j) {
+                    new_ptr[j].destroy(m_arena.get());
                     allocator().destroy(&new_ptr[j]);
                 }
                 allocator().deallocate(new_ptr, size);
@@ -737,7 +785,8 @@ public:
      * @param other set to be moved.
      */
     hash_set(hash_set &&other) noexcept
-        : m_pack(std::move(other.m_pack)), m_log2_size(other.m_log2_size), m_n_elements(other.m_n_elements)
+        : m_pack(std::move(other.m_pack)), m_log2_size(other.m_log2_size), m_n_elements(other.m_n_elements),
+          m_arena(std::move(other.m_arena))
     {
         // Clear out the other one.
         other.ptr() = nullptr;
@@ -828,6 +877,7 @@ public:
             m_pack = std::move(other.m_pack);
             m_log2_size = other.m_log2_size;
             m_n_elements = other.m_n_elements;
+            m_arena = std::move(other.m_arena);
             // Zero out other.
             other.ptr() = nullptr;
             other.m_log2_size = 0u;
@@ -1107,6 +1157,7 @@ public:
         std::swap(m_pack, other.m_pack);
         std::swap(m_log2_size, other.m_log2_size);
         std::swap(m_n_elements, other.m_n_elements);
+        std::swap(m_arena, other.m_arena);
     }
     /// Rehash set.
     /**
@@ -1255,7 +1306,7 @@ public:
         piranha_assert(find(std::forward<U>(k)) == end());
         // Assert bucket index is correct.
         piranha_assert(bucket_idx == _bucket(k));
-        auto p = ptr()[bucket_idx].insert(std::forward<U>(k));
+        auto p = ptr()[bucket_idx].insert(std::forward<U>(k), m_arena.get());
         return iterator(this, bucket_idx, local_iterator(p));
     }
     /// Find element (low-level).
@@ -1357,6 +1408,48 @@ public:
         piranha_assert(idx < bucket_count());
         return ptr()[idx];
     }
+    /// Mutable reference to list in bucket.
+    /**
+     * @param idx index of the bucket whose list will be returned.
+     *
+     * @return a mutable reference to the list of items contained in the bucket positioned
+     * at index \p idx.
+     */
+    list &_get_bucket_list(const size_type &idx)
+    {
+        piranha_assert(idx < bucket_count());
+        return ptr()[idx];
+    }
+    /// Clear bucket.
+    /**
+     * Destroy all the elements contained in the bucket positioned at index \p idx, and free the memory of
+     * the nodes of the bucket's list. This method will not update the number of elements in the set.
+     *
+     * It is safe to call this method concurrently from multiple threads, as long as each thread operates
+     * on a different bucket.
+     *
+     * @param idx index of the bucket to be cleared.
+     */
+    void _clear_bucket(const size_type &idx)
+    {
+        piranha_assert(idx < bucket_count());
+        auto &bucket = ptr()[idx];
+        if (!bucket.m_node.m_next) {
+            return;
+        }
+        // Detach the rest of the list, and destroy the payload of the first node, which lives in the bucket.
+        auto cur = bucket.m_node.m_next;
+        bucket.m_node.ptr()->~T();
+        bucket.m_node.m_next = nullptr;
+        // Destroy and free the remaining nodes.
+        while (cur != &bucket.terminator) {
+            const auto next = cur->m_next;
+            cur->ptr()->~T();
+            list::free_node(m_arena.get(), cur);
+            cur = next;
+        }
+        piranha_assert(bucket.empty());
+    }
     /// Erase element.
     /**
      * Erase the element to which \p it points. \p it must be a valid iterator
@@ -1396,7 +1489,7 @@ public:
                 // Move-construct from the second element, and then destroy it.
                 ::new (static_cast<void *>(&bucket.m_node.m_storage)) T(std::move(*bucket.m_node.m_next->ptr()));
                 bucket.m_node.m_next->ptr()->~T();
-                ::delete bucket.m_node.m_next;
+                list::free_node(m_arena.get(), bucket.m_node.m_next);
                 // Establish the new link.
                 bucket.m_node.m_next = tmp;
                 return bucket.begin();
@@ -1412,7 +1505,7 @@ public:
                     prev_b_it.m_ptr->m_next = b_it.m_ptr->m_next;
                     // Delete the current one.
                     b_it.m_ptr->ptr()->~T();
-                    ::delete b_it.m_ptr;
+                    list::free_node(m_arena.get(), b_it.m_ptr);
                     break;
                 };
             }
@@ -1430,6 +1523,7 @@ private:
     pack_type m_pack;
     size_type m_log2_size;
     size_type m_n_elements;
+    std::unique_ptr<arena_type> m_arena;
 };
 
 template <typename T, typename Hash, typename Pred>
@@ -1438,6 +1532,9 @@ typename hash_set<T, Hash, Pred>::node hash_set<T, Hash, Pred>::list::terminator
 template <typename T, typename Hash, typename Pred>
 const typename hash_set<T, Hash, Pred>::size_type hash_set<T, Hash, Pred>::m_n_nonzero_sizes;
 
+template <typename T, typename Hash, typename Pred>
+const typename hash_set<T, Hash, Pred>::size_type hash_set<T, Hash, Pred>::m_arena_min_buckets;
+
 #if defined(PIRANHA_WITH_BOOST_S11N)
 
 inline namespace impl
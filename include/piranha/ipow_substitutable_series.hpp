@@ -32,8 +32,11 @@ see https://www.gnu.org/licenses/. */
 #include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
+#include <piranha/config.hpp>
 #include <piranha/detail/init.hpp>
+#include <piranha/detail/multiplicative_subs.hpp>
 #include <piranha/forwarding.hpp>
 #include <piranha/integer.hpp>
 #include <piranha/series.hpp>
@@ -167,6 +170,55 @@ class ipow_substitutable_series : public Series, ipow_substitutable_series_tag
     // Enabler for the alternate overload.
     template <typename Int>
     using ipow_subs_int_enabler = enable_if_t<std::is_integral<Int>::value, int>;
+    // Batched substitution. If the substitution acts only on keys with multiplicative substitution, the terms
+    // are grouped according to the exponent of the substituted symbol, and the value of the substitution is
+    // computed once per group. See the implementation of subs() in substitutable_series for details.
+    template <typename T>
+    using ipow_subs_dummy_type =
+        typename std::conditional<key_has_ipow_subs<typename Series::term_type::key_type, integer>::value, integer,
+                                  T>::type;
+    template <typename T>
+    using batched_ipow_subs
+        = conjunction<std::integral_constant<bool, subs_term_score<typename Series::term_type, T>::value == 2u>,
+                      key_has_multiplicative_subs<typename Series::term_type::key_type>,
+                      std::is_constructible<ipow_subs_dummy_type<T>, const int &>>;
+    template <typename T>
+    ipow_subs_type<T> ipow_subs_dispatch(const symbol_idx &idx, const std::string &name, const integer &n, const T &x,
+                                         const std::false_type &) const
+    {
+        return this->template termwise_accumulate<ipow_subs_type<T>>(
+            [this, idx, &name, &n, &x](const typename Series::term_type &t) {
+                return subs_term_impl(t, idx, name, n, x, this->m_symbol_set);
+            });
+    }
+    template <typename T>
+    ipow_subs_type<T> ipow_subs_dispatch(const symbol_idx &idx, const std::string &name, const integer &n, const T &x,
+                                         const std::true_type &) const
+    {
+        using term_type = typename Series::term_type;
+        using key_type = typename term_type::key_type;
+        using m_size_type = std::vector<char>::size_type;
+        const auto &ss = this->m_symbol_set;
+        if (idx == ss.size()) {
+            // The symbol is not in the series, no point in grouping.
+            return ipow_subs_dispatch(idx, name, n, x, std::false_type{});
+        }
+        std::vector<char> mask(static_cast<m_size_type>(ss.size()), char(1));
+        mask[static_cast<m_size_type>(idx)] = char(0);
+        const auto p_ss = ss_trim(ss, mask);
+        const ipow_subs_dummy_type<T> one(1);
+        return this->template termwise_grouped_accumulate<ipow_subs_type<T>>(
+            [&ss, &mask, idx, &n, &one](const term_type &t) {
+                auto ksubs = t.m_key.ipow_subs(idx, n, one, ss);
+                piranha_assert(ksubs.size() == 1u);
+                return std::make_pair(t.m_key.trim(mask, ss), term_type(t.m_cf, std::move(ksubs[0u].second)));
+            },
+            [&p_ss, &n, &x](const key_type &k, const Derived &s) {
+                auto ksubs = k.ipow_subs(symbol_idx(0), n, x, p_ss);
+                piranha_assert(ksubs.size() == 1u);
+                return s * std::move(ksubs[0u].first);
+            });
+    }
 
 public:
     /// Defaulted default constructor.
@@ -208,7 +260,13 @@ public:
      * to compute the result.
      *
      * This method will return an object resulting from the substitution of the integral power of the symbol called \p
-     * name in \p this with the generic object \p x.
+     * name in \p this with the generic object \p x. The terms of large series are processed in parallel via
+     * piranha::series::termwise_accumulate().
+     *
+     * If only the keys are involved in the substitution, and the key type is a monomial type, the terms are
+     * grouped according to the exponent of the substituted symbol via
+     * piranha::series::termwise_grouped_accumulate(), so that the value of the substitution is computed once per
+     * group and multiplied by the sum of the terms in the group.
      *
      * @param name name of the symbol to be substituted.
      * @param n integral power of the symbol to be substituted.
@@ -225,11 +283,7 @@ public:
     ipow_subs_type<T> ipow_subs(const std::string &name, const integer &n, const T &x) const
     {
         const auto idx = ss_index_of(this->m_symbol_set, name);
-        ipow_subs_type<T> retval(0);
-        for (const auto &t : this->m_container) {
-            retval += subs_term_impl(t, idx, name, n, x, this->m_symbol_set);
-        }
-        return retval;
+        return ipow_subs_dispatch(idx, name, n, x, std::integral_constant<bool, batched_ipow_subs<T>::value>{});
     }
     /// Substitution.
     /**
@@ -50,6 +50,7 @@ see https://www.gnu.org/licenses/. */
 #include <piranha/detail/init.hpp>
 #include <piranha/detail/km_commons.hpp>
 #include <piranha/detail/monomial_common.hpp>
+#include <piranha/detail/multiplicative_subs.hpp>
 #include <piranha/detail/prepare_for_print.hpp>
 #include <piranha/detail/safe_integral_arith.hpp>
 #include <piranha/exceptions.hpp>
@@ -1150,6 +1151,15 @@ private:
 /// Alias for piranha::kronecker_monomial with default type.
 using k_monomial = kronecker_monomial<>;
 
+inline namespace impl
+{
+
+// The substitution methods of kronecker_monomial are multiplicative.
+template <typename T>
+struct key_has_multiplicative_subs<kronecker_monomial<T>> : std::true_type {
+};
+}
+
 // Implementation of piranha::key_is_one() for kronecker_monomial.
 template <typename T>
 class key_is_one_impl<kronecker_monomial<T>>
@@ -1162,6 +1172,28 @@ public:
         return !k.get_int();
     }
 };
+
+inline namespace impl
+{
+
+// Flat representation of kronecker_monomial for the flat data format: the internal integral instance.
+template <typename T>
+struct flat_key<kronecker_monomial<T>> {
+    using packed_type = T;
+    static std::uint64_t tag()
+    {
+        return 1u;
+    }
+    static packed_type pack(const kronecker_monomial<T> &k)
+    {
+        return k.get_int();
+    }
+    static kronecker_monomial<T> unpack(const packed_type &n)
+    {
+        return kronecker_monomial<T>(n);
+    }
+};
+}
 }
 
 #if defined(PIRANHA_WITH_BOOST_S11N)
@@ -0,0 +1,283 @@
+/* Copyright 2009-2017 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#ifndef PIRANHA_MAPPED_SERIES_HPP
+#define PIRANHA_MAPPED_SERIES_HPP
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <boost/iterator/iterator_facade.hpp>
+
+#include <piranha/config.hpp>
+#include <piranha/kronecker_monomial.hpp>
+#include <piranha/math.hpp>
+#include <piranha/real_trigonometric_kronecker_monomial.hpp>
+#include <piranha/s11n.hpp>
+#include <piranha/series.hpp>
+#include <piranha/symbol_utils.hpp>
+#include <piranha/type_traits.hpp>
+
+namespace piranha
+{
+
+/// Memory-mapped series.
+/**
+ * This class provides a read-only view of a series stored in a file in the piranha::data_format::flat_binary
+ * format. On platforms supporting <tt>mmap()</tt>, the file is mapped in memory and the terms are decoded on the fly
+ * from the mapped data, so that opening the file does not require reading its whole content nor rebuilding a
+ * series. On other platforms, the content of the file is read into a buffer.
+ *
+ * A memory-mapped series can be iterated over (the iterators yield the terms by value), evaluated and converted
+ * into a series via thaw(). Copies of a memory-mapped series share the same underlying view of the file.
+ *
+ * The flat format stores the symbol set of the series, the keys of the terms as packed integral values, and the
+ * coefficients as fixed-width values. It is a non-portable format intended for the temporary storage of large
+ * series (e.g., cached intermediate results). The header of the file records the byte order and the widths of the
+ * integral types of the platform, the version of the format and the coefficient and key types: files created on a
+ * platform with a different byte order or different type widths, or with an incompatible version of the format,
+ * are rejected when opened.
+ *
+ * ## Type requirements ##
+ *
+ * \p Series must satisfy piranha::is_series, its coefficient type must be an arithmetic type, and its key type
+ * must be either piranha::kronecker_monomial or piranha::real_trigonometric_kronecker_monomial.
+ *
+ * ## Exception safety guarantee ##
+ *
+ * Unless otherwise specified, this class provides the strong exception safety guarantee for all operations.
+ *
+ * ## Move semantics ##
+ *
+ * Move construction and move assignment will leave the moved-from object in an unspecified but valid state.
+ */
+template <typename Series>
+class mapped_series
+{
+    PIRANHA_TT_CHECK(is_series, Series);
+    static_assert(std::is_arithmetic<typename Series::term_type::cf_type>::value,
+                  "The coefficient type of a mapped series must be an arithmetic type.");
+    static_assert(is_detected<flat_key_packed_t, typename Series::term_type::key_type>::value,
+                  "The key type of a mapped series must be a Kronecker key.");
+
+public:
+    /// Alias for the series type.
+    using series_type = Series;
+    /// Alias for the term type.
+    using term_type = typename Series::term_type;
+    /// Size type.
+    using size_type = std::size_t;
+
+private:
+    using cf_type = typename term_type::cf_type;
+    using key_type = typename term_type::key_type;
+    // Decode the term at index i.
+    term_type term_at(size_type i) const
+    {
+        return flat_term_at<term_type>(m_content, i);
+    }
+
+public:
+    /// Const iterator type.
+    /**
+     * A random-access iterator which decodes the terms on the fly. The dereferencing operator returns the terms
+     * by value.
+     */
+    class const_iterator
+        : public boost::iterator_facade<const_iterator, term_type, boost::random_access_traversal_tag, term_type>
+    {
+        friend class mapped_series;
+        friend class boost::iterator_core_access;
+        explicit const_iterator(const mapped_series *ms, size_type idx) : m_ms(ms), m_idx(idx) {}
+        term_type dereference() const
+        {
+            return m_ms->term_at(m_idx);
+        }
+        bool equal(const const_iterator &other) const
+        {
+            return m_idx == other.m_idx;
+        }
+        void increment()
+        {
+            ++m_idx;
+        }
+        void decrement()
+        {
+            --m_idx;
+        }
+        void advance(std::ptrdiff_t n)
+        {
+            m_idx = static_cast<size_type>(static_cast<std::ptrdiff_t>(m_idx) + n);
+        }
+        std::ptrdiff_t distance_to(const const_iterator &other) const
+        {
+            return static_cast<std::ptrdiff_t>(other.m_idx) - static_cast<std::ptrdiff_t>(m_idx);
+        }
+
+    public:
+        /// Default constructor.
+        const_iterator() : m_ms(nullptr), m_idx(0u) {}
+
+    private:
+        const mapped_series *m_ms;
+        size_type m_idx;
+    };
+    /// Default constructor.
+    /**
+     * The mapped series will be empty and with an empty symbol set.
+     */
+    mapped_series() : m_content{symbol_fset{}, 0u, nullptr, nullptr} {}
+    /// Defaulted copy constructor.
+    mapped_series(const mapped_series &) = default;
+    /// Defaulted move constructor.
+    mapped_series(mapped_series &&) = default;
+    /// Constructor from file.
+    /**
+     * This constructor will open the file \p filename, which must have been created by piranha::save_file()
+     * with the piranha::data_format::flat_binary format from a series of type \p Series.
+     *
+     * @param filename the name of the file.
+     *
+     * @throws std::runtime_error if the file cannot be opened or mapped into memory.
+     * @throws std::invalid_argument if the header of the file is not valid, or if it is not consistent with the
+     * type \p Series, with the byte order and the integral type widths of the platform or with the size of the file.
+     * @throws unspecified any exception thrown by:
+     * - memory errors in standard containers,
+     * - the public interface of piranha::symbol_fset,
+     * - piranha::safe_cast().
+     */
+    explicit mapped_series(const std::string &filename)
+        : m_view(std::make_shared<const flat_file_view>(filename)),
+          m_content(flat_parse<key_type, cf_type>(*m_view, filename))
+    {
+    }
+    /// Copy assignment operator.
+    /**
+     * @param other the assignment argument.
+     *
+     * @return a reference to \p this.
+     *
+     * @throws unspecified any exception thrown by the copy constructor.
+     */
+    mapped_series &operator=(const mapped_series &other)
+    {
+        if (likely(this != &other)) {
+            *this = mapped_series(other);
+        }
+        return *this;
+    }
+    /// Defaulted move assignment operator.
+    mapped_series &operator=(mapped_series &&) = default;
+    /// Thaw.
+    /**
+     * The terms of the file are validated while being inserted into the series, and the terms with a zero
+     * coefficient are discarded.
+     *
+     * @return a series containing the same symbol set and terms as \p this.
+     *
+     * @throws std::invalid_argument if the file contains terms which are incompatible with its symbol set,
+     * or duplicate terms.
+     * @throws unspecified any exception thrown by:
+     * - the public interface of piranha::series and piranha::hash_set,
+     * - the constructor of the term type,
+     * - <tt>boost::numeric_cast()</tt>.
+     */
+    Series thaw() const
+    {
+        return flat_thaw<Series>(m_content);
+    }
+    /// Symbol set getter.
+    /**
+     * @return a const reference to the symbol set of \p this.
+     */
+    const symbol_fset &get_symbol_set() const
+    {
+        return m_content.m_symbol_set;
+    }
+    /// Size.
+    /**
+     * @return the number of terms in \p this.
+     */
+    size_type size() const
+    {
+        return m_content.m_size;
+    }
+    /// Empty test.
+    /**
+     * @return \p true if \p this does not contain any term, \p false otherwise.
+     */
+    bool empty() const
+    {
+        return !m_content.m_size;
+    }
+    /// Begin iterator.
+    /**
+     * @return an iterator to the first term of \p this.
+     */
+    const_iterator begin() const
+    {
+        return const_iterator(this, 0u);
+    }
+    /// End iterator.
+    /**
+     * @return an iterator to the end of the range of terms of \p this.
+     */
+    const_iterator end() const
+    {
+        return const_iterator(this, m_content.m_size);
+    }
+    /// Evaluation.
+    /**
+     * \note
+     * This method is enabled only if \p Series is evaluable with objects of type \p T.
+     *
+     * The semantics of this method are the same as those of piranha::math::evaluate() for \p Series. The terms
+     * are decoded one at a time from the underlying file view.
+     *
+     * @param dict the dictionary that will be used for evaluation.
+     *
+     * @return the result of evaluating \p this according to \p dict.
+     *
+     * @throws unspecified any exception thrown by piranha::math::evaluate() for \p Series.
+     */
+    template <typename T, enable_if_t<is_evaluable<Series, T>::value, int> = 0>
+    series_eval_type<Series, T> evaluate(const symbol_fmap<T> &dict) const
+    {
+        return math::evaluate_impl<Series, T>{}.evaluate_terms(m_content.m_symbol_set, *this, dict);
+    }
+
+private:
+    std::shared_ptr<const flat_file_view> m_view;
+    flat_content m_content;
+};
+}
+
+#endif
@@ -53,6 +53,7 @@ see https://www.gnu.org/licenses/. */
 #include <piranha/detail/cf_mult_impl.hpp>
 #include <piranha/detail/init.hpp>
 #include <piranha/detail/monomial_common.hpp>
+#include <piranha/detail/multiplicative_subs.hpp>
 #include <piranha/detail/prepare_for_print.hpp>
 #include <piranha/detail/safe_integral_arith.hpp>
 #include <piranha/exceptions.hpp>
@@ -1204,6 +1205,15 @@ public:
 template <typename T, typename S>
 const std::size_t monomial<T, S>::multiply_arity;
 
+inline namespace impl
+{
+
+// The substitution methods of monomial are multiplicative.
+template <typename T, typename S>
+struct key_has_multiplicative_subs<monomial<T, S>> : std::true_type {
+};
+}
+
 // Implementation of piranha::key_is_one() for monomial.
 template <typename T, typename S>
 class key_is_one_impl<monomial<T, S>>
@@ -0,0 +1,735 @@
+/* Copyright 2009-2017 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#ifndef PIRANHA_OA_HASH_SET_HPP
+#define PIRANHA_OA_HASH_SET_HPP
+
+#include <algorithm>
+#include <boost/iterator/iterator_facade.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include <piranha/config.hpp>
+#include <piranha/exceptions.hpp>
+#include <piranha/type_traits.hpp>
+
+namespace piranha
+{
+
+/// Open-addressing hash set.
+/**
+ * Hash set class with an interface similar to piranha::hash_set. The implementation employs open addressing
+ * with linear probing and the Robin Hood displacement strategy: the elements are stored directly in a flat array
+ * of slots, and a parallel array records, for each occupied slot, the distance of the element from its
+ * destination bucket. On insertion, an element displaces any element which is closer to its own destination
+ * bucket, so that the variance of the probe lengths is kept small. Erasure uses backward shifting, so that
+ * no tombstones are needed.
+ *
+ * Compared to piranha::hash_set, no memory allocation is needed for colliding elements, lookups scan contiguous
+ * memory, and the table can be operated at higher load factors without degrading into linked list traversals.
+ * On the other hand, elements move around on insertion and erasure, and a bucket index identifies only the
+ * starting point of a probe sequence (the elements with the same destination bucket are not guaranteed
+ * to be stored in that bucket). Hence, this class does not provide the bucket-list interface of
+ * piranha::hash_set, and it cannot be used in the algorithms which partition a table in bucket ranges
+ * among multiple threads.
+ *
+ * The low-level methods _bucket(), _bucket_from_hash(), _find() and _unique_insert() have the same signatures
+ * as in piranha::hash_set, so that this class can be used as a drop-in replacement in the single-threaded
+ * parts of the series multiplication algorithms. Note however that, unlike in piranha::hash_set,
+ * _unique_insert() will update the number of elements and it will grow the table if needed.
+ *
+ * The sizes of the table are powers of two.
+ *
+ * ## Type requirements ##
+ *
+ * - \p T must satisfy piranha::is_container_element,
+ * - \p Hash must satisfy piranha::is_hash_function_object,
+ * - \p Pred must satisfy piranha::is_equality_function_object.
+ *
+ * ## Exception safety guarantee ##
+ *
+ * This class provides the strong exception safety guarantee for all operations apart from methods involving insertion,
+ * which provide the basic guarantee (after a failed insertion, the set will be left in an unspecified but valid state).
+ *
+ * ## Move semantics ##
+ *
+ * Move construction and move assignment will leave the moved-from object equivalent to an empty set whose hasher and
+ * equality predicate have been moved-from.
+ */
+template <typename T, typename Hash = std::hash<T>, typename Pred = std::equal_to<T>>
+class oa_hash_set
+{
+    PIRANHA_TT_CHECK(is_container_element, T);
+    PIRANHA_TT_CHECK(is_hash_function_object, Hash, T);
+    PIRANHA_TT_CHECK(is_equality_function_object, Pred, T);
+    // Storage for a single element.
+    using storage_type = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+    // Type used to record the probe distances. A value of zero signals an empty slot, otherwise the value
+    // is the distance from the destination bucket plus one.
+    // NOTE: the number of slots is limited to the maximum value of dist_type, so that the probe distances
+    // (which are always less than the number of slots) cannot overflow.
+    using dist_type = std::uint_least32_t;
+
+public:
+    /// Functor type for the calculation of hash values.
+    using hasher = Hash;
+    /// Functor type for comparing the items in the set.
+    using key_equal = Pred;
+    /// Key type.
+    using key_type = T;
+    /// Size type.
+    /**
+     * Alias for \p std::size_t.
+     */
+    using size_type = std::size_t;
+
+private:
+    // Index value representing the end of the table.
+    static const size_type s_end_idx = std::numeric_limits<size_type>::max();
+    // Read-only iterator.
+    class iterator_impl : public boost::iterator_facade<iterator_impl, T const, boost::forward_traversal_tag>
+    {
+        friend class oa_hash_set;
+
+    public:
+        iterator_impl() : m_set(nullptr), m_idx(s_end_idx) {}
+        explicit iterator_impl(oa_hash_set const *set, const size_type &idx) : m_set(set), m_idx(idx) {}
+
+    private:
+        friend class boost::iterator_core_access;
+        void increment()
+        {
+            piranha_assert(m_set && m_idx < m_set->m_capacity);
+            m_idx = m_set->next_occupied(static_cast<size_type>(m_idx + 1u));
+        }
+        bool equal(const iterator_impl &other) const
+        {
+            // NOTE: comparing iterators from different containers is UB
+            // in the standard.
+            piranha_assert(m_set == other.m_set || !m_set || !other.m_set);
+            return m_idx == other.m_idx;
+        }
+        T const &dereference() const
+        {
+            piranha_assert(m_set && m_idx < m_set->m_capacity && m_set->m_dists[m_idx]);
+            return *m_set->slot_ptr(m_idx);
+        }
+        oa_hash_set const *m_set;
+        size_type m_idx;
+    };
+    // Pointers to the elements.
+    T *slot_ptr(const size_type &idx)
+    {
+        return static_cast<T *>(static_cast<void *>(&m_slots[idx]));
+    }
+    const T *slot_ptr(const size_type &idx) const
+    {
+        return static_cast<const T *>(static_cast<const void *>(&m_slots[idx]));
+    }
+    // Index of the first occupied slot starting from idx, or s_end_idx.
+    size_type next_occupied(size_type idx) const
+    {
+        for (; idx < m_capacity; ++idx) {
+            if (m_dists[idx]) {
+                return idx;
+            }
+        }
+        return s_end_idx;
+    }
+    // Maximum number of elements before the table is grown (a load factor of 7/8).
+    size_type max_elements() const
+    {
+        return static_cast<size_type>(m_capacity - m_capacity / 8u);
+    }
+    // Maximum number of slots (the largest power of two representable by both size_type and dist_type).
+    static size_type max_capacity()
+    {
+        const auto max_dist = static_cast<std::uintmax_t>(std::numeric_limits<dist_type>::max());
+        const auto max_size = static_cast<std::uintmax_t>(std::numeric_limits<size_type>::max());
+        return static_cast<size_type>((std::min(max_dist, max_size) >> 1u) + 1u);
+    }
+    // Smallest power of two not less than n (zero if n is zero).
+    static size_type capacity_from_hint(const size_type &n)
+    {
+        if (!n) {
+            return 0u;
+        }
+        if (unlikely(n > max_capacity())) {
+            piranha_throw(std::bad_alloc, );
+        }
+        size_type retval = 1u;
+        while (retval < n) {
+            retval = static_cast<size_type>(retval * 2u);
+        }
+        return retval;
+    }
+    // Allocate storage for the given capacity. Must be called on a set with no storage.
+    void allocate(const size_type &capacity)
+    {
+        piranha_assert(!m_capacity && !m_slots && !m_dists);
+        if (!capacity) {
+            return;
+        }
+        std::unique_ptr<storage_type[]> slots(new storage_type[capacity]);
+        m_dists.reset(new dist_type[capacity]());
+        m_slots = std::move(slots);
+        m_capacity = capacity;
+    }
+    // Destroy all the elements and release the storage.
+    void destroy_and_deallocate()
+    {
+        for (size_type i = 0u; i < m_capacity; ++i) {
+            if (m_dists[i]) {
+                slot_ptr(i)->~T();
+                m_dists[i] = 0u;
+            }
+        }
+        m_slots.reset();
+        m_dists.reset();
+        m_capacity = 0u;
+        m_n_elements = 0u;
+    }
+    template <typename U>
+    using insert_enabler = enable_if_t<std::is_same<T, uncvref_t<U>>::value, int>;
+
+public:
+    /// Iterator type.
+    /**
+     * A read-only forward iterator.
+     */
+    using iterator = iterator_impl;
+
+private:
+    // Static checks on the iterator type.
+    PIRANHA_TT_CHECK(is_forward_iterator, iterator);
+
+public:
+    /// Const iterator type.
+    /**
+     * Equivalent to the iterator type.
+     */
+    using const_iterator = iterator;
+    /// Default constructor.
+    /**
+     * If not specified, it will default-initialise the hasher and the equality predicate. The resulting
+     * hash set will be empty.
+     *
+     * @param h hasher functor.
+     * @param k equality predicate.
+     *
+     * @throws unspecified any exception thrown by the copy constructors of <tt>Hash</tt> or <tt>Pred</tt>.
+     */
+    oa_hash_set(const hasher &h = hasher{}, const key_equal &k = key_equal{})
+        : m_hasher(h), m_key_equal(k), m_capacity(0u), m_n_elements(0u)
+    {
+    }
+    /// Constructor from number of buckets.
+    /**
+     * Will construct a set whose number of buckets is at least equal to \p n_buckets.
+     *
+     * @param n_buckets desired number of buckets.
+     * @param h hasher functor.
+     * @param k equality predicate.
+     *
+     * @throws std::bad_alloc if the desired number of buckets is greater than an implementation-defined maximum, or in
+     * case of memory errors.
+     * @throws unspecified any exception thrown by the copy constructors of <tt>Hash</tt> or <tt>Pred</tt>.
+     */
+    explicit oa_hash_set(const size_type &n_buckets, const hasher &h = hasher{}, const key_equal &k = key_equal{})
+        : m_hasher(h), m_key_equal(k), m_capacity(0u), m_n_elements(0u)
+    {
+        allocate(capacity_from_hint(n_buckets));
+    }
+    /// Copy constructor.
+    /**
+     * The hasher and the equality comparator will also be copied. The elements are stored in the same positions
+     * as in \p other.
+     *
+     * @param other piranha::oa_hash_set that will be copied into \p this.
+     *
+     * @throws unspecified any exception thrown by memory allocation errors,
+     * the copy constructor of the stored type, <tt>Hash</tt> or <tt>Pred</tt>.
+     */
+    oa_hash_set(const oa_hash_set &other)
+        : m_hasher(other.m_hasher), m_key_equal(other.m_key_equal), m_capacity(0u), m_n_elements(0u)
+    {
+        allocate(other.m_capacity);
+        try {
+            for (size_type i = 0u; i < m_capacity; ++i) {
+                if (other.m_dists[i]) {
+                    ::new (static_cast<void *>(&m_slots[i])) T(*other.slot_ptr(i));
+                    m_dists[i] = other.m_dists[i];
+                }
+            }
+        } catch (...) {
+            destroy_and_deallocate();
+            throw;
+        }
+        m_n_elements = other.m_n_elements;
+    }
+    /// Move constructor.
+    /**
+     * After the move, \p other will have zero buckets and zero elements, and its hasher and equality predicate
+     * will have been used to move-construct their counterparts in \p this.
+     *
+     * @param other set to be moved.
+     */
+    oa_hash_set(oa_hash_set &&other) noexcept : m_hasher(std::move(other.m_hasher)),
+                                                m_key_equal(std::move(other.m_key_equal)),
+                                                m_slots(std::move(other.m_slots)),
+                                                m_dists(std::move(other.m_dists)),
+                                                m_capacity(other.m_capacity),
+                                                m_n_elements(other.m_n_elements)
+    {
+        other.m_capacity = 0u;
+        other.m_n_elements = 0u;
+    }
+    /// Copy assignment operator.
+    /**
+     * @param other assignment argument.
+     *
+     * @return reference to \p this.
+     *
+     * @throws unspecified any exception thrown by the copy constructor.
+     */
+    oa_hash_set &operator=(const oa_hash_set &other)
+    {
+        if (likely(this != &other)) {
+            oa_hash_set tmp(other);
+            *this = std::move(tmp);
+        }
+        return *this;
+    }
+    /// Move assignment operator.
+    /**
+     * @param other set to be moved into \p this.
+     *
+     * @return reference to \p this.
+     */
+    oa_hash_set &operator=(oa_hash_set &&other) noexcept
+    {
+        if (likely(this != &other)) {
+            destroy_and_deallocate();
+            m_hasher = std::move(other.m_hasher);
+            m_key_equal = std::move(other.m_key_equal);
+            m_slots = std::move(other.m_slots);
+            m_dists = std::move(other.m_dists);
+            m_capacity = other.m_capacity;
+            m_n_elements = other.m_n_elements;
+            other.m_capacity = 0u;
+            other.m_n_elements = 0u;
+        }
+        return *this;
+    }
+    /// Destructor.
+    ~oa_hash_set()
+    {
+        destroy_and_deallocate();
+    }
+    /// Const begin iterator.
+    /**
+     * @return oa_hash_set::const_iterator to the first element of the set, or end() if the set is empty.
+     */
+    const_iterator begin() const
+    {
+        return const_iterator(this, next_occupied(0u));
+    }
+    /// Const end iterator.
+    /**
+     * @return oa_hash_set::const_iterator to the position past the last element of the set.
+     */
+    const_iterator end() const
+    {
+        return const_iterator(this, s_end_idx);
+    }
+    /// Number of elements contained in the set.
+    /**
+     * @return number of elements in the set.
+     */
+    size_type size() const
+    {
+        return m_n_elements;
+    }
+    /// Test for empty set.
+    /**
+     * @return \p true if size() returns 0, \p false otherwise.
+     */
+    bool empty() const
+    {
+        return !size();
+    }
+    /// Number of buckets.
+    /**
+     * @return number of buckets (i.e., slots) in the set.
+     */
+    size_type bucket_count() const
+    {
+        return m_capacity;
+    }
+    /// Load factor.
+    /**
+     * @return <tt>(double)size() / bucket_count()</tt>, or 0 if the number of buckets is zero.
+     */
+    double load_factor() const
+    {
+        return m_capacity ? static_cast<double>(m_n_elements) / static_cast<double>(m_capacity) : 0.;
+    }
+    /// Maximum load factor.
+    /**
+     * @return the maximum load factor allowed before a resize.
+     */
+    double max_load_factor() const
+    {
+        return .875;
+    }
+    /// Index of destination bucket.
+    /**
+     * @param k input argument.
+     *
+     * @return index of the destination bucket for \p k (i.e., the first slot of its probe sequence).
+     *
+     * @throws std::invalid_argument if bucket_count() returns zero.
+     * @throws unspecified any exception thrown by _bucket().
+     */
+    size_type bucket(const key_type &k) const
+    {
+        if (unlikely(!m_capacity)) {
+            piranha_throw(std::invalid_argument, "cannot calculate bucket index in an empty set");
+        }
+        return _bucket(k);
+    }
+    /// Find element.
+    /**
+     * @param k element to be located.
+     *
+     * @return oa_hash_set::const_iterator to <tt>k</tt>'s position in the set, or end() if \p k is not in the set.
+     *
+     * @throws unspecified any exception thrown by _find() or by _bucket().
+     */
+    const_iterator find(const key_type &k) const
+    {
+        if (unlikely(!m_capacity)) {
+            return end();
+        }
+        return _find(k, _bucket(k));
+    }
+    /// Insert element.
+    /**
+     * \note
+     * This method is enabled only if \p U is the same as \p T, after the removal of cv/reference qualifiers.
+     *
+     * If no other key equivalent to \p k exists in the set, the insertion is successful and returns the
+     * <tt>(it,true)</tt> pair - where \p it is the position in the set into which the object has been inserted.
+     * Otherwise, the return value will be <tt>(it,false)</tt> - where \p it is the position of the existing equivalent
+     * object.
+     *
+     * @param k object that will be inserted into the set.
+     *
+     * @return <tt>(oa_hash_set::iterator,bool)</tt> pair containing an iterator to the newly-inserted object (or its
+     * existing equivalent) and the result of the operation.
+     *
+     * @throws unspecified any exception thrown by _find(), _bucket() or _unique_insert().
+     */
+    template <typename U, insert_enabler<U> = 0>
+    std::pair<iterator, bool> insert(U &&k)
+    {
+        if (unlikely(!m_capacity)) {
+            _increase_size();
+        }
+        const auto bucket_idx = _bucket(k);
+        const auto it = _find(k, bucket_idx);
+        if (it != end()) {
+            return std::make_pair(it, false);
+        }
+        return std::make_pair(_unique_insert(std::forward<U>(k), bucket_idx), true);
+    }
+    /// Erase element.
+    /**
+     * Erase the element to which \p it points. \p it must be a valid iterator pointing to an element of the set.
+     * The elements following the erased one in its probe sequence are shifted backwards, hence all iterators
+     * will be invalidated by this operation.
+     *
+     * @param it iterator to the element of the set to be removed.
+     */
+    void erase(const_iterator it)
+    {
+        piranha_assert(it.m_set == this && it.m_idx < m_capacity && m_dists[it.m_idx]);
+        const size_type mask = static_cast<size_type>(m_capacity - 1u);
+        auto idx = it.m_idx;
+        slot_ptr(idx)->~T();
+        m_dists[idx] = 0u;
+        // Shift backwards the elements which are not in their destination bucket.
+        for (auto next = static_cast<size_type>((idx + 1u) & mask); m_dists[next] > 1u;
+             idx = next, next = static_cast<size_type>((next + 1u) & mask)) {
+            ::new (static_cast<void *>(&m_slots[idx])) T(std::move(*slot_ptr(next)));
+            slot_ptr(next)->~T();
+            m_dists[idx] = static_cast<dist_type>(m_dists[next] - 1u);
+            m_dists[next] = 0u;
+        }
+        --m_n_elements;
+    }
+    /// Remove all elements.
+    /**
+     * After this call, size() and bucket_count() will both return zero.
+     */
+    void clear()
+    {
+        destroy_and_deallocate();
+    }
+    /// Swap content.
+    /**
+     * Will use \p std::swap to swap hasher and equality predicate.
+     *
+     * @param other swap argument.
+     *
+     * @throws unspecified any exception thrown by swapping hasher or equality predicate via \p std::swap.
+     */
+    void swap(oa_hash_set &other)
+    {
+        std::swap(m_hasher, other.m_hasher);
+        std::swap(m_key_equal, other.m_key_equal);
+        std::swap(m_slots, other.m_slots);
+        std::swap(m_dists, other.m_dists);
+        std::swap(m_capacity, other.m_capacity);
+        std::swap(m_n_elements, other.m_n_elements);
+    }
+    /// Rehash set.
+    /**
+     * Change the number of buckets in the set to at least \p new_size. No rehash is performed
+     * if rehashing would lead to exceeding the maximum load factor.
+     *
+     * @param new_size new desired number of buckets.
+     *
+     * @throws unspecified any exception thrown by the constructor from number of buckets,
+     * _unique_insert() or _bucket().
+     */
+    void rehash(const size_type &new_size)
+    {
+        // If rehash is requested to zero, do something only if there are no items stored in the set.
+        if (!new_size) {
+            if (!size()) {
+                clear();
+            }
+            return;
+        }
+        // Do nothing if rehashing to the new size would lead to exceeding the max load factor.
+        if (static_cast<double>(size()) / static_cast<double>(new_size) > max_load_factor()) {
+            return;
+        }
+        oa_hash_set new_set(new_size, m_hasher, m_key_equal);
+        if (unlikely(new_set.max_elements() < m_n_elements)) {
+            // This can happen because of the rounding in max_elements(), grow one more time.
+            new_set._increase_size();
+        }
+        try {
+            for (size_type i = 0u; i < m_capacity; ++i) {
+                if (m_dists[i]) {
+                    const auto new_idx = new_set._bucket(*slot_ptr(i));
+                    new_set._unique_insert(std::move(*slot_ptr(i)), new_idx);
+                }
+            }
+        } catch (...) {
+            // Clear up both this and the new set upon any kind of error.
+            clear();
+            new_set.clear();
+            throw;
+        }
+        *this = std::move(new_set);
+    }
+    /** @name Low-level interface
+     * Low-level methods and types.
+     */
+    //@{
+    /// Insert unique element (low-level).
+    /**
+     * \note
+     * This method is enabled only if \p U is the same as \p T, after the removal of cv/reference qualifiers.
+     *
+     * This method will insert \p k into the set, starting the probe sequence from the bucket at index
+     * \p bucket_idx. It is assumed that \p k is not already present in the set, and that \p bucket_idx
+     * is the output of _bucket() for \p k.
+     *
+     * Unlike piranha::hash_set::_unique_insert(), this method will increase the number of elements in the set
+     * and, if the insertion would result in exceeding the maximum load factor, it will first grow the table
+     * (in which case \p bucket_idx is ignored and recomputed). The other elements of the set might be moved
+     * to different slots as a result of the insertion, hence all iterators are invalidated.
+     *
+     * @param k object that will be inserted into the set.
+     * @param bucket_idx destination bucket for \p k.
+     *
+     * @return iterator pointing to the newly-inserted element.
+     *
+     * @throws unspecified any exception thrown by the copy constructor of oa_hash_set::key_type, by _bucket() or by
+     * memory allocation errors.
+     */
+    template <typename U, insert_enabler<U> = 0>
+    iterator _unique_insert(U &&k, size_type bucket_idx)
+    {
+        // Assert that key is not present already in the set.
+        piranha_assert(find(k) == end());
+        if (unlikely(m_n_elements >= max_elements())) {
+            _increase_size();
+            bucket_idx = _bucket(k);
+        }
+        // Assert bucket index is correct.
+        piranha_assert(bucket_idx == _bucket(k));
+        const size_type mask = static_cast<size_type>(m_capacity - 1u);
+        auto idx = bucket_idx;
+        dist_type d = 1u;
+        // Find the destination of k: either the first empty slot, or the first slot whose element
+        // is closer to its destination bucket than k.
+        while (true) {
+            if (!m_dists[idx]) {
+                ::new (static_cast<void *>(&m_slots[idx])) T(std::forward<U>(k));
+                m_dists[idx] = d;
+                ++m_n_elements;
+                return iterator(this, idx);
+            }
+            if (m_dists[idx] < d) {
+                break;
+            }
+            idx = static_cast<size_type>((idx + 1u) & mask);
+            ++d;
+        }
+        // k takes the place of the element in idx, which is then carried forward along the probe sequence,
+        // displacing other elements as needed.
+        // NOTE: after the construction of carry, all the operations are noexcept.
+        const auto retval = idx;
+        T carry(std::forward<U>(k));
+        while (true) {
+            if (!m_dists[idx]) {
+                ::new (static_cast<void *>(&m_slots[idx])) T(std::move(carry));
+                m_dists[idx] = d;
+                break;
+            }
+            if (m_dists[idx] < d) {
+                T tmp(std::move(*slot_ptr(idx)));
+                *slot_ptr(idx) = std::move(carry);
+                carry = std::move(tmp);
+                std::swap(m_dists[idx], d);
+            }
+            idx = static_cast<size_type>((idx + 1u) & mask);
+            ++d;
+        }
+        ++m_n_elements;
+        return iterator(this, retval);
+    }
+    /// Find element (low-level).
+    /**
+     * Locate element in the set. The parameter \p bucket_idx is the index of the destination bucket for \p k and, for
+     * a set with a nonzero number of buckets, must be equal to the output of bucket(). This method will not check if
+     * the value of \p bucket_idx is correct.
+     *
+     * @param k element to be located.
+     * @param bucket_idx index of the destination bucket for \p k.
+     *
+     * @return oa_hash_set::iterator to <tt>k</tt>'s position in the set, or end() if \p k is not in the set.
+     *
+     * @throws unspecified any exception thrown by calling the equality predicate.
+     */
+    const_iterator _find(const key_type &k, const size_type &bucket_idx) const
+    {
+        // Assert bucket index is correct.
+        piranha_assert(bucket_idx == _bucket(k) && bucket_idx < bucket_count());
+        const size_type mask = static_cast<size_type>(m_capacity - 1u);
+        auto idx = bucket_idx;
+        // NOTE: the Robin Hood invariant ensures that, if k is in the set, all the slots between
+        // its destination bucket and its position hold elements at a distance not smaller than
+        // the current one. This loop always terminates, as the load factor is less than one.
+        for (std::size_t d = 1u; m_dists[idx] >= d; idx = static_cast<size_type>((idx + 1u) & mask), ++d) {
+            if (m_dists[idx] == d && m_key_equal(*slot_ptr(idx), k)) {
+                return const_iterator(this, idx);
+            }
+        }
+        return end();
+    }
+    /// Index of destination bucket from hash value.
+    /**
+     * Note that this method will not check if the number of buckets is zero.
+     *
+     * @param hash input hash value.
+     *
+     * @return index of the destination bucket for an object with hash value \p hash.
+     */
+    size_type _bucket_from_hash(const std::size_t &hash) const
+    {
+        piranha_assert(bucket_count());
+        return hash & (m_capacity - 1u);
+    }
+    /// Index of destination bucket (low-level).
+    /**
+     * Equivalent to bucket(), with the exception that this method will not check
+     * if the number of buckets is zero.
+     *
+     * @param k input argument.
+     *
+     * @return index of the destination bucket for \p k.
+     *
+     * @throws unspecified any exception thrown by the call operator of the hasher.
+     */
+    size_type _bucket(const key_type &k) const
+    {
+        return _bucket_from_hash(m_hasher(k));
+    }
+    /// Increase bucket count.
+    /**
+     * Increase the number of buckets to the next implementation-defined value.
+     *
+     * @throws std::bad_alloc if the operation results in a resize of the set past an implementation-defined
+     * maximum number of buckets.
+     * @throws unspecified any exception thrown by rehash().
+     */
+    void _increase_size()
+    {
+        if (unlikely(m_capacity >= max_capacity())) {
+            piranha_throw(std::bad_alloc, );
+        }
+        rehash(m_capacity ? static_cast<size_type>(m_capacity * 2u) : size_type(1u));
+    }
+    //@}
+private:
+    hasher m_hasher;
+    key_equal m_key_equal;
+    std::unique_ptr<storage_type[]> m_slots;
+    std::unique_ptr<dist_type[]> m_dists;
+    size_type m_capacity;
+    size_type m_n_elements;
+};
+
+template <typename T, typename Hash, typename Pred>
+const typename oa_hash_set<T, Hash, Pred>::size_type oa_hash_set<T, Hash, Pred>::s_end_idx;
+}
+
+#endif
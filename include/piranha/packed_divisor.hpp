@@ -0,0 +1,1102 @@
+/* Copyright 2009-2017 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#ifndef PIRANHA_PACKED_DIVISOR_HPP
+#define PIRANHA_PACKED_DIVISOR_HPP
+
+#include <algorithm>
+#include <array>
+#include <boost/functional/hash.hpp>
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <piranha/config.hpp>
+#include <piranha/detail/cf_mult_impl.hpp>
+#include <piranha/detail/divisor_series_fwd.hpp>
+#include <piranha/detail/init.hpp>
+#include <piranha/detail/km_commons.hpp>
+#include <piranha/detail/prepare_for_print.hpp>
+#include <piranha/divisor.hpp>
+#include <piranha/exceptions.hpp>
+#include <piranha/is_cf.hpp>
+#include <piranha/is_key.hpp>
+#include <piranha/key/key_is_one.hpp>
+#include <piranha/kronecker_array.hpp>
+#include <piranha/math.hpp>
+#include <piranha/math/gcd3.hpp>
+#include <piranha/math/is_one.hpp>
+#include <piranha/math/is_zero.hpp>
+#include <piranha/math/pow.hpp>
+#include <piranha/s11n.hpp>
+#include <piranha/safe_cast.hpp>
+#include <piranha/small_vector.hpp>
+#include <piranha/static_vector.hpp>
+#include <piranha/symbol_utils.hpp>
+#include <piranha/term.hpp>
+#include <piranha/type_traits.hpp>
+
+namespace piranha
+{
+
+inline namespace impl
+{
+
+// Pair code-exponent, for use in the packed_divisor class.
+template <typename T>
+struct packed_divisor_p_type {
+    packed_divisor_p_type() : code(0), e(0) {}
+    explicit packed_divisor_p_type(const T &code_, const T &e_) : code(code_), e(e_) {}
+    bool operator==(const packed_divisor_p_type &other) const
+    {
+        return code == other.code && e == other.e;
+    }
+    bool operator!=(const packed_divisor_p_type &other) const
+    {
+        return !(*this == other);
+    }
+#if defined(PIRANHA_WITH_BOOST_S11N)
+    // Boost serialization support.
+    template <class Archive>
+    void save(Archive &ar, unsigned) const
+    {
+        boost_save(ar, code);
+        boost_save(ar, e);
+    }
+    template <class Archive>
+    void load(Archive &ar, unsigned)
+    {
+        boost_load(ar, code);
+        boost_load(ar, e);
+    }
+    BOOST_SERIALIZATION_SPLIT_MEMBER()
+#endif
+    // Members.
+    T code;
+    T e;
+};
+}
+
+#if defined(PIRANHA_WITH_BOOST_S11N)
+
+// Serialization methods for the packed divisor's pair type. Not documented because they are implementation details.
+template <typename Archive, typename T>
+struct boost_save_impl<Archive, packed_divisor_p_type<T>, enable_if_t<has_boost_save<Archive, T>::value>>
+    : boost_save_via_boost_api<Archive, packed_divisor_p_type<T>> {
+};
+
+template <typename Archive, typename T>
+struct boost_load_impl<Archive, packed_divisor_p_type<T>, enable_if_t<has_boost_load<Archive, T>::value>>
+    : boost_load_via_boost_api<Archive, packed_divisor_p_type<T>> {
+};
+
+#endif
+
+#if defined(PIRANHA_WITH_MSGPACK)
+
+template <typename Stream, typename T>
+struct msgpack_pack_impl<Stream, packed_divisor_p_type<T>,
+                         enable_if_t<conjunction<is_msgpack_stream<Stream>, has_msgpack_pack<Stream, T>>::value>> {
+    void operator()(msgpack::packer<Stream> &pk, const packed_divisor_p_type<T> &p, msgpack_format f) const
+    {
+        pk.pack_array(2);
+        msgpack_pack(pk, p.code, f);
+        msgpack_pack(pk, p.e, f);
+    }
+};
+
+template <typename T>
+struct msgpack_convert_impl<packed_divisor_p_type<T>, enable_if_t<has_msgpack_convert<T>::value>> {
+    void operator()(packed_divisor_p_type<T> &p, const msgpack::object &o, msgpack_format f) const
+    {
+        std::array<msgpack::object, 2> tmp;
+        o.convert(tmp);
+        msgpack_convert(p.code, tmp[0], f);
+        msgpack_convert(p.e, tmp[1], f);
+    }
+};
+
+#endif
+
+/// Packed divisor class.
+/**
+ * This class represents the same mathematical objects as piranha::divisor, that is, keys of the form
+ * \f[
+ * \prod_j\frac{1}{\left(a_{0,j}x_0+a_{1,j}x_1+\ldots+a_{n,j}x_n\right)^{e_j}},
+ * \f]
+ * but with a compact memory layout. Each vector of \f$ a_{i,j} \f$ is encoded into a single instance of \p T via
+ * piranha::kronecker_array, and the resulting (code, exponent) pairs are stored, sorted by code, in a
+ * piranha::small_vector. For the typical divisor with few factors, no dynamic memory is allocated, equality is an
+ * elementwise comparison and the hash value is computed directly from the codes.
+ *
+ * The factors satisfy the same canonical form of piranha::divisor. Since the codes do not record the number of
+ * symbols, it is the responsibility of the user to insert only factors whose size matches the reference
+ * piranha::symbol_fset. The range of the \f$ a_{i,j} \f$ is limited by the Kronecker codification (see
+ * piranha::kronecker_array::get_limits()), and it shrinks as the number of symbols grows.
+ *
+ * This class can be used as an alternative key type in piranha::divisor_series.
+ *
+ * ## Type requirements ##
+ *
+ * \p T must be a C++ signed integral type.
+ *
+ * ## Exception safety guarantee ##
+ *
+ * Unless otherwise specified, this class provides the strong exception safety guarantee for all operations.
+ *
+ * ## Move semantics ##
+ *
+ * Move semantics is equivalent to the move semantics of piranha::small_vector.
+ */
+template <typename T>
+class packed_divisor
+{
+    static_assert(std::is_signed<T>::value && std::is_integral<T>::value, "The value type must be a signed integer");
+    // Make friend with the divisor series.
+    template <typename, typename>
+    friend class divisor_series;
+
+public:
+    /// Alias for \p T.
+    using value_type = T;
+
+private:
+    using p_type = packed_divisor_p_type<value_type>;
+    using ka = kronecker_array<value_type>;
+    // Type used for unpacking the factors.
+    using v_type = static_vector<value_type, 255u>;
+
+public:
+    /// Underlying container type.
+    using container_type = small_vector<p_type>;
+    /// Size type.
+    /**
+     * It corresponds to the size type of the internal container.
+     */
+    using size_type = typename container_type::size_type;
+    /// Arity of the multiply() method.
+    static const std::size_t multiply_arity = 1u;
+
+private:
+    // Canonical factor: the first nonzero element is positive and the gcd of all elements is 1.
+    // NOTE: the elements are within the Kronecker limits, hence the gcd computation is safe.
+    static bool factor_is_canonical(const v_type &v)
+    {
+        bool first_nonzero_found = false;
+        value_type cd(0);
+        for (const auto &n : v) {
+            if (!first_nonzero_found && !piranha::is_zero(n)) {
+                if (n < 0) {
+                    return false;
+                }
+                first_nonzero_found = true;
+            }
+            piranha::gcd3(cd, cd, n);
+        }
+        return piranha::is_one(cd);
+    }
+    static bool p_type_less(const p_type &a, const p_type &b)
+    {
+        return a.code < b.code;
+    }
+    bool destruction_checks() const
+    {
+        for (auto it = m_container.begin(); it != m_container.end(); ++it) {
+            // Check: the exponent must be greater than zero.
+            if (it->e <= 0) {
+                return false;
+            }
+            // Check: the codes are strictly increasing.
+            if (it != m_container.begin() && !p_type_less(*(it - 1), *it)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    // Checks on a deserialized divisor: the internal consistency checks, and the canonical form of the factors.
+    // NOTE: the factors can be unpacked only after having checked the compatibility with args.
+    bool load_checks(const symbol_fset &args) const
+    {
+        return destruction_checks()
+               && std::all_of(m_container.begin(), m_container.end(),
+                              [&args](const p_type &f) { return factor_is_canonical(unpack_factor(f, args)); });
+    }
+    static void update_exponent(value_type &a, const value_type &b)
+    {
+        piranha_assert(a > 0);
+        piranha_assert(b > 0);
+        // NOTE: this is safe as we require b to be a positive value.
+        if (unlikely(a > std::numeric_limits<value_type>::max() - b)) {
+            piranha_throw(std::invalid_argument, "overflow in the computation of the exponent of a divisor term");
+        }
+        a = static_cast<value_type>(a + b);
+    }
+    // Insert a factor, keeping the container sorted.
+    void insertion_impl(const p_type &f)
+    {
+        const auto it = std::lower_bound(m_container.begin(), m_container.end(), f, p_type_less);
+        if (it != m_container.end() && it->code == f.code) {
+            update_exponent(it->e, f.e);
+            return;
+        }
+        const auto pos = it - m_container.begin();
+        m_container.push_back(f);
+        // Move the new factor into its position.
+        std::rotate(m_container.begin() + pos, m_container.end() - 1, m_container.end());
+    }
+    // Decode the vector of a factor.
+    static v_type unpack_factor(const p_type &f, const symbol_fset &args)
+    {
+        return detail::km_unpack<v_type, ka>(args, f.code);
+    }
+    // Sort the factors after a re-encoding.
+    void sort_factors()
+    {
+        std::sort(m_container.begin(), m_container.end(), p_type_less);
+    }
+    // Enabler for insertion.
+    template <typename It, typename Exponent>
+    using insert_enabler
+        = enable_if_t<conjunction<is_input_iterator<It>,
+                                  has_safe_cast<value_type, typename std::iterator_traits<It>::value_type>,
+                                  has_safe_cast<value_type, Exponent>>::value,
+                      int>;
+    // Enabler for the construction from divisor.
+    template <typename U>
+    using divisor_ctor_enabler = enable_if_t<has_safe_cast<value_type, U>::value, int>;
+
+public:
+    /// Defaulted default constructor.
+    /**
+     * This constructor will initialise an empty divisor.
+     */
+    packed_divisor() = default;
+    /// Defaulted copy constructor.
+    packed_divisor(const packed_divisor &) = default;
+    /// Defaulted move constructor.
+    packed_divisor(packed_divisor &&) = default;
+    /// Converting constructor.
+    /**
+     * This constructor is used in the generic constructor of piranha::series. It is equivalent
+     * to a copy constructor with extra checking.
+     *
+     * @param other the construction argument.
+     * @param args the reference piranha::symbol_fset.
+     *
+     * @throws std::invalid_argument if \p other is not compatible with \p args.
+     * @throws unspecified any exception thrown by the copy constructor.
+     */
+    explicit packed_divisor(const packed_divisor &other, const symbol_fset &args) : m_container(other.m_container)
+    {
+        if (unlikely(!is_compatible(args))) {
+            piranha_throw(std::invalid_argument, "the constructed packed divisor is incompatible with the "
+                                                 "input symbol set");
+        }
+    }
+    /// Constructor from piranha::divisor.
+    /**
+     * \note
+     * This constructor is enabled only if \p U can be safely cast to piranha::packed_divisor::value_type.
+     *
+     * This constructor will pack the factors of \p d. It allows to convert a piranha::divisor_series
+     * with piranha::divisor keys into a piranha::divisor_series with piranha::packed_divisor keys.
+     *
+     * @param d the construction argument.
+     * @param args the reference piranha::symbol_fset.
+     *
+     * @throws std::invalid_argument if \p d is not compatible with \p args.
+     * @throws unspecified any exception thrown by insert().
+     */
+    template <typename U, divisor_ctor_enabler<U> = 0>
+    explicit packed_divisor(const divisor<U> &d, const symbol_fset &args)
+    {
+        if (unlikely(!d.is_compatible(args))) {
+            piranha_throw(std::invalid_argument, "cannot construct a packed divisor from a divisor which is "
+                                                 "incompatible with the input symbol set");
+        }
+        for (const auto &p : d._container()) {
+            insert(p.v.begin(), p.v.end(), p.e);
+        }
+    }
+    /// Constructor from piranha::symbol_fset.
+    /**
+     * Equivalent to the default constructor.
+     */
+    explicit packed_divisor(const symbol_fset &) {}
+    /// Trivial destructor.
+    ~packed_divisor()
+    {
+        piranha_assert(destruction_checks());
+        PIRANHA_TT_CHECK(is_key, packed_divisor);
+    }
+    /// Copy assignment operator.
+    /**
+     * @param other the assignment argument.
+     *
+     * @return a reference to \p this.
+     *
+     * @throws unspecified any exception thrown by the assignment operator of piranha::small_vector.
+     */
+    packed_divisor &operator=(const packed_divisor &other) = default;
+    /// Move assignment operator.
+    /**
+     * @param other the assignment argument.
+     *
+     * @return a reference to \p this.
+     */
+    packed_divisor &operator=(packed_divisor &&other) = default;
+    /// Create and insert a term from range and exponent.
+    /**
+     * \note
+     * This method is enabled only if:
+     * - \p It is an input iterator,
+     * - the value type of \p It can be safely cast to piranha::packed_divisor::value_type,
+     * - \p Exponent can be safely cast to piranha::packed_divisor::value_type.
+     *
+     * This method behaves like piranha::divisor::insert(): the elements in the range <tt>[begin,end)</tt>
+     * are packed into a single code, and if a factor with the same code exists already \p e will be added
+     * to its exponent.
+     *
+     * This method provides the basic exception safety guarantee.
+     *
+     * @param begin start of the range of \f$ a_{i,j} \f$.
+     * @param end end of the range of \f$ a_{i,j} \f$.
+     * @param e exponent.
+     *
+     * @throws std::invalid_argument if the term to be inserted is not in canonical form, if its elements
+     * cannot be packed, or if the insertion leads to an overflow in the value of an exponent.
+     * @throws unspecified any exception thrown by:
+     * - piranha::safe_cast(),
+     * - piranha::kronecker_array::encode(),
+     * - manipulations of piranha::static_vector and piranha::small_vector.
+     */
+    template <typename It, typename Exponent, insert_enabler<It, Exponent> = 0>
+    void insert(It begin, It end, const Exponent &e)
+    {
+        p_type f;
+        f.e = safe_cast<value_type>(e);
+        if (unlikely(f.e <= 0)) {
+            piranha_throw(std::invalid_argument, "a term of a divisor must have a positive exponent");
+        }
+        v_type tmp;
+        for (; begin != end; ++begin) {
+            tmp.push_back(safe_cast<value_type>(*begin));
+        }
+        // NOTE: encode() checks the elements against the Kronecker limits. These are more restrictive
+        // than the range checks of piranha::divisor, so we do not need additional checks here.
+        f.code = ka::encode(tmp);
+        if (unlikely(!factor_is_canonical(tmp))) {
+            piranha_throw(std::invalid_argument, "term not in canonical form");
+        }
+        insertion_impl(f);
+    }
+    /// Size.
+    /**
+     * @return the number of terms in the product.
+     */
+    size_type size() const
+    {
+        return m_container.size();
+    }
+    /// Const access to the internal container.
+    /**
+     * @return a const reference to the internal container.
+     */
+    const container_type &_container() const
+    {
+        return m_container;
+    }
+    /// Clear.
+    /**
+     * This method will remove all terms from the divisor.
+     */
+    void clear()
+    {
+        m_container.resize(0u);
+    }
+    /// Equality operator.
+    /**
+     * Since the factors are kept sorted by code, two packed divisors are equal if their internal
+     * containers are equal.
+     *
+     * @param other comparison argument.
+     *
+     * @return \p true if \p this is equal to \p other, \p false otherwise.
+     */
+    bool operator==(const packed_divisor &other) const
+    {
+        return m_container == other.m_container;
+    }
+    /// Inequality operator.
+    /**
+     * @param other comparison argument.
+     *
+     * @return the opposite of operator==().
+     */
+    bool operator!=(const packed_divisor &other) const
+    {
+        return !((*this) == other);
+    }
+    /// Hash value.
+    /**
+     * The hash value is computed by mixing the codes of the factors. For a divisor with a single factor,
+     * the hash value is the code itself. An empty divisor has a hash value of 0.
+     *
+     * @return a hash value for the divisor.
+     */
+    std::size_t hash() const
+    {
+        const auto it_f = m_container.end();
+        auto it = m_container.begin();
+        if (it == it_f) {
+            return 0u;
+        }
+        auto retval = static_cast<std::size_t>(it->code);
+        for (++it; it != it_f; ++it) {
+            boost::hash_combine(retval, it->code);
+        }
+        return retval;
+    }
+    /// Compatibility check.
+    /**
+     * An empty divisor is considered compatible with any set of symbols. Otherwise, a non-empty
+     * divisor is compatible if all its codes are within the Kronecker limits for the size of \p args.
+     *
+     * @param args the reference piranha::symbol_fset.
+     *
+     * @return \p true if \p this is compatible with \p args, \p false otherwise.
+     */
+    bool is_compatible(const symbol_fset &args) const
+    {
+        if (m_container.empty()) {
+            return true;
+        }
+        const auto s = args.size();
+        const auto &limits = ka::get_limits();
+        if (!s || s >= limits.size()) {
+            return false;
+        }
+        const auto &l = limits[static_cast<decltype(limits.size())>(s)];
+        return std::all_of(m_container.begin(), m_container.end(), [&l](const p_type &p) {
+            return p.code >= std::get<1u>(l) && p.code <= std::get<2u>(l);
+        });
+    }
+    /// Merge symbols.
+    /**
+     * This method will return a copy of \p this in which, for every factor of the divisor, the value 0 has been
+     * inserted at the positions specified by \p ins_map (see piranha::divisor::merge_symbols()).
+     *
+     * @param ins_map the insertion map.
+     * @param args the reference symbol set for \p this.
+     *
+     * @return a piranha::packed_divisor resulting from inserting into \p this zeroes at the positions specified by
+     * \p ins_map.
+     *
+     * @throws std::invalid_argument in the following cases:
+     * - the size of \p ins_map is zero,
+     * - the last index in \p ins_map is greater than the size of \p args,
+     * - the factors of \p this cannot be packed with the enlarged symbol set.
+     * @throws unspecified any exception thrown by piranha::kronecker_array::encode() and
+     * piranha::kronecker_array::decode().
+     */
+    packed_divisor merge_symbols(const symbol_idx_fmap<symbol_fset> &ins_map, const symbol_fset &args) const
+    {
+        packed_divisor retval(*this);
+        for (auto &f : retval.m_container) {
+            f.code = detail::km_merge_symbols<v_type, ka>(ins_map, args, f.code);
+        }
+        // NOTE: inserting zeroes preserves the canonical form and the distinctness of the factors,
+        // but the re-encoding can change their order.
+        retval.sort_factors();
+        return retval;
+    }
+
+private:
+    // Print the factors, using the stream manipulators supplied by the caller.
+    template <typename FBegin, typename FEnd, typename FExpo, typename FCoeff>
+    void print_impl(std::ostream &os, const symbol_fset &args, const FBegin &fbegin, const FEnd &fend,
+                    const FExpo &fexpo, const FCoeff &fcoeff, bool star_sep) const
+    {
+        if (unlikely(!is_compatible(args))) {
+            piranha_throw(std::invalid_argument, "invalid size of arguments set");
+        }
+        bool first_term = true;
+        for (const auto &f : m_container) {
+            if (first_term) {
+                first_term = false;
+            } else if (star_sep) {
+                os << '*';
+            }
+            const auto v = unpack_factor(f, args);
+            bool printed_something = false;
+            fbegin(os);
+            auto it_args = args.begin();
+            for (typename v_type::size_type i = 0u; i < v.size(); ++i, ++it_args) {
+                // If the aij is zero, don't print anything.
+                if (piranha::is_zero(v[i])) {
+                    continue;
+                }
+                // A positive aij, in case previous output exists, must be preceded
+                // by a "+" sign.
+                if (v[i] > 0 && printed_something) {
+                    os << '+';
+                }
+                // Print the aij, unless it's "-1": in that case, just print the minus sign.
+                if (v[i] == -1) {
+                    os << '-';
+                } else if (v[i] != 1) {
+                    fcoeff(os, v[i]);
+                }
+                os << *it_args;
+                printed_something = true;
+            }
+            fend(os);
+            // Print the exponent, if different from one.
+            if (f.e != 1) {
+                fexpo(os, f.e);
+            }
+        }
+    }
+
+public:
+    /// Print to stream.
+    /**
+     * The output format is the same of piranha::divisor::print(), with the factors printed in the
+     * order of their codes.
+     *
+     * @param os the target stream.
+     * @param args the reference symbol set for \p this.
+     *
+     * @throws std::invalid_argument if \p this is not compatible with \p args.
+     * @throws unspecified any exception thrown by printing to \p os piranha::packed_divisor::value_type, strings or
+     * characters.
+     */
+    void print(std::ostream &os, const symbol_fset &args) const
+    {
+        if (m_container.empty()) {
+            return;
+        }
+        os << "1/[";
+        print_impl(os, args, [](std::ostream &o) { o << '('; }, [](std::ostream &o) { o << ')'; },
+                   [](std::ostream &o, const value_type &e) { o << "**" << detail::prepare_for_print(e); },
+                   [](std::ostream &o, const value_type &n) { o << detail::prepare_for_print(n) << '*'; }, true);
+        os << ']';
+    }
+    /// Print to stream in TeX mode.
+    /**
+     * The output format is the same of piranha::divisor::print_tex(), with the factors printed in the
+     * order of their codes.
+     *
+     * @param os the target stream.
+     * @param args the reference symbol set for \p this.
+     *
+     * @throws std::invalid_argument if \p this is not compatible with \p args.
+     * @throws unspecified any exception thrown by printing to \p os piranha::packed_divisor::value_type, strings or
+     * characters.
+     */
+    void print_tex(std::ostream &os, const symbol_fset &args) const
+    {
+        if (m_container.empty()) {
+            return;
+        }
+        os << "\\frac{1}{";
+        print_impl(os, args, [](std::ostream &o) { o << "\\left("; }, [](std::ostream &o) { o << "\\right)"; },
+                   [](std::ostream &o, const value_type &e) { o << "^{" << detail::prepare_for_print(e) << "}"; },
+                   [](std::ostream &o, const value_type &n) { o << detail::prepare_for_print(n); }, false);
+        os << '}';
+    }
+
+private:
+    // Evaluation utilities.
+    template <typename U>
+    using eval_sum_type = decltype(std::declval<const value_type &>() * std::declval<const U &>());
+    template <typename U>
+    using eval_type_
+        = decltype(piranha::pow(std::declval<const eval_sum_type<U> &>(), std::declval<const value_type &>()));
+    template <typename U>
+    using eval_type = enable_if_t<
+        conjunction<std::is_constructible<eval_type_<U>, const int &>, is_divisible_in_place<eval_type_<U>>,
+                    std::is_constructible<eval_sum_type<U>, const int &>, is_addable_in_place<eval_sum_type<U>>>::value,
+        eval_type_<U>>;
+
+public:
+    /// Evaluation.
+    /**
+     * \note
+     * This method is available only if \p U supports the arithmetic operations necessary to construct the return type.
+     *
+     * This method is equivalent to piranha::divisor::evaluate().
+     *
+     * @param values the values will be used for the evaluation.
+     * @param args the reference piranha::symbol_fset.
+     *
+     * @return the result of evaluating \p this with the values provided in \p values.
+     *
+     * @throws std::invalid_argument if there exist an incompatibility between \p this,
+     * \p args or \p values.
+     * @throws unspecified any exception thrown by the construction of the return type.
+     */
+    template <typename U>
+    eval_type<U> evaluate(const std::vector<U> &values, const symbol_fset &args) const
+    {
+        if (unlikely(args.size() != values.size())) {
+            piranha_throw(std::invalid_argument, "cannot evaluate packed divisor: the size of the symbol set ("
+                                                     + std::to_string(args.size())
+                                                     + ") differs from the size of the vector of values ("
+                                                     + std::to_string(values.size()) + ")");
+        }
+        if (unlikely(!is_compatible(args))) {
+            piranha_throw(std::invalid_argument, "cannot evaluate packed divisor: the divisor is not compatible "
+                                                 "with the symbol set");
+        }
+        eval_type<U> retval(1);
+        for (const auto &f : m_container) {
+            const auto v = unpack_factor(f, args);
+            eval_sum_type<U> tmp(0);
+            for (typename v_type::size_type i = 0u; i < v.size(); ++i) {
+                tmp += v[i] * values[static_cast<decltype(values.size())>(i)];
+            }
+            retval /= piranha::pow(tmp, f.e);
+        }
+        return retval;
+    }
+
+private:
+    // Multiplication utilities.
+    template <typename Cf>
+    using multiply_enabler = enable_if_t<has_mul3<Cf>::value, int>;
+
+public:
+    /// Multiply terms with a packed divisor key.
+    /**
+     * \note
+     * This method is enabled only if \p Cf satisfies piranha::has_mul3.
+     *
+     * Multiply \p t1 by \p t2, storing the result in the only element of \p res. If \p Cf is an mp++
+     * rational, then only the numerators of the coefficients will be multiplied. The keys are multiplied
+     * by merging their sorted factors, in linear time.
+     *
+     * This method offers the basic exception safety guarantee.
+     *
+     * @param res the return value.
+     * @param t1 the first argument.
+     * @param t2 the second argument.
+     * @param args the reference piranha::symbol_fset.
+     *
+     * @throws std::invalid_argument if the key of \p t1 and/or the key of \p t2 are incompatible with \p args, or if
+     * the multiplication of the keys results in an exponent exceeding the allowed range.
+     * @throws unspecified any exception thrown by:
+     * - piranha::math::mul3(),
+     * - piranha::small_vector::push_back().
+     */
+    template <typename Cf, multiply_enabler<Cf> = 0>
+    static void multiply(std::array<term<Cf, packed_divisor>, multiply_arity> &res,
+                         const term<Cf, packed_divisor> &t1, const term<Cf, packed_divisor> &t2,
+                         const symbol_fset &args)
+    {
+        term<Cf, packed_divisor> &t = res[0u];
+        if (unlikely(!t1.m_key.is_compatible(args) || !t2.m_key.is_compatible(args))) {
+            piranha_throw(std::invalid_argument, "cannot multiply terms with packed divisor keys: at least one of the "
+                                                 "terms is not compatible with the input symbol set");
+        }
+        // Coefficient.
+        cf_mult_impl(t.m_cf, t1.m_cf, t2.m_cf);
+        // Merge the sorted factors of the keys.
+        auto &c = t.m_key.m_container;
+        c.resize(0u);
+        auto it1 = t1.m_key.m_container.begin(), it2 = t2.m_key.m_container.begin();
+        const auto it_f1 = t1.m_key.m_container.end(), it_f2 = t2.m_key.m_container.end();
+        while (it1 != it_f1 && it2 != it_f2) {
+            if (it1->code < it2->code) {
+                c.push_back(*it1);
+                ++it1;
+            } else if (it2->code < it1->code) {
+                c.push_back(*it2);
+                ++it2;
+            } else {
+                c.push_back(*it1);
+                update_exponent(c[static_cast<size_type>(c.size() - 1u)].e, it2->e);
+                ++it1;
+                ++it2;
+            }
+        }
+        for (; it1 != it_f1; ++it1) {
+            c.push_back(*it1);
+        }
+        for (; it2 != it_f2; ++it2) {
+            c.push_back(*it2);
+        }
+    }
+    /// Identify symbols that can be trimmed.
+    /**
+     * This method is used in piranha::series::trim(), and it behaves like piranha::divisor::trim_identify().
+     *
+     * @param trim_mask a mask signalling candidate elements for trimming.
+     * @param args the reference piranha::symbol_fset.
+     *
+     * @throws std::invalid_argument if \p this is not compatible with \p args, or if the sizes of ``trim_mask``
+     * and ``args`` differ.
+     * @throws unspecified any exception thrown by piranha::kronecker_array::decode().
+     */
+    void trim_identify(std::vector<char> &trim_mask, const symbol_fset &args) const
+    {
+        if (unlikely(!is_compatible(args))) {
+            piranha_throw(std::invalid_argument, "invalid arguments set for trim_identify()");
+        }
+        if (unlikely(trim_mask.size() != args.size())) {
+            piranha_throw(std::invalid_argument,
+                          "invalid symbol_set for trim_identify() in a packed divisor: the size of the symbol set ("
+                              + std::to_string(args.size()) + ") differs from the size of the trim mask ("
+                              + std::to_string(trim_mask.size()) + ")");
+        }
+        for (const auto &f : m_container) {
+            detail::km_trim_identify<v_type, ka>(trim_mask, args, f.code);
+        }
+    }
+    /// Trim.
+    /**
+     * This method is used in piranha::series::trim(), and it behaves like piranha::divisor::trim().
+     *
+     * @param trim_mask a mask indicating which elements will be removed.
+     * @param args the reference piranha::symbol_fset.
+     *
+     * @return a trimmed copy of \p this.
+     *
+     * @throws std::invalid_argument if ``this`` is not compatible with ``args`` or if
+     * the sizes of ``args`` and ``trim_mask`` differ.
+     * @throws unspecified any exception thrown by insert().
+     */
+    packed_divisor trim(const std::vector<char> &trim_mask, const symbol_fset &args) const
+    {
+        if (unlikely(!is_compatible(args))) {
+            piranha_throw(std::invalid_argument, "invalid arguments set for trim()");
+        }
+        if (unlikely(trim_mask.size() != args.size())) {
+            piranha_throw(std::invalid_argument,
+                          "invalid symbol_set for trim() in a packed divisor: the size of the symbol set ("
+                              + std::to_string(args.size()) + ") differs from the size of the trim mask ("
+                              + std::to_string(trim_mask.size()) + ")");
+        }
+        packed_divisor retval;
+        for (const auto &f : m_container) {
+            const auto v = unpack_factor(f, args);
+            v_type tmp;
+            for (typename v_type::size_type i = 0u; i < v.size(); ++i) {
+                if (!trim_mask[static_cast<decltype(trim_mask.size())>(i)]) {
+                    tmp.push_back(v[i]);
+                }
+            }
+            retval.insert(tmp.begin(), tmp.end(), f.e);
+        }
+        return retval;
+    }
+    /// Split divisor.
+    /**
+     * This method will split \p this into two parts: the first one will contain the terms of the divisor
+     * whose \f$ a_{i,j} \f$ values at the position \p p are not zero, the second one the remaining terms.
+     *
+     * @param p the position of the splitting symbol.
+     * @param args the reference piranha::symbol_fset.
+     *
+     * @return the original divisor split into two parts.
+     *
+     * @throws std::invalid_argument if \p args is not compatible with \p this or \p p, or \p p
+     * is not less than the size of \p args.
+     * @throws unspecified any exception thrown by piranha::kronecker_array::decode() or
+     * piranha::small_vector::push_back().
+     */
+    std::pair<packed_divisor, packed_divisor> split(const symbol_idx &p, const symbol_fset &args) const
+    {
+        if (unlikely(!is_compatible(args))) {
+            piranha_throw(std::invalid_argument, "invalid size of arguments set");
+        }
+        if (unlikely(p >= args.size())) {
+            piranha_throw(std::invalid_argument,
+                          "invalid index for the splitting of a packed divisor: the value of the index ("
+                              + std::to_string(p) + ") is not less than the number of symbols in the divisor ("
+                              + std::to_string(args.size()) + ")");
+        }
+        // NOTE: the factors are visited in order, so both parts stay sorted.
+        std::pair<packed_divisor, packed_divisor> retval;
+        for (const auto &f : m_container) {
+            if (piranha::is_zero(unpack_factor(f, args)[static_cast<typename v_type::size_type>(p)])) {
+                retval.second.m_container.push_back(f);
+            } else {
+                retval.first.m_container.push_back(f);
+            }
+        }
+        return retval;
+    }
+    /// Convert to piranha::divisor.
+    /**
+     * @param args the reference piranha::symbol_fset.
+     *
+     * @return a piranha::divisor containing the unpacked factors of \p this.
+     *
+     * @throws std::invalid_argument if \p this is not compatible with \p args.
+     * @throws unspecified any exception thrown by piranha::divisor::insert().
+     */
+    divisor<value_type> to_divisor(const symbol_fset &args) const
+    {
+        if (unlikely(!is_compatible(args))) {
+            piranha_throw(std::invalid_argument, "cannot convert a packed divisor which is incompatible with the "
+                                                 "input symbol set");
+        }
+        divisor<value_type> retval;
+        for (const auto &f : m_container) {
+            const auto v = unpack_factor(f, args);
+            retval.insert(v.begin(), v.end(), f.e);
+        }
+        return retval;
+    }
+
+private:
+#if defined(PIRANHA_WITH_BOOST_S11N)
+    // Make friend with the s11n functions.
+    template <typename Archive, typename T1>
+    friend void boost::serialization::save(Archive &,
+                                           const piranha::boost_s11n_key_wrapper<piranha::packed_divisor<T1>> &,
+                                           unsigned);
+    template <typename Archive, typename T1>
+    friend void boost::serialization::load(Archive &, piranha::boost_s11n_key_wrapper<piranha::packed_divisor<T1>> &,
+                                           unsigned);
+#endif
+
+#if defined(PIRANHA_WITH_MSGPACK)
+    template <typename Stream>
+    using msgpack_pack_enabler
+        = enable_if_t<conjunction<is_msgpack_stream<Stream>, has_msgpack_pack<Stream, container_type>>::value, int>;
+    template <typename U>
+    using msgpack_convert_enabler = enable_if_t<has_msgpack_convert<typename U::container_type>::value, int>;
+
+public:
+    /// Pack in msgpack format.
+    /**
+     * \note
+     * This method is enabled only if \p Stream satisfies piranha::is_msgpack_stream and the internal container type
+     * satisfies piranha::has_msgpack_pack.
+     *
+     * This method will pack \p this in to \p p using the format f. The (code, exponent) pairs are packed as
+     * they are, without unpacking the factors.
+     *
+     * @param p the target <tt>msgpack::packer</tt>.
+     * @param f the desired piranha::msgpack_format.
+     * @param args the reference piranha::symbol_fset.
+     *
+     * @throws std::invalid_argument if \p args is not compatible with \p this.
+     * @throws unspecified any exception thrown by piranha::msgpack_pack().
+     */
+    template <typename Stream, msgpack_pack_enabler<Stream> = 0>
+    void msgpack_pack(msgpack::packer<Stream> &p, msgpack_format f, const symbol_fset &args) const
+    {
+        if (unlikely(!is_compatible(args))) {
+            piranha_throw(std::invalid_argument, "an invalid symbol_set was passed as an argument for the "
+                                                 "msgpack_pack() method of a packed divisor");
+        }
+        piranha::msgpack_pack(p, m_container, f);
+    }
+    /// Convert from msgpack object.
+    /**
+     * \note
+     * This method is enabled only if the internal container type satisfies piranha::has_msgpack_convert.
+     *
+     * This method will convert the input msgpack object \p o into \p this, using the format \p f. The method
+     * provides the basic exception safety guarantee.
+     *
+     * @param o the input <tt>msgpack::object</tt>.
+     * @param f the desired piranha::msgpack_format.
+     * @param args the reference piranha::symbol_fset.
+     *
+     * @throws std::invalid_argument if the deserialized divisor is not compatible with \p args, or if it fails
+     * internal consistency checks.
+     * @throws unspecified any exception thrown by piranha::msgpack_convert().
+     */
+    template <typename U = packed_divisor, msgpack_convert_enabler<U> = 0>
+    void msgpack_convert(const msgpack::object &o, msgpack_format f, const symbol_fset &args)
+    {
+        try {
+            piranha::msgpack_convert(m_container, o, f);
+            if (unlikely(!is_compatible(args))) {
+                piranha_throw(std::invalid_argument, "the packed divisor loaded from a msgpack object is not "
+                                                     "compatible with the supplied symbol set");
+            }
+            if (unlikely(!load_checks(args))) {
+                piranha_throw(std::invalid_argument, "the packed divisor loaded from a msgpack object failed "
+                                                     "internal consistency checks");
+            }
+        } catch (...) {
+            m_container = container_type{};
+            throw;
+        }
+    }
+#endif
+
+private:
+    container_type m_container;
+};
+
+template <typename T>
+const std::size_t packed_divisor<T>::multiply_arity;
+
+// Implementation of piranha::key_is_one() for packed_divisor.
+template <typename T>
+class key_is_one_impl<packed_divisor<T>>
+{
+public:
+    bool operator()(const packed_divisor<T> &d, const symbol_fset &) const
+    {
+        return d._container().empty();
+    }
+};
+}
+
+#if defined(PIRANHA_WITH_BOOST_S11N)
+
+// Implementation of the Boost s11n api.
+namespace boost
+{
+namespace serialization
+{
+
+template <typename Archive, typename T>
+inline void save(Archive &ar, const piranha::boost_s11n_key_wrapper<piranha::packed_divisor<T>> &k, unsigned)
+{
+    if (unlikely(!k.key().is_compatible(k.ss()))) {
+        piranha_throw(std::invalid_argument, "an invalid symbol_set was passed as an argument during the "
+                                             "Boost serialization of a packed divisor");
+    }
+    piranha::boost_save(ar, k.key().m_container);
+}
+
+template <typename Archive, typename T>
+inline void load(Archive &ar, piranha::boost_s11n_key_wrapper<piranha::packed_divisor<T>> &k, unsigned)
+{
+    try {
+        piranha::boost_load(ar, k.key().m_container);
+        if (unlikely(!k.key().is_compatible(k.ss()))) {
+            piranha_throw(std::invalid_argument, "the packed divisor loaded from a Boost archive is not compatible "
+                                                 "with the supplied symbol set");
+        }
+        if (unlikely(!k.key().load_checks(k.ss()))) {
+            piranha_throw(std::invalid_argument, "the packed divisor loaded from a Boost archive failed internal "
+                                                 "consistency checks");
+        }
+    } catch (...) {
+        k.key().m_container = typename piranha::packed_divisor<T>::container_type{};
+        throw;
+    }
+}
+
+template <typename Archive, typename T>
+inline void serialize(Archive &ar, piranha::boost_s11n_key_wrapper<piranha::packed_divisor<T>> &k, unsigned version)
+{
+    split_free(ar, k, version);
+}
+}
+}
+
+namespace piranha
+{
+
+inline namespace impl
+{
+
+template <typename Archive, typename T>
+using packed_divisor_boost_save_enabler
+    = enable_if_t<has_boost_save<Archive, typename packed_divisor<T>::container_type>::value>;
+
+template <typename Archive, typename T>
+using packed_divisor_boost_load_enabler
+    = enable_if_t<has_boost_load<Archive, typename packed_divisor<T>::container_type>::value>;
+}
+
+/// Specialisation of piranha::boost_save() for piranha::packed_divisor.
+/**
+ * \note
+ * This specialisation is enabled only if piranha::packed_divisor::container_type satisfies piranha::has_boost_save.
+ *
+ * @throws std::invalid_argument if the symbol set is incompatible with the divisor.
+ * @throws unspecified any exception thrown by piranha::boost_save().
+ */
+template <typename Archive, typename T>
+struct boost_save_impl<Archive, boost_s11n_key_wrapper<packed_divisor<T>>,
+                       packed_divisor_boost_save_enabler<Archive, T>>
+    : boost_save_via_boost_api<Archive, boost_s11n_key_wrapper<packed_divisor<T>>> {
+};
+
+/// Specialisation of piranha::boost_load() for piranha::packed_divisor.
+/**
+ * \note
+ * This specialisation is enabled only if piranha::packed_divisor::container_type satisfies piranha::has_boost_load.
+ *
+ * The basic exception safety guarantee is provided.
+ *
+ * @throws std::invalid_argument if the symbol set is not compatible with the loaded divisor or if the loaded divisor
+ * fails internal consistency checks.
+ * @throws unspecified any exception thrown by piranha::boost_load().
+ */
+template <typename Archive, typename T>
+struct boost_load_impl<Archive, boost_s11n_key_wrapper<packed_divisor<T>>,
+                       packed_divisor_boost_load_enabler<Archive, T>>
+    : boost_load_via_boost_api<Archive, boost_s11n_key_wrapper<packed_divisor<T>>> {
+};
+}
+
+#endif
+
+namespace std
+{
+
+template <typename T>
+struct hash<piranha::packed_divisor<T>> {
+    /// Result type.
+    typedef size_t result_type;
+    /// Argument type.
+    typedef piranha::packed_divisor<T> argument_type;
+    /// Hash operator.
+    /**
+     * @param a piranha::packed_divisor whose hash value will be returned.
+     *
+     * @return piranha::packed_divisor::hash().
+     */
+    result_type operator()(const argument_type &a) const
+    {
+        return a.hash();
+    }
+};
+}
+
+#endif
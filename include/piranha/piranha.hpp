@@ -186,13 +186,17 @@ see https://www.gnu.org/licenses/. */
 
 #include <piranha/array_key.hpp>
 #include <piranha/base_series_multiplier.hpp>
+#include <piranha/batch_evaluator.hpp>
 #include <piranha/cache_aligning_allocator.hpp>
+#include <piranha/chunked_s11n.hpp>
 #include <piranha/config.hpp>
 #include <piranha/convert_to.hpp>
 #include <piranha/divisor.hpp>
 #include <piranha/divisor_series.hpp>
 #include <piranha/dynamic_aligning_allocator.hpp>
 #include <piranha/exceptions.hpp>
+#include <piranha/fixed_integer.hpp>
+#include <piranha/frozen_series.hpp>
 #include <piranha/hash_set.hpp>
 #include <piranha/integer.hpp>
 #include <piranha/invert.hpp>
@@ -206,6 +210,7 @@ see https://www.gnu.org/licenses/. */
 #include <piranha/kronecker_array.hpp>
 #include <piranha/kronecker_monomial.hpp>
 #include <piranha/lambdify.hpp>
+#include <piranha/mapped_series.hpp>
 #include <piranha/math.hpp>
 #include <piranha/math/binomial.hpp>
 #include <piranha/math/cos.hpp>
@@ -217,6 +222,8 @@ see https://www.gnu.org/licenses/. */
 #include <piranha/math/sin.hpp>
 #include <piranha/memory.hpp>
 #include <piranha/monomial.hpp>
+#include <piranha/oa_hash_set.hpp>
+#include <piranha/packed_divisor.hpp>
 #include <piranha/poisson_series.hpp>
 #include <piranha/polynomial.hpp>
 #include <piranha/power_series.hpp>
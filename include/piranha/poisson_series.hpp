@@ -30,18 +30,30 @@ see https://www.gnu.org/licenses/. */
 #define PIRANHA_POISSON_SERIES_HPP
 
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <boost/container/container_fwd.hpp>
 #include <boost/iterator/transform_iterator.hpp>
+#include <boost/numeric/conversion/cast.hpp>
+#include <cmath>
+#include <cstddef>
 #include <iterator>
+#include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
+#include <mp++/rational.hpp>
+
 #include <piranha/base_series_multiplier.hpp>
 #include <piranha/config.hpp>
+#include <piranha/detail/atomic_flag_array.hpp>
+#include <piranha/detail/atomic_lock_guard.hpp>
 #include <piranha/detail/divisor_series_fwd.hpp>
 #include <piranha/detail/init.hpp>
 #include <piranha/detail/poisson_series_fwd.hpp>
@@ -53,6 +65,7 @@ see https://www.gnu.org/licenses/. */
 #include <piranha/ipow_substitutable_series.hpp>
 #include <piranha/is_cf.hpp>
 #include <piranha/key_is_multipliable.hpp>
+#include <piranha/kronecker_array.hpp>
 #include <piranha/math.hpp>
 #include <piranha/math/cos.hpp>
 #include <piranha/math/gcd3.hpp>
@@ -69,6 +82,7 @@ see https://www.gnu.org/licenses/. */
 #include <piranha/term.hpp>
 #include <piranha/thread_pool.hpp>
 #include <piranha/trigonometric_series.hpp>
+#include <piranha/tuning.hpp>
 #include <piranha/type_traits.hpp>
 
 namespace piranha
@@ -758,6 +772,17 @@ namespace detail
 
 template <typename Series>
 using ps_series_multiplier_enabler = typename std::enable_if<std::is_base_of<poisson_series_tag, Series>::value>::type;
+
+// Identification of real trigonometric Kronecker monomials for dispatching in the multiplier.
+template <typename T>
+struct is_rtk_monomial {
+    static const bool value = false;
+};
+
+template <typename T>
+struct is_rtk_monomial<real_trigonometric_kronecker_monomial<T>> {
+    static const bool value = true;
+};
 }
 
 /// Specialisation of piranha::series_multiplier for piranha::poisson_series.
@@ -768,71 +793,266 @@ class series_multiplier<Series, detail::ps_series_multiplier_enabler<Series>> :
     template <typename T>
     using call_enabler = typename std::enable_if<
         key_is_multipliable<typename T::term_type::cf_type, typename T::term_type::key_type>::value, int>::type;
+    template <typename T>
+    using key_t = typename T::term_type::key_type;
+    // Key multiplier operating on the packed representation of real trigonometric Kronecker monomials.
+    struct packed_rtk_multiplier {
+        template <typename Res, typename Term>
+        void operator()(Res &res, const Term &t1, const Term &t2, const symbol_fset &ss) const
+        {
+            Term::key_type::multiply_packed(res, t1, t2, ss);
+        }
+    };
+    // Check if the multiplication can be performed on the packed representation of the keys. This is possible
+    // only if the sums of the maximum absolute values of the multipliers of the two series are within
+    // the limits of the Kronecker codification.
+    template <typename T = Series, typename std::enable_if<!detail::is_rtk_monomial<key_t<T>>::value, int>::type = 0>
+    bool packed_check() const
+    {
+        return false;
+    }
+    template <typename T = Series, typename std::enable_if<detail::is_rtk_monomial<key_t<T>>::value, int>::type = 0>
+    bool packed_check() const
+    {
+        using value_type = typename key_t<T>::value_type;
+        using ka = kronecker_array<value_type>;
+        const auto size = this->m_ss.size();
+        const auto &limits = ka::get_limits();
+        if (unlikely(size >= limits.size())) {
+            return false;
+        }
+        const auto &minmax_vec = std::get<0u>(limits[static_cast<decltype(limits.size())>(size)]);
+        piranha_assert(minmax_vec.size() == size);
+        // Maximum absolute values of the multipliers in the two series.
+        auto max_abs = [this, size](const typename base::v_ptr &v) {
+            std::vector<value_type> retval(safe_cast<typename std::vector<value_type>::size_type>(size), value_type(0));
+            for (const auto &ptr : v) {
+                const auto tmp = ptr->m_key.unpack(this->m_ss);
+                for (decltype(tmp.size()) i = 0u; i < tmp.size(); ++i) {
+                    // NOTE: the range of the components is symmetric, so the absolute value is representable.
+                    const auto a = static_cast<value_type>(tmp[i] >= value_type(0) ? tmp[i] : -tmp[i]);
+                    if (a > retval[i]) {
+                        retval[i] = a;
+                    }
+                }
+            }
+            return retval;
+        };
+        const auto max1 = max_abs(this->m_v1), max2 = max_abs(this->m_v2);
+        for (decltype(minmax_vec.size()) i = 0u; i < minmax_vec.size(); ++i) {
+            // NOTE: both values are in the [0, M_i] range, hence the subtraction cannot overflow.
+            if (max1[i] > minmax_vec[i] - max2[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
     void divide_by_two(Series &s) const
     {
-        // NOTE: if we ever implement multi-threaded series division we most likely need
-        // to revisit this.
-        piranha_assert(this->m_n_threads > 0u);
-        if (this->m_n_threads == 1u) {
-            // This is possible, as the requirements of series divisibility and trig key
-            // multipliability overlap.
-            s /= 2;
-        } else {
-            using bucket_size_type = typename base::bucket_size_type;
-            using term_type = typename Series::term_type;
-            auto &container = s._container();
-            std::atomic<bucket_size_type> total_erase_count(0u);
-            auto divider
-                = [&container, &total_erase_count, this](bucket_size_type start_idx, bucket_size_type end_idx) {
-                      // A vector of terms to be erased at each bucket iteration.
-                      std::vector<term_type> term_list;
-                      // Total number of terms erased by this thread.
-                      bucket_size_type erase_count = 0u;
-                      for (; start_idx != end_idx; ++start_idx) {
-                          // Reset the list of terms to be erased.
-                          term_list.clear();
-                          const auto &list = container._get_bucket_list(start_idx);
-                          for (const auto &t : list) {
-                              t.m_cf /= 2;
-                              if (unlikely(t.is_zero(this->m_ss))) {
-                                  term_list.push_back(t);
-                              }
-                          }
-                          for (const auto &t : term_list) {
-                              container._erase(container._find(t, start_idx));
-                              erase_count = static_cast<bucket_size_type>(erase_count + 1u);
-                          }
-                      }
-                      // Update the global counter of erased terms.
-                      total_erase_count += erase_count;
-                  };
-            // Buckets per thread.
-            const auto bpt = static_cast<bucket_size_type>(container.bucket_count() / this->m_n_threads);
-            // Go with the threads.
-            future_list<decltype(divider(0u, 0u))> ff_list;
-            try {
-                for (unsigned i = 0u; i < this->m_n_threads; ++i) {
-                    const auto start_idx = static_cast<bucket_size_type>(bpt * i);
-                    // Special casing for the last thread.
-                    const auto end_idx = (i == this->m_n_threads - 1u) ? container.bucket_count()
-                                                                       : static_cast<bucket_size_type>(bpt * (i + 1u));
-                    ff_list.push_back(thread_pool::enqueue(i, divider, start_idx, end_idx));
+        // This is possible, as the requirements of series divisibility and trig key
+        // multipliability overlap. The division of large series is parallelised
+        // in the series class.
+        s /= 2;
+    }
+    // Multi-threaded multiplication. The buckets of the output container are subdivided into zones, and each thread
+    // buffers the terms resulting from its term-by-term multiplications according to their destination zone.
+    // When a buffer is full, the thread tries to acquire the corresponding zone (without blocking) and, if successful,
+    // accumulates the buffered terms into the output. After a thread has flushed all its buffers, it signals
+    // the completion of its work on each zone, and the last thread to complete a zone sanitises the terms in the zone
+    // and divides their coefficients by two. This replaces the separate passes over the output of
+    // base_series_multiplier::sanitise_series() and of divide_by_two().
+    template <typename KeyMultiplier>
+    Series zoned_multiplication() const
+    {
+        using term_type = typename Series::term_type;
+        using cf_type = typename term_type::cf_type;
+        using key_type = typename term_type::key_type;
+        using size_type = typename base::size_type;
+        using bucket_size_type = typename base::bucket_size_type;
+        using buffer_type = std::vector<term_type>;
+        constexpr std::size_t m_arity = key_type::multiply_arity;
+        // NOTE: with mp++ rational coefficients, the denominators of the coefficients of the result are set
+        // in finalise_series(), hence in that case the division by two must be done afterwards.
+        constexpr bool fold_division = !mppp::is_rational<cf_type>::value;
+        const unsigned n_threads = this->m_n_threads;
+        piranha_assert(n_threads > 1u);
+        Series retval;
+        retval.set_symbol_set(this->m_ss);
+        if (unlikely(this->m_v1.empty() || this->m_v2.empty())) {
+            return retval;
+        }
+        auto &container = retval._container();
+        const auto &args = retval.get_symbol_set();
+        // Estimate and rehash.
+        const auto est = this->template estimate_final_series_size<
+            m_arity, typename base::template plain_multiplier<false, KeyMultiplier>>();
+        container.rehash(boost::numeric_cast<bucket_size_type>(
+                             std::ceil(static_cast<double>(est) / container.max_load_factor())),
+                         tuning::get_parallel_memory_set() ? n_threads : 1u);
+        const bucket_size_type bucket_count = container.bucket_count();
+        piranha_assert(bucket_count);
+        // Sort the input terms according to the bucket positions of their keys in the output. This way,
+        // consecutive multiplications tend to produce terms that end up in nearby buckets.
+        auto r_bucket = [&container](term_type const *p) { return container._bucket_from_hash(p->hash()); };
+        auto term_cmp = [&r_bucket](term_type const *p1, term_type const *p2) { return r_bucket(p1) < r_bucket(p2); };
+        std::stable_sort(this->m_v1.begin(), this->m_v1.end(), term_cmp);
+        std::stable_sort(this->m_v2.begin(), this->m_v2.end(), term_cmp);
+        // Number of zones, a multiple of the number of threads (but not greater than the number of buckets).
+        // NOTE: zm is a tuning parameter, the same used in the polynomial multiplier.
+        const unsigned zm = 10u;
+        bucket_size_type n_zones = static_cast<bucket_size_type>(integer(n_threads) * zm);
+        if (n_zones > bucket_count) {
+            n_zones = bucket_count;
+        }
+        // Number of buckets per zone (at least 1). The last zone takes the remainder.
+        const bucket_size_type bpz = static_cast<bucket_size_type>(bucket_count / n_zones);
+        auto zone_idx = [bpz, n_zones](const bucket_size_type &b) -> bucket_size_type {
+            const auto z = static_cast<bucket_size_type>(b / bpz);
+            return z < n_zones ? z : static_cast<bucket_size_type>(n_zones - 1u);
+        };
+        // Flags used to acquire the zones.
+        detail::atomic_flag_array zone_flags(safe_cast<std::size_t>(n_zones));
+        // Number of threads which have not completed their work on each zone yet.
+        std::unique_ptr<std::atomic<unsigned>[]> pending(new std::atomic<unsigned>[safe_cast<std::size_t>(n_zones)]);
+        for (bucket_size_type z = 0u; z < n_zones; ++z) {
+            pending[static_cast<std::size_t>(z)].store(n_threads);
+        }
+        // The total number of terms in the result.
+        std::atomic<bucket_size_type> total_count(0u);
+        // The rows of the multiplication (i.e., the terms of the first series) are split into tasks, which
+        // are distributed dynamically among the threads.
+        const size_type size1 = this->m_v1.size();
+        const size_type n_tasks = std::min(safe_cast<size_type>(integer(n_threads) * zm), size1);
+        const size_type rpt = static_cast<size_type>(size1 / n_tasks);
+        std::atomic<size_type> next_task(0u);
+        // The number of buffered terms for a zone above which the buffer will be flushed.
+        const auto flush_size = safe_cast<typename buffer_type::size_type>(tuning::get_multiplication_block_size());
+        // Sanitise a zone and divide its coefficients by two.
+        auto finalise_zone = [&container, &args, &total_count, bucket_count, bpz, n_zones](const bucket_size_type &z) {
+            const auto start = static_cast<bucket_size_type>(z * bpz),
+                       end = (z == n_zones - 1u) ? bucket_count : static_cast<bucket_size_type>(start + bpz);
+            bucket_size_type count = 0u;
+            std::vector<term_type> term_list;
+            for (auto i = start; i != end; ++i) {
+                term_list.clear();
+                const auto &bl = container._get_bucket_list(i);
+                for (const auto &t : bl) {
+                    if (unlikely(!t.is_compatible(args))) {
+                        piranha_throw(std::invalid_argument, "incompatible term");
+                    }
+                    if (fold_division) {
+                        t.m_cf /= 2;
+                    }
+                    if (unlikely(t.is_zero(args))) {
+                        term_list.push_back(t);
+                    } else {
+                        count = static_cast<bucket_size_type>(count + 1u);
+                    }
+                }
+                for (const auto &t : term_list) {
+                    container._erase(container._find(t, i));
+                }
+            }
+            total_count += count;
+        };
+        auto thread_func = [this, zm, n_zones, n_tasks, rpt, size1, flush_size, &container, &zone_flags,
+                            &pending, &next_task, &zone_idx, &finalise_zone](unsigned thread_idx) {
+            // The per-zone buffers of terms.
+            std::vector<buffer_type> buffers(safe_cast<typename std::vector<buffer_type>::size_type>(n_zones));
+            const auto c_end = container.end();
+            // Try to acquire zone z and, if successful, accumulate the terms buffered for z into the output.
+            auto try_flush = [&buffers, &zone_flags, &container, &c_end](const bucket_size_type &z) -> bool {
+                auto &flag = zone_flags[static_cast<std::size_t>(z)];
+                if (flag.test_and_set(std::memory_order_acquire)) {
+                    return false;
+                }
+                detail::atomic_lock_guard alg(flag, std::adopt_lock);
+                auto &buf = buffers[static_cast<typename std::vector<buffer_type>::size_type>(z)];
+                for (auto &t : buf) {
+                    const auto b_idx = container._bucket(t);
+                    const auto it = container._find(t, b_idx);
+                    if (it == c_end) {
+                        container._unique_insert(std::move(t), b_idx);
+                    } else {
+                        it->m_cf += t.m_cf;
+                    }
+                }
+                buf.clear();
+                return true;
+            };
+            // Signal that this thread has completed its work on zone z.
+            auto complete = [&pending, &finalise_zone](const bucket_size_type &z) {
+                if (pending[static_cast<std::size_t>(z)].fetch_sub(1u) == 1u) {
+                    finalise_zone(z);
+                }
+            };
+            // Used to store the result of term multiplication.
+            std::array<term_type, m_arity> tmp_t;
+            auto mf = [this, flush_size, &tmp_t, &buffers, &container, &zone_idx, &try_flush](const size_type &i,
+                                                                                          const size_type &j) {
+                KeyMultiplier{}(tmp_t, *(this->m_v1[i]), *(this->m_v2[j]), this->m_ss);
+                for (std::size_t n = 0u; n < m_arity; ++n) {
+                    auto &tmp_term = tmp_t[n];
+                    const auto z = zone_idx(container._bucket(tmp_term));
+                    auto &buf = buffers[static_cast<typename std::vector<buffer_type>::size_type>(z)];
+                    // NOTE: the coefficient of tmp_term will be re-assigned by the next multiplication.
+                    buf.push_back(std::move(tmp_term));
+                    if (buf.size() >= flush_size) {
+                        // NOTE: if the zone is busy, we keep on buffering and we will try again later.
+                        try_flush(z);
+                    }
                 }
-                // First let's wait for everything to finish.
-                ff_list.wait_all();
-                // Then, let's handle the exceptions.
-                ff_list.get_all();
-            } catch (...) {
-                ff_list.wait_all();
-                // Clear out the container as it might be in an inconsistent state.
-                container.clear();
-                throw;
+            };
+            for (auto t = next_task++; t < n_tasks; t = next_task++) {
+                const auto start = static_cast<size_type>(t * rpt),
+                           end = (t == n_tasks - 1u) ? size1 : static_cast<size_type>((t + 1u) * rpt);
+                this->blocked_multiplication(mf, start, end);
             }
-            // Final size update - all of this is noexcept.
-            const auto tot = total_erase_count.load();
-            piranha_assert(tot <= s.size());
-            container._update_size(static_cast<bucket_size_type>(s.size() - tot));
+            // Flush the remaining buffers and complete the zones, starting from a zone that depends on the thread
+            // index in order to reduce contention. The zones which are busy will be visited again later.
+            std::vector<bucket_size_type> remaining, busy;
+            for (bucket_size_type k = 0u; k < n_zones; ++k) {
+                remaining.push_back(static_cast<bucket_size_type>((thread_idx * zm + k) % n_zones));
+            }
+            while (!remaining.empty()) {
+                busy.clear();
+                for (const auto &z : remaining) {
+                    if (buffers[static_cast<typename std::vector<buffer_type>::size_type>(z)].empty() || try_flush(z)) {
+                        complete(z);
+                    } else {
+                        busy.push_back(z);
+                    }
+                }
+                remaining.swap(busy);
+                // NOTE: the busy zones are being flushed by other threads. Instead of spinning on the flags, give
+                // the owners a chance to run before visiting the busy zones again.
+                if (!remaining.empty()) {
+                    std::this_thread::yield();
+                }
+            }
+        };
+        future_list<decltype(thread_func(0u))> ff_list;
+        try {
+            for (unsigned i = 0u; i < n_threads; ++i) {
+                ff_list.push_back(thread_pool::enqueue(i, thread_func, i));
+            }
+            // First let's wait for everything to finish.
+            ff_list.wait_all();
+            // Then, let's handle the exceptions.
+            ff_list.get_all();
+            // Final size update.
+            container._update_size(total_count.load());
+            this->finalise_series(retval);
+            if (!fold_division) {
+                divide_by_two(retval);
+            }
+        } catch (...) {
+            ff_list.wait_all();
+            // Clear out the container as it might be in an inconsistent state.
+            container.clear();
+            throw;
         }
+        return retval;
     }
 
 public:
@@ -844,17 +1064,33 @@ public:
      * This operator is enabled only if the coefficient and key types of \p Series satisfy
      * piranha::key_is_multipliable.
      *
-     * The call operator will use base_series_multiplier::plain_multiplication().
+     * The call operator will use base_series_multiplier::plain_multiplication(). If the key type is
+     * piranha::real_trigonometric_kronecker_monomial and the multipliers of the two series are small enough
+     * to guarantee that the multipliers of the result are within the limits of the Kronecker codification,
+     * the keys will be multiplied via piranha::real_trigonometric_kronecker_monomial::multiply_packed(),
+     * which avoids unpacking and re-encoding the keys.
+     *
+     * In multi-threaded mode, the output series is subdivided into zones of buckets which are acquired
+     * by the threads without blocking, and the division by two of the coefficients of the result is performed
+     * in the same pass that sanitises the output.
      *
      * @return the result of the multiplication.
      *
      * @throws unspecified any exception thrown by base_series_multiplier::plain_multiplication(),
+     * piranha::real_trigonometric_kronecker_monomial::unpack(), memory errors in standard containers,
      * or by piranha::term::is_zero().
      */
     template <typename T = Series, call_enabler<T> = 0>
     Series operator()() const
     {
-        auto retval(this->plain_multiplication());
+        // NOTE: the check needs to look at all the terms, but it is linear in the sizes of the series,
+        // whereas the multiplication is quadratic.
+        if (this->m_n_threads > 1u) {
+            return packed_check() ? zoned_multiplication<packed_rtk_multiplier>()
+                                  : zoned_multiplication<typename base::default_key_multiplier>();
+        }
+        auto retval(packed_check() ? this->template plain_multiplication<packed_rtk_multiplier>()
+                                   : this->plain_multiplication());
         divide_by_two(retval);
         return retval;
     }
@@ -32,6 +32,9 @@ see https://www.gnu.org/licenses/. */
 #include <algorithm>
 #include <cmath> // For std::ceil.
 #include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
 #include <functional>
 #include <initializer_list>
 #include <iterator>
@@ -39,6 +42,7 @@ see https://www.gnu.org/licenses/. */
 #include <map>
 #include <mutex>
 #include <numeric>
+#include <random>
 #include <stdexcept>
 #include <string>
 #include <tuple>
@@ -52,18 +56,20 @@ see https://www.gnu.org/licenses/. */
 
 #include <piranha/base_series_multiplier.hpp>
 #include <piranha/config.hpp>
-#include <piranha/detail/atomic_flag_array.hpp>
 #include <piranha/detail/cf_mult_impl.hpp>
 #include <piranha/detail/debug_access.hpp>
 #include <piranha/detail/divisor_series_fwd.hpp>
 #include <piranha/detail/init.hpp>
+#include <piranha/detail/kmv_sketch.hpp>
 #include <piranha/detail/parallel_vector_transform.hpp>
 #include <piranha/detail/poisson_series_fwd.hpp>
 #include <piranha/detail/polynomial_fwd.hpp>
 #include <piranha/detail/safe_integral_arith.hpp>
 #include <piranha/detail/sfinae_types.hpp>
 #include <piranha/exceptions.hpp>
+#include <piranha/fixed_integer.hpp>
 #include <piranha/forwarding.hpp>
+#include <piranha/frozen_series.hpp>
 #include <piranha/integer.hpp>
 #include <piranha/ipow_substitutable_series.hpp>
 #include <piranha/is_cf.hpp>
@@ -75,7 +81,9 @@ see https://www.gnu.org/licenses/. */
 #include <piranha/math/is_zero.hpp>
 #include <piranha/math/pow.hpp>
 #include <piranha/monomial.hpp>
+#include <piranha/oa_hash_set.hpp>
 #include <piranha/power_series.hpp>
+#include <piranha/s11n.hpp>
 #include <piranha/safe_cast.hpp>
 #include <piranha/series.hpp>
 #include <piranha/series_multiplier.hpp>
@@ -428,6 +436,12 @@ class polynomial
     using um_enabler =
         typename std::enable_if<std::is_same<T, decltype(std::declval<const T &>() * std::declval<const T &>())>::value,
                                 int>::type;
+    // Enabler for out-of-core multiplication.
+    template <typename T>
+    using oocm_enabler = typename std::enable_if<
+        std::is_same<T, decltype(std::declval<const T &>() * std::declval<const T &>())>::value
+            && detail::is_kronecker_monomial<typename T::term_type::key_type>::value,
+        int>::type;
     // Enabler for truncated multiplication.
     template <typename T, typename U>
     using tm_enabler =
@@ -451,6 +465,233 @@ class polynomial
             polynomial::clear_pow_cache();
         }
     }
+    // Fast exponentiation machinery. The fast algorithms are used only if the exponentiation does not change
+    // the coefficient type, the coefficient type has exact arithmetic and no degree, and it can be constructed
+    // from integer, multiplied and divided.
+    // NOTE: with inexact coefficient types (e.g., floating-point) the fast algorithms round differently from
+    // the repeated multiplications of series::pow(). As the two share the pow cache, the result of an
+    // exponentiation would then depend on which algorithm first computed the power, hence we restrict
+    // the fast algorithms to exact types.
+    // NOTE: the fast algorithms live here rather than in the power_series toolbox: Miller's recurrence needs the
+    // auto-truncation settings, which only polynomials have, and the binomial expansion is profitable only if
+    // the powers of single terms are single terms, which is not the case, e.g., for Poisson series.
+    template <typename T>
+    using fast_pow_mul_t = decltype(std::declval<const T &>() * std::declval<const T &>());
+    template <typename T>
+    using fast_pow_div_t = decltype(std::declval<const T &>() / std::declval<const T &>());
+    template <typename T>
+    using fast_pow_cf_mul_t
+        = decltype(std::declval<const T &>() * std::declval<const typename T::term_type::cf_type &>());
+    template <typename T>
+    using fast_pow_degree_t = enable_if_t<has_safe_cast<integer, degree_type<T>>::value, degree_type<T>>;
+    template <typename T, typename U = polynomial>
+    using fast_pow_checks
+        = conjunction<std::is_same<pow_ret_type<T>, U>,
+                      std::integral_constant<bool, ps_term_score<typename U::term_type>::value == 2u>,
+                      is_detected<at_degree_enabler, U>, is_detected<fast_pow_degree_t, U>, has_exact_addition<Cf>,
+                      std::is_constructible<Cf, const integer &>, std::is_same<detected_t<fast_pow_mul_t, Cf>, Cf>,
+                      std::is_same<detected_t<fast_pow_div_t, Cf>, Cf>, std::is_same<detected_t<fast_pow_mul_t, U>, U>,
+                      std::is_same<detected_t<fast_pow_cf_mul_t, U>, U>>;
+    // Default exponentiation.
+    template <typename T>
+    pow_ret_type<T> fast_pow(const T &x, const std::false_type &) const
+    {
+        return static_cast<series<Cf, Key, polynomial<Cf, Key>> const *>(this)->pow(x);
+    }
+    // Strategy selection for the exponentiation of polynomials with at least two terms.
+    template <typename T>
+    pow_ret_type<T> fast_pow(const T &x, const std::true_type &) const
+    {
+        integer n;
+        try {
+            n = safe_cast<integer>(x);
+        } catch (const safe_cast_failure &) {
+            // Non-integral exponent, the default implementation will deal with it.
+            return fast_pow(x, std::false_type{});
+        }
+        if (this->size() >= 2u && n != 0 && n != 1) {
+            const auto t = get_auto_truncate_degree();
+            // The natural powers computed by the fast algorithms are equal to those computed by the default
+            // implementation (the pow cache is cleared when the truncation settings change), thus they are looked up
+            // in and stored into the pow cache of the default implementation.
+            std::size_t n_cache = 0u;
+            bool cacheable = n.sgn() > 0;
+            if (cacheable) {
+                try {
+                    n_cache = safe_cast<std::size_t>(n);
+                } catch (const safe_cast_failure &) {
+                    cacheable = false;
+                }
+            }
+            polynomial retval;
+            if (std::get<0u>(t) == 0) {
+                if (n.sgn() > 0 && this->size() == 2u) {
+                    if (cacheable && this->pow_cache_find(n_cache, retval)) {
+                        return retval;
+                    }
+                    retval = binomial_pow(n);
+                    if (cacheable) {
+                        this->pow_cache_insert(n_cache, retval);
+                    }
+                    return retval;
+                }
+            } else {
+                if (cacheable && this->pow_cache_find(n_cache, retval)) {
+                    return retval;
+                }
+                if (miller_pow(retval, x, n, t)) {
+                    if (cacheable) {
+                        this->pow_cache_insert(n_cache, retval);
+                    }
+                    return retval;
+                }
+            }
+        }
+        return fast_pow(x, std::false_type{});
+    }
+    // Natural power of a polynomial with two terms a and b via the binomial expansion
+    // (a + b)**n = sum_{k=0}^{n} C(n, k) * a**k * b**(n - k).
+    // Only products by single-term polynomials are involved.
+    polynomial binomial_pow(const integer &n) const
+    {
+        using term_type = typename base::term_type;
+        using size_type = typename std::vector<polynomial>::size_type;
+        piranha_assert(this->size() == 2u && n.sgn() > 0);
+        const auto &ss = this->m_symbol_set;
+        auto it = this->m_container.begin();
+        polynomial a, b, one;
+        a.set_symbol_set(ss);
+        a.insert(*it);
+        b.set_symbol_set(ss);
+        b.insert(*++it);
+        one.set_symbol_set(ss);
+        one.insert(term_type(Cf(1), Key(ss)));
+        // The natural powers of b, from b**0 to b**n.
+        const auto size = static_cast<size_type>(safe_cast<size_type>(n) + 1u);
+        std::vector<polynomial> b_pows;
+        b_pows.push_back(one);
+        for (size_type i = 1u; i < size; ++i) {
+            b_pows.push_back(b_pows.back() * b);
+        }
+        polynomial retval, a_pow(std::move(one));
+        retval.set_symbol_set(ss);
+        integer bin(1);
+        for (size_type k = 0u; k < size; ++k) {
+            retval += (a_pow * b_pows[static_cast<size_type>(size - 1u - k)]) * Cf(bin);
+            if (k + 1u < size) {
+                // C(n, k + 1) = C(n, k) * (n - k) / (k + 1), the division is exact.
+                bin = bin * (n - k) / (k + 1u);
+                a_pow = a_pow * a;
+            }
+        }
+        return retval;
+    }
+    // Integral power of a polynomial with a constant term in the presence of degree-based auto-truncation,
+    // via J.C.P. Miller's recurrence. Writing the polynomial as the sum of its homogeneous components
+    // f_0 + f_1 + ... with respect to the truncation degree, with f_0 = c a constant, its power is
+    // g_0 + g_1 + ... with g_0 = c**n and
+    // g_k = 1 / (k * c) * sum_{j=1}^{k} ((n + 1) * j - k) * f_j * g_{k - j}.
+    // The components are computed only up to the truncation degree, and the recurrence is valid also for negative
+    // exponents. The return value is false if the algorithm cannot be applied, in which case retval is untouched.
+    template <typename T, typename Tuple>
+    bool miller_pow(polynomial &retval, const T &x, const integer &n, const Tuple &t) const
+    {
+        using term_type = typename base::term_type;
+        using size_type = typename std::vector<polynomial>::size_type;
+        integer max_degree;
+        try {
+            max_degree = safe_cast<integer>(std::get<1u>(t));
+        } catch (const safe_cast_failure &) {
+            return false;
+        }
+        if (max_degree.sgn() < 0) {
+            return false;
+        }
+        const auto &ss = this->m_symbol_set;
+        const auto idx = ss_intersect_idx(ss, std::get<2u>(t));
+        // Split the polynomial into the constant term and the (sparse) homogeneous components of positive degree,
+        // discarding the terms above the truncation degree.
+        term_type const *c = nullptr;
+        std::map<size_type, polynomial> f;
+        for (const auto &term : this->m_container) {
+            integer d;
+            try {
+                d = safe_cast<integer>(std::get<0u>(t) == 1 ? ps_get_degree(term, ss)
+                                                            : ps_get_degree(term, std::get<2u>(t), idx, ss));
+            } catch (const safe_cast_failure &) {
+                return false;
+            }
+            if (d.sgn() < 0) {
+                return false;
+            }
+            if (d.sgn() == 0) {
+                // The component of degree zero must be a single constant term.
+                if (c != nullptr || !piranha::key_is_one(term.m_key, ss)) {
+                    return false;
+                }
+                c = &term;
+                continue;
+            }
+            if (d > max_degree) {
+                continue;
+            }
+            auto &f_d = f[safe_cast<size_type>(d)];
+            if (f_d.empty()) {
+                f_d.set_symbol_set(ss);
+            }
+            f_d.insert(term);
+        }
+        if (c == nullptr) {
+            return false;
+        }
+        // NOTE: for coefficient types which are not a field (e.g., integers), the power of a non-invertible
+        // constant to a negative exponent is zero.
+        Cf c_n(piranha::pow(c->m_cf, x));
+        if (piranha::is_zero(c_n)) {
+            return false;
+        }
+        // For natural exponents, the degree of the power is bounded.
+        integer max_k(max_degree);
+        if (n.sgn() > 0) {
+            const integer p_degree = f.empty() ? integer{} : n * f.rbegin()->first;
+            if (p_degree < max_k) {
+                max_k = p_degree;
+            }
+        }
+        const auto k_max = safe_cast<size_type>(max_k);
+        std::vector<polynomial> g(1u);
+        g[0u].set_symbol_set(ss);
+        g[0u].insert(term_type(std::move(c_n), Key(ss)));
+        for (size_type k = 1u; k <= k_max; ++k) {
+            polynomial acc;
+            acc.set_symbol_set(ss);
+            for (const auto &p : f) {
+                if (p.first > k) {
+                    break;
+                }
+                const auto &g_kj = g[static_cast<size_type>(k - p.first)];
+                const integer w = (n + 1) * p.first - k;
+                if (g_kj.empty() || w.is_zero()) {
+                    continue;
+                }
+                acc += (p.second * Cf(w)) * g_kj;
+            }
+            // NOTE: the division is exact whenever the power is representable with the coefficient type.
+            const Cf div(Cf(integer(k)) * c->m_cf);
+            g.emplace_back();
+            g.back().set_symbol_set(ss);
+            for (const auto &term : acc.m_container) {
+                g.back().insert(term_type(term.m_cf / div, term.m_key));
+            }
+        }
+        polynomial tmp;
+        tmp.set_symbol_set(ss);
+        for (auto &g_k : g) {
+            tmp += std::move(g_k);
+        }
+        retval = std::move(tmp);
+        return true;
+    }
 
 public:
     /// Series rebind alias.
@@ -519,8 +760,26 @@ public:
      *
      * This exponentiation override will check if the polynomial consists of a single-term with non-unitary
      * key. In that case, the return polynomial will consist of a single term with coefficient computed via
-     * piranha::pow() and key computed via the monomial exponentiation method. Otherwise, the base
-     * (i.e., default) exponentiation method will be used.
+     * piranha::pow() and key computed via the monomial exponentiation method.
+     *
+     * If the exponentiation does not change the coefficient type, the coefficient type is an exact type (a C++
+     * integral type, piranha::integer or piranha::rational) and it supports construction from piranha::integer,
+     * multiplication and division, and \p x represents an integral
+     * value different from 0 and 1, the following strategies are attempted:
+     * - if degree-based auto-truncation is not active, \p x is positive and the polynomial consists of two terms,
+     *   the result is computed via the binomial expansion, which involves only products by single-term polynomials;
+     * - if degree-based auto-truncation is active and the homogeneous component of degree zero of the polynomial
+     *   (with respect to the degree used for truncation) is a single constant term \f$ c \f$ whose power
+     *   \f$ c^x \f$ is not zero, the result is computed via J.C.P. Miller's recurrence for the powers of power
+     *   series. The homogeneous components of the result are computed one at a time up to the truncation degree,
+     *   with a number of multiplications proportional to the number of nonzero homogeneous components of \p this.
+     *   The recurrence is valid also for negative exponents, so that, e.g., \f$ \left( 1 + x \right)^{-1} \f$
+     *   can be computed as a truncated power series.
+     *
+     * The natural powers computed via these strategies share the cache of piranha::series::pow(): they are looked up
+     * in the cache before being computed, and stored into the cache afterwards.
+     *
+     * Otherwise, the base (i.e., default) exponentiation method will be used.
      *
      * @param x exponent.
      *
@@ -530,7 +789,10 @@ public:
      * - piranha::key_is_one() and the exponentiation methods of the key type,
      * - piranha::pow(),
      * - construction of coefficient, key and term,
-     * - piranha::series::insert() , piranha::series::set_symbol_set() and piranha::series::pow().
+     * - piranha::series::insert() , piranha::series::set_symbol_set() and piranha::series::pow(),
+     * - piranha::safe_cast(), piranha::is_zero(), piranha::polynomial::get_auto_truncate_degree(),
+     * - arithmetic operations on coefficients and polynomials,
+     * - memory errors in standard containers.
      */
     template <typename T>
     pow_ret_type<T> pow(const T &x) const
@@ -547,7 +809,7 @@ public:
             retval.insert(term_type(std::move(cf), std::move(key)));
             return retval;
         }
-        return static_cast<series<Cf, Key, polynomial<Cf, Key>> const *>(this)->pow(x);
+        return fast_pow(x, std::integral_constant<bool, fast_pow_checks<T>::value>{});
     }
     /// Inversion.
     /**
@@ -578,6 +840,8 @@ public:
      * of the coefficient and on the value of the exponent of the integration variable. The integration will
      * fail if the exponent is negative or non-integral.
      *
+     * The terms of large polynomials are integrated in parallel using the threads of piranha::thread_pool.
+     *
      * @param name integration variable.
      *
      * @return the antiderivative of \p this with respect to \p name.
@@ -598,7 +862,6 @@ public:
     {
         typedef typename base::term_type term_type;
         typedef typename term_type::cf_type cf_type;
-        integrate_type<T> retval(0);
         // A copy of the current symbol set plus name. If name is
         // in the set already, it will be just a copy.
         const auto aug_ss = [this, &name]() -> symbol_fset {
@@ -606,21 +869,21 @@ public:
             tmp_ss.insert(name);
             return tmp_ss;
         }();
-        const auto it_f = this->m_container.end();
-        for (auto it = this->m_container.begin(); it != it_f; ++it) {
-            // If the derivative of the coefficient is null, we just need to deal with
-            // the integration of the key.
-            if (piranha::is_zero(math::partial(it->m_cf, name))) {
-                polynomial tmp;
-                tmp.set_symbol_set(aug_ss);
-                auto key_int = it->m_key.integrate(name, this->m_symbol_set);
-                tmp.insert(term_type(cf_type(1), std::move(key_int.second)));
-                retval += (tmp * it->m_cf) / key_int.first;
-            } else {
-                retval += integrate_impl(name, *it, std::integral_constant<bool, is_integrable<cf_type>::value>{});
-            }
-        }
-        return retval;
+        return this->template termwise_accumulate<integrate_type<T>>(
+            [this, &name, &aug_ss](const term_type &t) -> integrate_type<T> {
+                // If the derivative of the coefficient is null, we just need to deal with
+                // the integration of the key.
+                if (piranha::is_zero(math::partial(t.m_cf, name))) {
+                    polynomial tmp;
+                    tmp.set_symbol_set(aug_ss);
+                    auto key_int = t.m_key.integrate(name, this->m_symbol_set);
+                    tmp.insert(term_type(cf_type(1), std::move(key_int.second)));
+                    integrate_type<T> retval(0);
+                    retval += (tmp * t.m_cf) / key_int.first;
+                    return retval;
+                }
+                return this->integrate_impl(name, t, std::integral_constant<bool, is_integrable<cf_type>::value>{});
+            });
     }
     /// Set total-degree-based auto-truncation.
     /**
@@ -810,6 +1073,94 @@ public:
         };
         return um_tm_implementation(p1, p2, runner);
     }
+    /// Out-of-core multiplication.
+    /**
+     * \note
+     * This function template is enabled only if the calling piranha::polynomial satisfies piranha::is_multipliable,
+     * returning the calling piranha::polynomial as return type, and its key type is piranha::kronecker_monomial.
+     *
+     * This function will compute the untruncated product of \p p1 and \p p2 without storing the whole result in
+     * memory. The result is partitioned into polynomials of at most \p max_terms terms, covering disjoint and
+     * increasing ranges of the Kronecker codes of the result, and each partition is written to disk via
+     * piranha::save_file() as soon as it has been computed. The partition of index \p i is saved in the file named
+     * <tt>prefix + "." + std::to_string(i)</tt>, using the data format \p f and the compression method \p c.
+     *
+     * The result of the multiplication is the sum of the partitions: it can be rebuilt by loading
+     * all the partitions via piranha::load_file() and adding them together, or consumed one partition at a time.
+     *
+     * Each partition is first written to a temporary file (whose name is the final name followed by the suffix
+     * <tt>.part</tt>), which is renamed to its final name after piranha::save_file() has returned. If an error
+     * occurs, the temporary file and all the partitions saved so far are removed before the exception is re-thrown.
+     *
+     * The working memory of this function is proportional to the size of the smaller operand plus \p max_terms.
+     * See series_multiplier::_streaming_multiplication() for the details of the implementation. Note that this
+     * function is available only if the operands are of the same type and no type promotions affect the coefficient
+     * types during multiplication.
+     *
+     * @param p1 the first operand.
+     * @param p2 the second operand.
+     * @param prefix the prefix of the names of the files into which the partitions will be saved.
+     * @param max_terms the maximum number of terms in each partition.
+     * @param f the data format of the files.
+     * @param c the compression method of the files.
+     *
+     * @return the names of the files that were written, in ascending order of Kronecker codes (the vector is empty
+     * if the product is zero).
+     *
+     * @throws std::invalid_argument if \p max_terms is zero.
+     * @throws std::runtime_error if a temporary file cannot be renamed to its final name.
+     * @throws unspecified any exception thrown by:
+     * - the public interface of the specialisation of piranha::series_multiplier for piranha::polynomial,
+     * - the public interface of piranha::symbol_fset,
+     * - the public interface of piranha::series,
+     * - piranha::save_file(),
+     * - memory errors in standard containers.
+     */
+    template <typename T = polynomial, oocm_enabler<T> = 0>
+    static std::vector<std::string> out_of_core_multiplication(const polynomial &p1, const polynomial &p2,
+                                                               const std::string &prefix,
+                                                               const typename base::size_type &max_terms,
+                                                               data_format f, compression c)
+    {
+        std::vector<std::string> retval;
+        auto saver = [&retval, &prefix, f, c](const polynomial &part) {
+            auto filename = prefix + "." + std::to_string(retval.size());
+            const auto tmp_filename = filename + ".part";
+            try {
+                save_file(part, tmp_filename, f, c);
+                // NOTE: on POSIX systems std::rename() atomically replaces an existing file. On other platforms
+                // (e.g., Windows) it fails if the target exists: only in this case remove the target first
+                // and try again, accepting a short window in which no file with the final name exists.
+                bool failed = std::rename(tmp_filename.c_str(), filename.c_str()) != 0;
+                if (failed && std::ifstream(filename).good()) {
+                    failed = std::remove(filename.c_str()) != 0
+                             || std::rename(tmp_filename.c_str(), filename.c_str()) != 0;
+                }
+                if (unlikely(failed)) {
+                    piranha_throw(std::runtime_error,
+                                  "the file '" + tmp_filename + "' could not be renamed to '" + filename + "'");
+                }
+            } catch (...) {
+                std::remove(tmp_filename.c_str());
+                throw;
+            }
+            retval.push_back(std::move(filename));
+        };
+        auto runner = [&saver, &max_terms](const polynomial &a, const polynomial &b) {
+            series_multiplier<polynomial>(a, b)._streaming_multiplication(saver, max_terms);
+            return polynomial{};
+        };
+        try {
+            um_tm_implementation(p1, p2, runner);
+        } catch (...) {
+            // Do not leave an incomplete result on disk.
+            for (const auto &filename : retval) {
+                std::remove(filename.c_str());
+            }
+            throw;
+        }
+        return retval;
+    }
     /// Truncated multiplication (total degree).
     /**
      * \note
@@ -961,6 +1312,92 @@ const bool has_get_auto_truncate_degree<S>::value;
 // Global enabler for the polynomial multiplier.
 template <typename Series>
 using poly_multiplier_enabler = typename std::enable_if<std::is_base_of<detail::polynomial_tag, Series>::value>::type;
+
+#if defined(PIRANHA_HAVE_GCC_INT128)
+
+// 128-bit integer types, used as accumulators in the polynomial multiplier.
+__extension__ typedef __int128 poly_int128_t;
+__extension__ typedef unsigned __int128 poly_uint128_t;
+
+template <typename T>
+using is_poly_int128 = std::is_same<T, poly_int128_t>;
+
+#else
+
+template <typename T>
+using is_poly_int128 = std::false_type;
+
+#endif
+
+// Conversion of a machine integer accumulator to an mp++ integer or to a fixed integer.
+template <typename Int, typename T,
+          typename std::enable_if<std::is_integral<T>::value && !is_poly_int128<T>::value, int>::type = 0>
+inline Int small_acc_to_integer(const T &n)
+{
+    return Int(n);
+}
+
+#if defined(PIRANHA_HAVE_GCC_INT128)
+
+template <typename Int, typename T,
+          typename std::enable_if<is_poly_int128<T>::value && !is_fixed_integer<Int>::value, int>::type = 0>
+inline Int small_acc_to_integer(const T &n)
+{
+    // NOTE: the accumulators are guaranteed never to reach the minimum value of the 128-bit type,
+    // so we can safely negate here.
+    const bool neg = n < 0;
+    const auto u = static_cast<poly_uint128_t>(neg ? -n : n);
+    const auto lo = static_cast<std::uint_least64_t>(u & std::numeric_limits<std::uint_least64_t>::max()),
+               hi = static_cast<std::uint_least64_t>(u >> 64);
+    Int retval(lo);
+    if (hi) {
+        // NOTE: use two shifts of 32 bits, as unsigned long might be a 32-bit type.
+        Int tmp(hi);
+        tmp *= static_cast<std::uint_least64_t>(1u) << 32;
+        tmp *= static_cast<std::uint_least64_t>(1u) << 32;
+        retval += tmp;
+    }
+    if (neg) {
+        retval.neg();
+    }
+    return retval;
+}
+
+template <typename Int, typename T,
+          typename std::enable_if<is_poly_int128<T>::value && is_fixed_integer<Int>::value, int>::type = 0>
+inline Int small_acc_to_integer(const T &n)
+{
+    using value_type = typename Int::value_type;
+    if (unlikely(n > std::numeric_limits<value_type>::max() || n < std::numeric_limits<value_type>::min())) {
+        piranha_throw(std::overflow_error, "overflow in the accumulation of the fixed integer coefficients of a "
+                                           "polynomial multiplication");
+    }
+    return Int(static_cast<value_type>(n));
+}
+
+#endif
+
+// Term type used in the Kronecker multiplication of polynomials when the accumulation
+// of the coefficients is performed in a type different from the coefficient type.
+template <typename Key, typename Acc>
+struct kronecker_acc_term {
+    kronecker_acc_term() : m_key(), m_cf() {}
+    bool operator==(const kronecker_acc_term &other) const
+    {
+        return m_key == other.m_key;
+    }
+    Key m_key;
+    mutable Acc m_cf;
+};
+
+// Hasher for kronecker_acc_term, consistent with the hashing of polynomial terms.
+struct kronecker_acc_term_hasher {
+    template <typename Key, typename Acc>
+    std::size_t operator()(const kronecker_acc_term<Key, Acc> &t) const
+    {
+        return std::hash<Key>{}(t.m_key);
+    }
+};
 }
 
 /// Specialisation of piranha::series_multiplier for piranha::polynomial.
@@ -1288,6 +1725,24 @@ public:
         }
         check_bounds();
     }
+    /// Constructor from frozen series.
+    /**
+     * This constructor is equivalent to the constructor from \p Series, but it uses the base constructor from
+     * piranha::frozen_series. The frozen operands must not be modified or destroyed while \p this is in use.
+     *
+     * @param f1 first frozen series operand.
+     * @param f2 second frozen series operand.
+     *
+     * @throws std::overflow_error if a bounds check fails.
+     * @throws unspecified any exception thrown by the constructor from \p Series.
+     */
+    explicit series_multiplier(const frozen_series<Series> &f1, const frozen_series<Series> &f2) : base(f1, f2)
+    {
+        if (unlikely(this->m_v1.empty() || this->m_v2.empty() || this->m_ss.size() == 0u)) {
+            return;
+        }
+        check_bounds();
+    }
     /// Perform multiplication.
     /**
      * \note
@@ -1369,6 +1824,9 @@ public:
      * - piranha::base_series_multiplier::plain_multiplication() and _get_skip_limits() can be called.
      *
      * This method will perform the truncated multiplication of the series operands passed to the constructor.
+     * If the key type is piranha::kronecker_monomial, the multiplication will be performed with the same
+     * Kronecker algorithms used in the untruncated case, otherwise
+     * piranha::base_series_multiplier::plain_multiplication() will be used.
      * The truncation degree is set to \p max_degree, and it is either:
      * - the total maximum degree, if the number of \p Args is zero, or
      * - the partial degree, if the number of \p Args is two.
@@ -1394,9 +1852,6 @@ public:
     template <typename T, typename... Args>
     Series _truncated_multiplication(const T &max_degree, const Args &... args) const
     {
-        // NOTE: a possible optimisation here is the following: if the sum degrees of the arguments is less than
-        // or equal to the max truncation degree, just do the normal multiplication - which can also then take
-        // advantage of faster Kronecker multiplication, if the series are suitable.
         using term_type = typename Series::term_type;
         // NOTE: degree type is the same in total and partial.
         using degree_type = decltype(ps_get_degree(term_type{}, this->m_ss));
@@ -1431,12 +1886,8 @@ public:
                        [&v_d2](const size_type &i) { return v_d2[static_cast<d_size_type>(i)]; });
         this->m_v2 = std::move(v2_copy);
         v_d2 = std::move(v_d2_copy);
-        // Now get the skip limits and we build the limits functor.
-        const auto sl = _get_skip_limits(v_d1, v_d2, max_degree);
-        auto lf = [&sl](const size_type &idx1) {
-            return sl[static_cast<typename std::vector<size_type>::size_type>(idx1)];
-        };
-        return this->plain_multiplication(lf);
+        // Now get the skip limits and run the multiplication.
+        return truncated_mult_impl(_get_skip_limits(v_d1, v_d2, max_degree));
     }
     /// Establish skip limits for truncated multiplication.
     /**
@@ -1519,6 +1970,50 @@ public:
         piranha_assert(retval_checker());
         return retval;
     }
+    /// Streaming multiplication.
+    /**
+     * \note
+     * This method can be used only if operator()() can be called and the key type of \p Series is
+     * a piranha::kronecker_monomial.
+     *
+     * This method will compute the untruncated product of the two polynomials used as input arguments in the
+     * class' constructor without ever storing the whole result in memory. The terms of the result are computed in
+     * ascending order of their Kronecker codes, and they are collected into partial results of at most
+     * \p max_terms terms each. As soon as a partial result is complete, it is passed as a \p Series lvalue to the
+     * functor \p f (which can, e.g., write it to disk or move it somewhere else), and then it is discarded. The
+     * partial results cover disjoint and increasing ranges of Kronecker codes, so that their sum is the product of
+     * the operands. If the product is zero, \p f will never be called.
+     *
+     * The working memory used by this method is proportional to the size of the smaller operand plus
+     * \p max_terms, and the multiplication is performed in the calling thread.
+     *
+     * @param f the functor that will be invoked with each partial result.
+     * @param max_terms the maximum number of terms in each partial result.
+     *
+     * @throws std::invalid_argument if \p max_terms is zero.
+     * @throws unspecified any exception thrown by:
+     * - \p f,
+     * - piranha::base_series_multiplier::finalise_series(),
+     * - <tt>boost::numeric_cast()</tt>,
+     * - the public interface of piranha::hash_set,
+     * - piranha::safe_cast(),
+     * - memory errors in standard containers,
+     * - the arithmetic operations on the coefficients.
+     */
+    template <typename F, typename T = Series, call_enabler<T> = 0,
+              typename std::enable_if<detail::is_kronecker_monomial<typename T::term_type::key_type>::value, int>::type
+              = 0>
+    void _streaming_multiplication(const F &f, const typename base::bucket_size_type &max_terms) const
+    {
+        if (unlikely(!max_terms)) {
+            piranha_throw(std::invalid_argument, "the maximum number of terms in the partial results of a "
+                                                 "streaming multiplication must be nonzero");
+        }
+        if (unlikely(!this->m_v1.size() || !this->m_v2.size())) {
+            return;
+        }
+        kronecker_access_dispatch(kronecker_stream_op<F>{*this, f, max_terms});
+    }
     //@}
 private:
     // NOTE: wrapper to multadd that treats specially rational coefficients. We need to decide in the future
@@ -1604,8 +2099,8 @@ private:
     {
         return false;
     }
-    // Case 2: Kronecker mult, do the special multiplication unless a truncation is active. In that case, run the
-    // plain mult.
+    // Case 2: Kronecker mult, do the special multiplication. If a truncation is active, the wrapper
+    // will end up in truncated_mult_impl().
     template <typename T = Series,
               typename std::enable_if<detail::is_kronecker_monomial<typename T::term_type::key_type>::value, int>::type
               = 0>
@@ -1616,6 +2111,47 @@ private:
         }
         return untruncated_kronecker_mult();
     }
+    // Truncated multiplication with skip limits sl (see _get_skip_limits()).
+    // Case 1: not a Kronecker monomial, do the plain mult using the skip limits as limit functor.
+    template <typename T = Series,
+              typename std::enable_if<!detail::is_kronecker_monomial<typename T::term_type::key_type>::value, int>::type
+              = 0>
+    Series truncated_mult_impl(std::vector<typename base::size_type> sl) const
+    {
+        using size_type = typename base::size_type;
+        auto lf = [&sl](const size_type &idx1) {
+            return sl[static_cast<typename std::vector<size_type>::size_type>(idx1)];
+        };
+        return this->plain_multiplication(lf);
+    }
+    // Case 2: Kronecker monomial. The skip limits are passed to the Kronecker multiplication routines, which use
+    // them to restrict the term-by-term multiplications.
+    template <typename T = Series,
+              typename std::enable_if<detail::is_kronecker_monomial<typename T::term_type::key_type>::value, int>::type
+              = 0>
+    Series truncated_mult_impl(std::vector<typename base::size_type> sl) const
+    {
+        using size_type = typename base::size_type;
+        const auto size1 = this->m_v1.size(), size2 = this->m_v2.size();
+        piranha_assert(sl.size() == size1);
+        auto lf = [&sl](const size_type &idx1) {
+            return sl[static_cast<typename std::vector<size_type>::size_type>(idx1)];
+        };
+        // Same logic as in untruncated_kronecker_mult() for the estimation.
+        const auto e_thr = tuning::get_estimate_threshold();
+        if (integer(size1) * size2 < integer(e_thr) * e_thr && this->m_n_threads == 1u) {
+            return this->plain_multiplication(lf);
+        }
+        Series retval;
+        retval.set_symbol_set(this->m_ss);
+        if (unlikely(!size1 || !size2)) {
+            return retval;
+        }
+        const auto est
+            = this->template estimate_final_series_size<1u, typename base::template plain_multiplier<false>>(lf);
+        kronecker_multiplication(retval, est, sl);
+        return retval;
+    }
     template <typename T = Series,
               typename std::enable_if<detail::is_kronecker_monomial<typename T::term_type::key_type>::value, int>::type
               = 0>
@@ -1644,27 +2180,890 @@ private:
         if (unlikely(!size1 || !size2)) {
             return retval;
         }
+        // Use either the sketch or the plain functor in normal mode for the estimation.
+        const auto est
+            = tuning::get_sketch_estimation()
+                  ? this->cached_estimate([this]() { return this->kronecker_sketch_estimate(); })
+                  : this->template estimate_final_series_size<1u, typename base::template plain_multiplier<false>>();
+        // No skip limits in the untruncated case.
+        std::vector<typename base::size_type> sl;
+        kronecker_multiplication(retval, est, sl);
+        return retval;
+    }
+    // Estimate the size of the result of the untruncated Kronecker multiplication via KMV sketches of the
+    // distinct keys of the result. The keys of the result are computed by adding the packed keys of the
+    // operands, without any coefficient arithmetic and without storing terms in a hash table.
+    // In order to keep the cost of the estimation linear in the size of the operands, only a random sample of
+    // the terms of the larger operand is multiplied by all the terms of the smaller one. The sample is split in two
+    // halves of m terms each: the number of distinct keys D1 produced by the first half and D2 produced by the whole
+    // sample give the rate at which new keys appear as more terms are added, and the estimate is extrapolated
+    // linearly from this rate to the full size n of the larger operand as D2 + (n - 2m) * (D2 - D1) / m.
+    // Since the rate of appearance of new keys does not increase as terms are added, the extrapolation
+    // tends to overestimate, which is the safe direction for the sizing of the result.
+    // NOTE: the sketches do not account for cancellations in the coefficients, thus the estimate is an
+    // estimate of the number of distinct keys in the result.
+    typename base::bucket_size_type kronecker_sketch_estimate() const
+    {
+        using size_type = typename base::size_type;
+        // NOTE: tuning parameters. k is the number of hash values kept in each sketch (the relative standard
+        // error of a sketch is about 3%), pair_budget the approximate number of products of keys to be sketched
+        // and min_sample the minimum number of terms in each half of the sample.
+        const std::size_t k = 1024u, pair_budget = 1u << 22, min_sample = 16u;
+        // The rows of the sample are the terms of the larger series.
+        const bool swap = this->m_v1.size() < this->m_v2.size();
+        const auto &v1 = swap ? this->m_v2 : this->m_v1;
+        const auto &v2 = swap ? this->m_v1 : this->m_v2;
+        const size_type size1 = v1.size(), size2 = v2.size();
+        piranha_assert(size1 && size2);
+        // Number of rows in each half of the sample.
+        const auto m = static_cast<size_type>(std::max<std::size_t>(min_sample, pair_budget / 2u / size2));
+        // The sampled rows: if the sample would cover the whole series, just sketch the whole multiplication.
+        // NOTE: the random engine is default-seeded, so that the estimate is deterministic.
+        const bool exact = size1 / 2u <= m;
+        std::vector<size_type> idx(size1);
+        std::iota(idx.begin(), idx.end(), size_type(0u));
+        if (!exact) {
+            std::mt19937 engine;
+            std::shuffle(idx.begin(), idx.end(), engine);
+            idx.resize(static_cast<size_type>(m * 2u));
+        }
+        const size_type half = exact ? size1 : m, n_rows = static_cast<size_type>(idx.size());
+        const unsigned n_threads = this->m_n_threads;
+        // Per-thread sketches for the two halves of the sample.
+        std::vector<detail::kmv_sketch> sketches1(n_threads, detail::kmv_sketch(k)),
+            sketches2(n_threads, detail::kmv_sketch(k));
+        // Each thread deals with a block of each half of the sample.
+        auto thread_func = [&v1, &v2, &idx, &sketches1, &sketches2, size2, half, n_rows, n_threads](unsigned t_idx) {
+            using int_type = decltype(v1[0]->m_key.get_int());
+            auto sketch_rows = [&](detail::kmv_sketch &sk, size_type start, size_type end) {
+                const auto block_size = static_cast<size_type>((end - start) / n_threads);
+                const auto b_start = static_cast<size_type>(start + t_idx * block_size),
+                           b_end = (t_idx == n_threads - 1u) ? end
+                                                             : static_cast<size_type>(start + (t_idx + 1u) * block_size);
+                for (auto i = b_start; i < b_end; ++i) {
+                    const int_type key1 = v1[idx[i]]->m_key.get_int();
+                    for (size_type j = 0u; j < size2; ++j) {
+                        // NOTE: the sum cannot overflow, as we checked the bounds of the multiplication
+                        // in the constructor.
+                        const auto key = static_cast<int_type>(key1 + v2[j]->m_key.get_int());
+                        sk.add(detail::hash_mix64(static_cast<std::uint64_t>(key)));
+                    }
+                }
+            };
+            sketch_rows(sketches1[t_idx], 0u, half);
+            sketch_rows(sketches2[t_idx], half, n_rows);
+        };
+        if (n_threads == 1u) {
+            thread_func(0u);
+        } else {
+            future_list<void> ff_list;
+            try {
+                for (unsigned i = 0u; i < n_threads; ++i) {
+                    ff_list.push_back(thread_pool::enqueue(i, thread_func, i));
+                }
+                // First let's wait for everything to finish.
+                ff_list.wait_all();
+                // Then, let's handle the exceptions.
+                ff_list.get_all();
+            } catch (...) {
+                ff_list.wait_all();
+                throw;
+            }
+            for (unsigned i = 1u; i < n_threads; ++i) {
+                sketches1[0].merge(sketches1[i]);
+                sketches2[0].merge(sketches2[i]);
+            }
+        }
+        const double d1 = sketches1[0].estimate();
+        double retval = d1;
+        if (!exact) {
+            // Distinct keys in the whole sample.
+            sketches2[0].merge(sketches1[0]);
+            const double d2 = std::max(d1, sketches2[0].estimate()),
+                         max_size = static_cast<double>(size1) * static_cast<double>(size2);
+            retval = d2 + (static_cast<double>(size1) - static_cast<double>(n_rows)) * (d2 - d1) / static_cast<double>(m);
+            // The result cannot be larger than the number of products of terms.
+            retval = std::min(retval, max_size);
+        }
+        // Never return zero.
+        return boost::numeric_cast<typename base::bucket_size_type>(std::max(1., std::ceil(retval)));
+    }
+    // Coefficient accessors for the Kronecker multiplication routines. An accessor provides the coefficients
+    // of the input terms, the type used to accumulate the coefficients of the result, and the operations on it.
+    // Generic accessor: the coefficients are accumulated directly into objects of the coefficient type.
+    class kronecker_cf_access
+    {
+    public:
+        using acc_type = cf_t<Series>;
+        explicit kronecker_cf_access(const typename base::v_ptr &v1, const typename base::v_ptr &v2)
+            : m_v1(v1), m_v2(v2)
+        {
+        }
+        // Nothing to do here, the coefficients are read directly from the input terms.
+        void load() {}
+        const acc_type &c1(const typename base::size_type &i) const
+        {
+            return m_v1[i]->m_cf;
+        }
+        const acc_type &c2(const typename base::size_type &j) const
+        {
+            return m_v2[j]->m_cf;
+        }
+        static void mult(acc_type &out, const acc_type &a, const acc_type &b)
+        {
+            cf_mult_impl(out, a, b);
+        }
+        static void fma(acc_type &out, const acc_type &a, const acc_type &b)
+        {
+            fma_wrap(out, a, b);
+        }
+        static bool is_zero(const acc_type &x)
+        {
+            return piranha::is_zero(x);
+        }
+        static void to_cf(acc_type &out, acc_type &x)
+        {
+            out = std::move(x);
+        }
+
+    private:
+        const typename base::v_ptr &m_v1;
+        const typename base::v_ptr &m_v2;
+    };
+    // Accessor for small mp++ integer/rational and fixed integer coefficients: the coefficients of the input terms
+    // are copied into vectors of machine integers, and they are accumulated into values of type Acc.
+    template <typename Acc>
+    class kronecker_small_cf_access
+    {
+    public:
+        using acc_type = Acc;
+        using int_type = std::int_least64_t;
+        explicit kronecker_small_cf_access(const typename base::v_ptr &v1, const typename base::v_ptr &v2)
+            : m_v1(v1), m_v2(v2)
+        {
+        }
+        // Copy the coefficients of the input terms. This needs to be called after the multiplication
+        // routines have established the final ordering of the input terms.
+        void load()
+        {
+            auto loader = [](const typename base::v_ptr &v, std::vector<int_type> &out) {
+                out.resize(safe_cast<typename std::vector<int_type>::size_type>(v.size()));
+                std::transform(v.begin(), v.end(), out.begin(), [](typename base::v_ptr::value_type p) {
+                    return static_cast<int_type>(small_cf_integer(p->m_cf));
+                });
+            };
+            loader(m_v1, m_c1);
+            loader(m_v2, m_c2);
+        }
+        const int_type &c1(const typename base::size_type &i) const
+        {
+            return m_c1[static_cast<typename std::vector<int_type>::size_type>(i)];
+        }
+        const int_type &c2(const typename base::size_type &j) const
+        {
+            return m_c2[static_cast<typename std::vector<int_type>::size_type>(j)];
+        }
+        static void mult(acc_type &out, const int_type &a, const int_type &b)
+        {
+            out = static_cast<acc_type>(static_cast<acc_type>(a) * b);
+        }
+        static void fma(acc_type &out, const int_type &a, const int_type &b)
+        {
+            out = static_cast<acc_type>(out + static_cast<acc_type>(a) * b);
+        }
+        static bool is_zero(const acc_type &x)
+        {
+            return x == 0;
+        }
+        static void to_cf(cf_t<Series> &out, acc_type &x)
+        {
+            using int_t = uncvref_t<decltype(small_cf_integer(out))>;
+            out = cf_t<Series>(detail::small_acc_to_integer<int_t>(x));
+        }
+
+    private:
+        const typename base::v_ptr &m_v1;
+        const typename base::v_ptr &m_v2;
+        std::vector<int_type> m_c1;
+        std::vector<int_type> m_c2;
+    };
+    // Adaptor for an accessor Access whose accumulator type is not the coefficient type: the term-by-term products
+    // are computed via Access, converted to the coefficient type and accumulated directly into objects of the
+    // coefficient type. The conversions are exact, as the products satisfy the same bound as the accumulated values.
+    template <typename Access>
+    class kronecker_direct_access
+    {
+        using int_type = typename Access::int_type;
+
+    public:
+        using acc_type = cf_t<Series>;
+        explicit kronecker_direct_access(Access &ca) : m_ca(ca) {}
+        void load()
+        {
+            m_ca.load();
+        }
+        const int_type &c1(const typename base::size_type &i) const
+        {
+            return m_ca.c1(i);
+        }
+        const int_type &c2(const typename base::size_type &j) const
+        {
+            return m_ca.c2(j);
+        }
+        static void mult(acc_type &out, const int_type &a, const int_type &b)
+        {
+            typename Access::acc_type tmp;
+            Access::mult(tmp, a, b);
+            Access::to_cf(out, tmp);
+        }
+        static void fma(acc_type &out, const int_type &a, const int_type &b)
+        {
+            acc_type tmp;
+            mult(tmp, a, b);
+            out += tmp;
+        }
+        static bool is_zero(const acc_type &x)
+        {
+            return piranha::is_zero(x);
+        }
+        static void to_cf(acc_type &out, acc_type &x)
+        {
+            out = std::move(x);
+        }
+
+    private:
+        Access &m_ca;
+    };
+    // Integral value of a small coefficient: for rationals, this is the numerator (the multiplier has
+    // already reduced the multiplication of rationals to the multiplication of integers). Fixed integers
+    // are returned as they are.
+    template <typename T, typename std::enable_if<mppp::is_integer<T>::value, int>::type = 0>
+    static const T &small_cf_integer(const T &x)
+    {
+        return x;
+    }
+    template <typename T, typename std::enable_if<is_fixed_integer<T>::value, int>::type = 0>
+    static const T &small_cf_integer(const T &x)
+    {
+        return x;
+    }
+    template <typename T, typename std::enable_if<mppp::is_rational<T>::value, int>::type = 0>
+    static const typename T::int_t &small_cf_integer(const T &x)
+    {
+        piranha_assert(x.get_den().is_one());
+        return x.get_num();
+    }
+    // Number of bits needed to represent the worst-case value of the accumulated coefficients of the result.
+    // This will return zero if the coefficients of the operands are too large to be represented in
+    // kronecker_small_cf_access::int_type.
+    unsigned small_cf_acc_nbits() const
+    {
+        using int_type = std::int_least64_t;
+        auto max_nbits = [](const typename base::v_ptr &v) {
+            std::size_t retval = 0u;
+            for (const auto &p : v) {
+                retval = std::max<std::size_t>(retval, small_cf_integer(p->m_cf).nbits());
+            }
+            return retval;
+        };
+        const auto nb1 = max_nbits(this->m_v1), nb2 = max_nbits(this->m_v2);
+        if (nb1 > unsigned(std::numeric_limits<int_type>::digits)
+            || nb2 > unsigned(std::numeric_limits<int_type>::digits)) {
+            return 0u;
+        }
+        // Each coefficient of the result is the sum of at most min(size1, size2) term-by-term products,
+        // hence we need to add ceil(log2(min(size1, size2))) bits.
+        unsigned nb_sum = 0u;
+        for (auto tmp = static_cast<typename base::size_type>(std::min(this->m_v1.size(), this->m_v2.size()) - 1u);
+             tmp; tmp = static_cast<typename base::size_type>(tmp >> 1u)) {
+            ++nb_sum;
+        }
+        return static_cast<unsigned>(nb1 + nb2 + nb_sum);
+    }
+    // Coefficient types for which accumulation in machine integers is supported.
+    template <typename T>
+    using has_small_cf = disjunction<mppp::is_integer<T>, mppp::is_rational<T>, is_fixed_integer<T>>;
+    // Functors used to run the Kronecker multiplication algorithms with the accessor selected
+    // by kronecker_access_dispatch().
+    template <typename E>
+    struct kronecker_mult_op {
+        template <typename Access>
+        void operator()(Access &ca) const
+        {
+            m_mult.kronecker_multiplication_impl(m_retval, m_est, ca, m_sl);
+        }
+        const series_multiplier &m_mult;
+        Series &m_retval;
+        const E &m_est;
+        std::vector<typename base::size_type> &m_sl;
+    };
+    template <typename F>
+    struct kronecker_stream_op {
+        template <typename Access>
+        void operator()(Access &ca) const
+        {
+            m_mult.streaming_kronecker_multiplication(ca, m_f, m_max_terms);
+        }
+        const series_multiplier &m_mult;
+        const F &m_f;
+        const typename base::bucket_size_type &m_max_terms;
+    };
+    // Kronecker multiplication with skip limits sl, indexed as m_v1 (see _get_skip_limits()). sl is empty
+    // if the multiplication is not truncated. Both m_v1 and sl might be reordered by the multiplication routines.
+    template <typename E>
+    void kronecker_multiplication(Series &retval, const E &est, std::vector<typename base::size_type> &sl) const
+    {
+        kronecker_access_dispatch(kronecker_mult_op<E>{*this, retval, est, sl});
+    }
+    // Selection of the coefficient accessor for the Kronecker multiplication algorithms according to the
+    // coefficient type. The functor op is then invoked with the accessor.
+    // Case 1: the coefficients are not integral, accumulate directly into the coefficients.
+    template <typename Op, typename T = Series, typename std::enable_if<!has_small_cf<cf_t<T>>::value, int>::type = 0>
+    void kronecker_access_dispatch(const Op &op) const
+    {
+        kronecker_cf_access ca(this->m_v1, this->m_v2);
+        op(ca);
+    }
+    // Case 2: mp++ integer, rational or fixed integer coefficients. If the coefficients of the operands are small
+    // enough that the worst-case value of the coefficients of the result can be represented in a machine integer,
+    // we do all the accumulations in machine integers and convert to the coefficient type only at the end.
+    // Otherwise, we fall back to the generic accessor (which, for fixed integers, will check for overflow
+    // at every accumulation).
+    // NOTE: the bound is computed once for the whole product (from the largest coefficients of the operands and
+    // from the size of the smaller operand), rather than for each term of the result. This is coarser than
+    // a per-term bound, but it needs no overflow checks in the inner loops and no fallback in the middle of
+    // a multiplication: a single large coefficient sends the whole product to the generic accessor.
+    template <typename Op, typename T = Series, typename std::enable_if<has_small_cf<cf_t<T>>::value, int>::type = 0>
+    void kronecker_access_dispatch(const Op &op) const
+    {
+        const auto nbits = small_cf_acc_nbits();
+        if (nbits && nbits <= unsigned(std::numeric_limits<std::int_least64_t>::digits)) {
+            kronecker_small_cf_access<std::int_least64_t> ca(this->m_v1, this->m_v2);
+            op(ca);
+            return;
+        }
+#if defined(PIRANHA_HAVE_GCC_INT128)
+        if (nbits && nbits <= 127u) {
+            kronecker_small_cf_access<detail::poly_int128_t> ca(this->m_v1, this->m_v2);
+            op(ca);
+            return;
+        }
+#endif
+        kronecker_cf_access ca(this->m_v1, this->m_v2);
+        op(ca);
+    }
+    template <typename E, typename Access>
+    void kronecker_multiplication_impl(Series &retval, const E &est, Access &ca,
+                                       std::vector<typename base::size_type> &sl) const
+    {
+        // If the product is large and very sparse and we are running in single-threaded mode, use the heap
+        // algorithm. This does not need the hash table sized according to the estimate, so we check it before
+        // the rehash.
+        // NOTE: the heap and dense algorithms do not support truncation.
+        if (sl.empty() && heap_is_profitable(est)) {
+            heap_kronecker_multiplication(retval, ca);
+            return;
+        }
         // Rehash the retun value's container accordingly. Check the tuning flag to see if we want to use
         // multiple threads for initing the return value.
         // NOTE: it is important here that we use the same n_threads for multiplication and memset as
         // we tie together pinned threads with potentially different NUMA regions.
         const unsigned n_threads_rehash = tuning::get_parallel_memory_set() ? this->m_n_threads : 1u;
-        // Use the plain functor in normal mode for the estimation.
-        const auto est
-            = this->template estimate_final_series_size<1u, typename base::template plain_multiplier<false>>();
         // NOTE: if something goes wrong here, no big deal as retval is still empty.
         retval._container().rehash(boost::numeric_cast<typename Series::size_type>(
                                        std::ceil(static_cast<double>(est) / retval._container().max_load_factor())),
                                    n_threads_rehash);
         piranha_assert(retval._container().bucket_count());
-        sparse_kronecker_multiplication(retval);
-        return retval;
+        // If the product is dense enough, accumulate the result into a flat array of coefficients.
+        if (tuning::get_dense_multiplication() && sl.empty() && dense_kronecker_multiplication(retval, est, ca)) {
+            return;
+        }
+        // In single-threaded mode, optionally accumulate into an open-addressing hash table.
+        if (this->m_n_threads == 1u && tuning::get_open_addressing_multiplication()) {
+            oa_kronecker_multiplication(retval, ca, sl);
+            return;
+        }
+        sparse_kronecker_multiplication(retval, ca, sl, std::is_same<typename Access::acc_type, cf_t<Series>>{});
+    }
+    // Establish if the heap multiplication is profitable. This is the case when the estimated size of the result
+    // is above the threshold set in tuning and it is close to the number of term-by-term multiplications,
+    // that is, when there are few cancellations and the hash table would be large and filled in
+    // a cache-unfriendly way.
+    // NOTE: the heap algorithm is serial. m_n_threads is the number of threads granted by
+    // thread_pool::use_threads(): if it is larger than one, the parallel hash table multiplication is always
+    // preferred, as its speedup outweighs the better locality of the heap algorithm.
+    template <typename E>
+    bool heap_is_profitable(const E &est) const
+    {
+        if (this->m_n_threads != 1u) {
+            return false;
+        }
+        // NOTE: this is a tuning parameter, the maximum ratio between the number of term-by-term
+        // multiplications and the estimated size of the result.
+        const unsigned heap_ratio = 2u;
+        return integer(est) >= tuning::get_heap_multiplication_threshold()
+               && integer(est) * heap_ratio >= integer(this->m_v1.size()) * this->m_v2.size();
+    }
+    // Heap-based Kronecker multiplication (Johnson's algorithm, with the refinements by Monagan and Pearce).
+    // The terms of the two operands are sorted according to their packed keys. The terms of the result
+    // are then produced in ascending key order by merging the size2 rows of the multiplication table
+    // (one for each term of the smaller series) via a min-heap. A row is inserted in the heap only when the
+    // previous row has advanced past its first element, so that only the rows which can contain the next
+    // output term are in the heap. The working memory is O(size2), and the result is built into a hash
+    // table sized according to the exact number of terms produced.
+    // NOTE: the ascending order of the output is not preserved in retval, as series store their terms in
+    // hash tables. The terms are buffered before being inserted so that the table is allocated only once, with
+    // the exact size. The sorted order is exploited only by the streaming multiplication.
+    template <typename Access>
+    void heap_kronecker_multiplication(Series &retval, Access &ca) const
+    {
+        piranha_assert(this->m_n_threads == 1u);
+        using int_type = decltype(std::declval<const key_t<Series> &>().get_int());
+        using acc_type = typename Access::acc_type;
+        std::vector<std::pair<int_type, acc_type>> out;
+        heap_kronecker_stream(ca,
+                              [&out](const int_type &key, acc_type &acc) { out.emplace_back(key, std::move(acc)); });
+        kronecker_build_series(retval, out, ca);
     }
-    void sparse_kronecker_multiplication(Series &retval) const
+    // Build the series retval from the vector out of (packed key, accumulator) pairs, as produced by
+    // heap_kronecker_stream(). The keys in out must be distinct.
+    template <typename V, typename Access>
+    void kronecker_build_series(Series &retval, V &out, const Access &) const
+    {
+        using term_type = typename Series::term_type;
+        auto &container = retval._container();
+        try {
+            if (out.size()) {
+                container.rehash(boost::numeric_cast<typename Series::size_type>(
+                    std::ceil(static_cast<double>(out.size()) / container.max_load_factor())));
+                for (auto &p : out) {
+                    term_type tmp_term;
+                    tmp_term.m_key.set_int(p.first);
+                    Access::to_cf(tmp_term.m_cf, p.second);
+                    const auto idx = container._bucket(tmp_term);
+                    container._unique_insert(std::move(tmp_term), idx);
+                }
+                container._update_size(static_cast<typename Series::size_type>(out.size()));
+            }
+            this->finalise_series(retval);
+        } catch (...) {
+            container.clear();
+            throw;
+        }
+    }
+    // Streaming Kronecker multiplication (see _streaming_multiplication()). The terms produced by the heap
+    // algorithm in ascending key order are buffered, and every max_terms terms the buffer is turned into
+    // a partial result which is handed over to f.
+    template <typename Access, typename F>
+    void streaming_kronecker_multiplication(Access &ca, const F &f,
+                                            const typename base::bucket_size_type &max_terms) const
+    {
+        using int_type = decltype(std::declval<const key_t<Series> &>().get_int());
+        using acc_type = typename Access::acc_type;
+        std::vector<std::pair<int_type, acc_type>> out;
+        auto flush = [this, &out, &ca, &f]() {
+            Series part;
+            part.set_symbol_set(this->m_ss);
+            this->kronecker_build_series(part, out, ca);
+            out.clear();
+            f(part);
+        };
+        heap_kronecker_stream(ca, [&out, &flush, &max_terms](const int_type &key, acc_type &acc) {
+            out.emplace_back(key, std::move(acc));
+            if (out.size() >= max_terms) {
+                flush();
+            }
+        });
+        if (!out.empty()) {
+            flush();
+        }
+    }
+    // Core of the heap-based Kronecker multiplication: the nonzero terms of the result are computed in ascending
+    // order of packed key, and each of them is passed to the functor f as a (packed key, accumulator) pair.
+    template <typename Access, typename F>
+    void heap_kronecker_stream(Access &ca, const F &f) const
+    {
+        using term_type = typename Series::term_type;
+        using int_type = decltype(std::declval<const key_t<Series> &>().get_int());
+        using acc_type = typename Access::acc_type;
+        using size_type = typename base::size_type;
+        auto &v1 = this->m_v1;
+        auto &v2 = this->m_v2;
+        const auto size1 = v1.size();
+        const auto size2 = v2.size();
+        piranha_assert(size1 && size2);
+        // Sort the input terms according to their packed keys.
+        auto term_cmp = [](term_type const *p1, term_type const *p2) {
+            return p1->m_key.get_int() < p2->m_key.get_int();
+        };
+        std::stable_sort(v1.begin(), v1.end(), term_cmp);
+        std::stable_sort(v2.begin(), v2.end(), term_cmp);
+        ca.load();
+        // NOTE: the bounds have been checked in the constructor, so the sum of two packed keys
+        // is the packed key of the product and it does not overflow. Moreover, the sum is strictly
+        // increasing along each row, as the keys in v1 are all distinct.
+        auto item_key = [&v1, &v2](const size_type &i, const size_type &j) {
+            return static_cast<int_type>(v2[i]->m_key.get_int() + v1[j]->m_key.get_int());
+        };
+        // Entries in the heap. The heap is a binary min-heap with respect to the keys, stored in a vector.
+        struct heap_item {
+            int_type m_key;
+            size_type m_i;
+            size_type m_j;
+        };
+        using h_size_type = typename std::vector<heap_item>::size_type;
+        std::vector<heap_item> heap;
+        heap.reserve(static_cast<h_size_type>(size2));
+        // Restore the heap property after the replacement of the top item.
+        auto sift_down = [&heap]() {
+            const auto h_size = heap.size();
+            const auto item = heap[0];
+            h_size_type idx = 0u;
+            while (true) {
+                auto child = static_cast<h_size_type>(2u * idx + 1u);
+                if (child >= h_size) {
+                    break;
+                }
+                if (child + 1u < h_size && heap[child + 1u].m_key < heap[child].m_key) {
+                    ++child;
+                }
+                if (!(heap[child].m_key < item.m_key)) {
+                    break;
+                }
+                heap[idx] = heap[child];
+                idx = child;
+            }
+            heap[idx] = item;
+        };
+        // Insert a new item in the heap.
+        auto push = [&heap](const heap_item &item) {
+            heap.push_back(item);
+            auto idx = static_cast<h_size_type>(heap.size() - 1u);
+            while (idx) {
+                const auto parent = static_cast<h_size_type>((idx - 1u) / 2u);
+                if (!(item.m_key < heap[parent].m_key)) {
+                    break;
+                }
+                heap[idx] = heap[parent];
+                idx = parent;
+            }
+            heap[idx] = item;
+        };
+        heap.push_back(heap_item{item_key(0u, 0u), 0u, 0u});
+        while (!heap.empty()) {
+            const auto cur_key = heap[0].m_key;
+            acc_type acc;
+            // Process all the entries with the current key, accumulating their products. Each processed
+            // entry at the top of the heap is replaced by its successor in the row, or removed if the row
+            // is exhausted.
+            bool first = true;
+            do {
+                const auto i = heap[0].m_i, j = heap[0].m_j;
+                if (first) {
+                    Access::mult(acc, ca.c1(j), ca.c2(i));
+                    first = false;
+                } else {
+                    Access::fma(acc, ca.c1(j), ca.c2(i));
+                }
+                if (j + 1u < size1) {
+                    heap[0] = heap_item{item_key(i, static_cast<size_type>(j + 1u)), i, static_cast<size_type>(j + 1u)};
+                } else {
+                    heap[0] = heap.back();
+                    heap.pop_back();
+                }
+                if (!heap.empty()) {
+                    sift_down();
+                }
+                // When a row starts advancing, the next row becomes eligible for insertion. Its first key
+                // is strictly greater than the current one, as the keys in v2 are all distinct.
+                if (!j && i + 1u < size2) {
+                    push(heap_item{item_key(static_cast<size_type>(i + 1u), 0u), static_cast<size_type>(i + 1u), 0u});
+                }
+            } while (!heap.empty() && heap[0].m_key == cur_key);
+            if (!Access::is_zero(acc)) {
+                f(cur_key, acc);
+            }
+        }
+    }
+    // Dense Kronecker multiplication. The exponents of the terms in the result are mapped into a tight
+    // mixed-radix index spanning the box defined by the minimum/maximum exponents of the product. If the number
+    // of cells in the box is not too large wrt the estimated size of the result, the coefficients are
+    // accumulated in a flat array indexed by the position in the box, and the result is then built
+    // in a single pass over the array. Otherwise, this function will return false without doing anything.
+    template <typename E, typename Access>
+    bool dense_kronecker_multiplication(Series &retval, const E &est, Access &ca) const
+    {
+        using term_type = typename Series::term_type;
+        using cf_type = typename term_type::cf_type;
+        using key_type = typename term_type::key_type;
+        using value_type = typename key_type::value_type;
+        using size_type = typename base::size_type;
+        using e_size_type = typename std::vector<value_type>::size_type;
+        using d_size_type = std::vector<std::size_t>::size_type;
+        // The maximum allowed ratio between the number of cells in the box and the estimated size of the result.
+        // NOTE: this is a tuning parameter. The array of coefficients is allocated in full, so it must not be too
+        // large wrt the size of the output. On the other hand, products in total degree (e.g., the fateman
+        // benchmarks) fill only a fraction of the box, which decreases as the number of variables increases.
+        const unsigned dense_ratio = 32u;
+        auto &v1 = this->m_v1;
+        auto &v2 = this->m_v2;
+        const auto size1 = v1.size(), size2 = v2.size();
+        const auto n_vars = safe_cast<e_size_type>(this->m_ss.size());
+        // Nothing to gain if there are no variables.
+        if (unlikely(!n_vars)) {
+            return false;
+        }
+        // Unpack the exponents of the two operands into flat vectors.
+        auto unpacker = [this](const typename base::v_ptr &v, std::vector<value_type> &out) {
+            for (const auto &p : v) {
+                const auto tmp = p->m_key.unpack(this->m_ss);
+                out.insert(out.end(), tmp.begin(), tmp.end());
+            }
+        };
+        std::vector<value_type> e1, e2;
+        unpacker(v1, e1);
+        unpacker(v2, e2);
+        // Minimum/maximum exponents of the operands.
+        auto minmax_finder = [n_vars](const std::vector<value_type> &e, std::vector<value_type> &lo,
+                                      std::vector<value_type> &hi) {
+            piranha_assert(e.size() >= n_vars);
+            lo.assign(e.begin(), e.begin() + static_cast<std::ptrdiff_t>(n_vars));
+            hi = lo;
+            for (e_size_type i = n_vars; i < e.size(); i = static_cast<e_size_type>(i + n_vars)) {
+                for (e_size_type j = 0u; j < n_vars; ++j) {
+                    lo[j] = std::min(lo[j], e[i + j]);
+                    hi[j] = std::max(hi[j], e[i + j]);
+                }
+            }
+        };
+        std::vector<value_type> lo1, hi1, lo2, hi2;
+        minmax_finder(e1, lo1, hi1);
+        minmax_finder(e2, lo2, hi2);
+        // Compute the dimensions of the box, and the total number of cells. We use multiprecision
+        // arithmetic here to rule out overflows.
+        std::vector<std::size_t> dims, strides;
+        integer n_cells(1);
+        for (e_size_type j = 0u; j < n_vars; ++j) {
+            const integer dim = integer(hi1[j]) + hi2[j] - lo1[j] - lo2[j] + 1;
+            if (dim > integer(est) * dense_ratio) {
+                return false;
+            }
+            strides.push_back(static_cast<std::size_t>(n_cells));
+            n_cells *= dim;
+            if (n_cells > integer(est) * dense_ratio) {
+                return false;
+            }
+            dims.push_back(static_cast<std::size_t>(dim));
+        }
+        std::size_t n_cells_s;
+        if (!mppp::get(n_cells_s, n_cells)) {
+            return false;
+        }
+        // Now we know that all the exponent differences within the box are small, and we can compute
+        // the indices of the terms of the operands in the box.
+        auto indexer = [n_vars, &strides](const std::vector<value_type> &e, const std::vector<value_type> &lo,
+                                          std::vector<std::size_t> &out) {
+            for (e_size_type i = 0u; i < e.size(); i = static_cast<e_size_type>(i + n_vars)) {
+                std::size_t idx = 0u;
+                for (e_size_type j = 0u; j < n_vars; ++j) {
+                    idx += static_cast<std::size_t>(e[i + j] - lo[j]) * strides[static_cast<d_size_type>(j)];
+                }
+                out.push_back(idx);
+            }
+        };
+        std::vector<std::size_t> d1, d2;
+        indexer(e1, lo1, d1);
+        indexer(e2, lo2, d2);
+        piranha_assert(d1.size() == size1 && d2.size() == size2);
+        // Sort the second series (and its indices) according to the position in the box. This ensures that
+        // the inner loop writes into the array of coefficients at increasing addresses, and it allows to
+        // locate via binary search the terms that will end up in a given portion of the box.
+        std::vector<size_type> idx_vector(safe_cast<typename std::vector<size_type>::size_type>(size2));
+        std::iota(idx_vector.begin(), idx_vector.end(), size_type(0u));
+        std::stable_sort(idx_vector.begin(), idx_vector.end(), [&d2](const size_type &i1, const size_type &i2) {
+            return d2[static_cast<d_size_type>(i1)] < d2[static_cast<d_size_type>(i2)];
+        });
+        decltype(this->m_v2) v2_copy(size2);
+        decltype(d2) d2_copy(d2.size());
+        std::transform(idx_vector.begin(), idx_vector.end(), v2_copy.begin(),
+                       [&v2](const size_type &i) { return v2[i]; });
+        std::transform(idx_vector.begin(), idx_vector.end(), d2_copy.begin(),
+                       [&d2](const size_type &i) { return d2[static_cast<d_size_type>(i)]; });
+        v2 = std::move(v2_copy);
+        d2 = std::move(d2_copy);
+        ca.load();
+        // The dense accumulator.
+        std::vector<typename Access::acc_type> acc(n_cells_s);
+        // Accumulate into acc all the term-by-term products writing into the [a,b[ portion of the box.
+        auto zone_consume = [&ca, &d1, &d2, &acc, size1](std::size_t a, std::size_t b) {
+            for (size_type i = 0u; i < size1; ++i) {
+                const std::size_t k1 = d1[static_cast<d_size_type>(i)];
+                if (k1 >= b) {
+                    continue;
+                }
+                const auto d2_begin = d2.begin();
+                const auto it_start = (k1 >= a) ? d2_begin : std::lower_bound(d2_begin, d2.end(), a - k1);
+                const auto it_end = std::lower_bound(it_start, d2.end(), b - k1);
+                const auto &cf1 = ca.c1(i);
+                auto acc_ptr = acc.data() + k1;
+                for (auto j = static_cast<size_type>(it_start - d2_begin); j != static_cast<size_type>(it_end - d2_begin);
+                     ++j) {
+                    piranha_assert(k1 + d2[static_cast<d_size_type>(j)] < acc.size());
+                    Access::fma(acc_ptr[d2[static_cast<d_size_type>(j)]], cf1, ca.c2(j));
+                }
+            }
+        };
+        try {
+            if (this->m_n_threads == 1u) {
+                zone_consume(0u, n_cells_s);
+            } else {
+                // Subdivide the box into zones, a multiple of the number of threads. Each thread submits
+                // the zones it owns as stealable tasks and then waits for them, consuming its own zones
+                // and stealing those of the other threads once they are exhausted (as in the sparse multiplication).
+                // NOTE: zm is a tuning parameter.
+                const unsigned zm = 10u;
+                const auto n_zones = static_cast<std::size_t>(integer(this->m_n_threads) * zm);
+                // Number of cells per zone (can be zero).
+                const std::size_t cpz = n_cells_s / n_zones;
+                auto zone_functor = [&zone_consume, cpz, n_zones, n_cells_s](const std::size_t &z_idx) {
+                    zone_consume(z_idx * cpz, (z_idx == n_zones - 1u) ? n_cells_s : (z_idx + 1u) * cpz);
+                };
+                auto thread_functor = [&zone_functor](const unsigned &thread_idx) {
+                    future_list<void> fz_list;
+                    try {
+                        for (unsigned n = 0u; n < zm; ++n) {
+                            fz_list.push_back(thread_pool::submit(
+                                zone_functor, static_cast<std::size_t>(std::size_t(thread_idx) * zm + n)));
+                        }
+                        fz_list.wait_all();
+                        fz_list.get_all();
+                    } catch (...) {
+                        fz_list.wait_all();
+                        throw;
+                    }
+                };
+                future_list<decltype(thread_functor(0u))> ft_list;
+                try {
+                    for (unsigned i = 0u; i < this->m_n_threads; ++i) {
+                        ft_list.push_back(thread_pool::enqueue(i, thread_functor, i));
+                    }
+                    ft_list.wait_all();
+                    ft_list.get_all();
+                } catch (...) {
+                    ft_list.wait_all();
+                    throw;
+                }
+            }
+            // Build the result in a single pass over the array.
+            // NOTE: the number of cells is bounded by a small multiple of the estimated size of the result,
+            // hence we can do this in single-threaded mode.
+            auto &container = retval._container();
+            std::vector<value_type> tmp_e(n_vars);
+            for (std::size_t k = 0u; k < n_cells_s; ++k) {
+                if (Access::is_zero(acc[k])) {
+                    continue;
+                }
+                // Decode the position in the box into the exponents of the term.
+                std::size_t r = k;
+                for (e_size_type j = 0u; j < n_vars; ++j) {
+                    const auto dim = dims[static_cast<d_size_type>(j)];
+                    tmp_e[j] = static_cast<value_type>(lo1[j] + lo2[j] + static_cast<value_type>(r % dim));
+                    r /= dim;
+                }
+                cf_type tmp_cf;
+                Access::to_cf(tmp_cf, acc[k]);
+                term_type tmp_term(std::move(tmp_cf), key_type(tmp_e.begin(), tmp_e.end()));
+                const auto b_idx = container._bucket(tmp_term);
+                container._unique_insert(std::move(tmp_term), b_idx);
+            }
+            this->sanitise_series(retval, this->m_n_threads);
+            this->finalise_series(retval);
+        } catch (...) {
+            retval._container().clear();
+            throw;
+        }
+        return true;
+    }
+    // Sparse Kronecker multiplication, accumulating directly into the container of retval.
+    template <typename Access>
+    void sparse_kronecker_multiplication(Series &retval, Access &ca, std::vector<typename base::size_type> &sl,
+                                         std::true_type) const
+    {
+        try {
+            sparse_kronecker_multiplication_impl(retval._container(), ca, sl);
+            this->sanitise_series(retval, this->m_n_threads);
+            this->finalise_series(retval);
+        } catch (...) {
+            retval._container().clear();
+            throw;
+        }
+    }
+    // Sparse Kronecker multiplication with an accumulator type different from the coefficient type. The
+    // term-by-term products are still computed by ca in machine integers, but they are accumulated directly
+    // into the coefficients of retval (see kronecker_direct_access): accumulating into a temporary table of
+    // accumulators would require, at the end of the multiplication, both the temporary table and retval in memory.
+    template <typename Access>
+    void sparse_kronecker_multiplication(Series &retval, Access &ca, std::vector<typename base::size_type> &sl,
+                                         std::false_type) const
+    {
+        kronecker_direct_access<Access> da(ca);
+        sparse_kronecker_multiplication(retval, da, sl, std::true_type{});
+    }
+    // Single-threaded sparse Kronecker multiplication accumulating into an open-addressing hash table. The terms
+    // of the result are transferred into retval at the end.
+    template <typename Access>
+    void oa_kronecker_multiplication(Series &retval, Access &ca, std::vector<typename base::size_type> &sl) const
+    {
+        using term_type = typename Series::term_type;
+        using acc_term_type = detail::kronecker_acc_term<key_t<Series>, typename Access::acc_type>;
+        using acc_container_type = oa_hash_set<acc_term_type, detail::kronecker_acc_term_hasher>;
+        piranha_assert(this->m_n_threads == 1u);
+        auto &container = retval._container();
+        try {
+            // NOTE: retval has been sized according to the estimate of the number of terms in the result:
+            // use twice as many slots, so that the load factor of the temporary table stays around 1/2
+            // if the estimate is accurate. The table will grow if needed.
+            acc_container_type acc_container(safe_cast<typename acc_container_type::size_type>(
+                                                 integer(container.bucket_count()) * 2),
+                                             detail::kronecker_acc_term_hasher{});
+            sparse_kronecker_multiplication_impl(acc_container, ca, sl);
+            // If the estimate was too low, make room in retval.
+            if (static_cast<double>(acc_container.size()) / static_cast<double>(container.bucket_count())
+                > container.max_load_factor()) {
+                container.rehash(boost::numeric_cast<typename Series::size_type>(
+                    std::ceil(static_cast<double>(acc_container.size()) / container.max_load_factor())));
+            }
+            typename Series::size_type n_terms = 0u;
+            for (const auto &t : acc_container) {
+                if (Access::is_zero(t.m_cf)) {
+                    continue;
+                }
+                typename term_type::cf_type tmp_cf;
+                Access::to_cf(tmp_cf, t.m_cf);
+                term_type tmp_term(std::move(tmp_cf), t.m_key);
+                const auto b_idx = container._bucket(tmp_term);
+                container._unique_insert(std::move(tmp_term), b_idx);
+                ++n_terms;
+            }
+            container._update_size(n_terms);
+            this->finalise_series(retval);
+        } catch (...) {
+            container.clear();
+            throw;
+        }
+    }
+    // Implementation of the sparse Kronecker multiplication. The result of the multiplication will be accumulated
+    // into container, whose terms have a key of the same type as Series and a coefficient of type
+    // Access::acc_type. The number of terms in container is not updated. sl are the skip limits (empty if the
+    // multiplication is not truncated), which are reordered together with m_v1.
+    template <typename Container, typename Access>
+    void sparse_kronecker_multiplication_impl(Container &container, Access &ca,
+                                              std::vector<typename base::size_type> &sl) const
     {
         using bucket_size_type = typename base::bucket_size_type;
         using size_type = typename base::size_type;
         using term_type = typename Series::term_type;
+        using acc_term_type = typename Container::key_type;
         // Type representing multiplication tasks:
         // - the current term index from s1,
         // - the first term index in s2,
@@ -1675,14 +3074,70 @@ private:
         auto &v2 = this->m_v2;
         const auto size1 = v1.size();
         const auto size2 = v2.size();
-        auto &container = retval._container();
         // A convenience functor to compute the destination bucket
         // of a term into retval.
         auto r_bucket = [&container](term_type const *p) { return container._bucket_from_hash(p->hash()); };
         // Sort input terms according to bucket positions in retval.
         auto term_cmp = [&r_bucket](term_type const *p1, term_type const *p2) { return r_bucket(p1) < r_bucket(p2); };
-        std::stable_sort(v1.begin(), v1.end(), term_cmp);
-        std::stable_sort(v2.begin(), v2.end(), term_cmp);
+        // The terms of the second series are subdivided into groups, delimited by the indices in v2_groups. The
+        // terms in each row of the multiplication are all the terms in a set of consecutive groups starting from
+        // the first one. In the untruncated case there is a single group containing all the terms of the second
+        // series. In the truncated case, the second series is sorted by degree and the groups are delimited by
+        // the skip limits, so that the terms in each row are those with an index less than the skip limit.
+        // The sorting according to the bucket positions is done within each group.
+        std::vector<size_type> v2_groups{size_type(0u)};
+        if (sl.empty()) {
+            std::stable_sort(v1.begin(), v1.end(), term_cmp);
+            std::stable_sort(v2.begin(), v2.end(), term_cmp);
+            v2_groups.push_back(size2);
+        } else {
+            piranha_assert(sl.size() == size1);
+            // Sort v1, and apply the same permutation to the skip limits.
+            std::vector<size_type> perm(safe_cast<typename std::vector<size_type>::size_type>(size1));
+            std::iota(perm.begin(), perm.end(), size_type(0u));
+            std::stable_sort(perm.begin(), perm.end(),
+                             [&v1, &term_cmp](const size_type &i1, const size_type &i2) {
+                                 return term_cmp(v1[i1], v1[i2]);
+                             });
+            typename base::v_ptr v1_copy(v1.size());
+            std::vector<size_type> sl_copy(sl.size());
+            for (decltype(perm.size()) i = 0u; i < perm.size(); ++i) {
+                v1_copy[i] = v1[perm[i]];
+                sl_copy[i] = sl[perm[i]];
+            }
+            v1 = std::move(v1_copy);
+            sl = std::move(sl_copy);
+            // Determine the groups.
+            std::vector<size_type> tmp(sl);
+            std::sort(tmp.begin(), tmp.end());
+            for (const auto &l : tmp) {
+                if (l != v2_groups.back()) {
+                    v2_groups.push_back(l);
+                }
+            }
+            for (decltype(v2_groups.size()) g = 1u; g < v2_groups.size(); ++g) {
+                std::stable_sort(v2.begin() + static_cast<std::ptrdiff_t>(v2_groups[g - 1u]),
+                                 v2.begin() + static_cast<std::ptrdiff_t>(v2_groups[g]), term_cmp);
+            }
+        }
+        // The number of terms in the second series which are multiplied by the i-th term of the first series.
+        auto row_limit = [&sl, size2](const size_type &i) {
+            return sl.empty() ? size2 : sl[static_cast<typename std::vector<size_type>::size_type>(i)];
+        };
+        // Now that the ordering of the input terms is established, load the coefficients.
+        ca.load();
+        // Integral representation of the keys.
+        // NOTE: this will have to be adapted for kd_monomial.
+        using int_type = decltype(v1[0]->m_key.get_int());
+        // The keys of the second series are read by all the threads. They are copied into contiguous vectors,
+        // so that the inner loop does not need to dereference the term pointers, and there is one copy for each
+        // NUMA node hosting the threads (see thread_pool::set_numa_placement()), so that each thread reads
+        // the copy local to its node. Each copy is written by a thread of its node.
+        using k2_type = std::vector<int_type>;
+        auto k2_load = [&v2](k2_type &out) {
+            out.resize(safe_cast<typename k2_type::size_type>(v2.size()));
+            std::transform(v2.begin(), v2.end(), out.begin(), [](term_type const *p) { return p->m_key.get_int(); });
+        };
         // Task comparator. It will compare the bucket index of the terms resulting from
         // the multiplication of the term in the first series by the first term in the block
         // of the second series. This is essentially the first bucket index of retval in which the task
@@ -1709,27 +3164,24 @@ private:
         // End of the container, always the same value.
         const auto it_end = container.end();
         // Function to perform all the term-by-term multiplications in a task, using tmp_term
-        // as a temporary value for the computation of the result.
-        auto task_consume = [&v1, &v2, &container, it_end, this](const task_type &task, term_type &tmp_term) {
+        // as a temporary value for the computation of the result and k2 as the keys of the second series.
+        auto task_consume = [&v1, &container, &ca, it_end](const task_type &task, acc_term_type &tmp_term,
+                                                           const k2_type &k2) {
             // Get the term in the first series.
             auto t1 = v1[std::get<0u>(task)];
-            // Get pointers to the second series.
+            // Get pointers to the keys of the second series.
             // NOTE: don't use the subscript operator[] here, as these could point
             // one past the end of the vector.
-            auto start2 = v2.data() + std::get<1u>(task);
-            auto end2 = v2.data() + std::get<2u>(task);
-            // NOTE: these will have to be adapted for kd_monomial.
-            using int_type = decltype(t1->m_key.get_int());
+            auto start2 = k2.data() + std::get<1u>(task);
+            auto end2 = k2.data() + std::get<2u>(task);
             // Get shortcuts to cf and key in t1.
-            const auto &cf1 = t1->m_cf;
+            const auto &cf1 = ca.c1(std::get<0u>(task));
             const int_type key1 = t1->m_key.get_int();
             // Iterate over the task.
-            for (; start2 != end2; ++start2) {
-                // Const ref to the current term in the second series.
-                const auto &cur = **start2;
+            for (auto j = std::get<1u>(task); start2 != end2; ++start2, ++j) {
                 // Add the keys.
                 // NOTE: this will have to be adapted for kd_monomial.
-                tmp_term.m_key.set_int(static_cast<int_type>(key1 + cur.m_key.get_int()));
+                tmp_term.m_key.set_int(static_cast<int_type>(key1 + *start2));
                 // Try to locate the term into retval.
                 auto bucket_idx = container._bucket(tmp_term);
                 const auto it = container._find(tmp_term, bucket_idx);
@@ -1737,39 +3189,49 @@ private:
                     // NOTE: for coefficient series, we might want to insert with move() below,
                     // as we are not going to re-use the allocated resources in tmp.m_cf.
                     // Take care of multiplying the coefficient.
-                    cf_mult_impl(tmp_term.m_cf, cf1, cur.m_cf);
+                    Access::mult(tmp_term.m_cf, cf1, ca.c2(j));
                     container._unique_insert(tmp_term, bucket_idx);
                 } else {
                     // NOTE: here we need to decide if we want to give the same treatment to fmp as we did with
                     // cf_mult_impl.
                     // For the moment it is an implementation detail of this class.
-                    this->fma_wrap(it->m_cf, cf1, cur.m_cf);
+                    Access::fma(it->m_cf, cf1, ca.c2(j));
                 }
             }
         };
         if (this->m_n_threads == 1u) {
-            try {
-                // Single threaded case.
-                // Create the vector of tasks.
-                std::vector<task_type> tasks;
-                for (decltype(v1.size()) i = 0u; i < size1; ++i) {
-                    task_split(std::make_tuple(i, size_type(0u), size2), tasks);
-                }
-                // Sort the tasks.
-                std::stable_sort(tasks.begin(), tasks.end(), task_cmp);
-                // Iterate over the tasks and run the multiplication.
-                term_type tmp_term;
-                for (const auto &t : tasks) {
-                    task_consume(t, tmp_term);
-                }
-                this->sanitise_series(retval, this->m_n_threads);
-                this->finalise_series(retval);
-            } catch (...) {
-                retval._container().clear();
-                throw;
+            // Single threaded case.
+            // Create the vector of tasks.
+            std::vector<task_type> tasks;
+            for (decltype(v1.size()) i = 0u; i < size1; ++i) {
+                task_split(std::make_tuple(i, size_type(0u), row_limit(i)), tasks);
+            }
+            // Sort the tasks.
+            std::stable_sort(tasks.begin(), tasks.end(), task_cmp);
+            // Iterate over the tasks and run the multiplication.
+            k2_type k2;
+            k2_load(k2);
+            acc_term_type tmp_term;
+            for (const auto &t : tasks) {
+                task_consume(t, tmp_term, k2);
             }
             return;
         }
+        // NUMA node of each thread, and the copies of the keys of the second series (one per node). The copy
+        // for each node is loaded by the first thread of the node.
+        std::vector<unsigned> numa_nodes(safe_cast<std::vector<unsigned>::size_type>(this->m_n_threads));
+        for (unsigned i = 0u; i < this->m_n_threads; ++i) {
+            numa_nodes[i] = thread_pool::get_numa_node(i);
+        }
+        const unsigned n_nodes = *std::max_element(numa_nodes.begin(), numa_nodes.end()) + 1u;
+        std::vector<k2_type> k2_copies(safe_cast<typename std::vector<k2_type>::size_type>(n_nodes));
+        std::vector<unsigned char> k2_loaders(numa_nodes.size(), 0u);
+        for (unsigned n = 0u; n < n_nodes; ++n) {
+            const auto it = std::find(numa_nodes.begin(), numa_nodes.end(), n);
+            if (it != numa_nodes.end()) {
+                k2_loaders[static_cast<decltype(k2_loaders.size())>(it - numa_nodes.begin())] = 1u;
+            }
+        }
         // Number of buckets in retval.
         const bucket_size_type bucket_count = container.bucket_count();
         // Compute the number of zones in which the output container will be subdivided,
@@ -1793,7 +3255,7 @@ private:
             bucket_size_type ib = r_bucket(v1[i]);
             // Avoid zb - ib below wrapping around.
             if (zb < ib) {
-                return 0u;
+                return first;
             }
             const auto cmp = static_cast<bucket_size_type>(zb - ib);
             size_type idx, step, count = static_cast<size_type>(last - first);
@@ -1814,9 +3276,12 @@ private:
             }
             return first;
         };
-        // Fill the task table.
-        auto table_filler = [&task_table, bpz, this, bucket_count, size1, size2, &l_bound, &task_split,
-                             &task_cmp](const unsigned &thread_idx) {
+        // Fill the task table, and load the copies of the keys.
+        auto table_filler = [&task_table, bpz, this, bucket_count, size1, &v2_groups, &row_limit, &l_bound, &task_split,
+                             &task_cmp, &k2_load, &k2_copies, &k2_loaders, &numa_nodes](const unsigned &thread_idx) {
+            if (k2_loaders[thread_idx]) {
+                k2_load(k2_copies[numa_nodes[thread_idx]]);
+            }
             for (unsigned n = 0u; n < zm; ++n) {
                 std::vector<task_type> cur_tasks;
                 // [a,b[ is the container zone.
@@ -1828,26 +3293,38 @@ private:
                 } else {
                     b = static_cast<bucket_size_type>(a + bpz);
                 }
-                // First batch of tasks.
-                for (size_type i = 0u; i < size1; ++i) {
-                    auto t = std::make_tuple(i, l_bound(0u, size2, a, i), l_bound(0u, size2, b, i));
-                    if (std::get<1u>(t) == 0u && std::get<2u>(t) == 0u) {
-                        // This means that all the next tasks we will compute will be empty,
-                        // no sense in calculating them.
-                        break;
+                for (decltype(v2_groups.size()) g = 1u; g < v2_groups.size(); ++g) {
+                    // [gs,ge[ is the range of the current group in v2.
+                    const auto gs = v2_groups[g - 1u], ge = v2_groups[g];
+                    // First batch of tasks.
+                    for (size_type i = 0u; i < size1; ++i) {
+                        if (row_limit(i) < ge) {
+                            // The group is not in the row of the current term.
+                            continue;
+                        }
+                        auto t = std::make_tuple(i, l_bound(gs, ge, a, i), l_bound(gs, ge, b, i));
+                        if (std::get<1u>(t) == gs && std::get<2u>(t) == gs) {
+                            // This means that all the next tasks we will compute will be empty,
+                            // no sense in calculating them.
+                            break;
+                        }
+                        task_split(t, cur_tasks);
                     }
-                    task_split(t, cur_tasks);
-                }
-                // Second batch of tasks.
-                // Note: we can always compute a,b + bucket_count because of the limits on the maximum value of
-                // bucket_count.
-                for (size_type i = 0u; i < size1; ++i) {
-                    auto t = std::make_tuple(i, l_bound(0u, size2, static_cast<bucket_size_type>(a + bucket_count), i),
-                                             l_bound(0u, size2, static_cast<bucket_size_type>(b + bucket_count), i));
-                    if (std::get<1u>(t) == 0u && std::get<2u>(t) == 0u) {
-                        break;
+                    // Second batch of tasks.
+                    // Note: we can always compute a,b + bucket_count because of the limits on the maximum value of
+                    // bucket_count.
+                    for (size_type i = 0u; i < size1; ++i) {
+                        if (row_limit(i) < ge) {
+                            continue;
+                        }
+                        auto t = std::make_tuple(
+                            i, l_bound(gs, ge, static_cast<bucket_size_type>(a + bucket_count), i),
+                            l_bound(gs, ge, static_cast<bucket_size_type>(b + bucket_count), i));
+                        if (std::get<1u>(t) == gs && std::get<2u>(t) == gs) {
+                            break;
+                        }
+                        task_split(t, cur_tasks);
                     }
-                    task_split(t, cur_tasks);
                 }
                 // Sort the task vector.
                 std::stable_sort(cur_tasks.begin(), cur_tasks.end(), task_cmp);
@@ -1870,9 +3347,9 @@ private:
             throw;
         }
         // Check the consistency of the table for debug purposes.
-        auto table_checker = [&task_table, size1, size2, &r_bucket, bpz, bucket_count, &v1, &v2]() -> bool {
+        auto table_checker = [&task_table, size1, &row_limit, &r_bucket, bpz, bucket_count, &v1, &v2]() -> bool {
             // Total number of term-by-term multiplications. Needs to be equal
-            // to size1 * size2 at the end.
+            // to the sum of the row limits at the end.
             integer tot_n(0);
             // Tmp term for multiplications.
             term_type tmp_term;
@@ -1888,7 +3365,6 @@ private:
                 }
                 for (const auto &t : v) {
                     auto idx1 = std::get<0u>(t), start2 = std::get<1u>(t), end2 = std::get<2u>(t);
-                    using int_type = decltype(v1[idx1]->m_key.get_int());
                     piranha_assert(start2 <= end2);
                     tot_n += end2 - start2;
                     for (; start2 != end2; ++start2) {
@@ -1901,38 +3377,42 @@ private:
                     }
                 }
             }
-            return tot_n == integer(size1) * size2;
+            integer n_mults(0);
+            for (size_type i = 0u; i < size1; ++i) {
+                n_mults += row_limit(i);
+            }
+            return tot_n == n_mults;
         };
         (void)table_checker;
         piranha_assert(table_checker());
-        // Init the vector of atomic flags.
-        detail::atomic_flag_array af(safe_cast<std::size_t>(task_table.size()));
-        // Thread functor.
-        auto thread_functor = [&task_table, &af, &task_consume](const unsigned &thread_idx) {
-            using t_size_type = decltype(task_table.size());
-            // Temporary term_type for caching.
-            term_type tmp_term;
-            // The starting index in the task table.
-            auto t_idx = static_cast<t_size_type>(t_size_type(thread_idx) * zm);
-            const auto start_t_idx = t_idx;
-            while (true) {
-                // If this returns false, it means that the tasks still need to be consumed;
-                if (!af[static_cast<std::size_t>(t_idx)].test_and_set()) {
-                    // Current vector of tasks.
-                    const auto &cur_tasks = task_table[t_idx];
-                    for (const auto &t : cur_tasks) {
-                        task_consume(t, tmp_term);
-                    }
-                }
-                // Update the index, wrapping around if necessary.
-                t_idx = static_cast<t_size_type>(t_idx + 1u);
-                if (t_idx == task_table.size()) {
-                    t_idx = 0u;
-                }
-                // If we got back to the original index, get out.
-                if (t_idx == start_t_idx) {
-                    break;
+        // Zone functor: consume the tasks of the t_idx-th zone, reading the copy of the keys of the second series
+        // of the NUMA node of the zone's owner.
+        auto zone_functor = [&task_table, &task_consume, &k2_copies, &numa_nodes](const unsigned &owner,
+                                                                                 const std::size_t &t_idx) {
+            // Temporary term for caching.
+            acc_term_type tmp_term;
+            const auto &k2 = k2_copies[numa_nodes[owner]];
+            for (const auto &t : task_table[static_cast<decltype(task_table.size())>(t_idx)]) {
+                task_consume(t, tmp_term, k2);
+            }
+        };
+        // Thread functor. Each thread submits the zones it owns (whose buckets it initialised if
+        // tuning::get_parallel_memory_set() is active) as stealable tasks to its own queue, and then waits
+        // for them: while waiting, it consumes its own zones and, once they are exhausted, it steals
+        // the zones of the other threads. Idle threads of the pool steal first from the threads with the following
+        // indices, which are on the same NUMA node when thread_pool::set_numa_placement() is active.
+        auto thread_functor = [&zone_functor](const unsigned &thread_idx) {
+            future_list<void> fz_list;
+            try {
+                for (unsigned n = 0u; n < zm; ++n) {
+                    fz_list.push_back(thread_pool::submit(zone_functor, thread_idx,
+                                                          static_cast<std::size_t>(std::size_t(thread_idx) * zm + n)));
                 }
+                fz_list.wait_all();
+                fz_list.get_all();
+            } catch (...) {
+                fz_list.wait_all();
+                throw;
             }
         };
         // Go with the multiplication threads.
@@ -1945,13 +3425,8 @@ private:
             ft_list.wait_all();
             // Then, let's handle the exceptions.
             ft_list.get_all();
-            // Finally, fix and finalise the series.
-            this->sanitise_series(retval, this->m_n_threads);
-            this->finalise_series(retval);
         } catch (...) {
             ft_list.wait_all();
-            // Clean up and re-throw.
-            retval._container().clear();
             throw;
         }
     }
@@ -325,6 +325,42 @@ private:
         }
         return sign_change;
     }
+    // Implementation of canonicalisation on the packed representation of a monomial with m multipliers.
+    // NOTE: the Kronecker codification is linear (the code of a vector is the scalar product of the vector by
+    // the coding vector), so that the code of the opposite of a vector is the opposite of the code. The first nonzero
+    // multiplier is the first nonzero digit in the balanced mixed-radix representation of the code, whose radixes
+    // are 2 * M_i + 1 (M_i being the limits of the components in the codification).
+    static bool canonicalise_packed_impl(value_type &n, const size_type &m)
+    {
+        if (!n) {
+            return false;
+        }
+        piranha_assert(m < ka::get_limits().size());
+        const auto &minmax_vec = std::get<0u>(ka::get_limits()[static_cast<decltype(ka::get_limits().size())>(m)]);
+        value_type q = n;
+        for (decltype(minmax_vec.size()) i = 0u; i < minmax_vec.size(); ++i) {
+            const auto M = minmax_vec[i];
+            const auto radix = static_cast<value_type>(2 * M + 1);
+            // Compute the i-th digit, in the [-M, M] range.
+            auto r = static_cast<value_type>(q % radix);
+            if (r > M) {
+                r = static_cast<value_type>(r - radix);
+            } else if (r < -M) {
+                r = static_cast<value_type>(r + radix);
+            }
+            if (r > value_type(0)) {
+                return false;
+            }
+            if (r < value_type(0)) {
+                n = static_cast<value_type>(-n);
+                return true;
+            }
+            q = static_cast<value_type>(q / radix);
+        }
+        // A nonzero code must have a nonzero digit.
+        piranha_assert(false);
+        return false;
+    }
 
 public:
     /// Canonicalise.
@@ -650,25 +686,8 @@ public:
                          const term<Cf, real_trigonometric_kronecker_monomial> &t2, const symbol_fset &args)
     {
         // Coefficients first.
-        cf_mult_impl(res[0u].m_cf, t1.m_cf, t2.m_cf);
-        res[1u].m_cf = res[0u].m_cf;
-        const bool f1 = t1.m_key.get_flavour(), f2 = t2.m_key.get_flavour();
-        if (f1 && f2) {
-            // cos, cos: no change.
-        } else if (!f1 && !f2) {
-            // sin, sin: negate the plus.
-            math::negate(res[0u].m_cf);
-        } else if (!f1 && f2) {
-            // sin, cos: no change.
-        } else {
-            // cos, sin: negate the minus.
-            math::negate(res[1u].m_cf);
-        }
+        multiply_cfs(res, t1, t2);
         // Now the keys.
-        auto &retval_plus = res[0u].m_key;
-        auto &retval_minus = res[1u].m_key;
-        // Flags to signal if a sign change in the multipliers was needed as part of the canonicalization.
-        bool sign_plus = false, sign_minus = false;
         const auto size = args.size();
         const auto tmp1 = t1.m_key.unpack(args), tmp2 = t2.m_key.unpack(args);
         v_type result_plus, result_minus;
@@ -683,10 +702,86 @@ public:
             result_minus[i] = safe_int_add(result_minus[i], static_cast<value_type>(-tmp2[i]));
         }
         // Handle sign changes.
-        sign_plus = canonicalise_impl(result_plus);
-        sign_minus = canonicalise_impl(result_minus);
+        // Flags to signal if a sign change in the multipliers was needed as part of the canonicalization.
+        const bool sign_plus = canonicalise_impl(result_plus);
+        const bool sign_minus = canonicalise_impl(result_minus);
         // Compute them before assigning, so in case of exceptions we do not touch the return values.
         const auto re_plus = ka::encode(result_plus), re_minus = ka::encode(result_minus);
+        multiply_keys(res, t1, t2, re_plus, re_minus, sign_plus, sign_minus);
+    }
+    /// Multiply terms with a trigonometric monomial (packed version).
+    /**
+     * \note
+     * This method is enabled only if the same conditions of multiply() are satisfied.
+     *
+     * This method computes the same result as multiply(), but it operates directly on the codified representations
+     * of the monomials: the multipliers of the results are computed via the addition and subtraction of the codes
+     * of the operands, and the canonical form of the results is determined from the codes by examining only the
+     * multipliers up to the first nonzero one. Thus, the cost of unpacking and re-encoding the monomials is avoided.
+     *
+     * The caller must ensure that, for each symbol, the sum of the absolute values of the multipliers of \p t1 and
+     * \p t2 is within the limits of the Kronecker codification for monomials of size <tt>args.size()</tt>
+     * (as reported by piranha::kronecker_array::get_limits()). This condition is not checked, and if it does not
+     * hold the result is unspecified. Typically, this condition is verified once for all the terms of two series
+     * before computing their product.
+     *
+     * @param res result of the multiplication.
+     * @param t1 first argument.
+     * @param t2 second argument.
+     * @param args the reference piranha::symbol_fset.
+     *
+     * @throws unspecified any exception thrown by:
+     * - piranha::math::mul3(),
+     * - copy-assignment on the coefficient type,
+     * - piranha::math::negate().
+     */
+    template <typename Cf, multiply_enabler<Cf> = 0>
+    static void multiply_packed(std::array<term<Cf, real_trigonometric_kronecker_monomial>, multiply_arity> &res,
+                                const term<Cf, real_trigonometric_kronecker_monomial> &t1,
+                                const term<Cf, real_trigonometric_kronecker_monomial> &t2, const symbol_fset &args)
+    {
+        multiply_cfs(res, t1, t2);
+        // NOTE: the sum and the difference of the codes cannot overflow, as the results are valid codes
+        // by hypothesis.
+        auto re_plus = static_cast<value_type>(t1.m_key.m_value + t2.m_key.m_value),
+             re_minus = static_cast<value_type>(t1.m_key.m_value - t2.m_key.m_value);
+        const bool sign_plus = canonicalise_packed_impl(re_plus, args.size());
+        const bool sign_minus = canonicalise_packed_impl(re_minus, args.size());
+        multiply_keys(res, t1, t2, re_plus, re_minus, sign_plus, sign_minus);
+    }
+
+private:
+    // Multiplication of the coefficients.
+    template <typename Cf>
+    static void multiply_cfs(std::array<term<Cf, real_trigonometric_kronecker_monomial>, multiply_arity> &res,
+                             const term<Cf, real_trigonometric_kronecker_monomial> &t1,
+                             const term<Cf, real_trigonometric_kronecker_monomial> &t2)
+    {
+        cf_mult_impl(res[0u].m_cf, t1.m_cf, t2.m_cf);
+        res[1u].m_cf = res[0u].m_cf;
+        const bool f1 = t1.m_key.get_flavour(), f2 = t2.m_key.get_flavour();
+        if (f1 && f2) {
+            // cos, cos: no change.
+        } else if (!f1 && !f2) {
+            // sin, sin: negate the plus.
+            math::negate(res[0u].m_cf);
+        } else if (!f1 && f2) {
+            // sin, cos: no change.
+        } else {
+            // cos, sin: negate the minus.
+            math::negate(res[1u].m_cf);
+        }
+    }
+    // Assignment of the keys resulting from a multiplication, given the canonical codes of the multipliers
+    // and the flags signalling if a sign change was needed as part of the canonicalisation.
+    template <typename Cf>
+    static void multiply_keys(std::array<term<Cf, real_trigonometric_kronecker_monomial>, multiply_arity> &res,
+                              const term<Cf, real_trigonometric_kronecker_monomial> &t1,
+                              const term<Cf, real_trigonometric_kronecker_monomial> &t2, const value_type &re_plus,
+                              const value_type &re_minus, bool sign_plus, bool sign_minus)
+    {
+        auto &retval_plus = res[0u].m_key;
+        auto &retval_minus = res[1u].m_key;
         retval_plus.m_value = re_plus;
         retval_minus.m_value = re_minus;
         const bool f = (t1.m_key.get_flavour() == t2.m_key.get_flavour());
@@ -700,6 +795,8 @@ public:
             math::negate(res[1u].m_cf);
         }
     }
+
+public:
     /// Hash value.
     /**
      * @return the internal integer instance, cast to \p std::size_t.
@@ -1440,6 +1537,30 @@ public:
         return r.get_int() == T(0) && r.get_flavour();
     }
 };
+
+inline namespace impl
+{
+
+// Flat representation of real_trigonometric_kronecker_monomial for the flat data format: the internal integral
+// instance and the flavour.
+template <typename T>
+struct flat_key<real_trigonometric_kronecker_monomial<T>> {
+    // NOTE: the flavour is stored as 0/1 in the second element.
+    using packed_type = std::array<T, 2>;
+    static std::uint64_t tag()
+    {
+        return 2u;
+    }
+    static packed_type pack(const real_trigonometric_kronecker_monomial<T> &k)
+    {
+        return packed_type{{k.get_int(), static_cast<T>(k.get_flavour())}};
+    }
+    static real_trigonometric_kronecker_monomial<T> unpack(const packed_type &p)
+    {
+        return real_trigonometric_kronecker_monomial<T>(p[0], p[1] != T(0));
+    }
+};
+}
 }
 
 #if defined(PIRANHA_WITH_BOOST_S11N)
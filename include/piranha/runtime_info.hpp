@@ -34,6 +34,8 @@ see https://www.gnu.org/licenses/. */
 #include <boost/lexical_cast.hpp>
 #include <fstream>
 #include <iostream>
+#include <new>
+#include <stdexcept>
 #include <string>
 
 extern "C" {
@@ -71,6 +73,7 @@ extern "C" {
 
 #include <memory>
 #include <thread>
+#include <vector>
 
 #include <piranha/config.hpp>
 #include <piranha/detail/init.hpp>
@@ -81,6 +84,62 @@ extern "C" {
 namespace piranha
 {
 
+namespace detail
+{
+
+#if defined(__linux__)
+
+// Parse a list of indices in the format used by the Linux /sys filesystem (e.g., "0-3,8,10-11").
+// Will throw if the list is malformed.
+inline std::vector<unsigned> parse_sys_index_list(const std::string &str)
+{
+    std::vector<unsigned> retval;
+    std::string::size_type start = 0u;
+    while (start < str.size()) {
+        auto end = str.find(',', start);
+        if (end == std::string::npos) {
+            end = str.size();
+        }
+        const auto item = str.substr(start, end - start);
+        const auto dash = item.find('-');
+        if (dash == std::string::npos) {
+            retval.push_back(boost::lexical_cast<unsigned>(item));
+        } else {
+            const auto a = boost::lexical_cast<unsigned>(item.substr(0u, dash)),
+                       b = boost::lexical_cast<unsigned>(item.substr(dash + 1u));
+            if (unlikely(a > b)) {
+                piranha_throw(std::invalid_argument, "invalid index range in the list '" + str + "'");
+            }
+            for (auto i = a;; ++i) {
+                retval.push_back(i);
+                if (i == b) {
+                    break;
+                }
+            }
+        }
+        start = end + 1u;
+    }
+    return retval;
+}
+
+// Read the first line of a file in the /sys filesystem. Returns false on failure.
+inline bool read_sys_line(const std::string &path, std::string &out)
+{
+    std::ifstream sys_file(path);
+    if (!sys_file.is_open() || !sys_file.good()) {
+        return false;
+    }
+    std::getline(sys_file, out);
+    // Remove trailing whitespace.
+    while (!out.empty() && (out.back() == '\n' || out.back() == ' ')) {
+        out.pop_back();
+    }
+    return true;
+}
+
+#endif
+}
+
 /// Runtime information.
 /**
  * This class allows to query information about the runtime environment.
@@ -214,6 +273,47 @@ public:
         return 0u;
 #endif
     }
+    /// NUMA topology.
+    /**
+     * This method will return the processors belonging to each NUMA node of the system. The <tt>i</tt>-th element
+     * of the returned vector contains the indices of the logical processors in the <tt>i</tt>-th online NUMA node,
+     * in ascending order. Nodes without processors (e.g., memory-only nodes) are not included.
+     *
+     * On Linux, the topology is read from the \p /sys filesystem. On the other platforms, or if the detection fails,
+     * an empty vector is returned.
+     *
+     * @return the NUMA topology of the system, or an empty vector if it cannot be determined.
+     *
+     * @throws unspecified any exception thrown by memory allocation errors in standard containers.
+     */
+    static std::vector<std::vector<unsigned>> get_numa_topology()
+    {
+        std::vector<std::vector<unsigned>> retval;
+#if defined(__linux__)
+        const std::string base_path("/sys/devices/system/node/");
+        std::string line;
+        if (!detail::read_sys_line(base_path + "online", line)) {
+            return retval;
+        }
+        try {
+            for (const auto &node : detail::parse_sys_index_list(line)) {
+                if (!detail::read_sys_line(base_path + "node" + std::to_string(node) + "/cpulist", line)) {
+                    return {};
+                }
+                auto cpus = detail::parse_sys_index_list(line);
+                if (!cpus.empty()) {
+                    retval.push_back(std::move(cpus));
+                }
+            }
+        } catch (const std::bad_alloc &) {
+            throw;
+        } catch (...) {
+            // Malformed content in the /sys files.
+            return {};
+        }
+#endif
+        return retval;
+    }
 };
 }
 
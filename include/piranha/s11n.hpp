@@ -38,6 +38,8 @@ see https://www.gnu.org/licenses/. */
 #include <boost/algorithm/string/predicate.hpp>
 
 #include <piranha/config.hpp>
+#include <piranha/detail/demangle.hpp>
+#include <piranha/detail/flat_format.hpp>
 #include <piranha/detail/init.hpp>
 #include <piranha/exceptions.hpp>
 #include <piranha/type_traits.hpp>
@@ -1236,7 +1238,15 @@ enum class data_format {
     /**
      * This format will employ internally the msgpack_format::portable format.
      */
-    msgpack_portable
+    msgpack_portable,
+    /// Flat binary.
+    /**
+     * This format stores objects in a flat, non-portable binary layout which can be memory-mapped. It is
+     * implemented via piranha::flat_save_impl and piranha::flat_load_impl, and it does not support compression.
+     * The files record the byte order and the widths of the integral types of the platform on which they were
+     * created, and they can be loaded only on platforms on which these match.
+     */
+    flat_binary
 };
 
 /// Compression format.
@@ -1254,6 +1264,33 @@ enum class compression {
     zlib
 };
 
+/// Default implementation of the flat data format saving function.
+/**
+ * Specialisations of this class are used by piranha::save_file() to save objects of type \p T in the
+ * piranha::data_format::flat_binary format. A specialisation must provide a call operator with signature
+ * @code
+ * void operator()(const T &x, const std::string &filename) const;
+ * @endcode
+ * which writes \p x into the file named \p filename. The default implementation does not define any call operator.
+ */
+template <typename T, typename = void>
+struct flat_save_impl {
+};
+
+/// Default implementation of the flat data format loading function.
+/**
+ * Specialisations of this class are used by piranha::load_file() to load objects of type \p T from files in the
+ * piranha::data_format::flat_binary format. A specialisation must provide a call operator with signature
+ * @code
+ * void operator()(T &x, const std::string &filename) const;
+ * @endcode
+ * which loads the content of the file named \p filename into \p x. The default implementation does not define any
+ * call operator.
+ */
+template <typename T, typename = void>
+struct flat_load_impl {
+};
+
 inline namespace impl
 {
 
@@ -1534,6 +1571,48 @@ inline void load_file_msgpack_impl(T &, const std::string &, data_format, compre
 
 #endif
 
+// Save/load functions for the flat format.
+template <typename T>
+using flat_save_impl_t
+    = decltype(flat_save_impl<T>{}(std::declval<const T &>(), std::declval<const std::string &>()));
+
+template <typename T>
+using flat_load_impl_t = decltype(flat_load_impl<T>{}(std::declval<T &>(), std::declval<const std::string &>()));
+
+template <typename T, enable_if_t<is_detected<flat_save_impl_t, T>::value, int> = 0>
+inline void save_file_flat_impl(const T &x, const std::string &filename, compression c)
+{
+    // NOTE: the whole point of the flat format is to be able to map the file in memory, which
+    // is not possible with compressed files.
+    if (unlikely(c != compression::none)) {
+        piranha_throw(not_implemented_error, "the flat data format does not support compression");
+    }
+    flat_save_impl<T>{}(x, filename);
+}
+
+template <typename T, enable_if_t<!is_detected<flat_save_impl_t, T>::value, int> = 0>
+inline void save_file_flat_impl(const T &, const std::string &, compression)
+{
+    piranha_throw(not_implemented_error,
+                  "type '" + demangle<T>() + "' does not support serialization via the flat data format");
+}
+
+template <typename T, enable_if_t<is_detected<flat_load_impl_t, T>::value, int> = 0>
+inline void load_file_flat_impl(T &x, const std::string &filename, compression c)
+{
+    if (unlikely(c != compression::none)) {
+        piranha_throw(not_implemented_error, "the flat data format does not support compression");
+    }
+    flat_load_impl<T>{}(x, filename);
+}
+
+template <typename T, enable_if_t<!is_detected<flat_load_impl_t, T>::value, int> = 0>
+inline void load_file_flat_impl(T &, const std::string &, compression)
+{
+    piranha_throw(not_implemented_error,
+                  "type '" + demangle<T>() + "' does not support deserialization via the flat data format");
+}
+
 // General enabler for load_file().
 template <typename T>
 using load_file_enabler = enable_if_t<!std::is_const<T>::value, int>;
@@ -1562,11 +1641,13 @@ inline std::pair<compression, data_format> get_cdf_from_filename(std::string fil
         f = data_format::msgpack_binary;
     } else if (boost::ends_with(filename, ".mpackp")) {
         f = data_format::msgpack_portable;
+    } else if (boost::ends_with(filename, ".flatb")) {
+        f = data_format::flat_binary;
     } else {
         piranha_throw(std::invalid_argument,
                       "unable to deduce the data format from the filename '" + orig_fname
-                          + "'. The filename must end with one of ['.boostb','.boostp','.mpackb','.mpackp'], "
-                            "optionally followed by one of ['.bz2','gz','zip'].");
+                          + "'. The filename must end with one of ['.boostb','.boostp','.mpackb','.mpackp',"
+                            "'.flatb'], optionally followed by one of ['.bz2','gz','zip'].");
     }
     return std::make_pair(c, f);
 }
@@ -1577,9 +1658,10 @@ inline std::pair<compression, data_format> get_cdf_from_filename(std::string fil
  * This function will save the generic object \p x to the file named \p filename, using the data format
  * \p f and the compression method \p c.
  *
- * This function is built on lower-level routines such as piranha::boost_save() and piranha::msgpack_pack(). The data
- * format \p f establishes both the lower level serialization method to be used and its variant (e.g., portable
- * vs binary). If requested (i.e., if \p c is not piranha::compression::none), the output file will be compressed.
+ * This function is built on lower-level routines such as piranha::boost_save(), piranha::msgpack_pack() and
+ * piranha::flat_save_impl. The data format \p f establishes both the lower level serialization method to be used and
+ * its variant (e.g., portable vs binary). If requested (i.e., if \p c is not piranha::compression::none), the output
+ * file will be compressed.
  *
  * @param x object to be saved to file.
  * @param filename name of the output file.
@@ -1590,7 +1672,8 @@ inline std::pair<compression, data_format> get_cdf_from_filename(std::string fil
  * - the type \p T does not implement the required serialization method (e.g., \p f is
  *   piranha::data_format::boost_binary but \p T does not provide an implementation of piranha::boost_save()),
  * - a necessary optional third-party library (e.g., msgpack or one of the compression libraries)
- *   is not available on the host platform.
+ *   is not available on the host platform,
+ * - \p f is piranha::data_format::flat_binary and \p c is not piranha::compression::none.
  * @throws std::runtime_error in case the file cannot be opened for writing.
  * @throws unspecified any exception thrown by:
  * - piranha::safe_cast(),
@@ -1604,6 +1687,8 @@ inline void save_file(const T &x, const std::string &filename, data_format f, co
         save_file_boost_impl(x, filename, f, c);
     } else if (f == data_format::msgpack_binary || f == data_format::msgpack_portable) {
         save_file_msgpack_impl(x, filename, f, c);
+    } else if (f == data_format::flat_binary) {
+        save_file_flat_impl(x, filename, c);
     }
 }
 
@@ -1616,10 +1701,10 @@ inline void save_file(const T &x, const std::string &filename, data_format f, co
  *   piranha::compression format is assumed (respectively, piranha::compression::bzip2, piranha::compression::gzip
  *   and piranha::compression::zlib). Otherwise, piranha::compression::none is assumed;
  * - after the removal of any compression suffix, the extension of \p filename is examined again: if the extension is
- *   one of <tt>.boostp</tt>, <tt>.boostb</tt>, <tt>.mpackp</tt> and <tt>.mpackb</tt>, then the corresponding data
- *   format is selected (respectively, piranha::data_format::boost_portable, piranha::data_format::boost_binary,
- *   piranha::data_format::msgpack_portable, piranha::data_format::msgpack_binary). Othwewise, an error will be
- *   produced.
+ *   one of <tt>.boostp</tt>, <tt>.boostb</tt>, <tt>.mpackp</tt>, <tt>.mpackb</tt> and <tt>.flatb</tt>, then the
+ *   corresponding data format is selected (respectively, piranha::data_format::boost_portable,
+ *   piranha::data_format::boost_binary, piranha::data_format::msgpack_portable, piranha::data_format::msgpack_binary,
+ *   piranha::data_format::flat_binary). Othwewise, an error will be produced.
  *
  * Examples:
  * - <tt>foo.boostb.bz2</tt> deduces piranha::data_format::boost_binary and piranha::compression::bzip2;
@@ -1649,9 +1734,9 @@ inline void save_file(const T &x, const std::string &filename)
  * stored in the format \p f using the compression method \p c. If \p c is not piranha::compression::none, it will
  * be assumed that the file is compressed.
  *
- * This function is built on lower-level routines such as piranha::boost_load() and piranha::msgpack_convert(). The data
- * format \p f establishes both the lower level serialization method to be used and its variant (e.g., portable
- * vs binary).
+ * This function is built on lower-level routines such as piranha::boost_load(), piranha::msgpack_convert() and
+ * piranha::flat_load_impl. The data format \p f establishes both the lower level serialization method to be used and
+ * its variant (e.g., portable vs binary).
  *
  * @param x the object into which the content of the file name \p filename will be deserialized.
  * @param filename name of the input file.
@@ -1662,7 +1747,8 @@ inline void save_file(const T &x, const std::string &filename)
  * - the type \p T does not implement the required serialization method (e.g., \p f is
  *   piranha::data_format::boost_binary but \p T does not provide an implementation of piranha::boost_load()),
  * - a necessary optional third-party library (e.g., msgpack or one of the compression libraries)
- *   is not available on the host platform.
+ *   is not available on the host platform,
+ * - \p f is piranha::data_format::flat_binary and \p c is not piranha::compression::none.
  * @throws std::runtime_error in case the file cannot be opened for reading.
  * @throws unspecified any exception thrown by:
  * - piranha::safe_cast(),
@@ -1677,6 +1763,8 @@ inline void load_file(T &x, const std::string &filename, data_format f, compress
         load_file_boost_impl(x, filename, f, c);
     } else if (f == data_format::msgpack_binary || f == data_format::msgpack_portable) {
         load_file_msgpack_impl(x, filename, f, c);
+    } else if (f == data_format::flat_binary) {
+        load_file_flat_impl(x, filename, c);
     }
 }
 
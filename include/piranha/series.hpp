@@ -57,13 +57,18 @@ see https://www.gnu.org/licenses/. */
 #include <utility>
 #include <vector>
 
+#include <mp++/integer.hpp>
+#include <mp++/rational.hpp>
+
 #include <piranha/config.hpp>
 #include <piranha/convert_to.hpp>
 #include <piranha/detail/debug_access.hpp>
 #include <piranha/detail/init.hpp>
+#include <piranha/detail/pow_cache.hpp>
 #include <piranha/detail/series_fwd.hpp>
 #include <piranha/detail/sfinae_types.hpp>
 #include <piranha/exceptions.hpp>
+#include <piranha/fixed_integer.hpp>
 #include <piranha/hash_set.hpp>
 #include <piranha/integer.hpp>
 #include <piranha/invert.hpp>
@@ -83,6 +88,8 @@ see https://www.gnu.org/licenses/. */
 #include <piranha/settings.hpp>
 #include <piranha/symbol_utils.hpp>
 #include <piranha/term.hpp>
+#include <piranha/thread_pool.hpp>
+#include <piranha/tuning.hpp>
 #include <piranha/type_traits.hpp>
 
 namespace piranha
@@ -265,6 +272,25 @@ template <typename T>
 const std::size_t series_recursion_index<
     T, typename std::enable_if<std::is_base_of<detail::series_tag, typename std::decay<T>::type>::value>::type>::value;
 
+inline namespace impl
+{
+
+// Detect if the in-place addition of instances of T is exact, so that the result of a sum does not depend on how
+// the addends are grouped. This holds for integral and rational types, and for series whose coefficient type
+// (recursively) has an exact addition. The parallel term-wise accumulations of series are restricted to these types,
+// so that their results are always identical to the serial ones. For the non-series types, the multiplication is
+// exact as well, which is used to select the fast exponentiation algorithms of polynomials.
+template <typename T, typename = void>
+struct has_exact_addition
+    : disjunction<std::is_integral<T>, mppp::is_integer<T>, mppp::is_rational<T>, is_fixed_integer<T>> {
+};
+
+template <typename T>
+struct has_exact_addition<T, enable_if_t<std::is_base_of<detail::series_tag, T>::value>>
+    : has_exact_addition<typename T::term_type::cf_type> {
+};
+}
+
 /// Type trait to detect the availability of a series multiplier.
 /**
  * This type trait will be \p true if a piranha::series_multiplier of \p Series can be constructed and used
@@ -909,9 +935,8 @@ class series_operators
         // Create a copy of x and work on it. This is always possible.
         ret_type retval(std::forward<T>(x));
         // NOTE: x is not used any more.
-        const auto it_f = retval.m_container.end();
         try {
-            for (auto it = retval.m_container.begin(); it != it_f;) {
+            retval.map_cfs_impl([&y](typename ret_type::term_type::cf_type &cf) {
 #if defined(PIRANHA_COMPILER_IS_GCC)
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wconversion"
@@ -919,19 +944,11 @@ class series_operators
                 // NOTE: here the original requirement is that cf / y is defined, but we know
                 // that cf / y results in another cf, and we assume always that cf /= y is exactly equivalent
                 // to cf = cf / y. And cf must be move-assignable. So this should be possible.
-                it->m_cf /= y;
+                cf /= y;
 #if defined(PIRANHA_COMPILER_IS_GCC)
 #pragma GCC diagnostic pop
 #endif
-                // NOTE: no need to check for compatibility, as it depends only on the key type and here
-                // we are only acting on the coefficient.
-                if (unlikely(it->is_zero(retval.m_symbol_set))) {
-                    // Erase will return the next iterator.
-                    it = retval.m_container.erase(it);
-                } else {
-                    ++it;
-                }
-            }
+            });
         } catch (...) {
             // In case of errors clear out the series.
             retval.m_container.clear();
@@ -1435,14 +1452,313 @@ private:
             merge_terms_impl1<Sign>(std::forward<T>(s));
         }
     }
+    // Parallel merging
+    // ================
+    // Number of threads to be used when merging the terms of c into this. The number of terms of c
+    // is taken as the amount of work to be performed.
+    unsigned merge_n_threads(const container_type &c) const
+    {
+        const auto min_work = settings::get_min_work_per_thread();
+        // NOTE: don't use threads if there is not enough work, or if the sizes of the containers overflow.
+        if (static_cast<unsigned long long>(c.size()) / 2u < min_work
+            || unlikely(c.size() > std::numeric_limits<size_type>::max() - m_container.size())) {
+            return 1u;
+        }
+        return thread_pool::use_threads(static_cast<unsigned long long>(c.size()), min_work);
+    }
+    // Merge a compatible, non-ignorable term into the bucket of m_container with index bucket_idx, without rehashing
+    // and without updating the size of the container. Returns 1 if a new term was inserted, -1 if an existing
+    // term was erased, 0 otherwise.
+    template <bool Sign, typename T>
+    int bucket_insertion(T &&term, const size_type &bucket_idx)
+    {
+        const auto it = m_container._find(term, bucket_idx);
+        if (it == m_container.end()) {
+            const auto new_it = m_container._unique_insert(std::forward<T>(term), bucket_idx);
+            if (!Sign) {
+                math::negate(new_it->m_cf);
+                if (unlikely(new_it->is_zero(m_symbol_set))) {
+                    m_container._erase(new_it);
+                    return 0;
+                }
+            }
+            return 1;
+        }
+        piranha_assert(!it->is_zero(m_symbol_set) && it->is_compatible(m_symbol_set));
+        insertion_cf_arithmetics<Sign>(it, std::forward<T>(term));
+        if (unlikely(it->is_zero(m_symbol_set))) {
+            m_container._erase(it);
+            return -1;
+        }
+        return 0;
+    }
+    static const term_type &merge_fwd(const term_type *p)
+    {
+        return *p;
+    }
+    static term_type &&merge_fwd(term_type *p)
+    {
+        return std::move(*p);
+    }
+    // Merge the terms of c into this using n_threads threads from the thread pool. The buckets of m_container
+    // are subdivided into zones, and each zone is written by a single thread (the same technique used in
+    // the multithreaded polynomial multiplication). The terms of c are moved if Move is true. If negate_all is true,
+    // all the terms of this are negated after the merge (this is needed if the containers were swapped in
+    // a subtraction). In case of errors, the caller is expected to clear the containers involved.
+    template <bool Sign, bool Move, typename Container>
+    void parallel_merge(Container &c, unsigned n_threads, bool negate_all)
+    {
+        using b_size_type = typename container_type::size_type;
+        using ptr_type = typename std::conditional<Move, term_type *, const term_type *>::type;
+        using t_list_type = std::vector<std::vector<std::vector<std::pair<ptr_type, b_size_type>>>>;
+        piranha_assert(n_threads > 1u);
+        // Make sure the destination container can hold all the terms without rehashing.
+        const auto max_n_buckets = boost::numeric_cast<b_size_type>(
+            std::ceil(static_cast<double>(m_container.size() + c.size()) / m_container.max_load_factor()));
+        if (m_container.bucket_count() < max_n_buckets) {
+            m_container.rehash(max_n_buckets, n_threads);
+        }
+        const b_size_type b_count = m_container.bucket_count(), src_b_count = c.bucket_count();
+        // Subdivide the destination into zones, a multiple of the number of threads.
+        // NOTE: zm is a tuning parameter.
+        const unsigned zm = 10u;
+        const auto n_zones = safe_cast<b_size_type>(integer(n_threads) * zm);
+        // Number of buckets per zone (can be zero), the last zone extends up to the end of the container.
+        const b_size_type bpz = static_cast<b_size_type>(b_count / n_zones);
+        auto zone_from_bucket = [bpz, n_zones](const b_size_type &idx) -> b_size_type {
+            return bpz ? std::min(static_cast<b_size_type>(idx / bpz), static_cast<b_size_type>(n_zones - 1u))
+                       : static_cast<b_size_type>(n_zones - 1u);
+        };
+        // In the first pass, each thread processes a range of buckets of c, and sorts the terms
+        // into lists according to the destination zone.
+        t_list_type t_lists(n_threads);
+        auto sort_functor = [&](const unsigned &thread_idx) {
+            auto &lists = t_lists[thread_idx];
+            lists.resize(safe_cast<typename t_list_type::value_type::size_type>(n_zones));
+            // Number of source buckets per thread (can be zero), the last thread processes the remainder.
+            const auto bpt = static_cast<b_size_type>(src_b_count / n_threads);
+            const auto start = static_cast<b_size_type>(bpt * thread_idx),
+                       end = (thread_idx == n_threads - 1u) ? src_b_count : static_cast<b_size_type>(start + bpt);
+            for (auto i = start; i < end; ++i) {
+                for (auto &t : c._get_bucket_list(i)) {
+                    if (unlikely(!t.is_compatible(m_symbol_set))) {
+                        piranha_throw(std::invalid_argument, "cannot insert incompatible term");
+                    }
+                    if (unlikely(t.is_zero(m_symbol_set))) {
+                        continue;
+                    }
+                    const auto idx = m_container._bucket(t);
+                    lists[static_cast<decltype(lists.size())>(zone_from_bucket(idx))].emplace_back(&t, idx);
+                }
+            }
+        };
+        // Number of inserted and erased terms, for each zone.
+        std::vector<std::pair<size_type, size_type>> counts(safe_cast<std::size_t>(n_zones),
+                                                            std::make_pair(size_type(0), size_type(0)));
+        // In the second pass, each zone is merged by a separate task.
+        auto zone_functor = [&](const b_size_type &z_idx) {
+            auto &cnt = counts[static_cast<std::size_t>(z_idx)];
+            for (auto &lists : t_lists) {
+                for (const auto &p : lists[static_cast<decltype(lists.size())>(z_idx)]) {
+                    const auto r = bucket_insertion<Sign>(merge_fwd(p.first), p.second);
+                    if (r > 0) {
+                        ++cnt.first;
+                    } else if (r < 0) {
+                        ++cnt.second;
+                    }
+                }
+            }
+            if (negate_all) {
+                const auto a = static_cast<b_size_type>(bpz * z_idx),
+                           b = (z_idx == n_zones - 1u) ? b_count : static_cast<b_size_type>(bpz * (z_idx + 1u));
+                for (auto i = a; i < b; ++i) {
+                    for (const auto &t : m_container._get_bucket_list(i)) {
+                        math::negate(t.m_cf);
+                    }
+                    // NOTE: erase the terms that became ignorable (if any) one at a time, as erasing
+                    // invalidates the other iterators in the bucket.
+                    while (true) {
+                        const auto &l = m_container._get_bucket_list(i);
+                        const auto it = std::find_if(l.begin(), l.end(), [this](const term_type &t) {
+                            return t.is_zero(this->m_symbol_set);
+                        });
+                        if (it == l.end()) {
+                            break;
+                        }
+                        m_container._erase(m_container._find(*it, i));
+                        ++cnt.second;
+                    }
+                }
+            }
+        };
+        // Each thread submits the zones it owns as stealable tasks and waits for them, so that threads
+        // running out of zones steal the remaining ones from the others.
+        auto merge_functor = [&zone_functor](const unsigned &thread_idx) {
+            future_list<void> fz_list;
+            try {
+                for (unsigned n = 0u; n < zm; ++n) {
+                    fz_list.push_back(
+                        thread_pool::submit(zone_functor, static_cast<b_size_type>(b_size_type(thread_idx) * zm + n)));
+                }
+                fz_list.wait_all();
+                fz_list.get_all();
+            } catch (...) {
+                fz_list.wait_all();
+                throw;
+            }
+        };
+        auto run = [n_threads](const std::function<void(const unsigned &)> &f) {
+            future_list<void> ft_list;
+            try {
+                for (unsigned i = 0u; i < n_threads; ++i) {
+                    ft_list.push_back(thread_pool::enqueue(i, f, i));
+                }
+                ft_list.wait_all();
+                ft_list.get_all();
+            } catch (...) {
+                ft_list.wait_all();
+                throw;
+            }
+        };
+        run(sort_functor);
+        run(merge_functor);
+        // Update the size.
+        auto new_size = m_container.size();
+        for (const auto &p : counts) {
+            new_size = static_cast<size_type>(new_size + p.first);
+        }
+        for (const auto &p : counts) {
+            piranha_assert(new_size >= p.second);
+            new_size = static_cast<size_type>(new_size - p.second);
+        }
+        m_container._update_size(new_size);
+    }
+    // Parallel term-wise operations
+    // =============================
+    // Number of threads to be used in an operation whose amount of work is proportional to the number of terms
+    // of this.
+    unsigned termwise_n_threads() const
+    {
+        const auto min_work = settings::get_min_work_per_thread();
+        if (static_cast<unsigned long long>(m_container.size()) / 2u < min_work) {
+            return 1u;
+        }
+        return thread_pool::use_threads(static_cast<unsigned long long>(m_container.size()), min_work);
+    }
+    // Run f(thread_idx, start, end) in n_threads threads from the thread pool, where [start, end) is a range of
+    // buckets of m_container. The ranges are disjoint, and the last thread processes the remainder of the buckets.
+    template <typename F>
+    void for_bucket_ranges(unsigned n_threads, const F &f) const
+    {
+        using b_size_type = typename container_type::size_type;
+        piranha_assert(n_threads > 1u);
+        const b_size_type b_count = m_container.bucket_count();
+        // Number of buckets per thread (can be zero).
+        const auto bpt = static_cast<b_size_type>(b_count / n_threads);
+        future_list<void> ft_list;
+        try {
+            for (unsigned i = 0u; i < n_threads; ++i) {
+                const auto start = static_cast<b_size_type>(bpt * i),
+                           end = (i == n_threads - 1u) ? b_count : static_cast<b_size_type>(start + bpt);
+                ft_list.push_back(thread_pool::enqueue(i, f, i, start, end));
+            }
+            ft_list.wait_all();
+            ft_list.get_all();
+        } catch (...) {
+            ft_list.wait_all();
+            throw;
+        }
+    }
+    // Apply f to the coefficients of all terms, and erase the terms which become ignorable. Large series are
+    // processed in parallel by ranges of buckets. In case of errors, the caller is expected to clear the container.
+    template <typename F>
+    void map_cfs_impl(const F &f)
+    {
+        using b_size_type = typename container_type::size_type;
+        const auto n_threads = termwise_n_threads();
+        if (n_threads == 1u) {
+            const auto it_f = m_container.end();
+            for (auto it = m_container.begin(); it != it_f;) {
+                f(it->m_cf);
+                // NOTE: no need to check for compatibility, as it depends only on the key type and here
+                // we are only acting on the coefficient.
+                if (unlikely(it->is_zero(m_symbol_set))) {
+                    it = m_container.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            return;
+        }
+        // Number of erased terms, for each thread.
+        std::vector<b_size_type> erase_counts(n_threads, b_size_type(0));
+        for_bucket_ranges(n_threads, [this, &f, &erase_counts](const unsigned &thread_idx, const b_size_type &start,
+                                                                const b_size_type &end) {
+            auto &cnt = erase_counts[thread_idx];
+            for (auto i = start; i < end; ++i) {
+                for (const auto &t : m_container._get_bucket_list(i)) {
+                    f(t.m_cf);
+                }
+                // NOTE: erase the ignorable terms one at a time, as in parallel_merge().
+                while (true) {
+                    const auto &l = m_container._get_bucket_list(i);
+                    const auto it = std::find_if(l.begin(), l.end(), [this](const term_type &t) {
+                        return t.is_zero(this->m_symbol_set);
+                    });
+                    if (it == l.end()) {
+                        break;
+                    }
+                    m_container._erase(m_container._find(*it, i));
+                    ++cnt;
+                }
+            }
+        });
+        auto new_size = m_container.size();
+        for (const auto &cnt : erase_counts) {
+            piranha_assert(new_size >= cnt);
+            new_size = static_cast<b_size_type>(new_size - cnt);
+        }
+        m_container._update_size(new_size);
+    }
+    // A minimal container-like view over a set of vectors of terms, usable as source in parallel_merge(). Each vector
+    // is seen as a bucket, so that, when there is one vector per thread, each thread of the merge sorts the terms
+    // of one vector.
+    struct term_lists {
+        using size_type = typename container_type::size_type;
+        explicit term_lists(unsigned n) : m_lists(n)
+        {
+        }
+        size_type size() const
+        {
+            size_type retval(0);
+            for (const auto &l : m_lists) {
+                retval = static_cast<size_type>(retval + l.size());
+            }
+            return retval;
+        }
+        size_type bucket_count() const
+        {
+            return static_cast<size_type>(m_lists.size());
+        }
+        std::vector<term_type> &_get_bucket_list(const size_type &idx)
+        {
+            return m_lists[static_cast<typename std::vector<std::vector<term_type>>::size_type>(idx)];
+        }
+        std::vector<std::vector<term_type>> m_lists;
+    };
     // Overload if we cannot move objects from series.
     template <bool Sign, typename T>
     void merge_terms_impl1(T &&s, typename std::enable_if<!is_nonconst_rvalue_ref<T &&>::value>::type * = nullptr)
     {
         const auto it_f = s.m_container.end();
         try {
-            for (auto it = s.m_container.begin(); it != it_f; ++it) {
-                insert<Sign>(*it);
+            const auto n_threads = merge_n_threads(s.m_container);
+            if (n_threads > 1u) {
+                parallel_merge<Sign, false>(s.m_container, n_threads, false);
+            } else {
+                for (auto it = s.m_container.begin(); it != it_f; ++it) {
+                    insert<Sign>(*it);
+                }
             }
         } catch (...) {
             // In case of any insertion error, zero out this series.
@@ -1492,22 +1808,18 @@ private:
         // Try to steal memory from other.
         swap_for_merge(std::move(m_container), std::move(s.m_container), swap);
         try {
-            const auto it_f = s.m_container._m_end();
-            for (auto it = s.m_container._m_begin(); it != it_f; ++it) {
-                insert<Sign>(std::move(*it));
-            }
-            // If we swapped the operands and a negative merge was performed, we need to change
-            // the signs of all coefficients.
-            if (swap && !Sign) {
-                const auto it_f2 = m_container.end();
-                for (auto it = m_container.begin(); it != it_f2;) {
-                    math::negate(it->m_cf);
-                    if (unlikely(it->is_zero(m_symbol_set))) {
-                        // Erase the invalid term.
-                        it = m_container.erase(it);
-                    } else {
-                        ++it;
-                    }
+            const auto n_threads = merge_n_threads(s.m_container);
+            if (n_threads > 1u) {
+                parallel_merge<Sign, true>(s.m_container, n_threads, swap && !Sign);
+            } else {
+                const auto it_f = s.m_container._m_end();
+                for (auto it = s.m_container._m_begin(); it != it_f; ++it) {
+                    insert<Sign>(std::move(*it));
+                }
+                // If we swapped the operands and a negative merge was performed, we need to change
+                // the signs of all coefficients.
+                if (swap && !Sign) {
+                    map_cfs_impl([](typename term_type::cf_type &cf) { math::negate(cf); });
                 }
             }
         } catch (...) {
@@ -1797,50 +2109,41 @@ private:
     {
         static_assert(std::is_same<Derived, partial_type<Series>>::value, "Invalid type.");
         // This is the faster algorithm.
-        Derived retval;
-        retval.m_symbol_set = this->m_symbol_set;
-        // Prepare a number of buckets equal to the current one.
-        retval.m_container.rehash(this->m_container.bucket_count());
-        const auto pos = ss_index_of(retval.m_symbol_set, name);
-        const auto it_f = this->m_container.end();
-        for (auto it = this->m_container.begin(); it != it_f; ++it) {
-            // NOTE: here the term being inserted cannot be incompatible as it->m_key is coming from
+        const auto pos = ss_index_of(this->m_symbol_set, name);
+        return termwise_transform([this, &name, pos](const term_type &t, std::vector<term_type> &out) {
+            // NOTE: here the first term cannot be incompatible as t.m_key is coming from
             // a series with the same symbol set. The worst that can happen is something going awry in the derivative of
             // the coefficient. If the derivative becomes zero, the insertion routine will not insert anything.
-            retval.insert(term_type{math::partial(it->m_cf, name), it->m_key});
-            // NOTE: if the partial of the key returns an incompatible key, an error will be raised.
-            auto p_key = it->m_key.partial(pos, retval.m_symbol_set);
+            out.emplace_back(math::partial(t.m_cf, name), t.m_key);
+            // NOTE: if the partial of the key returns an incompatible key, an error will be raised on insertion.
+            auto p_key = t.m_key.partial(pos, this->m_symbol_set);
 #if defined(PIRANHA_COMPILER_IS_GCC)
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wconversion"
 #endif
-            retval.insert(term_type{it->m_cf * p_key.first, std::move(p_key.second)});
+            out.emplace_back(t.m_cf * p_key.first, std::move(p_key.second));
 #if defined(PIRANHA_COMPILER_IS_GCC)
 #pragma GCC diagnostic pop
 #endif
-        }
-        return retval;
+        });
     }
     template <typename Series = Derived, typename std::enable_if<partial_type_<Series>::algo == 1, int>::type = 0>
     partial_type<Series> partial_impl(const std::string &name) const
     {
         const auto pos = ss_index_of(this->m_symbol_set, name);
-        partial_type<Series> retval(0);
-        const auto it_f = this->m_container.end();
-        for (auto it = this->m_container.begin(); it != it_f; ++it) {
+        return termwise_accumulate<partial_type<Series>>([this, &name, pos](const term_type &t) {
             // Construct the two pieces of the derivative relating to the key
             // in the original term.
             Derived tmp0;
             tmp0.m_symbol_set = this->m_symbol_set;
-            tmp0.insert(term_type{1, it->m_key});
-            auto p_key = it->m_key.partial(pos, this->m_symbol_set);
+            tmp0.insert(term_type{1, t.m_key});
+            auto p_key = t.m_key.partial(pos, this->m_symbol_set);
             Derived tmp1;
             tmp1.m_symbol_set = this->m_symbol_set;
             tmp1.insert(term_type{1, std::move(p_key.second)});
             // Assemble everything into the return value.
-            retval += math::partial(it->m_cf, name) * tmp0 + it->m_cf * p_key.first * tmp1;
-        }
-        return retval;
+            return math::partial(t.m_cf, name) * tmp0 + t.m_cf * p_key.first * tmp1;
+        });
     }
     // Custom derivatives boilerplate.
     // Partial derivative of a series type, as defined by math::partial(). Note that here we cannot use
@@ -1950,17 +2253,26 @@ private:
         }
     };
     template <typename Series>
-    using pow_map_type = std::unordered_map<Series, std::vector<pow_m_type<Series>>, series_hasher, series_equal_to>;
+    using pow_cache_type = detail::pow_cache<Series, pow_m_type<Series>, series_hasher, series_equal_to>;
     // NOTE: here, as in the custom derivative machinery, we need to pass through a static function
     // to get the cache because Derived is an incomplete type and we cannot thus use a static data member
     // involving Derived in series. Also, we need the Series template argument to inhibit the instantiation
     // of the function for series types that do not support exponentiation.
     template <typename Series = Derived>
-    static pow_map_type<Series> &get_pow_cache()
+    static pow_cache_type<Series> &get_pow_cache()
     {
-        static pow_map_type<Series> s_pow_cache;
+        static pow_cache_type<Series> s_pow_cache;
         return s_pow_cache;
     }
+    // Estimate of the memory used by a series stored in the pow cache: the container, the bucket array
+    // and the terms. The memory allocated dynamically by coefficients and keys is not accounted for.
+    template <typename Series>
+    static std::size_t pow_cache_memory(const Series &s)
+    {
+        using t_type = typename Series::term_type;
+        return sizeof(Series) + static_cast<std::size_t>(s.table_bucket_count()) * (sizeof(t_type) + sizeof(void *))
+               + static_cast<std::size_t>(s.size()) * sizeof(t_type);
+    }
     // Empty for sfinae.
     template <typename T, typename U, typename = void>
     struct pow_ret_type_ {
@@ -2238,21 +2550,15 @@ public:
      * the basic exception safety guarantee is provided.
      *
      * If any term becomes ignorable or incompatible after negation, it will be erased from the series.
+     * Large series are processed in parallel using the threads of piranha::thread_pool.
      *
-     * @throws unspecified any exception thrown by math::negate() or by piranha::term::is_zero().
+     * @throws unspecified any exception thrown by math::negate(), by piranha::term::is_zero() or by threading
+     * primitives.
      */
     void negate()
     {
         try {
-            const auto it_f = m_container.end();
-            for (auto it = m_container.begin(); it != it_f;) {
-                math::negate(it->m_cf);
-                if (unlikely(it->is_zero(m_symbol_set))) {
-                    it = m_container.erase(it);
-                } else {
-                    ++it;
-                }
-            }
+            map_cfs_impl([](typename term_type::cf_type &cf) { math::negate(cf); });
         } catch (...) {
             m_container.clear();
             throw;
@@ -2312,7 +2618,10 @@ public:
      * - otherwise, an exception will be raised.
      *
      * An internal thread-safe cache of natural powers of series is maintained in order to improve performance during,
-     * e.g., substitution operations. This cache can be cleared with clear_pow_cache().
+     * e.g., substitution operations. Threads computing powers of different series do not block each other, and
+     * threads requesting a power which is being computed by another thread will wait for its completion instead of
+     * computing it again. The memory used by the cache is bounded (see get_pow_cache_stats()), and the cache can be
+     * cleared with clear_pow_cache().
      *
      * @param x exponent.
      *
@@ -2373,23 +2682,17 @@ public:
         if (n.sgn() < 0) {
             piranha_throw(std::invalid_argument, "invalid argument for series exponentiation: negative integral value");
         }
-        // Lock the cache for the rest of the method.
-        std::lock_guard<std::mutex> lock(s_pow_mutex);
-        auto &v = get_pow_cache()[*static_cast<Derived const *>(this)];
-        using s_type = decltype(v.size());
-        // Init the vector, if needed.
-        if (!v.size()) {
+        // Fetch the power from the cache, computing the missing powers if needed.
+        // NOTE: for series it seems like it is better to run the dumb algorithm instead of, e.g.,
+        // exponentiation by squaring - the growth in number of terms seems to be slower.
+        auto one = []() {
             m_type tmp;
             tmp.insert(m_term_type(m_cf_type(1), m_key_type(symbol_fset{})));
-            v.push_back(std::move(tmp));
-        }
-        // Fill in the missing powers.
-        while (v.size() <= n) {
-            // NOTE: for series it seems like it is better to run the dumb algorithm instead of, e.g.,
-            // exponentiation by squaring - the growth in number of terms seems to be slower.
-            v.push_back(v.back() * (*static_cast<Derived const *>(this)));
-        }
-        return ret_type(v[static_cast<s_type>(n)]);
+            return tmp;
+        };
+        return ret_type(get_pow_cache().get(*static_cast<Derived const *>(this), safe_cast<std::size_t>(n), one,
+                                            pow_cache_memory<m_type>,
+                                            safe_cast<std::size_t>(tuning::get_pow_cache_max_memory())));
     }
     /// Clear the internal cache of natural powers.
     /**
@@ -2400,9 +2703,27 @@ public:
     template <typename T = Derived, is_identical_enabler<T> = 0>
     static void clear_pow_cache()
     {
-        std::lock_guard<std::mutex> lock(s_pow_mutex);
         get_pow_cache().clear();
     }
+    /// Statistics of the internal cache of natural powers.
+    /**
+     * The cache of natural powers maintained by piranha::series::pow() is limited in size: after a new power has
+     * been computed, the powers of the least recently used series are evicted from the cache until the estimated
+     * memory used by the cache is below the limit set via piranha::tuning::set_pow_cache_max_memory(). The memory
+     * estimate accounts for the hash tables and the terms of the cached powers, but not for the memory allocated
+     * dynamically by coefficients and keys.
+     *
+     * The statistics are reset by clear_pow_cache().
+     *
+     * @return the statistics of the cache of natural powers for the calling series type.
+     *
+     * @throws unspecified any exception thrown by threading primitives.
+     */
+    template <typename T = Derived, is_identical_enabler<T> = 0>
+    static pow_cache_stats get_pow_cache_stats()
+    {
+        return get_pow_cache().stats();
+    }
     /// Partial derivative.
     /**
      * \note
@@ -2421,6 +2742,8 @@ public:
      * into account
      * custom derivatives registered via piranha::series::register_custom_derivative().
      *
+     * The terms of large series are differentiated in parallel using the threads of piranha::thread_pool.
+     *
      * @param name name of the argument with respect to which the derivative will be calculated.
      *
      * @return partial derivative of \p this with respect to the symbol \p name.
@@ -2574,6 +2897,8 @@ public:
      * - the assignment operator of piranha::symbol_fset,
      * - term, coefficient, key construction.
      */
+    // NOTE: the terms are filtered serially, as func is not required to be safe to call concurrently
+    // (e.g., it might wrap a Python callable in pyranha).
     Derived filter(std::function<bool(const std::pair<typename term_type::cf_type, Derived> &)> func) const
     {
         Derived retval;
@@ -2612,6 +2937,7 @@ public:
      * - series multiplication and addition.
      */
     // TODO require multipliability of cf * Derived and addability of the result to Derived in place.
+    // NOTE: as in filter(), func is called serially.
     Derived transform(std::function<std::pair<typename term_type::cf_type, Derived>(
                           const std::pair<typename term_type::cf_type, Derived> &)>
                           func) const
@@ -2635,7 +2961,8 @@ public:
      * is zero in all monomials).
      *
      * If the coefficient type is an instance of piranha::series, trim() will be called recursively on the coefficients
-     * while building the return value.
+     * while building the return value. Large series are processed in parallel using the threads of
+     * piranha::thread_pool.
      *
      * @return trimmed version of \p this.
      *
@@ -2648,18 +2975,57 @@ public:
      */
     Derived trim() const
     {
+        using b_size_type = typename container_type::size_type;
         // Init the trimming mask.
         std::vector<char> trim_mask(safe_cast<std::vector<char>::size_type>(m_symbol_set.size()), char(1));
-        // Determine the symbols to be trimmed.
-        const auto it_f = this->m_container.end();
-        for (auto it = this->m_container.begin(); it != it_f; ++it) {
-            it->m_key.trim_identify(trim_mask, m_symbol_set);
-        }
-        // Build the retval.
         Derived retval;
+        const auto n_threads = termwise_n_threads();
+        if (n_threads == 1u) {
+            // Determine the symbols to be trimmed.
+            const auto it_f = this->m_container.end();
+            for (auto it = this->m_container.begin(); it != it_f; ++it) {
+                it->m_key.trim_identify(trim_mask, m_symbol_set);
+            }
+            // Build the retval.
+            retval.m_symbol_set = ss_trim(m_symbol_set, trim_mask);
+            for (auto it = this->m_container.begin(); it != it_f; ++it) {
+                retval.insert(term_type{trim_cf_impl(it->m_cf), it->m_key.trim(trim_mask, m_symbol_set)});
+            }
+            return retval;
+        }
+        // Each thread identifies the symbols to be trimmed in its range of buckets using its own mask. A symbol
+        // can then be trimmed only if it can be trimmed according to all the masks.
+        std::vector<std::vector<char>> masks(n_threads, trim_mask);
+        for_bucket_ranges(n_threads,
+                          [this, &masks](const unsigned &thread_idx, const b_size_type &start, const b_size_type &end) {
+                              auto &mask = masks[thread_idx];
+                              for (auto i = start; i < end; ++i) {
+                                  for (const auto &t : this->m_container._get_bucket_list(i)) {
+                                      t.m_key.trim_identify(mask, this->m_symbol_set);
+                                  }
+                              }
+                          });
+        for (const auto &mask : masks) {
+            std::transform(trim_mask.begin(), trim_mask.end(), mask.begin(), trim_mask.begin(),
+                           [](char a, char b) { return static_cast<char>(a && b); });
+        }
         retval.m_symbol_set = ss_trim(m_symbol_set, trim_mask);
-        for (auto it = this->m_container.begin(); it != it_f; ++it) {
-            retval.insert(term_type{trim_cf_impl(it->m_cf), it->m_key.trim(trim_mask, m_symbol_set)});
+        // Each thread trims the terms in its range of buckets, and the trimmed terms are then merged into retval.
+        term_lists lists(n_threads);
+        for_bucket_ranges(n_threads, [this, &lists, &trim_mask](const unsigned &thread_idx, const b_size_type &start,
+                                                               const b_size_type &end) {
+            auto &l = lists.m_lists[thread_idx];
+            for (auto i = start; i < end; ++i) {
+                for (const auto &t : this->m_container._get_bucket_list(i)) {
+                    l.emplace_back(trim_cf_impl(t.m_cf), t.m_key.trim(trim_mask, this->m_symbol_set));
+                }
+            }
+        });
+        try {
+            retval.template parallel_merge<true, true>(lists, n_threads, false);
+        } catch (...) {
+            retval.m_container.clear();
+            throw;
         }
         return retval;
     }
@@ -2829,6 +3195,298 @@ public:
     }
     //@}
 protected:
+    /// Look up a natural power in the cache of piranha::series::pow().
+    /**
+     * This method can be used by derived classes which compute natural powers via specialised algorithms, in order
+     * to share the cache of natural powers with piranha::series::pow().
+     *
+     * @param n the exponent.
+     * @param out the object to which the <tt>n</tt>-th power of \p this will be assigned, if found.
+     *
+     * @return \p true if the <tt>n</tt>-th power of \p this is in the cache, \p false otherwise.
+     *
+     * @throws unspecified any exception thrown by:
+     * - threading primitives,
+     * - hash() or is_identical(),
+     * - the copy assignment operator of \p out,
+     * - the computation of the power, if it is being computed concurrently by another thread.
+     */
+    template <typename Series = Derived>
+    bool pow_cache_find(std::size_t n, pow_m_type<Series> &out) const
+    {
+        return get_pow_cache().find(*static_cast<Derived const *>(this), n, out);
+    }
+    /// Store a natural power in the cache of piranha::series::pow().
+    /**
+     * The cache is not modified if it already contains the <tt>n</tt>-th power of \p this. \p p must be equal to
+     * the value that piranha::series::pow() would compute via repeated multiplications.
+     *
+     * @param n the exponent.
+     * @param p the <tt>n</tt>-th power of \p this.
+     *
+     * @throws unspecified any exception thrown by:
+     * - threading primitives,
+     * - hash() or is_identical(),
+     * - memory errors in standard containers,
+     * - the copy constructor of \p p.
+     */
+    template <typename Series = Derived>
+    void pow_cache_insert(std::size_t n, const pow_m_type<Series> &p) const
+    {
+        get_pow_cache().insert(*static_cast<Derived const *>(this), n, p, pow_cache_memory<pow_m_type<Series>>,
+                               safe_cast<std::size_t>(tuning::get_pow_cache_max_memory()));
+    }
+    /// Term-wise accumulation.
+    /**
+     * This method will compute the sum of the values returned by <tt>f(t)</tt> for all the terms \p t in the series,
+     * starting from an instance of \p T constructed from zero. If the series is large enough,
+     * the computation will be split among multiple threads from piranha::thread_pool, each processing a separate
+     * range of buckets and accumulating a partial sum. The partial sums are then added to the return value in
+     * the order of the thread indices. \p f must thus be safe to call concurrently on different terms.
+     *
+     * The way in which the terms are split into partial sums depends on the number of threads. The computation is
+     * thus parallelised only if the addition of instances of \p T is exact (i.e., if \p T is an integral or rational
+     * type, or a series whose coefficients are, recursively, of such types). With floating-point types, the sum is
+     * always computed serially, so that the result does not depend on the number of threads.
+     *
+     * This method is meant to be used by derived classes to implement term-wise operations such as substitutions.
+     *
+     * @param f the functor that will be applied to the terms.
+     *
+     * @return the sum of the values returned by \p f.
+     *
+     * @throws unspecified any exception thrown by:
+     * - the call operator of \p f,
+     * - the construction of \p T from zero and the in-place addition of the values returned by \p f,
+     * - memory allocation errors in standard containers,
+     * - threading primitives.
+     */
+    template <typename T, typename F>
+    T termwise_accumulate(const F &f) const
+    {
+        using b_size_type = typename container_type::size_type;
+        T retval(0);
+        const auto n_threads = has_exact_addition<T>::value ? termwise_n_threads() : 1u;
+        if (n_threads == 1u) {
+            for (const auto &t : m_container) {
+                retval += f(t);
+            }
+            return retval;
+        }
+        std::vector<T> partials;
+        partials.reserve(static_cast<typename std::vector<T>::size_type>(n_threads));
+        for (unsigned i = 0u; i < n_threads; ++i) {
+            partials.emplace_back(0);
+        }
+        for_bucket_ranges(n_threads, [this, &f, &partials](const unsigned &thread_idx, const b_size_type &start,
+                                                            const b_size_type &end) {
+            auto &acc = partials[thread_idx];
+            for (auto i = start; i < end; ++i) {
+                for (const auto &t : this->m_container._get_bucket_list(i)) {
+                    acc += f(t);
+                }
+            }
+        });
+        for (auto &acc : partials) {
+            retval += std::move(acc);
+        }
+        return retval;
+    }
+    /// Term-wise transformation.
+    /**
+     * This method will build a series with the same symbol set as \p this from the terms produced by
+     * <tt>f(t, out)</tt> for all the terms \p t in the series. \p f must append the terms it produces to \p out,
+     * an \p std::vector of terms. The produced terms are inserted into the return value, which is pre-sized
+     * with the number of buckets of \p this: terms with equal keys are accumulated, and ignorable terms are discarded.
+     *
+     * If the series is large enough, the terms will be produced by multiple threads from piranha::thread_pool, each
+     * processing a separate range of buckets, and they will then be merged in parallel into the return value.
+     * \p f must thus be safe to call concurrently on different terms.
+     *
+     * This method is meant to be used by derived classes to implement term-wise operations whose result has the same
+     * type as the calling series, such as differentiation.
+     *
+     * @param f the functor that will be applied to the terms.
+     *
+     * @return the series built from the terms produced by \p f.
+     *
+     * @throws std::invalid_argument if a term produced by \p f is not compatible with the symbol set of \p this.
+     * @throws unspecified any exception thrown by:
+     * - the call operator of \p f,
+     * - insert(),
+     * - memory allocation errors in standard containers,
+     * - threading primitives.
+     */
+    template <typename F>
+    Derived termwise_transform(const F &f) const
+    {
+        using b_size_type = typename container_type::size_type;
+        Derived retval;
+        retval.m_symbol_set = m_symbol_set;
+        retval.m_container.rehash(m_container.bucket_count());
+        const auto n_threads = termwise_n_threads();
+        if (n_threads == 1u) {
+            std::vector<term_type> out;
+            for (const auto &t : m_container) {
+                f(t, out);
+                for (auto &new_t : out) {
+                    retval.insert(std::move(new_t));
+                }
+                out.clear();
+            }
+            return retval;
+        }
+        term_lists lists(n_threads);
+        for_bucket_ranges(n_threads, [this, &f, &lists](const unsigned &thread_idx, const b_size_type &start,
+                                                         const b_size_type &end) {
+            auto &l = lists.m_lists[thread_idx];
+            for (auto i = start; i < end; ++i) {
+                for (const auto &t : this->m_container._get_bucket_list(i)) {
+                    f(t, l);
+                }
+            }
+        });
+        try {
+            retval.template parallel_merge<true, true>(lists, n_threads, false);
+        } catch (...) {
+            retval.m_container.clear();
+            throw;
+        }
+        return retval;
+    }
+    /// Grouped term-wise accumulation.
+    /**
+     * This method is a variant of termwise_accumulate() for operations in which many terms share an expensive
+     * factor. <tt>g(t)</tt> must return an \p std::pair whose first element is a grouping key, and whose second
+     * element is a term. The terms returned by \p g are first accumulated into one series per grouping key (with
+     * the same symbol set as \p this), then the return value is computed as the sum of the values of <tt>f(k, s)</tt>
+     * for each grouping key \p k and corresponding series \p s. The grouping key type must provide a <tt>hash()</tt>
+     * method and an equality operator (e.g., a key type).
+     *
+     * If the series is large enough, the grouping will be split among multiple threads from piranha::thread_pool.
+     * Groups with at least piranha::settings::get_min_work_per_thread() terms are evaluated serially in the calling
+     * thread, so that \p f can in turn use multiple threads (e.g., in a series multiplication), while the
+     * evaluation of the remaining groups is split among multiple threads if there are enough of them. \p g and
+     * \p f must thus be safe to call concurrently. As in termwise_accumulate(), the computation is parallelised only
+     * if both \p T and the calling series have an exact addition, so that the result does not depend on the number
+     * of threads.
+     *
+     * @param g the grouping functor.
+     * @param f the evaluation functor.
+     *
+     * @return the sum of the values returned by \p f.
+     *
+     * @throws unspecified any exception thrown by:
+     * - the call operators of \p g and \p f,
+     * - insert() and the in-place addition of series,
+     * - the construction of \p T from zero and the in-place addition of the values returned by \p f,
+     * - memory allocation errors in standard containers,
+     * - threading primitives.
+     */
+    template <typename T, typename G, typename F>
+    T termwise_grouped_accumulate(const G &g, const F &f) const
+    {
+        using b_size_type = typename container_type::size_type;
+        using g_key_type = uncvref_t<decltype(g(std::declval<const term_type &>()).first)>;
+        struct g_key_hasher {
+            std::size_t operator()(const g_key_type &k) const
+            {
+                return k.hash();
+            }
+        };
+        using g_map_type = std::unordered_map<g_key_type, Derived, g_key_hasher>;
+        // Add the term returned by g(t) to the group it belongs to.
+        auto group = [this, &g](g_map_type &m, const term_type &t) {
+            auto p = g(t);
+            auto it = m.find(p.first);
+            if (it == m.end()) {
+                Derived tmp;
+                tmp.m_symbol_set = this->m_symbol_set;
+                it = m.emplace(std::move(p.first), std::move(tmp)).first;
+            }
+            it->second.insert(std::move(p.second));
+        };
+        const auto n_threads
+            = conjunction<has_exact_addition<T>, has_exact_addition<Derived>>::value ? termwise_n_threads() : 1u;
+        g_map_type groups;
+        if (n_threads == 1u) {
+            for (const auto &t : m_container) {
+                group(groups, t);
+            }
+        } else {
+            std::vector<g_map_type> partials(static_cast<typename std::vector<g_map_type>::size_type>(n_threads));
+            for_bucket_ranges(n_threads, [this, &group, &partials](const unsigned &thread_idx, const b_size_type &start,
+                                                                    const b_size_type &end) {
+                auto &m = partials[thread_idx];
+                for (auto i = start; i < end; ++i) {
+                    for (const auto &t : this->m_container._get_bucket_list(i)) {
+                        group(m, t);
+                    }
+                }
+            });
+            for (auto &m : partials) {
+                for (auto &p : m) {
+                    auto it = groups.find(p.first);
+                    if (it == groups.end()) {
+                        groups.emplace(p.first, std::move(p.second));
+                    } else {
+                        it->second += std::move(p.second);
+                    }
+                }
+            }
+        }
+        // Evaluate the groups. The evaluation of f on a large group (e.g., a series multiplication) can be
+        // parallelised internally, which is not possible from a thread of the pool: the large groups are thus
+        // evaluated serially in the calling thread, and only the small groups are split among the threads of the
+        // pool, each thread processing a strided subset of them.
+        using g_vector_type = std::vector<typename g_map_type::value_type const *>;
+        const auto min_work = settings::get_min_work_per_thread();
+        T retval(0);
+        g_vector_type g_vector;
+        for (const auto &p : groups) {
+            if (static_cast<unsigned long long>(p.second.size()) >= min_work) {
+                retval += f(p.first, p.second);
+            } else {
+                g_vector.push_back(&p);
+            }
+        }
+        // Fan out only if each thread gets at least two small groups.
+        const auto n_g_threads = static_cast<unsigned>(
+            std::min(static_cast<typename g_vector_type::size_type>(n_threads), g_vector.size() / 2u));
+        if (n_g_threads <= 1u) {
+            for (const auto ptr : g_vector) {
+                retval += f(ptr->first, ptr->second);
+            }
+            return retval;
+        }
+        std::vector<T> partials;
+        partials.reserve(static_cast<typename std::vector<T>::size_type>(n_g_threads));
+        for (unsigned i = 0u; i < n_g_threads; ++i) {
+            partials.emplace_back(0);
+        }
+        auto eval = [&f, &g_vector, &partials, n_g_threads](const unsigned &thread_idx) {
+            auto &acc = partials[thread_idx];
+            for (auto i = static_cast<typename g_vector_type::size_type>(thread_idx); i < g_vector.size();
+                 i = static_cast<typename g_vector_type::size_type>(i + n_g_threads)) {
+                acc += f(g_vector[i]->first, g_vector[i]->second);
+            }
+        };
+        future_list<void> ft_list;
+        try {
+            for (unsigned i = 0u; i < n_g_threads; ++i) {
+                ft_list.push_back(thread_pool::enqueue(i, eval, i));
+            }
+            ft_list.wait_all();
+            ft_list.get_all();
+        } catch (...) {
+            ft_list.wait_all();
+            throw;
+        }
+        for (auto &acc : partials) {
+            retval += std::move(acc);
+        }
+        return retval;
+    }
     /// Symbol set.
     symbol_fset m_symbol_set;
     /// Terms container.
@@ -2837,16 +3495,11 @@ protected:
 private:
     // Custom derivatives machinery.
     static std::mutex s_cp_mutex;
-    // Pow cache machinery;
-    static std::mutex s_pow_mutex;
 };
 
 template <typename Cf, typename Key, typename Derived>
 std::mutex series<Cf, Key, Derived>::s_cp_mutex;
 
-template <typename Cf, typename Key, typename Derived>
-std::mutex series<Cf, Key, Derived>::s_pow_mutex;
-
 inline namespace impl
 {
 
@@ -3495,14 +4148,31 @@ public:
      * - arithmetic operations on the evaluation type.
      */
     eval_type operator()(const Series &s, const symbol_fmap<T> &dict) const
+    {
+        return evaluate_terms(s.get_symbol_set(), s._container(), dict);
+    }
+    /// Evaluate a range of terms.
+    /**
+     * This method will evaluate the terms in the range \p terms, whose keys are defined on the
+     * symbol set \p ss, according to the dictionary \p dict. The semantics are the same as the call operator.
+     * This method is used to evaluate term collections which are not stored in an instance of \p Series
+     * (e.g., piranha::frozen_series).
+     *
+     * @param ss the reference symbol set for the keys in \p terms.
+     * @param terms the range of terms to be evaluated.
+     * @param dict the dictionary that will be used for evaluation.
+     *
+     * @return the result of evaluating the terms in \p terms according to the evaluation dictionary \p dict.
+     *
+     * @throws unspecified any exception thrown by the call operator.
+     */
+    template <typename Range>
+    eval_type evaluate_terms(const symbol_fset &ss, const Range &terms, const symbol_fmap<T> &dict) const
     {
         // NOTE: possible improvement: if the evaluation type is less-than comparable,
         // build a vector of evaluated terms, sort it and accumulate (to minimise accuracy loss
         // with fp types and maybe improve performance - e.g., for integers).
 
-        // Cache a reference to the symbol set.
-        const auto &ss = s.get_symbol_set();
-
         // Init the vector that will be used for key evaluation. Make it possibly
         // thread local in order to avoid allocations each time we invoke this function.
         PIRANHA_MAYBE_TLS std::vector<T> evec;
@@ -3536,7 +4206,7 @@ public:
 
         // Init the return value and accumulate it.
         eval_type retval(0);
-        for (const auto &t : s._container()) {
+        for (const auto &t : terms) {
             multadd(retval, math::evaluate(t.m_cf, dict), t.m_key.evaluate(evec, ss));
         }
         return retval;
@@ -3754,6 +4424,78 @@ struct msgpack_convert_impl<Series, series_msgpack_convert_enabler<Series>> {
 inline namespace impl
 {
 
+template <typename Series>
+using flat_series_enabler
+    = enable_if_t<conjunction<is_series<Series>, std::is_arithmetic<typename Series::term_type::cf_type>,
+                              is_detected<flat_key_packed_t, typename Series::term_type::key_type>>::value>;
+}
+
+/// Specialisation of piranha::flat_save_impl for piranha::series.
+/**
+ * \note
+ * This specialisation is enabled only if \p Series satisfies piranha::is_series, its coefficient type is an arithmetic
+ * type, and its key type is either piranha::kronecker_monomial or piranha::real_trigonometric_kronecker_monomial.
+ */
+template <typename Series>
+struct flat_save_impl<Series, flat_series_enabler<Series>> {
+    /// Call operator.
+    /**
+     * This operator will write \p s into the file \p filename in the layout described in piranha::mapped_series.
+     *
+     * @param s the series to be saved.
+     * @param filename the name of the file.
+     *
+     * @throws std::runtime_error if the file cannot be opened or if an error occurs while writing into it.
+     * @throws std::overflow_error if the size of the file overflows 64-bit integers.
+     * @throws unspecified any exception thrown by:
+     * - memory errors in standard containers,
+     * - piranha::safe_cast().
+     */
+    void operator()(const Series &s, const std::string &filename) const
+    {
+        flat_save(s, filename);
+    }
+};
+
+/// Specialisation of piranha::flat_load_impl for piranha::series.
+/**
+ * \note
+ * This specialisation is enabled only if \p Series satisfies piranha::is_series, its coefficient type is an arithmetic
+ * type, and its key type is either piranha::kronecker_monomial or piranha::real_trigonometric_kronecker_monomial.
+ */
+template <typename Series>
+struct flat_load_impl<Series, flat_series_enabler<Series>> {
+    /// Call operator.
+    /**
+     * This operator will load the content of the file \p filename into \p s. The strong exception safety guarantee
+     * is provided.
+     *
+     * @param s the target series.
+     * @param filename the name of the file.
+     *
+     * @throws std::runtime_error if the file cannot be opened or mapped into memory.
+     * @throws std::invalid_argument if the file was not created from a series of type \p Series with the
+     * piranha::data_format::flat_binary format on a platform with the same byte order and integral type widths,
+     * if its content is not consistent with its size, or if it contains terms which are incompatible with its
+     * symbol set or duplicate terms.
+     * @throws unspecified any exception thrown by:
+     * - memory errors in standard containers,
+     * - the public interface of piranha::symbol_fset, piranha::series and piranha::hash_set,
+     * - the constructor of the term type,
+     * - piranha::safe_cast() and <tt>boost::numeric_cast()</tt>.
+     */
+    void operator()(Series &s, const std::string &filename) const
+    {
+        using term_type = typename Series::term_type;
+        const flat_file_view view(filename);
+        s = flat_thaw<Series>(
+            flat_parse<typename term_type::key_type, typename term_type::cf_type>(view, filename));
+    }
+};
+
+inline namespace impl
+{
+
 template <typename T>
 using series_zero_is_absorbing_enabler = enable_if_t<is_series<uncvref_t<T>>::value>;
 }
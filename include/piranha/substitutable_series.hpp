@@ -32,9 +32,13 @@ see https://www.gnu.org/licenses/. */
 #include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
+#include <piranha/config.hpp>
 #include <piranha/detail/init.hpp>
+#include <piranha/detail/multiplicative_subs.hpp>
 #include <piranha/forwarding.hpp>
+#include <piranha/integer.hpp>
 #include <piranha/math.hpp>
 #include <piranha/series.hpp>
 #include <piranha/symbol_utils.hpp>
@@ -162,6 +166,62 @@ class substitutable_series : public Series, detail::substitutable_series_tag
         = enable_if_t<conjunction<std::is_constructible<subs_type_<T>, const int &>, is_addable_in_place<subs_type_<T>>,
                                   is_returnable<subs_type_<T>>, has_sm_intersect_idx<T>>::value,
                       subs_type_<T>>;
+    // Batched substitution. If the substitution acts only on keys with multiplicative substitution, the terms
+    // are grouped according to the projections of their keys onto the substituted symbols. The value of the
+    // substitution (e.g., a product of powers of series) is then computed once per group, and multiplied by
+    // the sum of the terms of the group.
+    // The keys after the substitution are computed by substituting dummy unitary values, of type integer if possible.
+    template <typename T>
+    using subs_dummy_type =
+        typename std::conditional<key_has_subs<typename Series::term_type::key_type, integer>::value, integer, T>::type;
+    template <typename T>
+    using batched_subs
+        = conjunction<std::integral_constant<bool, subs_term_score<typename Series::term_type, T>::value == 2u>,
+                      key_has_multiplicative_subs<typename Series::term_type::key_type>,
+                      std::is_constructible<subs_dummy_type<T>, const int &>>;
+    template <typename T>
+    subs_type<T> subs_dispatch(const symbol_fmap<T> &dict, const symbol_idx_fmap<T> &idx, const std::false_type &) const
+    {
+        return this->template termwise_accumulate<subs_type<T>>(
+            [this, &dict, &idx](const typename Series::term_type &t) {
+                return subs_term_impl(t, dict, idx, this->m_symbol_set);
+            });
+    }
+    template <typename T>
+    subs_type<T> subs_dispatch(const symbol_fmap<T> &dict, const symbol_idx_fmap<T> &idx, const std::true_type &) const
+    {
+        using term_type = typename Series::term_type;
+        using key_type = typename term_type::key_type;
+        using m_size_type = std::vector<char>::size_type;
+        if (idx.empty()) {
+            // Nothing to substitute, no point in grouping.
+            return subs_dispatch(dict, idx, std::false_type{});
+        }
+        const auto &ss = this->m_symbol_set;
+        // The projection mask, the substitution map relative to the symbol set of the projections
+        // and the map of dummy values.
+        std::vector<char> mask(static_cast<m_size_type>(ss.size()), char(1));
+        symbol_idx_fmap<T> p_idx;
+        symbol_idx_fmap<subs_dummy_type<T>> d_idx;
+        symbol_idx i = 0;
+        for (const auto &p : idx) {
+            mask[static_cast<m_size_type>(p.first)] = char(0);
+            p_idx.emplace_hint(p_idx.end(), i++, p.second);
+            d_idx.emplace_hint(d_idx.end(), p.first, subs_dummy_type<T>(1));
+        }
+        const auto p_ss = ss_trim(ss, mask);
+        return this->template termwise_grouped_accumulate<subs_type<T>>(
+            [&ss, &mask, &d_idx](const term_type &t) {
+                auto ksubs = t.m_key.subs(d_idx, ss);
+                piranha_assert(ksubs.size() == 1u);
+                return std::make_pair(t.m_key.trim(mask, ss), term_type(t.m_cf, std::move(ksubs[0u].second)));
+            },
+            [&p_ss, &p_idx](const key_type &k, const Derived &s) {
+                auto ksubs = k.subs(p_idx, p_ss);
+                piranha_assert(ksubs.size() == 1u);
+                return s * std::move(ksubs[0u].first);
+            });
+    }
 
 public:
     /// Defaulted default constructor.
@@ -204,7 +264,14 @@ public:
      * ``T`` must be suitable for use in sm_intersect_idx().
      *
      * This method will return an object resulting from the substitution in \p this of the symbols in \p dict
-     * with the mapped values.
+     * with the mapped values. The terms of large series are processed in parallel via
+     * piranha::series::termwise_accumulate().
+     *
+     * If only the keys are involved in the substitution, and the key type is a monomial type, the terms are
+     * grouped according to the exponents of the substituted symbols via
+     * piranha::series::termwise_grouped_accumulate(): the value of the substitution is computed once per group
+     * (e.g., via piranha::series::pow() and its cache if the substituted values are series) and multiplied by the
+     * sum of the terms in the group.
      *
      * @param dict a dictionary mapping a set of symbols to the values that will be substituted for them.
      *
@@ -219,11 +286,7 @@ public:
     subs_type<T> subs(const symbol_fmap<T> &dict) const
     {
         const auto idx = sm_intersect_idx(this->m_symbol_set, dict);
-        subs_type<T> retval(0);
-        for (const auto &t : this->m_container) {
-            retval += subs_term_impl(t, dict, idx, this->m_symbol_set);
-        }
-        return retval;
+        return subs_dispatch(dict, idx, std::integral_constant<bool, batched_subs<T>::value>{});
     }
 };
 
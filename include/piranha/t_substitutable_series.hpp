@@ -201,6 +201,7 @@ public:
      * This method is available only if the requirements outlined in piranha::t_substitutable_series are satisfied.
      *
      * Trigonometric substitution is the substitution of the cosine and sine of \p name for \p c and \p s.
+     * The terms of large series are processed in parallel via piranha::series::termwise_accumulate().
      *
      * @param name name of the symbol that will be subject to substitution.
      * @param c cosine of \p name.
@@ -219,12 +220,11 @@ public:
     template <typename T, typename U>
     t_subs_type<T, U> t_subs(const std::string &name, const T &c, const U &s) const
     {
-        t_subs_type<T, U> retval(0);
         const auto idx = ss_index_of(this->m_symbol_set, name);
-        for (const auto &t : this->m_container) {
-            retval += t_subs_utils<T, U>::subs(t, name, idx, c, s, this->m_symbol_set);
-        }
-        return retval;
+        return this->template termwise_accumulate<t_subs_type<T, U>>(
+            [this, &name, idx, &c, &s](const typename Series::term_type &t) {
+                return t_subs_utils<T, U>::subs(t, name, idx, c, s, this->m_symbol_set);
+            });
     }
 };
 
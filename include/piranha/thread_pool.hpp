@@ -32,12 +32,15 @@ see https://www.gnu.org/licenses/. */
 #include <algorithm>
 #include <atomic>
 #include <boost/lexical_cast.hpp>
+#include <chrono>
 #include <condition_variable>
 #include <cstdlib>
+#include <deque>
 #include <functional>
 #include <future>
 #include <ios>
 #include <iostream>
+#include <iterator>
 #include <list>
 #include <memory>
 #include <mutex>
@@ -70,15 +73,150 @@ namespace piranha
 inline namespace impl
 {
 
+struct task_queue;
+
+// Pointer to the task queue owning the calling thread (null if the calling thread does not belong to a task queue).
+inline task_queue *&current_task_queue()
+{
+    static thread_local task_queue *ptr = nullptr;
+    return ptr;
+}
+
+// Shared state of a group of task queues supporting work stealing. The queues of a group
+// register themselves in m_queues on construction and unregister on destruction.
+// NOTE: when both are needed, the group mutex must be locked before the mutex of a queue.
+struct task_queue_group {
+    task_queue_group() : m_n_shared(0u), m_n_idle(0u) {}
+    std::mutex m_mutex;
+    std::vector<task_queue *> m_queues;
+    // Number of stealable tasks currently stored in the queues of the group.
+    std::atomic<unsigned long long> m_n_shared;
+    // Number of threads of the group currently waiting for tasks.
+    std::atomic<unsigned> m_n_idle;
+};
+
+// State of a task being executed by a thread of the pool, created when the task submits its first stealable subtask.
+// The subtasks keep the frame alive and notify it when they complete, so that the task can block until
+// its subtasks have been executed by other threads.
+struct task_frame {
+    task_frame() : m_pending(0u) {}
+    void complete()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            piranha_assert(m_pending);
+            --m_pending;
+        }
+        m_cond.notify_all();
+    }
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    // Number of subtasks which have not completed yet.
+    unsigned long long m_pending;
+};
+
+// Frame of the task being executed by the calling thread (null if the task has not submitted any stealable
+// subtask, or if the calling thread does not belong to a task queue).
+inline std::shared_ptr<task_frame> &current_task_frame()
+{
+    static thread_local std::shared_ptr<task_frame> ptr;
+    return ptr;
+}
+
+// RAII helper to give a fresh frame to a task being executed by the calling thread, restoring
+// the frame of the enclosing task (if any) at the end.
+struct task_frame_guard {
+    task_frame_guard() : m_old(std::move(current_task_frame()))
+    {
+        current_task_frame().reset();
+    }
+    ~task_frame_guard()
+    {
+        current_task_frame() = std::move(m_old);
+    }
+    task_frame_guard(const task_frame_guard &) = delete;
+    task_frame_guard &operator=(const task_frame_guard &) = delete;
+    std::shared_ptr<task_frame> m_old;
+};
+
+// A stealable task, together with the frame of the task which submitted it (null if the task was submitted
+// from outside the pool).
+struct shared_task {
+    std::function<void()> m_f;
+    const task_frame *m_parent;
+};
+
+// Placement of the threads of the pool when the NUMA placement policy is active. The processors of the system
+// are listed NUMA node by NUMA node, so that threads with consecutive indices are bound to processors belonging
+// to the same node. If the topology cannot be determined, all the processors are assigned to a single node.
+struct numa_placement_table {
+    numa_placement_table()
+    {
+        const auto topology = runtime_info::get_numa_topology();
+        if (topology.empty()) {
+            const unsigned hc = runtime_info::get_hardware_concurrency();
+            for (unsigned i = 0u; i < hc; ++i) {
+                m_procs.push_back(i);
+                m_nodes.push_back(0u);
+            }
+        } else {
+            for (decltype(topology.size()) i = 0u; i < topology.size(); ++i) {
+                for (const auto &p : topology[i]) {
+                    m_procs.push_back(p);
+                    m_nodes.push_back(static_cast<unsigned>(i));
+                }
+            }
+        }
+    }
+    // Processor to which the n-th thread is bound. If n is not smaller than the number of processors,
+    // n itself is returned (so that the binding will fail, as in the default policy).
+    unsigned proc(unsigned n) const
+    {
+        return (n < m_procs.size()) ? m_procs[n] : n;
+    }
+    // NUMA node of the n-th thread. Threads in excess of the number of processors are
+    // assigned to the nodes in a round-robin fashion.
+    unsigned node(unsigned n) const
+    {
+        return m_nodes.empty() ? 0u : m_nodes[n % m_nodes.size()];
+    }
+    std::vector<unsigned> m_procs;
+    std::vector<unsigned> m_nodes;
+};
+
+inline const numa_placement_table &get_numa_placement_table()
+{
+    static const numa_placement_table table;
+    return table;
+}
+
 // Task queue class. Inspired by:
 // https://github.com/progschj/ThreadPool
+// Each queue holds two containers of tasks: the pinned tasks, which are consumed only by the thread
+// of the queue, and the shared tasks, which can be stolen by the other threads of the group when they are idle.
+// A task being executed by the thread of the queue can wait on its own shared subtasks: the waiting thread executes
+// the subtasks which have not been stolen, and it blocks until the stolen ones are completed.
 struct task_queue {
-    task_queue(unsigned n, bool bind) : m_stop(false)
+    task_queue(unsigned n, bool bind, std::shared_ptr<task_queue_group> group = nullptr)
+        : task_queue(n, bind, n, std::move(group))
     {
-        auto runner = [this, n, bind]() {
+    }
+    // If bind is true, the thread of the queue will be bound to the processor with index proc.
+    task_queue(unsigned n, bool bind, unsigned proc, std::shared_ptr<task_queue_group> group)
+        : m_stop(false), m_sleeping(false), m_idx(n), m_group(std::move(group))
+    {
+        if (m_group) {
+            std::lock_guard<std::mutex> glock(m_group->m_mutex);
+            if (m_group->m_queues.size() <= n) {
+                m_group->m_queues.resize(static_cast<decltype(m_group->m_queues.size())>(n + 1u), nullptr);
+            }
+            m_group->m_queues[n] = this;
+        }
+        auto runner = [this, bind, proc]() {
+            current_task_queue() = this;
             if (bind) {
                 try {
-                    bind_to_proc(n);
+                    bind_to_proc(proc);
                 } catch (...) {
                     // Don't stop if we cannot bind.
                     // NOTE: logging candidate.
@@ -86,22 +224,50 @@ struct task_queue {
             }
             try {
                 while (true) {
-                    std::unique_lock<std::mutex> lock(this->m_mutex);
-                    while (!this->m_stop && this->m_tasks.empty()) {
-                        // Need to wait for something to happen only if the task
-                        // list is empty and we are not stopping.
-                        // NOTE: wait will be noexcept in C++14.
-                        this->m_cond.wait(lock);
+                    std::function<void()> task;
+                    {
+                        std::unique_lock<std::mutex> lock(this->m_mutex);
+                        while (true) {
+                            if (this->pop_local(task)) {
+                                break;
+                            }
+                            if (this->m_stop) {
+                                // If the stop flag was set, and we do not have more tasks,
+                                // just exit.
+                                break;
+                            }
+                            if (this->m_group) {
+                                // Try to steal a task from the other queues of the group.
+                                lock.unlock();
+                                const bool stolen = this->steal(task);
+                                lock.lock();
+                                if (stolen) {
+                                    break;
+                                }
+                                // NOTE: if a shared task was submitted after our stealing attempt, try again
+                                // instead of waiting. See the comments in wake_thief().
+                                if (this->m_group->m_n_shared.load()) {
+                                    continue;
+                                }
+                            }
+                            // Need to wait for something to happen only if there are no tasks
+                            // to consume and we are not stopping.
+                            // NOTE: wait will be noexcept in C++14.
+                            this->m_sleeping = true;
+                            if (this->m_group) {
+                                ++this->m_group->m_n_idle;
+                            }
+                            this->m_cond.wait(lock);
+                            if (this->m_group) {
+                                --this->m_group->m_n_idle;
+                            }
+                            this->m_sleeping = false;
+                        }
                     }
-                    if (this->m_stop && this->m_tasks.empty()) {
-                        // If the stop flag was set, and we do not have more tasks,
-                        // just exit.
+                    if (!task) {
                         break;
                     }
-                    // NOTE: move constructor of std::function could throw, unfortunately.
-                    std::function<void()> task(std::move(this->m_tasks.front()));
-                    this->m_tasks.pop();
-                    lock.unlock();
+                    task_frame_guard tfg;
                     task();
                 }
             } catch (...) {
@@ -128,10 +294,130 @@ struct task_queue {
         // log it and abort as there is not much we can do).
         try {
             stop();
+            // Unregister from the group. After this, no other thread can access this queue.
+            if (m_group) {
+                std::lock_guard<std::mutex> glock(m_group->m_mutex);
+                m_group->m_queues[m_idx] = nullptr;
+            }
         } catch (...) {
             std::abort();
         }
     }
+    // Pop a task from the local containers. Must be called with m_mutex locked.
+    bool pop_local(std::function<void()> &task)
+    {
+        if (!m_tasks.empty()) {
+            // NOTE: move constructor of std::function could throw, unfortunately.
+            task = std::move(m_tasks.front());
+            m_tasks.pop();
+            return true;
+        }
+        if (!m_shared.empty()) {
+            // NOTE: the owner consumes the most recent shared task (better locality for nested
+            // parallelism), thieves consume the oldest.
+            task = std::move(m_shared.back().m_f);
+            m_shared.pop_back();
+            --m_group->m_n_shared;
+            return true;
+        }
+        return false;
+    }
+    // Steal a shared task from another queue of the group. Must be called with m_mutex unlocked.
+    bool steal(std::function<void()> &task)
+    {
+        piranha_assert(m_group);
+        std::lock_guard<std::mutex> glock(m_group->m_mutex);
+        const auto size = m_group->m_queues.size();
+        for (decltype(m_group->m_queues.size()) i = 1u; i < size; ++i) {
+            auto q = m_group->m_queues[(m_idx + i) % size];
+            if (!q) {
+                continue;
+            }
+            std::lock_guard<std::mutex> lock(q->m_mutex);
+            if (!q->m_shared.empty()) {
+                task = std::move(q->m_shared.front().m_f);
+                q->m_shared.pop_front();
+                --m_group->m_n_shared;
+                return true;
+            }
+        }
+        return false;
+    }
+    // Wake up a sleeping thread of the group, so that it can steal a newly-submitted shared task.
+    // NOTE: the counter of shared tasks is increased before calling this function. A thread going to sleep checks
+    // the counter and sets m_sleeping in the same critical section, so either it sees the new task, or
+    // it is seen as sleeping here.
+    void wake_thief()
+    {
+        std::lock_guard<std::mutex> glock(m_group->m_mutex);
+        for (auto q : m_group->m_queues) {
+            if (!q || q == this) {
+                continue;
+            }
+            std::lock_guard<std::mutex> lock(q->m_mutex);
+            if (q->m_sleeping) {
+                q->m_cond.notify_one();
+                return;
+            }
+        }
+    }
+    // Execute in the calling thread, which must be the thread of this queue, a subtask of the task currently
+    // being executed which has not been stolen yet. Returns false if no such subtask is available.
+    // NOTE: other tasks are never executed here: they could be unrelated to the waiting task and block
+    // on it, and executing them would let the stack of the waiting thread grow without bounds.
+    bool help()
+    {
+        const auto frame = current_task_frame().get();
+        if (!frame) {
+            return false;
+        }
+        std::function<void()> task;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            // NOTE: search from the most recent task, as the subtasks of the current task were submitted after
+            // the tasks of the enclosing frames.
+            const auto it = std::find_if(m_shared.rbegin(), m_shared.rend(),
+                                         [frame](const shared_task &t) { return t.m_parent == frame; });
+            if (it == m_shared.rend()) {
+                return false;
+            }
+            task = std::move(it->m_f);
+            m_shared.erase(std::next(it).base());
+            --m_group->m_n_shared;
+        }
+        task_frame_guard tfg;
+        task();
+        return true;
+    }
+    // Wait on fut from the thread of this queue. The subtasks of the current task are executed while waiting, and
+    // the thread blocks on the frame of the current task while its stolen subtasks are being executed elsewhere.
+    template <typename Future>
+    void wait(const Future &fut)
+    {
+        while (fut.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            if (help()) {
+                continue;
+            }
+            const auto frame = current_task_frame().get();
+            if (!frame) {
+                // The current task has no subtasks, fut must refer to some other task.
+                fut.wait();
+                return;
+            }
+            std::unique_lock<std::mutex> lock(frame->m_mutex);
+            if (!frame->m_pending) {
+                lock.unlock();
+                fut.wait();
+                return;
+            }
+            // NOTE: a subtask sets its future before notifying the frame under the lock of the frame,
+            // so either we see here the future as ready, or we will be woken up.
+            if (fut.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+                return;
+            }
+            frame->m_cond.wait(lock);
+        }
+    }
     // Small utility to remove reference_wrapper.
     template <typename T>
     struct unwrap_ref {
@@ -165,9 +451,10 @@ struct task_queue {
                                             std::is_move_constructible<uncvref_t<Args>>>>...,
                     is_returnable<f_ret_type<F, Args...>>>::value,
         int>;
-    // Main enqueue function.
+    // Main enqueue function. If shared is true and the queue belongs to a group, the task can be
+    // stolen by the other queues of the group.
     template <typename F, typename... Args, enabler<F &&, Args &&...> = 0>
-    std::future<f_ret_type<F &&, Args &&...>> enqueue(F &&f, Args &&... args)
+    std::future<f_ret_type<F &&, Args &&...>> enqueue_impl(bool shared, F &&f, Args &&... args)
     {
         using ret_type = f_ret_type<F &&, Args &&...>;
         using p_task_type = std::packaged_task<ret_type()>;
@@ -177,18 +464,58 @@ struct task_queue {
         // - std::function (in m_tasks) gives the uniform type interface via type erasure.
         auto task = std::make_shared<p_task_type>(std::bind(std::forward<F>(f), std::forward<Args>(args)...));
         std::future<ret_type> res = task->get_future();
+        shared = shared && m_group;
+        // A shared task submitted from the thread of this queue is a subtask of the task being executed.
+        std::shared_ptr<task_frame> frame;
+        if (shared && current_task_queue() == this) {
+            auto &cur_frame = current_task_frame();
+            if (!cur_frame) {
+                cur_frame = std::make_shared<task_frame>();
+            }
+            frame = cur_frame;
+        }
         {
             std::unique_lock<std::mutex> lock(m_mutex);
-            if (unlikely(m_stop)) {
-                // Enqueueing is not allowed if the queue is stopped.
+            if (unlikely(m_stop && current_task_queue() != this)) {
+                // Enqueueing is not allowed if the queue is stopped, unless the task is being enqueued
+                // from the queue's own thread (which consumes all the pending tasks before exiting).
                 piranha_throw(std::runtime_error, "cannot enqueue task while the task queue is stopping");
             }
-            m_tasks.push([task]() { (*task)(); });
+            if (frame) {
+                m_shared.push_back(shared_task{[task, frame]() {
+                                                   (*task)();
+                                                   frame->complete();
+                                               },
+                                               frame.get()});
+                {
+                    std::lock_guard<std::mutex> flock(frame->m_mutex);
+                    ++frame->m_pending;
+                }
+                ++m_group->m_n_shared;
+            } else if (shared) {
+                m_shared.push_back(shared_task{[task]() { (*task)(); }, nullptr});
+                ++m_group->m_n_shared;
+            } else {
+                m_tasks.push([task]() { (*task)(); });
+            }
         }
         // NOTE: notify_one is noexcept.
         m_cond.notify_one();
+        if (shared) {
+            wake_thief();
+        }
         return res;
     }
+    template <typename F, typename... Args, enabler<F &&, Args &&...> = 0>
+    std::future<f_ret_type<F &&, Args &&...>> enqueue(F &&f, Args &&... args)
+    {
+        return enqueue_impl(false, std::forward<F>(f), std::forward<Args>(args)...);
+    }
+    template <typename F, typename... Args, enabler<F &&, Args &&...> = 0>
+    std::future<f_ret_type<F &&, Args &&...>> submit(F &&f, Args &&... args)
+    {
+        return enqueue_impl(true, std::forward<F>(f), std::forward<Args>(args)...);
+    }
     // NOTE: we call this only from dtor, it is here in order to be able to test it.
     // So the exception handling in dtor will suffice, keep it in mind if things change.
     void stop()
@@ -208,9 +535,13 @@ struct task_queue {
     }
     // Data members.
     bool m_stop;
+    bool m_sleeping;
+    const unsigned m_idx;
+    std::shared_ptr<task_queue_group> m_group;
     std::condition_variable m_cond;
     std::mutex m_mutex;
     std::queue<std::function<void()>> m_tasks;
+    std::deque<shared_task> m_shared;
     std::thread m_thread;
 };
 
@@ -220,12 +551,13 @@ using thread_queues_t = std::pair<std::vector<std::unique_ptr<task_queue>>, std:
 inline thread_queues_t get_initial_thread_queues()
 {
     thread_queues_t retval;
-    // Create the vector of queues.
+    // Create the vector of queues, all belonging to the same work-stealing group.
     const unsigned candidate = runtime_info::get_hardware_concurrency(), hc = (candidate > 0u) ? candidate : 1u;
     retval.first.reserve(static_cast<decltype(retval.first.size())>(hc));
+    auto group = std::make_shared<task_queue_group>();
     for (unsigned i = 0u; i < hc; ++i) {
         // NOTE: thread binding is disabled on startup.
-        retval.first.emplace_back(::new task_queue(i, false));
+        retval.first.emplace_back(::new task_queue(i, false, group));
     }
     // Generate the set of thread IDs.
     for (const auto &ptr : retval.first) {
@@ -245,7 +577,10 @@ template <typename = void>
 struct thread_pool_base {
     static thread_queues_t s_queues;
     static bool s_bind;
+    static bool s_numa;
     static std::atomic_flag s_atf;
+    // Counter for the round-robin distribution of the tasks submitted from outside the pool.
+    static unsigned s_next;
 };
 
 template <typename T>
@@ -257,6 +592,12 @@ std::atomic_flag thread_pool_base<T>::s_atf = ATOMIC_FLAG_INIT;
 template <typename T>
 bool thread_pool_base<T>::s_bind = false;
 
+template <typename T>
+bool thread_pool_base<T>::s_numa = false;
+
+template <typename T>
+unsigned thread_pool_base<T>::s_next = 0u;
+
 template <typename>
 void thread_pool_shutdown();
 }
@@ -307,6 +648,11 @@ public:
      * execution queue consumed by the thread to which the task is assigned. The return value is an \p std::future
      * which can be used to retrieve the return value of (or the exception thrown by) the callable.
      *
+     * If the calling thread belongs to the pool, the task is not pinned to the <tt>n</tt>-th thread: it is instead
+     * added as a subtask of the calling task, exactly as in submit(). This allows the parallel algorithms to be
+     * nested (see use_threads()), as waiting from within the pool on a task pinned to another (possibly busy) thread
+     * could lead to deadlocks.
+     *
      * @param n index of the thread that will consume the task.
      * @param f callable object representing the task.
      * @param args arguments to \p f.
@@ -330,9 +676,57 @@ public:
                                                      + " is out of range, the thread pool contains only "
                                                      + std::to_string(s_queues.first.size()) + " threads");
         }
+        auto cur = current_task_queue();
+        if (cur && cur->m_group) {
+            return cur->submit(std::forward<F>(f), std::forward<Args>(args)...);
+        }
         return base::s_queues.first[static_cast<decltype(base::s_queues.first.size())>(n)]->enqueue(
             std::forward<F>(f), std::forward<Args>(args)...);
     }
+    /// Submit task.
+    /**
+     * \note
+     * This method is enabled only if the same requirements of enqueue() are satisfied.
+     *
+     * This method will add a task to the pool without pinning it to a specific thread. If the calling thread belongs
+     * to the pool, the task is added to the queue of the calling thread, otherwise the tasks submitted via this
+     * method are distributed among the threads in the pool in a round-robin fashion. In both cases, the task
+     * can be stolen and executed by any idle thread in the pool, so that uneven workloads are automatically
+     * balanced among the threads.
+     *
+     * A task submitted from within a task running in the pool is a subtask of the latter. Waiting on the futures
+     * of the subtasks via piranha::future_list will not deadlock: the waiting thread executes the subtasks which
+     * have not been stolen by other threads, and it blocks until the stolen subtasks are completed. Hence, tasks
+     * submitted via this method can themselves submit and wait on subtasks. Note that a waiting thread never
+     * executes tasks other than the subtasks of the task it is running.
+     *
+     * @param f callable object representing the task.
+     * @param args arguments to \p f.
+     *
+     * @return an \p std::future that will store the result of <tt>f(args...)</tt>.
+     *
+     * @throws std::runtime_error if a task is being submitted while the task queue is stopping (e.g., during
+     * program shutdown).
+     * @throws unspecified any exception thrown by:
+     * - \p std::bind() or the constructor of \p std::packaged_task or \p std::function,
+     * - threading primitives,
+     * - memory allocation errors.
+     */
+    template <typename F, typename... Args>
+    static enqueue_t<F &&, Args &&...> submit(F &&f, Args &&... args)
+    {
+        // NOTE: if the calling thread belongs to the pool, its queue is alive at least until
+        // the current task completes.
+        auto cur = current_task_queue();
+        if (cur) {
+            return cur->submit(std::forward<F>(f), std::forward<Args>(args)...);
+        }
+        detail::atomic_lock_guard lock(s_atf);
+        const auto size = base::s_queues.first.size();
+        piranha_assert(size);
+        const auto n = static_cast<decltype(base::s_queues.first.size())>(base::s_next++ % size);
+        return base::s_queues.first[n]->submit(std::forward<F>(f), std::forward<Args>(args)...);
+    }
     /// Size
     /**
      * @return the number of threads in the pool.
@@ -344,14 +738,17 @@ public:
     }
 
 private:
-    // Helper function to create 'new_size' new queues with thread binding set to 'bind'.
-    static thread_queues_t create_new_queues(unsigned new_size, bool bind)
+    // Helper function to create 'new_size' new queues with thread binding set to 'bind' and
+    // NUMA placement set to 'numa'.
+    static thread_queues_t create_new_queues(unsigned new_size, bool bind, bool numa)
     {
         thread_queues_t new_queues;
         // Create the task queues.
         new_queues.first.reserve(static_cast<decltype(new_queues.first.size())>(new_size));
+        auto group = std::make_shared<task_queue_group>();
         for (auto i = 0u; i < new_size; ++i) {
-            new_queues.first.emplace_back(::new task_queue(i, bind));
+            new_queues.first.emplace_back(
+                ::new task_queue(i, bind, (bind && numa) ? get_numa_placement_table().proc(i) : i, group));
         }
         // Fill in the thread ids set.
         for (const auto &ptr : new_queues.first) {
@@ -388,9 +785,9 @@ public:
         if (unlikely(new_size == 0u)) {
             piranha_throw(std::invalid_argument, "cannot resize the thread pool to zero");
         }
-        // NOTE: need to lock here as we are reading the s_bind member.
+        // NOTE: need to lock here as we are reading the s_bind and s_numa members.
         detail::atomic_lock_guard lock(s_atf);
-        auto new_queues = create_new_queues(new_size, base::s_bind);
+        auto new_queues = create_new_queues(new_size, base::s_bind, base::s_numa);
         // NOTE: here the allocator is not swapped, as std::allocator won't propagate on swap.
         // Besides, all instances of std::allocator are equal, so the operation is well-defined.
         // http://en.cppreference.com/w/cpp/container/vector/swap
@@ -423,7 +820,7 @@ public:
             // Don't do anything if we are not changing the binding policy.
             return;
         }
-        auto new_queues = create_new_queues(static_cast<unsigned>(base::s_queues.first.size()), flag);
+        auto new_queues = create_new_queues(static_cast<unsigned>(base::s_queues.first.size()), flag, base::s_numa);
         new_queues.swap(base::s_queues);
         base::s_bind = flag;
     }
@@ -439,6 +836,69 @@ public:
         detail::atomic_lock_guard lock(s_atf);
         return base::s_bind;
     }
+    /// Set the NUMA placement policy.
+    /**
+     * If \p flag is \p true, the threads in the pool will be bound to the processors of the system NUMA node by NUMA
+     * node, as detected by piranha::runtime_info::get_numa_topology(): the threads with the lowest indices are bound
+     * to the processors of the first node, the following threads to the processors of the second node, and so on.
+     * Threads with neighbouring indices will thus share the same node, and the parallel algorithms that partition
+     * their data among the threads by index will place contiguous memory regions on the same node. If \p flag is
+     * \p false, the <tt>i</tt>-th thread is bound to the <tt>i</tt>-th processor.
+     *
+     * The NUMA placement policy has an effect only if thread binding is active (see set_binding()). The
+     * NUMA placement policy is disabled by default.
+     *
+     * @param flag the desired NUMA placement policy.
+     *
+     * @throws unspecified any exception thrown by:
+     * - threading primitives,
+     * - memory allocation errors.
+     */
+    static void set_numa_placement(bool flag)
+    {
+        detail::atomic_lock_guard lock(s_atf);
+        if (flag == base::s_numa) {
+            return;
+        }
+        if (base::s_bind) {
+            // The threads need to be re-bound only if binding is active.
+            auto new_queues = create_new_queues(static_cast<unsigned>(base::s_queues.first.size()), true, flag);
+            new_queues.swap(base::s_queues);
+        }
+        base::s_numa = flag;
+    }
+    /// Get the NUMA placement policy.
+    /**
+     * @return the flag set by set_numa_placement().
+     */
+    static bool get_numa_placement()
+    {
+        detail::atomic_lock_guard lock(s_atf);
+        return base::s_numa;
+    }
+    /// NUMA node of a thread.
+    /**
+     * If both thread binding and the NUMA placement policy are active, this method will return the index of the
+     * NUMA node to which the <tt>n</tt>-th thread in the pool is bound (that is, the index of the node in the vector
+     * returned by piranha::runtime_info::get_numa_topology()). Otherwise, zero will be returned.
+     *
+     * @param n the index of the thread.
+     *
+     * @return the NUMA node of the <tt>n</tt>-th thread in the pool.
+     *
+     * @throws std::invalid_argument if the thread index is equal to or larger than the current pool size.
+     * @throws unspecified any exception thrown by memory allocation errors.
+     */
+    static unsigned get_numa_node(unsigned n)
+    {
+        detail::atomic_lock_guard lock(s_atf);
+        if (unlikely(n >= s_queues.first.size())) {
+            piranha_throw(std::invalid_argument, "the thread index " + std::to_string(n)
+                                                     + " is out of range, the thread pool contains only "
+                                                     + std::to_string(s_queues.first.size()) + " threads");
+        }
+        return (base::s_bind && base::s_numa) ? get_numa_placement_table().node(n) : 0u;
+    }
     /// Compute number of threads to use.
     /**
      * \note
@@ -447,9 +907,11 @@ public:
      * This function computes the suggested number of threads to use, given an amount of total \p work_size units of
      * work and a minimum amount of work units per thread \p min_work_per_thread.
      *
-     * The returned value will always be 1 if the calling thread belongs to the thread pool; otherwise, a number of
-     * threads such that each thread has at least \p min_work_per_thread units of work to consume will be returned.
-     * In any case, the return value is always greater than zero.
+     * A number of threads such that each thread has at least \p min_work_per_thread units of work to consume will be
+     * returned. If the calling thread belongs to the thread pool, the work will be executed by subtasks of the calling
+     * task (see enqueue() and submit()), which can be stolen only by the threads of the pool that are idle: in this
+     * case the returned value will not exceed one plus the number of currently idle threads. In any case, the return
+     * value is always greater than zero.
      *
      * @param work_size total number of work units.
      * @param min_work_per_thread minimum number of work units to be consumed by a thread in the pool.
@@ -473,12 +935,15 @@ public:
                                                      + " for minimum work per thread (it must be strictly positive)");
         }
         detail::atomic_lock_guard lock(s_atf);
-        // Don't use threads if the calling thread belongs to the pool.
+        auto n_threads = static_cast<unsigned>(base::s_queues.first.size());
+        piranha_assert(n_threads);
+        // If the calling thread belongs to the pool, use only the threads which are idle (plus the calling one).
         if (base::s_queues.second.find(std::this_thread::get_id()) != base::s_queues.second.end()) {
-            return 1u;
+            const auto cur = current_task_queue();
+            piranha_assert(cur && cur->m_group);
+            const unsigned n_idle = cur->m_group->m_n_idle.load();
+            n_threads = (n_idle < n_threads) ? static_cast<unsigned>(n_idle + 1u) : n_threads;
         }
-        const auto n_threads = static_cast<unsigned>(base::s_queues.first.size());
-        piranha_assert(n_threads);
         if (work_size / n_threads >= min_work_per_thread) {
             // Enough work per thread, use them all.
             return n_threads;
@@ -515,12 +980,19 @@ inline void thread_pool_shutdown()
 template <typename T>
 class future_list
 {
-    // Wait on a valid future, or abort.
+    // Wait on a valid future, or abort. If the calling thread belongs to the thread pool,
+    // it will execute the pending subtasks of its current task while waiting, so that tasks waiting on
+    // subtasks cannot deadlock.
     static void wait_or_abort(const std::future<T> &fut)
     {
         piranha_assert(fut.valid());
         try {
-            fut.wait();
+            auto cur = current_task_queue();
+            if (cur) {
+                cur->wait(fut);
+            } else {
+                fut.wait();
+            }
         } catch (...) {
             // NOTE: logging candidate, with info from exception.
             std::abort();
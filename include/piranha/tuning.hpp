@@ -48,6 +48,13 @@ struct base_tuning {
     static std::atomic<bool> s_parallel_memory_set;
     static std::atomic<unsigned long> s_mult_block_size;
     static std::atomic<unsigned long> s_estimate_threshold;
+    static std::atomic<bool> s_dense_multiplication;
+    static std::atomic<unsigned long> s_heap_mult_threshold;
+    static std::atomic<bool> s_oa_multiplication;
+    static std::atomic<bool> s_sketch_estimation;
+    static std::atomic<bool> s_estimate_cache;
+    static std::atomic<bool> s_node_arena;
+    static std::atomic<unsigned long> s_pow_cache_max_memory;
 };
 
 template <typename T>
@@ -58,6 +65,27 @@ std::atomic<unsigned long> base_tuning<T>::s_mult_block_size(256u);
 
 template <typename T>
 std::atomic<unsigned long> base_tuning<T>::s_estimate_threshold(200u);
+
+template <typename T>
+std::atomic<bool> base_tuning<T>::s_dense_multiplication(true);
+
+template <typename T>
+std::atomic<unsigned long> base_tuning<T>::s_heap_mult_threshold(16777216ul);
+
+template <typename T>
+std::atomic<bool> base_tuning<T>::s_oa_multiplication(false);
+
+template <typename T>
+std::atomic<bool> base_tuning<T>::s_sketch_estimation(false);
+
+template <typename T>
+std::atomic<bool> base_tuning<T>::s_estimate_cache(false);
+
+template <typename T>
+std::atomic<bool> base_tuning<T>::s_node_arena(false);
+
+template <typename T>
+std::atomic<unsigned long> base_tuning<T>::s_pow_cache_max_memory(1073741824ul);
 }
 
 /// Performance tuning.
@@ -181,6 +209,265 @@ public:
     {
         s_estimate_threshold.store(200u);
     }
+    /// Get the \p dense_multiplication flag.
+    /**
+     * When the exponents of the product of two series are packed in a range which is not much larger than
+     * the estimated number of terms in the result, some multiplication algorithms (e.g., the Kronecker multiplication
+     * of polynomials) can accumulate the result in a dense array of coefficients instead of a hash table.
+     * This flag controls whether the dense accumulation strategy is allowed or not.
+     *
+     * The default value of this flag is \p true (i.e., Piranha will use dense accumulation when it
+     * deems it profitable).
+     *
+     * @return current value of the \p dense_multiplication flag.
+     */
+    static bool get_dense_multiplication()
+    {
+        return s_dense_multiplication.load();
+    }
+    /// Set the \p dense_multiplication flag.
+    /**
+     * @see piranha::tuning::get_dense_multiplication() for an explanation of the meaning of this flag.
+     *
+     * @param flag desired value for the \p dense_multiplication flag.
+     */
+    static void set_dense_multiplication(bool flag)
+    {
+        s_dense_multiplication.store(flag);
+    }
+    /// Reset the \p dense_multiplication flag.
+    /**
+     * This method will reset the \p dense_multiplication flag to its default value.
+     *
+     * @see piranha::tuning::get_dense_multiplication() for an explanation of the meaning of this flag.
+     */
+    static void reset_dense_multiplication()
+    {
+        s_dense_multiplication.store(true);
+    }
+    /// Get the heap multiplication threshold.
+    /**
+     * When the product of two series is very sparse (i.e., the number of terms in the result is close to the
+     * number of term-by-term multiplications), some multiplication algorithms (e.g., the single-threaded
+     * Kronecker multiplication of polynomials) can merge the rows of the multiplication table via a heap.
+     * The terms of the result are then produced in order, and there is no need to allocate
+     * a hash table sized according to the estimated number of terms in the result. This is profitable
+     * for large products, whose hash tables do not fit in the cache.
+     * This value establishes the estimated number of terms in the result above which the heap
+     * multiplication will be employed for very sparse products. A value of zero will select
+     * the heap multiplication for all very sparse products.
+     *
+     * The precise way in which this value is used depends on the multiplication algorithm.
+     * The default value of this flag is 16777216 (i.e., 2**24).
+     *
+     * @return the heap multiplication threshold.
+     */
+    static unsigned long get_heap_multiplication_threshold()
+    {
+        return s_heap_mult_threshold.load();
+    }
+    /// Set the heap multiplication threshold.
+    /**
+     * @see piranha::tuning::get_heap_multiplication_threshold() for an explanation of the meaning of this value.
+     *
+     * @param size desired value for the heap multiplication threshold.
+     */
+    static void set_heap_multiplication_threshold(unsigned long size)
+    {
+        s_heap_mult_threshold.store(size);
+    }
+    /// Reset the heap multiplication threshold.
+    /**
+     * This method will reset the heap multiplication threshold to its default value.
+     *
+     * @see piranha::tuning::get_heap_multiplication_threshold() for an explanation of the meaning of this value.
+     */
+    static void reset_heap_multiplication_threshold()
+    {
+        s_heap_mult_threshold.store(16777216ul);
+    }
+    /// Get the \p open_addressing_multiplication flag.
+    /**
+     * Some single-threaded multiplication algorithms (e.g., the sparse Kronecker multiplication of polynomials)
+     * can accumulate the terms of the result in a piranha::oa_hash_set, an open-addressing hash table,
+     * instead of a piranha::hash_set. The terms are then transferred into the return value at the end of the
+     * multiplication. This flag controls whether the open-addressing accumulation is used or not.
+     *
+     * The default value of this flag is \p false.
+     *
+     * @return current value of the \p open_addressing_multiplication flag.
+     */
+    static bool get_open_addressing_multiplication()
+    {
+        return s_oa_multiplication.load();
+    }
+    /// Set the \p open_addressing_multiplication flag.
+    /**
+     * @see piranha::tuning::get_open_addressing_multiplication() for an explanation of the meaning of this flag.
+     *
+     * @param flag desired value for the \p open_addressing_multiplication flag.
+     */
+    static void set_open_addressing_multiplication(bool flag)
+    {
+        s_oa_multiplication.store(flag);
+    }
+    /// Reset the \p open_addressing_multiplication flag.
+    /**
+     * This method will reset the \p open_addressing_multiplication flag to its default value.
+     *
+     * @see piranha::tuning::get_open_addressing_multiplication() for an explanation of the meaning of this flag.
+     */
+    static void reset_open_addressing_multiplication()
+    {
+        s_oa_multiplication.store(false);
+    }
+    /// Get the \p sketch_estimation flag.
+    /**
+     * Before multiplying two series, the size of the result is estimated in order to size the output hash table.
+     * By default, the estimation is performed by running a few randomised partial multiplications. For
+     * some series types (e.g., polynomials with Kronecker monomials), the estimation can instead be computed
+     * from a sketch of the distinct keys of the result, which is built by combining the keys of a random sample
+     * of the terms of one operand with the keys of the other operand, without performing any arithmetic on the
+     * coefficients. This flag controls whether the sketch-based
+     * estimation is used or not, where available.
+     *
+     * The default value of this flag is \p false.
+     *
+     * @return current value of the \p sketch_estimation flag.
+     */
+    static bool get_sketch_estimation()
+    {
+        return s_sketch_estimation.load();
+    }
+    /// Set the \p sketch_estimation flag.
+    /**
+     * @see piranha::tuning::get_sketch_estimation() for an explanation of the meaning of this flag.
+     *
+     * @param flag desired value for the \p sketch_estimation flag.
+     */
+    static void set_sketch_estimation(bool flag)
+    {
+        s_sketch_estimation.store(flag);
+    }
+    /// Reset the \p sketch_estimation flag.
+    /**
+     * This method will reset the \p sketch_estimation flag to its default value.
+     *
+     * @see piranha::tuning::get_sketch_estimation() for an explanation of the meaning of this flag.
+     */
+    static void reset_sketch_estimation()
+    {
+        s_sketch_estimation.store(false);
+    }
+    /// Get the \p estimate_cache flag.
+    /**
+     * The estimates of the sizes of the results of series multiplications (see
+     * piranha::tuning::get_sketch_estimation()) can be stored in a cache, so that repeated multiplications of the
+     * same operands do not need to run the estimation again. The multiplications are identified by a signature
+     * consisting of the sizes of the operands, of the names of their symbols, of a fingerprint of their keys
+     * (the coefficients are not considered) and of the estimation method in use (which depends, e.g., on the
+     * \p sketch_estimation flag). This flag controls whether the cache is used or not.
+     *
+     * The default value of this flag is \p false.
+     *
+     * @return current value of the \p estimate_cache flag.
+     */
+    static bool get_estimate_cache()
+    {
+        return s_estimate_cache.load();
+    }
+    /// Set the \p estimate_cache flag.
+    /**
+     * @see piranha::tuning::get_estimate_cache() for an explanation of the meaning of this flag.
+     *
+     * @param flag desired value for the \p estimate_cache flag.
+     */
+    static void set_estimate_cache(bool flag)
+    {
+        s_estimate_cache.store(flag);
+    }
+    /// Reset the \p estimate_cache flag.
+    /**
+     * This method will reset the \p estimate_cache flag to its default value.
+     *
+     * @see piranha::tuning::get_estimate_cache() for an explanation of the meaning of this flag.
+     */
+    static void reset_estimate_cache()
+    {
+        s_estimate_cache.store(false);
+    }
+    /// Get the \p node_arena flag.
+    /**
+     * The buckets of piranha::hash_set are linked lists, whose nodes past the first one are allocated dynamically.
+     * When this flag is active, hash sets with a large number of buckets allocate such nodes from an arena
+     * owned by the set: the arena hands out memory from large slabs, with separate slabs for each thread,
+     * and it releases all the memory in bulk when the set is cleared or destroyed. The flag is checked when the
+     * buckets of a hash set are allocated (e.g., on construction and on rehashing).
+     *
+     * The default value of this flag is \p false.
+     *
+     * @return current value of the \p node_arena flag.
+     */
+    static bool get_node_arena()
+    {
+        return s_node_arena.load();
+    }
+    /// Set the \p node_arena flag.
+    /**
+     * @see piranha::tuning::get_node_arena() for an explanation of the meaning of this flag.
+     *
+     * @param flag desired value for the \p node_arena flag.
+     */
+    static void set_node_arena(bool flag)
+    {
+        s_node_arena.store(flag);
+    }
+    /// Reset the \p node_arena flag.
+    /**
+     * This method will reset the \p node_arena flag to its default value.
+     *
+     * @see piranha::tuning::get_node_arena() for an explanation of the meaning of this flag.
+     */
+    static void reset_node_arena()
+    {
+        s_node_arena.store(false);
+    }
+    /// Get the memory limit of the cache of natural powers of series.
+    /**
+     * piranha::series::pow() stores the natural powers of series in a cache (one for each series type), so that
+     * they can be reused in subsequent exponentiations. When the estimated memory used by a cache exceeds this value
+     * (in bytes), the powers of the least recently used series are evicted from the cache.
+     *
+     * The default value of this flag is 1073741824 (i.e., 1 GiB).
+     *
+     * @return the memory limit of the cache of natural powers of series.
+     *
+     * @see piranha::series::get_pow_cache_stats().
+     */
+    static unsigned long get_pow_cache_max_memory()
+    {
+        return s_pow_cache_max_memory.load();
+    }
+    /// Set the memory limit of the cache of natural powers of series.
+    /**
+     * @see piranha::tuning::get_pow_cache_max_memory() for an explanation of the meaning of this value.
+     *
+     * @param size desired value for the memory limit of the cache of natural powers of series.
+     */
+    static void set_pow_cache_max_memory(unsigned long size)
+    {
+        s_pow_cache_max_memory.store(size);
+    }
+    /// Reset the memory limit of the cache of natural powers of series.
+    /**
+     * This method will reset the memory limit of the cache of natural powers of series to its default value.
+     *
+     * @see piranha::tuning::get_pow_cache_max_memory() for an explanation of the meaning of this value.
+     */
+    static void reset_pow_cache_max_memory()
+    {
+        s_pow_cache_max_memory.store(1073741824ul);
+    }
 };
 }
 
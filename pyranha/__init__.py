@@ -359,6 +359,9 @@ class data_format(object):
     The portable variants are slower but suitable for use across architectures and Piranha versions, the binary
     variants are faster but they are not portable across architectures and Piranha versions.
 
+    The flat binary format stores series with fixed-width coefficients and Kronecker keys in a layout which
+    can be memory-mapped. It is not portable across architectures, and it does not support compression.
+
     """
 
     #: Boost portable format.
@@ -369,6 +372,8 @@ class data_format(object):
     msgpack_portable = _df.msgpack_portable
     #: msgpack binary format.
     msgpack_binary = _df.msgpack_binary
+    #: Flat binary format.
+    flat_binary = _df.flat_binary
 
 
 class compression(object):
@@ -416,10 +421,10 @@ def save_file(obj, name, df=None, cf=None):
       (respectively, :py:attr:`pyranha.compression.bzip2`, :py:attr:`pyranha.compression.gzip` and
       :py:attr:`pyranha.compression.zlib`). Otherwise, :py:attr:`pyranha.compression.none` is assumed;
     * after the removal of any compression suffix, the extension of *name* is examined again: if the extension is
-      one of ``.boostp``, ``.boostb``, ``.mpackp`` and ``.mpackb``, then the corresponding data format is selected
-      (respectively, :py:attr:`pyranha.data_format.boost_portable`, :py:attr:`pyranha.data_format.boost_binary`,
-      :py:attr:`pyranha.data_format.msgpack_portable`, :py:attr:`pyranha.data_format.msgpack_binary`). Othwewise, an
-      error will be produced.
+      one of ``.boostp``, ``.boostb``, ``.mpackp``, ``.mpackb`` and ``.flatb``, then the corresponding data format is
+      selected (respectively, :py:attr:`pyranha.data_format.boost_portable`, :py:attr:`pyranha.data_format.boost_binary`,
+      :py:attr:`pyranha.data_format.msgpack_portable`, :py:attr:`pyranha.data_format.msgpack_binary`,
+      :py:attr:`pyranha.data_format.flat_binary`). Othwewise, an error will be produced.
 
     Examples of file names:
 
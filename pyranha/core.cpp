@@ -199,7 +199,8 @@ BOOST_PYTHON_MODULE(_core)
         .value("boost_binary", piranha::data_format::boost_binary)
         .value("boost_portable", piranha::data_format::boost_portable)
         .value("msgpack_binary", piranha::data_format::msgpack_binary)
-        .value("msgpack_portable", piranha::data_format::msgpack_portable);
+        .value("msgpack_portable", piranha::data_format::msgpack_portable)
+        .value("flat_binary", piranha::data_format::flat_binary);
     bp::enum_<piranha::compression>("compression")
         .value("none", piranha::compression::none)
         .value("zlib", piranha::compression::zlib)
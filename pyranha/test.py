@@ -38,7 +38,7 @@ def _s11n_load_save_test(self, p):
     import os
     import shutil
     from . import load_file, save_file, data_format as df, compression as comp
-    for form in [df.boost_portable, df.boost_binary, df.msgpack_portable, df.msgpack_binary]:
+    for form in [df.boost_portable, df.boost_binary, df.msgpack_portable, df.msgpack_binary, df.flat_binary]:
         for c in [comp.none, comp.bzip2, comp.gzip, comp.zlib]:
             f = tempfile.NamedTemporaryFile(delete=False)
             f.close()
@@ -54,7 +54,9 @@ def _s11n_load_save_test(self, p):
     # Deduce from filename.
     temp_dir = tempfile.mkdtemp()
     try:
-        for suff in ['.boostb', '.boostp', '.mpackb', '.mpackp']:
+        # NOTE: the flat format is last, as it does not support compression and it
+        # is not available for all types.
+        for suff in ['.boostb', '.boostp', '.mpackb', '.mpackp', '.flatb']:
             for comp in ['', '.bz2', '.zip', '.gz']:
                 filename = os.path.join(temp_dir, 'foo' + suff + comp)
                 save_file(p, filename)
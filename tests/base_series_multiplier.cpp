@@ -170,6 +170,11 @@ struct m_checker : public base_series_multiplier<Series> {
     {
         base::finalise_series(std::forward<Args>(args)...);
     }
+    template <typename F>
+    typename base::bucket_size_type cached_estimate(const F &f) const
+    {
+        return base::cached_estimate(f);
+    }
     unsigned get_n_threads() const
     {
         return this->m_n_threads;
@@ -445,6 +450,69 @@ BOOST_AUTO_TEST_CASE(base_series_multiplier_estimate_final_series_size_test)
     settings::reset_n_threads();
 }
 
+// Estimators returning a fixed value.
+struct fixed_estimator_0 {
+    std::size_t operator()() const
+    {
+        return m_value;
+    }
+    std::size_t m_value;
+};
+
+struct fixed_estimator_1 {
+    std::size_t operator()() const
+    {
+        return m_value;
+    }
+    std::size_t m_value;
+};
+
+BOOST_AUTO_TEST_CASE(base_series_multiplier_cached_estimate_test)
+{
+    using pt = p_type<integer>;
+    pt x{"x"}, y{"y"};
+    const auto a = (x + 2 * y + 4).pow(3), b = (x - y - 3).pow(2);
+    {
+        // Without the cache, the estimator is always called.
+        m_checker<pt> m0(a, b);
+        BOOST_CHECK_EQUAL(m0.cached_estimate(fixed_estimator_0{10u}), 10u);
+        BOOST_CHECK_EQUAL(m0.cached_estimate(fixed_estimator_0{20u}), 20u);
+    }
+    tuning::set_estimate_cache(true);
+    {
+        m_checker<pt> m0(a, b);
+        BOOST_CHECK_EQUAL(m0.cached_estimate(fixed_estimator_0{10u}), 10u);
+        BOOST_CHECK_EQUAL(m0.cached_estimate(fixed_estimator_0{20u}), 10u);
+        // A different estimator does not reuse the cached value.
+        BOOST_CHECK_EQUAL(m0.cached_estimate(fixed_estimator_1{30u}), 30u);
+        BOOST_CHECK_EQUAL(m0.cached_estimate(fixed_estimator_1{40u}), 30u);
+        // Same for different operands.
+        m_checker<pt> m1(b, a * x);
+        BOOST_CHECK_EQUAL(m1.cached_estimate(fixed_estimator_0{50u}), 50u);
+        // The coefficients do not enter the signature.
+        m_checker<pt> m3(2 * a, b);
+        BOOST_CHECK_EQUAL(m3.cached_estimate(fixed_estimator_0{70u}), 10u);
+    }
+    {
+        // Toggling the sketch_estimation flag between two identical multiplications.
+        const auto c = (x + y - 7).pow(5), d = (x + 3).pow(4);
+        const auto ref = c * d;
+        m_checker<pt> m0(c, d);
+        tuning::set_sketch_estimation(false);
+        BOOST_CHECK_EQUAL(m0.cached_estimate(fixed_estimator_0{10u}), 10u);
+        BOOST_CHECK_EQUAL(c * d, ref);
+        tuning::set_sketch_estimation(true);
+        BOOST_CHECK_EQUAL(m0.cached_estimate(fixed_estimator_0{20u}), 20u);
+        BOOST_CHECK_EQUAL(c * d, ref);
+        tuning::set_sketch_estimation(false);
+        BOOST_CHECK_EQUAL(m0.cached_estimate(fixed_estimator_0{30u}), 10u);
+        tuning::set_sketch_estimation(true);
+        BOOST_CHECK_EQUAL(m0.cached_estimate(fixed_estimator_0{30u}), 20u);
+        tuning::reset_sketch_estimation();
+    }
+    tuning::reset_estimate_cache();
+}
+
 BOOST_AUTO_TEST_CASE(base_series_multiplier_sanitise_series_test)
 {
     using pt = p_type<integer>;
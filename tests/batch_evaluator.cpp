@@ -0,0 +1,127 @@
+/* Copyright 2009-2017 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#include <piranha/batch_evaluator.hpp>
+
+#define BOOST_TEST_MODULE batch_evaluator_test
+#include <boost/test/included/unit_test.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <piranha/integer.hpp>
+#include <piranha/kronecker_monomial.hpp>
+#include <piranha/math.hpp>
+#include <piranha/monomial.hpp>
+#include <piranha/poisson_series.hpp>
+#include <piranha/polynomial.hpp>
+#include <piranha/rational.hpp>
+#include <piranha/settings.hpp>
+#include <piranha/symbol_utils.hpp>
+
+using namespace piranha;
+
+// Check the batch evaluation of p against math::evaluate(), on n points.
+template <typename P>
+static void batch_checker(const P &p, const std::vector<std::string> &names, unsigned n)
+{
+    std::vector<std::vector<double>> values(names.size());
+    for (decltype(values.size()) i = 0u; i < values.size(); ++i) {
+        for (unsigned j = 0u; j < n; ++j) {
+            // Small non-zero values, different for each symbol.
+            values[i].push_back(static_cast<double>(int((j * 7u + i * 3u) % 11u) - 5) / 4. + .125);
+        }
+    }
+    batch_evaluator<P, double> be(p, names);
+    const auto res = be(values);
+    BOOST_CHECK_EQUAL(res.size(), n);
+    for (unsigned j = 0u; j < n; ++j) {
+        symbol_fmap<double> dict;
+        for (decltype(values.size()) i = 0u; i < values.size(); ++i) {
+            dict.insert(std::make_pair(names[i], values[i][j]));
+        }
+        const double ref = math::evaluate(p, dict);
+        BOOST_CHECK(std::abs(res[j] - ref) <= 1E-10 * std::max(1., std::abs(ref)));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(batch_evaluator_test)
+{
+    BOOST_CHECK((batch_evaluator_reqs<polynomial<integer, k_monomial>, double>::value));
+    BOOST_CHECK((batch_evaluator_reqs<polynomial<rational, monomial<int>>, double>::value));
+    BOOST_CHECK((batch_evaluator_reqs<polynomial<double, monomial<integer>>, double>::value));
+    BOOST_CHECK((!batch_evaluator_reqs<polynomial<rational, monomial<rational>>, double>::value));
+    BOOST_CHECK((!batch_evaluator_reqs<poisson_series<polynomial<rational, k_monomial>>, double>::value));
+    BOOST_CHECK((!batch_evaluator_reqs<int, double>::value));
+    for (unsigned nt = 1u; nt <= 4u; ++nt) {
+        settings::set_n_threads(nt);
+        settings::set_min_work_per_thread(1u);
+        {
+            using p_type = polynomial<integer, k_monomial>;
+            p_type x{"x"}, y{"y"}, z{"z"};
+            const auto p = (x + 2 * y - 3 * z + 1).pow(8);
+            batch_checker(p, {"x", "y", "z"}, 1000u);
+            batch_checker(p, {"z", "w", "y", "x"}, 300u);
+            batch_checker(p, {"z", "y", "x"}, 1u);
+            batch_checker(p, {"z", "y", "x"}, 0u);
+            batch_checker(p_type{}, {"x"}, 10u);
+            batch_checker(p_type{3}, {}, 0u);
+            batch_checker(p_type{3}, {"x"}, 10u);
+            // Negative exponents.
+            batch_checker(x.pow(-3) * y + z.pow(-1) - 2 * x.pow(2), {"x", "y", "z"}, 600u);
+        }
+        {
+            using p_type = polynomial<rational, monomial<int>>;
+            p_type x{"x"}, y{"y"};
+            const auto p = (x / 3 + y - 1).pow(7) + x.pow(-2) * y.pow(-5);
+            batch_checker(p, {"y", "x"}, 513u);
+        }
+        settings::reset_min_work_per_thread();
+    }
+    settings::reset_n_threads();
+    // Error handling.
+    using p_type = polynomial<integer, k_monomial>;
+    p_type x{"x"}, y{"y"};
+    BOOST_CHECK_THROW((batch_evaluator<p_type, double>(x + y, {"x", "x", "y"})), std::invalid_argument);
+    BOOST_CHECK_THROW((batch_evaluator<p_type, double>(x + y, {"x"})), std::invalid_argument);
+    batch_evaluator<p_type, double> be(x + y, {"x", "y"});
+    BOOST_CHECK_THROW(be({{1., 2.}}), std::invalid_argument);
+    BOOST_CHECK_THROW(be({{1., 2.}, {1.}}), std::invalid_argument);
+    BOOST_CHECK((be({{1., 2.}, {3., 4.}}) == std::vector<double>{4., 6.}));
+    // Copy and move semantics.
+    auto be2(be);
+    BOOST_CHECK((be2({{1.}, {-1.}}) == std::vector<double>{0.}));
+    auto be3(std::move(be2));
+    BOOST_CHECK((be3({{1.}, {-1.}}) == std::vector<double>{0.}));
+    be2 = be3;
+    BOOST_CHECK((be2({{2.}, {-1.}}) == std::vector<double>{1.}));
+}
@@ -0,0 +1,190 @@
+/* Copyright 2009-2017 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#include <piranha/chunked_s11n.hpp>
+
+#define BOOST_TEST_MODULE chunked_s11n_test
+#include <boost/test/included/unit_test.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <ios>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/algorithm/string/predicate.hpp>
+
+#include <piranha/config.hpp>
+#include <piranha/exceptions.hpp>
+#include <piranha/integer.hpp>
+#include <piranha/kronecker_monomial.hpp>
+#include <piranha/math.hpp>
+#include <piranha/monomial.hpp>
+#include <piranha/poisson_series.hpp>
+#include <piranha/polynomial.hpp>
+#include <piranha/rational.hpp>
+#include <piranha/s11n.hpp>
+#include <piranha/settings.hpp>
+
+using namespace piranha;
+
+static std::random_device rd;
+
+// Small raii class for creating a tmp file.
+struct tmp_file {
+    tmp_file() : m_path(PIRANHA_BINARY_TESTS_DIR "/" + std::to_string(rd())) {}
+    ~tmp_file()
+    {
+        std::remove(m_path.c_str());
+    }
+    std::string m_path;
+};
+
+static std::vector<data_format> chunked_dfs()
+{
+    std::vector<data_format> retval;
+#if defined(PIRANHA_WITH_BOOST_S11N)
+    retval.push_back(data_format::boost_binary);
+    retval.push_back(data_format::boost_portable);
+#endif
+#if defined(PIRANHA_WITH_MSGPACK)
+    retval.push_back(data_format::msgpack_binary);
+    retval.push_back(data_format::msgpack_portable);
+#endif
+    return retval;
+}
+
+static std::vector<compression> chunked_cfs()
+{
+    std::vector<compression> retval{compression::none};
+#if defined(PIRANHA_WITH_BZIP2)
+    retval.push_back(compression::bzip2);
+#endif
+#if defined(PIRANHA_WITH_ZLIB)
+    retval.push_back(compression::gzip);
+    retval.push_back(compression::zlib);
+#endif
+    return retval;
+}
+
+template <typename T>
+static inline T chunked_roundtrip(const T &x, data_format f, compression c)
+{
+    tmp_file file;
+    save_file_chunked(x, file.m_path, f, c);
+    T retval;
+    load_file_chunked(retval, file.m_path);
+    return retval;
+}
+
+BOOST_AUTO_TEST_CASE(chunked_s11n_roundtrip_test)
+{
+    using p_type1 = polynomial<integer, k_monomial>;
+    using p_type2 = polynomial<rational, monomial<short>>;
+    using ps_type = poisson_series<p_type2>;
+    p_type1 x{"x"}, y{"y"}, z{"z"};
+    const auto p1 = (x + 2 * y - 3 * z + 1).pow(10);
+    p_type2 a{"a"}, b{"b"};
+    const auto p2 = (a / 3 - b + 2).pow(15);
+    const auto ps = (ps_type{"a"} * math::cos(ps_type{"b"}) + 1).pow(5);
+    for (auto f : chunked_dfs()) {
+        for (auto c : chunked_cfs()) {
+            for (unsigned nt = 1u; nt <= 4u; ++nt) {
+                settings::set_n_threads(nt);
+                // Force the creation of many small chunks.
+                settings::set_min_work_per_thread(10u);
+                BOOST_CHECK_EQUAL(chunked_roundtrip(p1, f, c), p1);
+                BOOST_CHECK_EQUAL(chunked_roundtrip(p2, f, c), p2);
+                BOOST_CHECK_EQUAL(chunked_roundtrip(ps, f, c), ps);
+                BOOST_CHECK_EQUAL(chunked_roundtrip(p_type1{}, f, c), p_type1{});
+                BOOST_CHECK_EQUAL(chunked_roundtrip(p_type1{3}, f, c), p_type1{3});
+                settings::reset_min_work_per_thread();
+                BOOST_CHECK_EQUAL(chunked_roundtrip(p1, f, c), p1);
+            }
+            // Save with many threads, load with one.
+            settings::set_n_threads(4u);
+            settings::set_min_work_per_thread(10u);
+            tmp_file file;
+            save_file_chunked(p1, file.m_path, f, c);
+            settings::set_n_threads(1u);
+            p_type1 tmp;
+            load_file_chunked(tmp, file.m_path);
+            BOOST_CHECK_EQUAL(tmp, p1);
+            settings::reset_min_work_per_thread();
+        }
+    }
+    settings::reset_n_threads();
+}
+
+BOOST_AUTO_TEST_CASE(chunked_s11n_failures_test)
+{
+    using p_type = polynomial<integer, k_monomial>;
+    p_type x{"x"}, y{"y"};
+    const auto p = (x - y + 1).pow(4);
+    BOOST_CHECK_EXCEPTION(
+        save_file_chunked(p, "foo", data_format::flat_binary, compression::none), not_implemented_error,
+        [](const not_implemented_error &nie) {
+            return boost::contains(nie.what(),
+                                   "chunked serialization supports only the Boost and msgpack data formats");
+        });
+    p_type tmp{"z"};
+    BOOST_CHECK_EXCEPTION(load_file_chunked(tmp, "foobar123"), std::runtime_error, [](const std::runtime_error &re) {
+        return boost::contains(re.what(), "file 'foobar123' could not be opened for loading");
+    });
+    BOOST_CHECK_EQUAL(tmp, p_type{"z"});
+    // Not a chunked file.
+    tmp_file file;
+    {
+        std::ofstream ofile(file.m_path, std::ios::out | std::ios::binary | std::ios::trunc);
+        ofile << "hello world";
+    }
+    BOOST_CHECK_EXCEPTION(load_file_chunked(tmp, file.m_path), std::invalid_argument,
+                          [](const std::invalid_argument &ia) {
+                              return boost::contains(ia.what(), "is not a valid chunked file");
+                          });
+    BOOST_CHECK_EQUAL(tmp, p_type{"z"});
+#if defined(PIRANHA_WITH_BOOST_S11N)
+    // Truncated file.
+    save_file_chunked(p, file.m_path, data_format::boost_binary, compression::none);
+    {
+        std::ifstream ifile(file.m_path, std::ios::in | std::ios::binary);
+        std::string content{std::istreambuf_iterator<char>(ifile), std::istreambuf_iterator<char>()};
+        ifile.close();
+        std::ofstream ofile(file.m_path, std::ios::out | std::ios::binary | std::ios::trunc);
+        ofile.write(content.data(), static_cast<std::streamsize>(content.size() - 1u));
+    }
+    BOOST_CHECK_EXCEPTION(load_file_chunked(tmp, file.m_path), std::invalid_argument,
+                          [](const std::invalid_argument &ia) {
+                              return boost::contains(ia.what(), "is not a valid chunked file");
+                          });
+    BOOST_CHECK_EQUAL(tmp, p_type{"z"});
+#endif
+}
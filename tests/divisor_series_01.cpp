@@ -51,12 +51,14 @@ see https://www.gnu.org/licenses/. */
 #include <piranha/math/pow.hpp>
 #include <piranha/math/sin.hpp>
 #include <piranha/monomial.hpp>
+#include <piranha/packed_divisor.hpp>
 #include <piranha/poisson_series.hpp>
 #include <piranha/polynomial.hpp>
 #include <piranha/rational.hpp>
 #if defined(MPPP_WITH_MPFR)
 #include <piranha/real.hpp>
 #endif
+#include <piranha/settings.hpp>
 #include <piranha/symbol_utils.hpp>
 #include <piranha/type_traits.hpp>
 
@@ -407,3 +409,47 @@ BOOST_AUTO_TEST_CASE(divisor_series_rational_multiplication_test)
     s_type s1{1 / 2_q}, s2{2 / 3_q};
     BOOST_CHECK_EQUAL(s1 * s2, 1 / 3_q);
 }
+
+struct bulk_tester {
+    template <typename Key>
+    void operator()(const Key &) const
+    {
+        using s_type = divisor_series<polynomial<rational, monomial<int>>, Key>;
+        s_type x{"x"}, y{"y"}, z{"z"};
+        // Build a series with many distinct divisors, so that the work is split among threads, together with
+        // its expected derivatives, using d(1/L)/dx = -a/L**2.
+        s_type s, sx, sy, sz, s2, s2x;
+        for (int i = 1; i < 20; ++i) {
+            for (int j = 1; j < 20; ++j) {
+                const auto d = math::invert(x + i * y + j * z);
+                const auto cf = (x + i) * (z - j);
+                s += cf * d;
+                sx += (z - j) * d - cf * d * d;
+                sy += -i * cf * d * d;
+                sz += (x + i) * d - j * cf * d * d;
+                const auto d2 = math::invert(y + i * z);
+                s2 += (x + j) * d2;
+                s2x += (x * x / 2 + j * x) * d2;
+            }
+        }
+        settings::set_min_work_per_thread(1u);
+        for (unsigned nt = 1u; nt <= 4u; ++nt) {
+            settings::set_n_threads(nt);
+            BOOST_CHECK_EQUAL(s.partial("x"), sx);
+            BOOST_CHECK_EQUAL(s.partial("y"), sy);
+            BOOST_CHECK_EQUAL(s.partial("z"), sz);
+            BOOST_CHECK_EQUAL(s.partial("t"), 0);
+            BOOST_CHECK_EQUAL(s2.integrate("x"), s2x);
+            BOOST_CHECK_EQUAL(s.integrate("t"), s * s_type{"t"});
+            BOOST_CHECK_THROW(s.integrate("x"), std::invalid_argument);
+            BOOST_CHECK_THROW(s2.integrate("z"), std::invalid_argument);
+        }
+        settings::reset_n_threads();
+        settings::reset_min_work_per_thread();
+    }
+};
+
+BOOST_AUTO_TEST_CASE(divisor_series_bulk_partial_integrate_test)
+{
+    tuple_for_each(std::tuple<divisor<short>, divisor<integer>, packed_divisor<int>>{}, bulk_tester{});
+}
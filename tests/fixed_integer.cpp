@@ -0,0 +1,375 @@
+/* Copyright 2009-2017 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#include <piranha/fixed_integer.hpp>
+
+#define BOOST_TEST_MODULE fixed_integer_test
+#include <boost/test/included/unit_test.hpp>
+
+#include <boost/lexical_cast.hpp>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <mp++/exceptions.hpp>
+
+#include <piranha/config.hpp>
+#include <piranha/integer.hpp>
+#include <piranha/is_cf.hpp>
+#include <piranha/kronecker_monomial.hpp>
+#include <piranha/math/pow.hpp>
+#include <piranha/monomial.hpp>
+#include <piranha/polynomial.hpp>
+#include <piranha/s11n.hpp>
+#include <piranha/settings.hpp>
+#include <piranha/tuning.hpp>
+#include <piranha/type_traits.hpp>
+
+using namespace piranha;
+
+static std::mt19937 rng;
+
+static const int ntries = 1000;
+
+#if defined(PIRANHA_HAVE_FIXED_INTEGER_128)
+using fi_types = std::tuple<fixed_integer<1>, fixed_integer<2>>;
+#else
+using fi_types = std::tuple<fixed_integer<1>>;
+#endif
+
+struct basic_tester {
+    template <typename T>
+    void operator()(const T &) const
+    {
+        using value_type = typename T::value_type;
+        const auto max = std::numeric_limits<value_type>::max(), min = std::numeric_limits<value_type>::min();
+        BOOST_CHECK(is_cf<T>::value);
+        BOOST_CHECK(is_fixed_integer<T>::value);
+        BOOST_CHECK(!is_fixed_integer<T &>::value);
+        BOOST_CHECK((std::is_convertible<int, T>::value));
+        BOOST_CHECK((!std::is_convertible<integer, T>::value));
+        BOOST_CHECK((std::is_constructible<T, integer>::value));
+        BOOST_CHECK_EQUAL(sizeof(T), sizeof(value_type));
+        // Construction and conversion.
+        BOOST_CHECK(T{}.get() == 0);
+        BOOST_CHECK(T{42}.get() == 42);
+        BOOST_CHECK(T{-42ll}.get() == -42);
+        BOOST_CHECK(T{42u}.get() == 42);
+        BOOST_CHECK_EQUAL(static_cast<int>(T{-42}), -42);
+        BOOST_CHECK_EQUAL(static_cast<integer>(T{-42}), -42);
+        BOOST_CHECK(T{integer{-123}}.get() == -123);
+        BOOST_CHECK(T{max}.get() == max);
+        BOOST_CHECK(T{min}.get() == min);
+        BOOST_CHECK_EQUAL(static_cast<integer>(T{min}), integer{min});
+        BOOST_CHECK(T{static_cast<integer>(T{max})}.get() == max);
+        BOOST_CHECK_THROW(T{integer{max} + 1}, std::overflow_error);
+        BOOST_CHECK_THROW(T{integer{min} - 1}, std::overflow_error);
+        BOOST_CHECK_THROW(static_cast<unsigned>(T{-1}), std::overflow_error);
+        BOOST_CHECK_THROW(static_cast<signed char>(T{1000}), std::overflow_error);
+        BOOST_CHECK_EQUAL(static_cast<signed char>(T{-100}), -100);
+        if (sizeof(value_type) == sizeof(std::uint_least64_t)) {
+            BOOST_CHECK_THROW(T{std::numeric_limits<std::uint_least64_t>::max()}, std::overflow_error);
+        } else {
+            BOOST_CHECK_EQUAL(static_cast<integer>(T{std::numeric_limits<std::uint_least64_t>::max()}),
+                              integer{std::numeric_limits<std::uint_least64_t>::max()});
+            BOOST_CHECK_THROW(static_cast<long long>(T{max}), std::overflow_error);
+        }
+        // String representation.
+        BOOST_CHECK_EQUAL(T{}.to_string(), "0");
+        BOOST_CHECK_EQUAL(T{-1230}.to_string(), "-1230");
+        BOOST_CHECK_EQUAL(T{max}.to_string(), integer{max}.to_string());
+        BOOST_CHECK_EQUAL(T{min}.to_string(), integer{min}.to_string());
+        BOOST_CHECK_EQUAL(boost::lexical_cast<std::string>(T{-7}), "-7");
+        // Bit size and sign.
+        BOOST_CHECK_EQUAL(T{}.nbits(), 0u);
+        BOOST_CHECK_EQUAL(T{1}.nbits(), 1u);
+        BOOST_CHECK_EQUAL(T{-8}.nbits(), 4u);
+        BOOST_CHECK_EQUAL(T{max}.nbits(), unsigned(std::numeric_limits<value_type>::digits));
+        BOOST_CHECK_EQUAL(T{min}.nbits(), unsigned(std::numeric_limits<value_type>::digits) + 1u);
+        BOOST_CHECK_EQUAL(T{}.sgn(), 0);
+        BOOST_CHECK_EQUAL(T{3}.sgn(), 1);
+        BOOST_CHECK_EQUAL(T{-3}.sgn(), -1);
+        // Arithmetic.
+        BOOST_CHECK_EQUAL(T{3} + T{4}, 7);
+        BOOST_CHECK_EQUAL(T{3} + 4, 7);
+        BOOST_CHECK_EQUAL(3 - T{4}, -1);
+        BOOST_CHECK_EQUAL(T{-3} * 4, -12);
+        BOOST_CHECK_EQUAL(T{-7} / 2, -3);
+        BOOST_CHECK_EQUAL(T{-7} % 2, -1);
+        BOOST_CHECK_EQUAL(-T{5}, -5);
+        BOOST_CHECK_EQUAL(+T{5}, 5);
+        T n{10};
+        n += 5;
+        BOOST_CHECK_EQUAL(n, 15);
+        n -= 20;
+        BOOST_CHECK_EQUAL(n, -5);
+        n *= -3;
+        BOOST_CHECK_EQUAL(n, 15);
+        n /= 4;
+        BOOST_CHECK_EQUAL(n, 3);
+        n %= 2;
+        BOOST_CHECK_EQUAL(n, 1);
+        // Overflow and division errors, with the strong exception safety guarantee.
+        n = max;
+        BOOST_CHECK_THROW(n += 1, std::overflow_error);
+        BOOST_CHECK_EQUAL(n, max);
+        BOOST_CHECK_THROW(n * 2, std::overflow_error);
+        BOOST_CHECK_THROW(n *= -2, std::overflow_error);
+        BOOST_CHECK_EQUAL(n, max);
+        BOOST_CHECK_EQUAL(-n + -1, min);
+        n = min;
+        BOOST_CHECK_THROW(n -= 1, std::overflow_error);
+        BOOST_CHECK_THROW(-n, std::overflow_error);
+        BOOST_CHECK_THROW(n / -1, std::overflow_error);
+        BOOST_CHECK_THROW(n % -1, std::overflow_error);
+        BOOST_CHECK_THROW(n / 0, mppp::zero_division_error);
+        BOOST_CHECK_THROW(n %= 0, mppp::zero_division_error);
+        BOOST_CHECK_EQUAL(n, min);
+        // Comparisons.
+        BOOST_CHECK(T{1} == 1);
+        BOOST_CHECK(1 != T{2});
+        BOOST_CHECK(T{-1} < 0);
+        BOOST_CHECK(T{-1} <= -1);
+        BOOST_CHECK(T{min} < T{max});
+        BOOST_CHECK(T{2} > 1);
+        BOOST_CHECK(T{2} >= 2);
+        // Random checks against integer.
+        std::uniform_int_distribution<long long> dist(-1000000000ll, 1000000000ll);
+        for (int i = 0; i < ntries; ++i) {
+            const auto a = dist(rng), b = dist(rng);
+            BOOST_CHECK_EQUAL(static_cast<integer>(T{a} * b - a + b), integer{a} * b - a + b);
+            BOOST_CHECK_EQUAL(T{a} < b, a < b);
+            if (b) {
+                BOOST_CHECK_EQUAL(T{a} / b, a / b);
+                BOOST_CHECK_EQUAL(T{a} % b, a % b);
+            }
+        }
+    }
+};
+
+BOOST_AUTO_TEST_CASE(fixed_integer_basic_test)
+{
+    tuple_for_each(fi_types{}, basic_tester{});
+}
+
+struct pow_tester {
+    template <typename T>
+    void operator()(const T &) const
+    {
+        using value_type = typename T::value_type;
+        BOOST_CHECK((std::is_same<decltype(piranha::pow(T{}, 2)), T>::value));
+        BOOST_CHECK((std::is_same<decltype(piranha::pow(T{}, 2ull)), T>::value));
+        BOOST_CHECK((!is_exponentiable<T, double>::value));
+        BOOST_CHECK_EQUAL(piranha::pow(T{3}, 0), 1);
+        BOOST_CHECK_EQUAL(piranha::pow(T{0}, 0u), 1);
+        BOOST_CHECK_EQUAL(piranha::pow(T{3}, 5), 243);
+        BOOST_CHECK_EQUAL(piranha::pow(T{-2}, 7u), -128);
+        BOOST_CHECK_EQUAL(piranha::pow(T{1}, -5), 1);
+        BOOST_CHECK_EQUAL(piranha::pow(T{-1}, -5), -1);
+        BOOST_CHECK_EQUAL(piranha::pow(T{-1}, -4), 1);
+        BOOST_CHECK_THROW(piranha::pow(T{0}, -1), mppp::zero_division_error);
+        BOOST_CHECK_THROW(piranha::pow(T{2}, -1), std::domain_error);
+        // The largest power of two which can be represented, and the next one.
+        const int digits = std::numeric_limits<value_type>::digits;
+        BOOST_CHECK_EQUAL(static_cast<integer>(piranha::pow(T{2}, digits - 1)), piranha::pow(integer{2}, digits - 1));
+        BOOST_CHECK(piranha::pow(T{-2}, digits).get() == std::numeric_limits<value_type>::min());
+        BOOST_CHECK_THROW(piranha::pow(T{2}, digits), std::overflow_error);
+        BOOST_CHECK_THROW(piranha::pow(T{3}, 1000), std::overflow_error);
+    }
+};
+
+BOOST_AUTO_TEST_CASE(fixed_integer_pow_test)
+{
+    tuple_for_each(fi_types{}, pow_tester{});
+}
+
+#if defined(PIRANHA_WITH_BOOST_S11N) || defined(PIRANHA_WITH_MSGPACK)
+
+template <typename T>
+static inline std::vector<T> s11n_values()
+{
+    using value_type = typename T::value_type;
+    std::vector<T> retval{T{}, T{1}, T{-1}, T{std::numeric_limits<value_type>::max()},
+                          T{std::numeric_limits<value_type>::min()}};
+    std::uniform_int_distribution<long long> dist(std::numeric_limits<long long>::min(),
+                                                  std::numeric_limits<long long>::max());
+    for (int i = 0; i < ntries; ++i) {
+        retval.emplace_back(dist(rng));
+    }
+    return retval;
+}
+
+#endif
+
+#if defined(PIRANHA_WITH_BOOST_S11N)
+
+template <typename OArchive, typename IArchive, typename T>
+static inline void boost_roundtrip(const T &x)
+{
+    std::stringstream ss;
+    {
+        OArchive oa(ss);
+        boost_save(oa, x);
+    }
+    T retval;
+    {
+        IArchive ia(ss);
+        boost_load(ia, retval);
+    }
+    BOOST_CHECK_EQUAL(x, retval);
+}
+
+struct boost_s11n_tester {
+    template <typename T>
+    void operator()(const T &) const
+    {
+        BOOST_CHECK((has_boost_save<boost::archive::binary_oarchive, T>::value));
+        BOOST_CHECK((has_boost_save<boost::archive::text_oarchive &, const T &>::value));
+        BOOST_CHECK((!has_boost_save<boost::archive::binary_iarchive, T>::value));
+        BOOST_CHECK((has_boost_load<boost::archive::binary_iarchive, T>::value));
+        BOOST_CHECK((has_boost_load<boost::archive::text_iarchive &, T &>::value));
+        BOOST_CHECK((!has_boost_load<boost::archive::binary_iarchive &, const T &>::value));
+        for (const auto &x : s11n_values<T>()) {
+            boost_roundtrip<boost::archive::binary_oarchive, boost::archive::binary_iarchive>(x);
+            boost_roundtrip<boost::archive::text_oarchive, boost::archive::text_iarchive>(x);
+        }
+    }
+};
+
+BOOST_AUTO_TEST_CASE(fixed_integer_boost_s11n_test)
+{
+    tuple_for_each(fi_types{}, boost_s11n_tester{});
+}
+
+#endif
+
+#if defined(PIRANHA_WITH_MSGPACK)
+
+template <typename T>
+static inline void msgpack_roundtrip(const T &x, msgpack_format f)
+{
+    msgpack::sbuffer sbuf;
+    msgpack::packer<msgpack::sbuffer> p(sbuf);
+    msgpack_pack(p, x, f);
+    auto oh = msgpack::unpack(sbuf.data(), sbuf.size());
+    T retval;
+    msgpack_convert(retval, oh.get(), f);
+    BOOST_CHECK_EQUAL(x, retval);
+}
+
+struct msgpack_s11n_tester {
+    template <typename T>
+    void operator()(const T &) const
+    {
+        BOOST_CHECK((has_msgpack_pack<msgpack::sbuffer, T>::value));
+        BOOST_CHECK((has_msgpack_pack<std::stringstream, const T &>::value));
+        BOOST_CHECK((!has_msgpack_pack<void, const T &>::value));
+        BOOST_CHECK((has_msgpack_convert<T>::value));
+        BOOST_CHECK((has_msgpack_convert<T &>::value));
+        BOOST_CHECK((!has_msgpack_convert<const T &>::value));
+        for (auto f : {msgpack_format::portable, msgpack_format::binary}) {
+            for (const auto &x : s11n_values<T>()) {
+                msgpack_roundtrip(x, f);
+            }
+        }
+    }
+};
+
+BOOST_AUTO_TEST_CASE(fixed_integer_msgpack_s11n_test)
+{
+    tuple_for_each(fi_types{}, msgpack_s11n_tester{});
+}
+
+#endif
+
+// Check polynomial multiplication with fixed integer coefficients against integer coefficients.
+struct poly_tester {
+    template <typename Key>
+    struct runner {
+        template <typename T>
+        void operator()(const T &) const
+        {
+            using p_type = polynomial<T, Key>;
+            using pi_type = polynomial<integer, Key>;
+            BOOST_CHECK((std::is_same<decltype(p_type{} * p_type{}), p_type>::value));
+            auto to_int = [](const p_type &p) {
+                pi_type retval;
+                for (const auto &t : p._container()) {
+                    retval.insert(typename pi_type::term_type(static_cast<integer>(t.m_cf), t.m_key));
+                }
+                retval.set_symbol_set(p.get_symbol_set());
+                return retval;
+            };
+            p_type x{"x"}, y{"y"}, z{"z"}, t{"t"};
+            // Dense and sparse products, with and without cancellations.
+            p_type f1 = 1, g1 = 1;
+            for (int i = 0; i < 4; ++i) {
+                f1 *= x + y + 2 * z + t + 1;
+                g1 *= t - 3 * x - z + y + 1;
+            }
+            p_type f2, g2;
+            for (int i = 0; i < 200; ++i) {
+                f2 += (i % 7 - 3) * x.pow((i * 37) % 31) * y.pow((i * 53) % 29) * z.pow(i % 7);
+                g2 += (i % 5 + 1) * x.pow((i * 17) % 23) * y.pow(i % 11) * t.pow(i % 7);
+            }
+            const p_type fs[] = {f1, f2, x + y}, gs[] = {g1, g2, x - y};
+            for (auto i = 0u; i < 3u; ++i) {
+                const auto cmp = to_int(fs[i]) * to_int(gs[i]);
+                for (unsigned nt = 1u; nt <= 4u; ++nt) {
+                    settings::set_n_threads(nt);
+                    BOOST_CHECK(to_int(fs[i] * gs[i]) == cmp);
+                    BOOST_CHECK(to_int(gs[i] * fs[i]) == cmp);
+                }
+            }
+            settings::reset_n_threads();
+            // Overflow in the coefficients of the result.
+            using value_type = typename T::value_type;
+            const p_type big = T{std::numeric_limits<value_type>::max() / 2} * x + 1;
+            BOOST_CHECK_THROW(big * big, std::overflow_error);
+            BOOST_CHECK_THROW(big * (x + y) * big, std::overflow_error);
+        }
+    };
+    template <typename Key>
+    void operator()(const Key &) const
+    {
+        tuple_for_each(fi_types{}, runner<Key>{});
+    }
+};
+
+BOOST_AUTO_TEST_CASE(fixed_integer_polynomial_test)
+{
+    tuning::set_estimate_threshold(1u);
+    tuple_for_each(std::tuple<k_monomial, monomial<int>>{}, poly_tester{});
+    tuning::reset_estimate_threshold();
+}
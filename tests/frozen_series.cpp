@@ -0,0 +1,209 @@
+/* Copyright 2009-2017 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#include <piranha/frozen_series.hpp>
+
+#define BOOST_TEST_MODULE frozen_series_test
+#include <boost/test/included/unit_test.hpp>
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#include <piranha/config.hpp>
+#include <piranha/divisor.hpp>
+#include <piranha/divisor_series.hpp>
+#include <piranha/integer.hpp>
+#include <piranha/invert.hpp>
+#include <piranha/kronecker_monomial.hpp>
+#include <piranha/math.hpp>
+#include <piranha/monomial.hpp>
+#include <piranha/polynomial.hpp>
+#include <piranha/rational.hpp>
+#include <piranha/s11n.hpp>
+#include <piranha/symbol_utils.hpp>
+
+using namespace piranha;
+
+BOOST_AUTO_TEST_CASE(frozen_series_basic_test)
+{
+    using p_type = polynomial<integer, k_monomial>;
+    using f_type = frozen_series<p_type>;
+    f_type f0;
+    BOOST_CHECK(f0.empty());
+    BOOST_CHECK_EQUAL(f0.size(), 0u);
+    BOOST_CHECK(f0.begin() == f0.end());
+    BOOST_CHECK(f0.get_symbol_set().empty());
+    BOOST_CHECK_EQUAL(f0.thaw(), p_type{});
+    p_type x{"x"}, y{"y"}, z{"z"};
+    const auto p = (x + 2 * y - 3 * z + 1).pow(6);
+    f_type f1(p);
+    BOOST_CHECK(!f1.empty());
+    BOOST_CHECK_EQUAL(f1.size(), p.size());
+    BOOST_CHECK(f1.get_symbol_set() == p.get_symbol_set());
+    BOOST_CHECK_EQUAL(f1.thaw(), p);
+    // The terms are sorted according to their keys.
+    BOOST_CHECK(std::is_sorted(f1.begin(), f1.end(), [](const p_type::term_type &t1, const p_type::term_type &t2) {
+        return t1.m_key < t2.m_key;
+    }));
+    // Lookup.
+    for (const auto &t : p._container()) {
+        const auto it = f1.find(t);
+        BOOST_CHECK(it != f1.end());
+        BOOST_CHECK_EQUAL(it->m_cf, t.m_cf);
+    }
+    BOOST_CHECK(f1.find(p_type::term_type{integer(1), k_monomial{7, 0, 0}}) == f1.end());
+    // Copy/move semantics.
+    auto f2(f1);
+    BOOST_CHECK_EQUAL(f2.thaw(), p);
+    auto f3(std::move(f2));
+    BOOST_CHECK_EQUAL(f3.thaw(), p);
+    f2 = f3;
+    BOOST_CHECK_EQUAL(f2.thaw(), p);
+    f2 = std::move(f3);
+    BOOST_CHECK_EQUAL(f2.thaw(), p);
+    f2 = f_type{};
+    BOOST_CHECK(f2.empty());
+    // Evaluation.
+    const symbol_fmap<integer> d1{{"x", integer(2)}, {"y", integer(-3)}, {"z", integer(4)}};
+    BOOST_CHECK_EQUAL(f1.evaluate(d1), math::evaluate(p, d1));
+    const symbol_fmap<double> d2{{"x", 1.5}, {"y", -3.}, {"z", .5}};
+    BOOST_CHECK_EQUAL(f1.evaluate(d2), math::evaluate(p, d2));
+    BOOST_CHECK_THROW(f1.evaluate(symbol_fmap<integer>{{"x", integer(2)}}), std::invalid_argument);
+    // Keys which are not less-than comparable.
+    using ds_type = divisor_series<polynomial<rational, monomial<short>>, divisor<short>>;
+    ds_type a{"a"}, b{"b"};
+    const auto ds = (a + b) * 3 * math::invert(a) + (a - b) * math::invert(a + 2 * b) + 1;
+    frozen_series<ds_type> f4(ds);
+    BOOST_CHECK_EQUAL(f4.size(), ds.size());
+    BOOST_CHECK_EQUAL(f4.thaw(), ds);
+    for (const auto &t : ds._container()) {
+        BOOST_CHECK(f4.find(t) != f4.end());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(frozen_series_multiplier_test)
+{
+    {
+        // Integer coefficients and Kronecker monomials.
+        using p_type = polynomial<integer, k_monomial>;
+        using f_type = frozen_series<p_type>;
+        p_type x{"x"}, y{"y"}, z{"z"};
+        const auto a = (x + 2 * y - 3 * z + 1).pow(5), b = (x - y + z - 2).pow(4);
+        BOOST_CHECK_EQUAL(series_multiplier<p_type>(f_type(a), f_type(b))(), a * b);
+        BOOST_CHECK_EQUAL(series_multiplier<p_type>(f_type(b), f_type(a))(), a * b);
+        BOOST_CHECK_EQUAL(series_multiplier<p_type>(f_type(a), f_type(a))._untruncated_multiplication(), a * a);
+        // Empty operands.
+        const p_type e;
+        BOOST_CHECK_EQUAL(series_multiplier<p_type>(f_type(a), f_type(a * e))(), p_type{});
+        // Incompatible symbol sets.
+        BOOST_CHECK_THROW(series_multiplier<p_type>(f_type(a), f_type(x)), std::invalid_argument);
+    }
+    {
+        // Rational coefficients and monomials.
+        using p_type = polynomial<rational, monomial<int>>;
+        using f_type = frozen_series<p_type>;
+        p_type x{"x"}, y{"y"};
+        const auto a = (x / 2 + 2 * y / 3 - 1).pow(4), b = (x - y / 5 + 3).pow(3);
+        BOOST_CHECK_EQUAL(series_multiplier<p_type>(f_type(a), f_type(b))(), a * b);
+    }
+    {
+        // Floating-point coefficients: the zero is not absorbing.
+        using p_type = polynomial<double, k_monomial>;
+        using f_type = frozen_series<p_type>;
+        p_type x{"x"}, y{"y"};
+        const auto a = (x + 2 * y - 1).pow(3);
+        BOOST_CHECK_EQUAL(series_multiplier<p_type>(f_type(a), f_type(a))(), a * a);
+        p_type e;
+        e.set_symbol_set(a.get_symbol_set());
+        BOOST_CHECK_EQUAL(series_multiplier<p_type>(f_type(a), f_type(e))(), series_multiplier<p_type>(a, e)());
+    }
+    {
+        // Series with keys which are not less-than comparable.
+        using ds_type = divisor_series<polynomial<rational, monomial<short>>, divisor<short>>;
+        using f_type = frozen_series<ds_type>;
+        ds_type a{"a"}, b{"b"};
+        const auto d1 = (a + b) * 3 * math::invert(a) + 1, d2 = (a - b) * math::invert(a + 2 * b) + 2;
+        BOOST_CHECK_EQUAL(series_multiplier<ds_type>(f_type(d1), f_type(d2))(), series_multiplier<ds_type>(d1, d2)());
+    }
+}
+
+#if defined(PIRANHA_WITH_BOOST_S11N)
+
+BOOST_AUTO_TEST_CASE(frozen_series_boost_s11n_test)
+{
+    using p_type = polynomial<rational, k_monomial>;
+    using f_type = frozen_series<p_type>;
+    BOOST_CHECK((has_boost_save<boost::archive::binary_oarchive, f_type>::value));
+    BOOST_CHECK((has_boost_save<boost::archive::binary_oarchive &, const f_type &>::value));
+    BOOST_CHECK((!has_boost_save<boost::archive::binary_iarchive, f_type>::value));
+    BOOST_CHECK((has_boost_load<boost::archive::binary_iarchive, f_type>::value));
+    BOOST_CHECK((!has_boost_load<boost::archive::binary_iarchive &, const f_type &>::value));
+    BOOST_CHECK((!has_boost_load<boost::archive::binary_oarchive, f_type>::value));
+    p_type x{"x"}, y{"y"};
+    const auto p = (x / 3 + y - 1).pow(5);
+    const f_type f(p);
+    // Frozen series to frozen series.
+    {
+        std::stringstream ss;
+        {
+            boost::archive::binary_oarchive oa(ss);
+            boost_save(oa, f);
+        }
+        f_type retval;
+        boost::archive::binary_iarchive ia(ss);
+        boost_load(ia, retval);
+        BOOST_CHECK_EQUAL(retval.thaw(), p);
+    }
+    // The archive layout is the same as in the series.
+    {
+        std::stringstream ss;
+        {
+            boost::archive::binary_oarchive oa(ss);
+            boost_save(oa, f);
+        }
+        p_type retval;
+        boost::archive::binary_iarchive ia(ss);
+        boost_load(ia, retval);
+        BOOST_CHECK_EQUAL(retval, p);
+    }
+    {
+        std::stringstream ss;
+        {
+            boost::archive::binary_oarchive oa(ss);
+            boost_save(oa, p);
+        }
+        f_type retval;
+        boost::archive::binary_iarchive ia(ss);
+        boost_load(ia, retval);
+        BOOST_CHECK_EQUAL(retval.thaw(), p);
+    }
+}
+
+#endif
@@ -56,6 +56,7 @@ see https://www.gnu.org/licenses/. */
 #include <piranha/integer.hpp>
 #include <piranha/s11n.hpp>
 #include <piranha/thread_pool.hpp>
+#include <piranha/tuning.hpp>
 #include <piranha/type_traits.hpp>
 
 static const int ntries = 1000;
@@ -490,6 +491,23 @@ BOOST_AUTO_TEST_CASE(hash_set_erase_test)
     BOOST_CHECK_EQUAL(*it, 1u);
     it = h.erase(h.find(2u));
     BOOST_CHECK(it == h.end());
+    // Clear single buckets via the low-level interface.
+    h.clear();
+    h.rehash(4u);
+    h.insert(0u);
+    h.insert(4u);
+    h.insert(8u);
+    h.insert(1u);
+    h._clear_bucket(0u);
+    h._clear_bucket(2u);
+    h._update_size(1u);
+    BOOST_CHECK(h._get_bucket_list(0u).empty());
+    BOOST_CHECK(h.find(0u) == h.end());
+    BOOST_CHECK(h.find(4u) == h.end());
+    BOOST_CHECK(h.find(8u) == h.end());
+    BOOST_CHECK(h.find(1u) != h.end());
+    BOOST_CHECK(h.insert(4u).second);
+    BOOST_CHECK_EQUAL(h.size(), 2u);
 }
 
 struct clear_tester {
@@ -674,6 +692,133 @@ BOOST_AUTO_TEST_CASE(hash_set_mt_test)
     }
 }
 
+// A hash functor that maps runs of consecutive integers to the same value, so that
+// the bucket lists are forced to allocate overflow nodes.
+struct colliding_hash {
+    std::size_t operator()(const integer &n) const
+    {
+        return std::hash<integer>{}(n / 4);
+    }
+};
+
+// Number of elements in the arena test.
+static const int arena_size = 20000;
+
+template <typename H>
+static inline bool check_eq(const H &h1, const H &h2)
+{
+    if (h1.size() != h2.size()) {
+        return false;
+    }
+    for (const auto &x : h1) {
+        if (h2.find(x) == h2.end()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+BOOST_AUTO_TEST_CASE(hash_set_node_arena_test)
+{
+    using h_type = hash_set<integer, colliding_hash>;
+    const int size = arena_size;
+    tuning::set_node_arena(true);
+    // Serial insertion, lookup and erasure.
+    h_type h;
+    for (int i = 0; i < size; ++i) {
+        BOOST_CHECK(h.insert(integer(i)).second);
+    }
+    BOOST_CHECK_EQUAL(h.size(), unsigned(size));
+    BOOST_CHECK(h.bucket_count() >= 4096u);
+    for (int i = 0; i < size; ++i) {
+        BOOST_CHECK(h.find(integer(i)) != h.end());
+    }
+    for (int i = 0; i < size; i += 2) {
+        h.erase(h.find(integer(i)));
+    }
+    BOOST_CHECK_EQUAL(h.size(), unsigned(size / 2));
+    // Re-insertion will recycle the freed nodes.
+    for (int i = 0; i < size; ++i) {
+        h.insert(integer(i));
+    }
+    BOOST_CHECK_EQUAL(h.size(), unsigned(size));
+    // Copy, move and swap.
+    auto h2(h);
+    BOOST_CHECK_EQUAL(h2.size(), unsigned(size));
+    for (int i = 0; i < size; ++i) {
+        BOOST_CHECK(h2.find(integer(i)) != h2.end());
+    }
+    h_type h3(std::move(h2));
+    BOOST_CHECK_EQUAL(h3.size(), unsigned(size));
+    h3.insert(integer(size));
+    h_type h4;
+    h4.insert(integer(-1));
+    h4.swap(h3);
+    BOOST_CHECK_EQUAL(h4.size(), unsigned(size + 1));
+    BOOST_CHECK_EQUAL(h3.size(), 1u);
+    h3 = h4;
+    BOOST_CHECK_EQUAL(h3.size(), unsigned(size + 1));
+    h4 = std::move(h);
+    BOOST_CHECK_EQUAL(h4.size(), unsigned(size));
+    // Rehash and clear.
+    h4.rehash(h4.bucket_count() * 2u);
+    for (int i = 0; i < size; ++i) {
+        BOOST_CHECK(h4.find(integer(i)) != h4.end());
+    }
+    h4.clear();
+    BOOST_CHECK(h4.empty());
+    for (int i = 0; i < size; ++i) {
+        h4.insert(integer(i));
+    }
+    BOOST_CHECK_EQUAL(h4.size(), unsigned(size));
+    // Concurrent insertion in disjoint bucket ranges via the low-level interface.
+    thread_pool::resize(4u);
+    h_type h5(unsigned(size), colliding_hash{}, std::equal_to<integer>{}, 4u);
+    const auto bcount = h5.bucket_count();
+    future_list<void> ff;
+    for (unsigned t = 0u; t < 4u; ++t) {
+        ff.push_back(thread_pool::enqueue(t, [&h5, bcount, t]() {
+            const auto start = bcount / 4u * t, end = (t == 3u) ? bcount : bcount / 4u * (t + 1u);
+            for (int i = 0; i < arena_size; ++i) {
+                const integer n(i);
+                const auto idx = h5._bucket(n);
+                if (idx >= start && idx < end) {
+                    h5._unique_insert(n, idx);
+                }
+            }
+        }));
+    }
+    ff.wait_all();
+    ff.get_all();
+    h5._update_size(unsigned(size));
+    BOOST_CHECK(check_eq(h5, h4));
+    tuning::reset_node_arena();
+    // Sets without an arena interoperate with sets using it.
+    h_type h6;
+    for (int i = 0; i < size; ++i) {
+        h6.insert(integer(i));
+    }
+    BOOST_CHECK(check_eq(h5, h6));
+    h6 = std::move(h5);
+    for (int i = 0; i < size; i += 3) {
+        h6.erase(h6.find(integer(i)));
+    }
+    BOOST_CHECK_EQUAL(h6.size(), unsigned(size - (size + 2) / 3));
+    // Clear the buckets one by one, with the nodes being returned to the arena.
+    tuning::set_node_arena(true);
+    h_type h7(h4);
+    for (decltype(h7.bucket_count()) i = 0u; i < h7.bucket_count(); ++i) {
+        h7._clear_bucket(i);
+    }
+    h7._update_size(0u);
+    BOOST_CHECK(h7.begin() == h7.end());
+    for (int i = 0; i < size; ++i) {
+        h7.insert(integer(i));
+    }
+    BOOST_CHECK(check_eq(h7, h4));
+    tuning::reset_node_arena();
+}
+
 #if defined(PIRANHA_WITH_BOOST_S11N)
 
 BOOST_AUTO_TEST_CASE(hash_set_serialization_test)
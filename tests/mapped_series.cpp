@@ -0,0 +1,249 @@
+/* Copyright 2009-2017 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#include <piranha/mapped_series.hpp>
+
+#define BOOST_TEST_MODULE mapped_series_test
+#include <boost/test/included/unit_test.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <ios>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <boost/algorithm/string/predicate.hpp>
+
+#include <piranha/detail/flat_format.hpp>
+#include <piranha/exceptions.hpp>
+#include <piranha/integer.hpp>
+#include <piranha/kronecker_monomial.hpp>
+#include <piranha/math.hpp>
+#include <piranha/poisson_series.hpp>
+#include <piranha/polynomial.hpp>
+#include <piranha/real_trigonometric_kronecker_monomial.hpp>
+#include <piranha/s11n.hpp>
+#include <piranha/symbol_utils.hpp>
+
+using namespace piranha;
+
+static std::random_device rd;
+
+// Small raii class for creating a tmp file.
+struct tmp_file {
+    tmp_file() : m_path(PIRANHA_BINARY_TESTS_DIR "/" + std::to_string(rd())) {}
+    ~tmp_file()
+    {
+        std::remove(m_path.c_str());
+    }
+    std::string m_path;
+};
+
+// Overwrite the bytes of a file starting at offset with the object representation of x.
+template <typename T>
+static void patch_file(const std::string &filename, std::uint64_t offset, const T &x)
+{
+    std::fstream f(filename, std::ios::in | std::ios::out | std::ios::binary);
+    f.seekp(static_cast<std::streamoff>(offset));
+    char buffer[sizeof(T)];
+    std::memcpy(buffer, static_cast<const void *>(&x), sizeof(T));
+    f.write(buffer, static_cast<std::streamsize>(sizeof(T)));
+}
+
+BOOST_AUTO_TEST_CASE(mapped_series_polynomial_test)
+{
+    using p_type = polynomial<double, k_monomial>;
+    using m_type = mapped_series<p_type>;
+    m_type m0;
+    BOOST_CHECK(m0.empty());
+    BOOST_CHECK_EQUAL(m0.size(), 0u);
+    BOOST_CHECK(m0.begin() == m0.end());
+    BOOST_CHECK_EQUAL(m0.thaw(), p_type{});
+    p_type x{"x"}, y{"y"}, z{"z"};
+    const auto p = (x + 2 * y - 3 * z + 1).pow(8);
+    tmp_file file;
+    save_file(p, file.m_path, data_format::flat_binary, compression::none);
+    m_type m1(file.m_path);
+    BOOST_CHECK(!m1.empty());
+    BOOST_CHECK_EQUAL(m1.size(), p.size());
+    BOOST_CHECK(m1.get_symbol_set() == p.get_symbol_set());
+    BOOST_CHECK_EQUAL(std::distance(m1.begin(), m1.end()), static_cast<std::ptrdiff_t>(p.size()));
+    for (const auto &t : m1) {
+        const auto it = p._container().find(t);
+        BOOST_CHECK(it != p._container().end());
+        BOOST_CHECK_EQUAL(it->m_cf, t.m_cf);
+    }
+    BOOST_CHECK_EQUAL(m1.thaw(), p);
+    // Copies share the view of the file.
+    auto m2(m1);
+    BOOST_CHECK_EQUAL(m2.thaw(), p);
+    m2 = m_type{};
+    BOOST_CHECK(m2.empty());
+    m2 = std::move(m1);
+    BOOST_CHECK_EQUAL(m2.thaw(), p);
+    // Evaluation.
+    const symbol_fmap<double> d{{"x", 1.5}, {"y", -.5}, {"z", .25}};
+    BOOST_CHECK_CLOSE(m2.evaluate(d), math::evaluate(p, d), 1E-8);
+    BOOST_CHECK_THROW(m2.evaluate(symbol_fmap<double>{{"x", 1.}}), std::invalid_argument);
+    // Load via load_file().
+    p_type p2;
+    load_file(p2, file.m_path, data_format::flat_binary, compression::none);
+    BOOST_CHECK_EQUAL(p2, p);
+    // Empty series.
+    save_file(p_type{}, file.m_path, data_format::flat_binary, compression::none);
+    BOOST_CHECK(m_type(file.m_path).empty());
+    load_file(p2, file.m_path, data_format::flat_binary, compression::none);
+    BOOST_CHECK_EQUAL(p2, p_type{});
+    // Filename deduction.
+    tmp_file file2;
+    const auto fn = file2.m_path + ".flatb";
+    save_file(p, fn);
+    load_file(p2, fn);
+    BOOST_CHECK_EQUAL(p2, p);
+    std::remove(fn.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(mapped_series_poisson_series_test)
+{
+    using ps_type = poisson_series<double>;
+    using term_type = ps_type::term_type;
+    using key_type = term_type::key_type;
+    std::mt19937 rng;
+    std::uniform_int_distribution<int> idist(-10, 10), pdist(1, 10);
+    std::uniform_real_distribution<double> cdist(-1., 1.);
+    ps_type p;
+    p.set_symbol_set(symbol_fset{"x", "y", "z"});
+    // NOTE: the first multiplier is positive, so that the keys are in canonical form.
+    for (int i = 0; i < 1000; ++i) {
+        p.insert(term_type(cdist(rng), key_type({pdist(rng), idist(rng), idist(rng)}, idist(rng) > 0)));
+    }
+    tmp_file file;
+    save_file(p, file.m_path, data_format::flat_binary, compression::none);
+    mapped_series<ps_type> m(file.m_path);
+    BOOST_CHECK_EQUAL(m.size(), p.size());
+    BOOST_CHECK(m.get_symbol_set() == p.get_symbol_set());
+    BOOST_CHECK_EQUAL(m.thaw(), p);
+    const symbol_fmap<double> d{{"x", .3}, {"y", -1.2}, {"z", 2.}};
+    BOOST_CHECK_CLOSE(m.evaluate(d), math::evaluate(p, d), 1E-8);
+}
+
+BOOST_AUTO_TEST_CASE(mapped_series_failures_test)
+{
+    using p_type = polynomial<double, k_monomial>;
+    p_type x{"x"}, y{"y"};
+    const auto p = (x - y + 1).pow(4);
+    // No compression support.
+    BOOST_CHECK_EXCEPTION(save_file(p, "foo", data_format::flat_binary, compression::gzip), not_implemented_error,
+                          [](const not_implemented_error &nie) {
+                              return boost::contains(nie.what(), "the flat data format does not support compression");
+                          });
+    // Unsupported types.
+    BOOST_CHECK_EXCEPTION(save_file(42, "foo", data_format::flat_binary, compression::none), not_implemented_error,
+                          [](const not_implemented_error &nie) {
+                              return boost::contains(nie.what(), "does not support serialization via the flat");
+                          });
+    polynomial<integer, k_monomial> pi;
+    BOOST_CHECK_THROW(load_file(pi, "foo", data_format::flat_binary, compression::none), not_implemented_error);
+    // Non-existing file.
+    BOOST_CHECK_EXCEPTION(mapped_series<p_type>{"foobar123"}, std::runtime_error, [](const std::runtime_error &re) {
+        return boost::contains(re.what(), "file 'foobar123' could not be opened for loading");
+    });
+    // Mismatched types.
+    tmp_file file;
+    save_file(p, file.m_path, data_format::flat_binary, compression::none);
+    BOOST_CHECK_EXCEPTION(mapped_series<polynomial<float, k_monomial>>{file.m_path}, std::invalid_argument,
+                          [](const std::invalid_argument &ia) {
+                              return boost::contains(ia.what(), "different coefficient or key types");
+                          });
+    // Truncated file.
+    {
+        std::ifstream ifile(file.m_path, std::ios::in | std::ios::binary);
+        std::string content{std::istreambuf_iterator<char>(ifile), std::istreambuf_iterator<char>()};
+        ifile.close();
+        std::ofstream ofile(file.m_path, std::ios::out | std::ios::binary | std::ios::trunc);
+        ofile.write(content.data(), static_cast<std::streamsize>(content.size() - 1u));
+    }
+    BOOST_CHECK_EXCEPTION(mapped_series<p_type>{file.m_path}, std::invalid_argument,
+                          [](const std::invalid_argument &ia) { return boost::contains(ia.what(), "not consistent"); });
+    // Not a flat file.
+    {
+        std::ofstream ofile(file.m_path, std::ios::out | std::ios::binary | std::ios::trunc);
+        ofile << "hello world";
+    }
+    BOOST_CHECK_EXCEPTION(mapped_series<p_type>{file.m_path}, std::invalid_argument,
+                          [](const std::invalid_argument &ia) { return boost::contains(ia.what(), "too small"); });
+}
+
+BOOST_AUTO_TEST_CASE(mapped_series_corrupted_test)
+{
+    using p_type = polynomial<double, k_monomial>;
+    using packed_type = flat_key_packed_t<k_monomial>;
+    p_type x{"x"}, y{"y"};
+    const auto p = x + 2 * y;
+    // Size of the serialised symbol set {x,y}.
+    const std::uint64_t symbols_size = 2u * (sizeof(std::uint64_t) + 1u);
+    const auto layout = flat_compute_layout<packed_type, double>(symbols_size, 2u);
+    tmp_file file;
+    // Duplicate terms.
+    save_file(p, file.m_path, data_format::flat_binary, compression::none);
+    {
+        const mapped_series<p_type> m(file.m_path);
+        patch_file(file.m_path, layout.m_keys_offset + sizeof(packed_type),
+                   flat_key<k_monomial>::pack(m.begin()->m_key));
+    }
+    BOOST_CHECK_EXCEPTION(mapped_series<p_type>{file.m_path}.thaw(), std::invalid_argument,
+                          [](const std::invalid_argument &ia) {
+                              return boost::contains(ia.what(), "cannot load a duplicate term from a flat file");
+                          });
+    p_type p2;
+    BOOST_CHECK_EXCEPTION(load_file(p2, file.m_path, data_format::flat_binary, compression::none),
+                          std::invalid_argument, [](const std::invalid_argument &ia) {
+                              return boost::contains(ia.what(), "cannot load a duplicate term from a flat file");
+                          });
+    BOOST_CHECK(p2.empty());
+    // Keys incompatible with the symbol set.
+    save_file(p, file.m_path, data_format::flat_binary, compression::none);
+    patch_file(file.m_path, layout.m_keys_offset, std::numeric_limits<packed_type>::max());
+    BOOST_CHECK_EXCEPTION(mapped_series<p_type>{file.m_path}.thaw(), std::invalid_argument,
+                          [](const std::invalid_argument &ia) {
+                              return boost::contains(ia.what(), "cannot load an incompatible term from a flat file");
+                          });
+    // Zero coefficients are discarded.
+    save_file(p, file.m_path, data_format::flat_binary, compression::none);
+    patch_file(file.m_path, layout.m_cfs_offset, 0.);
+    const auto p3 = mapped_series<p_type>{file.m_path}.thaw();
+    BOOST_CHECK_EQUAL(p3.size(), 1u);
+    BOOST_CHECK(p3 == x || p3 == 2 * y);
+}
@@ -0,0 +1,196 @@
+/* Copyright 2009-2017 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#include <piranha/oa_hash_set.hpp>
+
+#define BOOST_TEST_MODULE oa_hash_set_test
+#include <boost/test/included/unit_test.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+#include <utility>
+
+#include <piranha/config.hpp>
+#include <piranha/exceptions.hpp>
+#include <piranha/type_traits.hpp>
+
+static const int ntries = 1000;
+
+using namespace piranha;
+
+static std::mt19937 rng;
+
+// A poor hasher, generating many collisions.
+struct bad_hasher {
+    std::size_t operator()(int n) const
+    {
+        return static_cast<std::size_t>(n / 7);
+    }
+};
+
+// Check the content of an oa_hash_set against a reference set.
+template <typename Set>
+static bool check_content(const Set &s, const std::unordered_set<int> &ref)
+{
+    if (s.size() != ref.size()) {
+        return false;
+    }
+    std::size_t count = 0u;
+    for (const auto &n : s) {
+        if (!ref.count(n)) {
+            return false;
+        }
+        ++count;
+    }
+    for (const auto &n : ref) {
+        if (s.find(n) == s.end()) {
+            return false;
+        }
+    }
+    return count == ref.size();
+}
+
+BOOST_AUTO_TEST_CASE(oa_hash_set_constructors_test)
+{
+    using set_type = oa_hash_set<int>;
+    set_type s0;
+    BOOST_CHECK(s0.empty());
+    BOOST_CHECK_EQUAL(s0.size(), 0u);
+    BOOST_CHECK_EQUAL(s0.bucket_count(), 0u);
+    BOOST_CHECK(s0.begin() == s0.end());
+    BOOST_CHECK(s0.find(42) == s0.end());
+    BOOST_CHECK_THROW(s0.bucket(42), std::invalid_argument);
+    BOOST_CHECK_EQUAL(s0.load_factor(), 0.);
+    set_type s1(100u);
+    BOOST_CHECK_EQUAL(s1.bucket_count(), 128u);
+    BOOST_CHECK(s1.empty());
+    for (int i = 0; i < 100; ++i) {
+        BOOST_CHECK(s1.insert(i).second);
+    }
+    BOOST_CHECK(!s1.insert(42).second);
+    BOOST_CHECK_EQUAL(s1.size(), 100u);
+    BOOST_CHECK(s1.load_factor() <= s1.max_load_factor());
+    auto s2(s1);
+    BOOST_CHECK_EQUAL(s2.size(), 100u);
+    BOOST_CHECK_EQUAL(s2.bucket_count(), s1.bucket_count());
+    for (int i = 0; i < 100; ++i) {
+        BOOST_CHECK(s2.find(i) != s2.end());
+    }
+    auto s3(std::move(s2));
+    BOOST_CHECK_EQUAL(s3.size(), 100u);
+    BOOST_CHECK_EQUAL(s2.size(), 0u);
+    BOOST_CHECK_EQUAL(s2.bucket_count(), 0u);
+    s2 = s3;
+    BOOST_CHECK_EQUAL(s2.size(), 100u);
+    s2 = std::move(s3);
+    BOOST_CHECK_EQUAL(s2.size(), 100u);
+    BOOST_CHECK(s3.empty());
+    s2.swap(s3);
+    BOOST_CHECK(s2.empty());
+    BOOST_CHECK_EQUAL(s3.size(), 100u);
+    s3.clear();
+    BOOST_CHECK(s3.empty());
+    BOOST_CHECK_EQUAL(s3.bucket_count(), 0u);
+    // Non-trivial types.
+    oa_hash_set<std::string> s4;
+    BOOST_CHECK(s4.insert(std::string("hello")).second);
+    BOOST_CHECK(s4.insert(std::string("world")).second);
+    BOOST_CHECK(!s4.insert(std::string("hello")).second);
+    BOOST_CHECK_EQUAL(s4.size(), 2u);
+    const auto s5(s4);
+    BOOST_CHECK(s5.find("world") != s5.end());
+}
+
+BOOST_AUTO_TEST_CASE(oa_hash_set_random_test)
+{
+    std::uniform_int_distribution<int> dist(0, 2000);
+    oa_hash_set<int, bad_hasher> s;
+    std::unordered_set<int> ref;
+    for (int i = 0; i < ntries; ++i) {
+        const auto n = dist(rng);
+        const auto ret = s.insert(n);
+        BOOST_CHECK_EQUAL(ret.second, ref.insert(n).second);
+        BOOST_CHECK_EQUAL(*ret.first, n);
+        BOOST_CHECK(s.load_factor() <= s.max_load_factor());
+    }
+    BOOST_CHECK(check_content(s, ref));
+    // Erase half the elements.
+    for (int i = 0; i < ntries / 2; ++i) {
+        const auto n = dist(rng);
+        const auto it = s.find(n);
+        BOOST_CHECK_EQUAL(it != s.end(), ref.count(n) == 1u);
+        if (it != s.end()) {
+            s.erase(it);
+            ref.erase(n);
+        }
+    }
+    BOOST_CHECK(check_content(s, ref));
+    // Rehash up and down.
+    s.rehash(s.bucket_count() * 4u);
+    BOOST_CHECK(check_content(s, ref));
+    s.rehash(1u);
+    BOOST_CHECK(check_content(s, ref));
+    s.rehash(0u);
+    BOOST_CHECK(check_content(s, ref));
+}
+
+BOOST_AUTO_TEST_CASE(oa_hash_set_low_level_test)
+{
+    std::uniform_int_distribution<int> dist(-1000, 1000);
+    oa_hash_set<int, bad_hasher> s(4u);
+    std::unordered_set<int> ref;
+    for (int i = 0; i < ntries; ++i) {
+        const auto n = dist(rng);
+        // NOTE: _unique_insert() will grow the table as needed.
+        const auto b_idx = s._bucket(n);
+        BOOST_CHECK(b_idx < s.bucket_count());
+        BOOST_CHECK_EQUAL(b_idx, s._bucket_from_hash(bad_hasher{}(n)));
+        if (s._find(n, b_idx) == s.end()) {
+            const auto it = s._unique_insert(n, b_idx);
+            BOOST_CHECK_EQUAL(*it, n);
+            ref.insert(n);
+        } else {
+            BOOST_CHECK(ref.count(n) == 1u);
+        }
+    }
+    BOOST_CHECK(check_content(s, ref));
+    BOOST_CHECK(s.load_factor() <= s.max_load_factor());
+    s._increase_size();
+    BOOST_CHECK(check_content(s, ref));
+}
+
+BOOST_AUTO_TEST_CASE(oa_hash_set_type_traits_test)
+{
+    BOOST_CHECK(is_forward_iterator<oa_hash_set<int>::iterator>::value);
+    BOOST_CHECK(is_forward_iterator<oa_hash_set<int>::const_iterator>::value);
+}
@@ -0,0 +1,488 @@
+/* Copyright 2009-2017 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#include <piranha/packed_divisor.hpp>
+
+#define BOOST_TEST_MODULE packed_divisor_test
+#include <boost/test/included/unit_test.hpp>
+
+#include <array>
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/lexical_cast.hpp>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <piranha/divisor.hpp>
+#include <piranha/divisor_series.hpp>
+#include <piranha/invert.hpp>
+#include <piranha/is_key.hpp>
+#include <piranha/key/key_is_one.hpp>
+#include <piranha/key_is_convertible.hpp>
+#include <piranha/key_is_multipliable.hpp>
+#include <piranha/kronecker_array.hpp>
+#include <piranha/math.hpp>
+#include <piranha/math/pow.hpp>
+#include <piranha/monomial.hpp>
+#include <piranha/polynomial.hpp>
+#include <piranha/rational.hpp>
+#include <piranha/s11n.hpp>
+#include <piranha/symbol_utils.hpp>
+#include <piranha/term.hpp>
+#include <piranha/type_traits.hpp>
+
+using namespace piranha;
+
+using value_types = std::tuple<int, long, long long>;
+
+struct basic_tester {
+    template <typename T>
+    void operator()(const T &) const
+    {
+        using d_type = packed_divisor<T>;
+        BOOST_CHECK(is_key<d_type>::value);
+        BOOST_CHECK(is_container_element<d_type>::value);
+        BOOST_CHECK((key_is_convertible<d_type, divisor<T>>::value));
+        BOOST_CHECK((key_is_multipliable<rational, d_type>::value));
+        const symbol_fset ss{"x", "y"};
+        std::vector<T> tmp;
+        d_type d0;
+        BOOST_CHECK_EQUAL(d0.size(), 0u);
+        BOOST_CHECK(key_is_one(d0, ss));
+        BOOST_CHECK_EQUAL(d0.hash(), 0u);
+        BOOST_CHECK(d0.is_compatible(symbol_fset{}));
+        // Canonical form checks.
+        tmp = {T(-1), T(2)};
+        BOOST_CHECK_THROW(d0.insert(tmp.begin(), tmp.end(), 1), std::invalid_argument);
+        tmp = {T(2), T(4)};
+        BOOST_CHECK_THROW(d0.insert(tmp.begin(), tmp.end(), 1), std::invalid_argument);
+        tmp = {T(0), T(0)};
+        BOOST_CHECK_THROW(d0.insert(tmp.begin(), tmp.end(), 1), std::invalid_argument);
+        tmp = {T(1), T(2)};
+        BOOST_CHECK_THROW(d0.insert(tmp.begin(), tmp.end(), 0), std::invalid_argument);
+        // Values outside the Kronecker limits.
+        const auto lim = std::get<0u>(kronecker_array<T>::get_limits()[2u])[0u];
+        tmp = {T(1), static_cast<T>(lim + 1)};
+        BOOST_CHECK_THROW(d0.insert(tmp.begin(), tmp.end(), 1), std::invalid_argument);
+        BOOST_CHECK_EQUAL(d0.size(), 0u);
+        // Insertion and exponent update.
+        tmp = {T(1), T(2)};
+        d0.insert(tmp.begin(), tmp.end(), 1);
+        BOOST_CHECK_EQUAL(d0.size(), 1u);
+        BOOST_CHECK(!key_is_one(d0, ss));
+        BOOST_CHECK_EQUAL(d0.hash(), static_cast<std::size_t>(kronecker_array<T>::encode(tmp)));
+        BOOST_CHECK_EQUAL(d0.hash(), std::hash<d_type>{}(d0));
+        d0.insert(tmp.begin(), tmp.end(), 2);
+        BOOST_CHECK_EQUAL(d0.size(), 1u);
+        BOOST_CHECK_EQUAL(d0._container()[0u].e, 3);
+        d0.insert(tmp.begin(), tmp.end(), std::numeric_limits<T>::max() - 3);
+        BOOST_CHECK_THROW(d0.insert(tmp.begin(), tmp.end(), 1), std::invalid_argument);
+        // Equality and hashing do not depend on the insertion order.
+        d_type d1, d2;
+        const std::vector<std::vector<T>> factors{{T(1), T(-2)}, {T(0), T(1)}, {T(3), T(1)}, {T(1), T(0)}};
+        for (const auto &f : factors) {
+            d1.insert(f.begin(), f.end(), 1);
+        }
+        for (auto it = factors.rbegin(); it != factors.rend(); ++it) {
+            d2.insert(it->begin(), it->end(), 1);
+        }
+        BOOST_CHECK(d1 == d2);
+        BOOST_CHECK_EQUAL(d1.hash(), d2.hash());
+        BOOST_CHECK(d1.is_compatible(ss));
+        d2.insert(factors[0u].begin(), factors[0u].end(), 1);
+        BOOST_CHECK(d1 != d2);
+        d2.clear();
+        BOOST_CHECK_EQUAL(d2.size(), 0u);
+        // Conversion from and to divisor.
+        divisor<T> dd;
+        for (const auto &f : factors) {
+            dd.insert(f.begin(), f.end(), 2);
+        }
+        d_type d3(dd, ss);
+        BOOST_CHECK_EQUAL(d3.size(), 4u);
+        BOOST_CHECK(d3.to_divisor(ss) == dd);
+        BOOST_CHECK_THROW((d_type{dd, symbol_fset{"x"}}), std::invalid_argument);
+        BOOST_CHECK_THROW(d3.to_divisor(symbol_fset{}), std::invalid_argument);
+    }
+};
+
+BOOST_AUTO_TEST_CASE(packed_divisor_basic_test)
+{
+    tuple_for_each(value_types{}, basic_tester{});
+}
+
+struct key_ops_tester {
+    template <typename T>
+    void operator()(const T &) const
+    {
+        using d_type = packed_divisor<T>;
+        const symbol_fset ss{"x", "y"};
+        std::vector<T> tmp;
+        // Printing.
+        d_type d0;
+        tmp = {T(1), T(-1)};
+        d0.insert(tmp.begin(), tmp.end(), 2);
+        std::ostringstream oss;
+        d0.print(oss, ss);
+        BOOST_CHECK_EQUAL(oss.str(), "1/[(x-y)**2]");
+        oss.str("");
+        d0.print_tex(oss, ss);
+        BOOST_CHECK_EQUAL(oss.str(), "\\frac{1}{\\left(x-y\\right)^{2}}");
+        BOOST_CHECK_THROW(d0.print(oss, symbol_fset{"x"}), std::invalid_argument);
+        // Evaluation.
+        BOOST_CHECK_EQUAL(d0.evaluate(std::vector<rational>{rational{3}, rational{1}}, ss), rational(1, 4));
+        BOOST_CHECK_THROW(d0.evaluate(std::vector<rational>{rational{3}}, ss), std::invalid_argument);
+        // Multiplication.
+        using term_type = term<rational, d_type>;
+        d_type d1;
+        tmp = {T(0), T(1)};
+        d1.insert(tmp.begin(), tmp.end(), 1);
+        tmp = {T(1), T(-1)};
+        d1.insert(tmp.begin(), tmp.end(), 1);
+        std::array<term_type, 1u> res;
+        d_type::multiply(res, term_type{rational{2}, d0}, term_type{rational{3}, d1}, ss);
+        BOOST_CHECK_EQUAL(res[0u].m_cf, 6);
+        d_type cmp(d1);
+        tmp = {T(1), T(-1)};
+        cmp.insert(tmp.begin(), tmp.end(), 2);
+        BOOST_CHECK(res[0u].m_key == cmp);
+        BOOST_CHECK(res[0u].m_key.to_divisor(ss) == cmp.to_divisor(ss));
+        // Merge symbols.
+        const auto d2 = d1.merge_symbols({{0u, symbol_fset{"a"}}}, ss);
+        divisor<T> dd;
+        tmp = {T(0), T(0), T(1)};
+        dd.insert(tmp.begin(), tmp.end(), 1);
+        tmp = {T(0), T(1), T(-1)};
+        dd.insert(tmp.begin(), tmp.end(), 1);
+        BOOST_CHECK(d2 == d_type(dd, symbol_fset{"a", "x", "y"}));
+        // Trim.
+        std::vector<char> mask{1, 1, 1};
+        d2.trim_identify(mask, symbol_fset{"a", "x", "y"});
+        BOOST_CHECK((mask == std::vector<char>{1, 0, 0}));
+        BOOST_CHECK(d2.trim(mask, symbol_fset{"a", "x", "y"}) == d1);
+        BOOST_CHECK_THROW(d2.trim(mask, ss), std::invalid_argument);
+        // Split.
+        const auto sp = d1.split(0u, ss);
+        d_type sp_first, sp_second;
+        tmp = {T(1), T(-1)};
+        sp_first.insert(tmp.begin(), tmp.end(), 1);
+        tmp = {T(0), T(1)};
+        sp_second.insert(tmp.begin(), tmp.end(), 1);
+        BOOST_CHECK(sp.first == sp_first);
+        BOOST_CHECK(sp.second == sp_second);
+        BOOST_CHECK_THROW(d1.split(2u, ss), std::invalid_argument);
+    }
+};
+
+BOOST_AUTO_TEST_CASE(packed_divisor_key_ops_test)
+{
+    tuple_for_each(value_types{}, key_ops_tester{});
+}
+
+struct series_tester {
+    template <typename T>
+    void operator()(const T &) const
+    {
+        using p_type = polynomial<rational, monomial<int>>;
+        using ds_type = divisor_series<p_type, divisor<T>>;
+        using ps_type = divisor_series<p_type, packed_divisor<T>>;
+        ds_type x{"x"}, y{"y"}, z{"z"};
+        // Build a few series with nontrivial divisors and check that packed and unpacked keys agree.
+        const std::vector<ds_type> v{x, x * y.invert(), (x + 2 * y).invert() * math::invert(y - z) * 3,
+                                     piranha::pow(math::invert(x - y), 2) * math::invert(2 * x + z) + z,
+                                     x * math::invert(y) * math::invert(z) * math::invert(y + z)};
+        for (const auto &a : v) {
+            const ps_type pa(a);
+            BOOST_CHECK_EQUAL(pa.size(), a.size());
+            BOOST_CHECK((std::is_same<decltype(math::invert(pa)), ps_type>::value));
+            for (const auto &b : v) {
+                const ps_type pb(b);
+                BOOST_CHECK_EQUAL(pa * pb, ps_type(a * b));
+                BOOST_CHECK_EQUAL(pa + pb, ps_type(a + b));
+            }
+            for (const auto &s : {"x", "y", "z", "t"}) {
+                BOOST_CHECK_EQUAL(math::partial(pa, s), ps_type(math::partial(a, s)));
+            }
+        }
+        // Inversion.
+        BOOST_CHECK_EQUAL(math::invert(ps_type{"x"} + 2 * ps_type{"y"}), ps_type(math::invert(x + 2 * y)));
+        BOOST_CHECK_EQUAL(boost::lexical_cast<std::string>(math::invert(2 * ps_type{"x"} - 2 * ps_type{"y"})),
+                          "1/2*1/[(x-y)]");
+        // Integration.
+        const ps_type px(x), py(y);
+        BOOST_CHECK_EQUAL(math::integrate(px + math::invert(py), "x"), px * px / 2 + px * math::invert(py));
+        BOOST_CHECK_THROW(math::integrate(px + math::invert(py) + math::invert(px), "x"), std::invalid_argument);
+    }
+};
+
+BOOST_AUTO_TEST_CASE(packed_divisor_series_test)
+{
+    tuple_for_each(value_types{}, series_tester{});
+}
+
+#if defined(PIRANHA_WITH_BOOST_S11N) || defined(PIRANHA_WITH_MSGPACK)
+
+// A few divisors in two and three variables, for the s11n tests.
+template <typename T>
+static inline std::vector<std::pair<packed_divisor<T>, symbol_fset>> s11n_divisors()
+{
+    std::vector<std::pair<packed_divisor<T>, symbol_fset>> retval;
+    retval.emplace_back(packed_divisor<T>{}, symbol_fset{});
+    retval.emplace_back(packed_divisor<T>{}, symbol_fset{"x", "y"});
+    packed_divisor<T> d;
+    std::vector<T> tmp{T(1), T(-2)};
+    d.insert(tmp.begin(), tmp.end(), 3);
+    tmp = {T(0), T(1)};
+    d.insert(tmp.begin(), tmp.end(), 1);
+    retval.emplace_back(d, symbol_fset{"x", "y"});
+    d.clear();
+    tmp = {T(1), T(0), T(-1)};
+    d.insert(tmp.begin(), tmp.end(), 2);
+    tmp = {T(3), T(1), T(2)};
+    d.insert(tmp.begin(), tmp.end(), 1);
+    tmp = {T(0), T(0), T(1)};
+    d.insert(tmp.begin(), tmp.end(), 5);
+    retval.emplace_back(d, symbol_fset{"x", "y", "z"});
+    return retval;
+}
+
+#endif
+
+#if defined(PIRANHA_WITH_BOOST_S11N)
+
+template <typename OArchive, typename IArchive, typename T>
+static inline void boost_round_trip(const T &d, const symbol_fset &s)
+{
+    using w_type = boost_s11n_key_wrapper<T>;
+    {
+        std::stringstream ss;
+        {
+            OArchive oa(ss);
+            boost_save(oa, w_type{d, s});
+        }
+        T retval;
+        {
+            IArchive ia(ss);
+            w_type w{retval, s};
+            boost_load(ia, w);
+        }
+        BOOST_CHECK(retval == d);
+    }
+    {
+        std::stringstream ss;
+        {
+            OArchive oa(ss);
+            w_type w{d, s};
+            oa << w;
+        }
+        T retval;
+        {
+            IArchive ia(ss);
+            w_type w{retval, s};
+            ia >> w;
+        }
+        BOOST_CHECK(retval == d);
+    }
+}
+
+struct boost_s11n_tester {
+    template <typename T>
+    void operator()(const T &) const
+    {
+        using d_type = packed_divisor<T>;
+        using w_type = boost_s11n_key_wrapper<d_type>;
+        BOOST_CHECK((has_boost_save<boost::archive::binary_oarchive, w_type>::value));
+        BOOST_CHECK((has_boost_save<boost::archive::binary_oarchive &, const w_type &>::value));
+        BOOST_CHECK((!has_boost_save<const boost::archive::binary_oarchive &, const w_type &>::value));
+        BOOST_CHECK((!has_boost_save<boost::archive::binary_iarchive, w_type>::value));
+        BOOST_CHECK((has_boost_load<boost::archive::binary_iarchive, w_type>::value));
+        BOOST_CHECK((has_boost_load<boost::archive::binary_iarchive &, w_type>::value));
+        BOOST_CHECK((!has_boost_load<boost::archive::binary_iarchive &, const w_type &>::value));
+        BOOST_CHECK((!has_boost_load<boost::archive::binary_oarchive, w_type>::value));
+        for (const auto &p : s11n_divisors<T>()) {
+            boost_round_trip<boost::archive::binary_oarchive, boost::archive::binary_iarchive>(p.first, p.second);
+            boost_round_trip<boost::archive::text_oarchive, boost::archive::text_iarchive>(p.first, p.second);
+            if (p.first.size() == 0u) {
+                continue;
+            }
+            // Error handling with invalid symbol sets.
+            std::stringstream sst;
+            {
+                boost::archive::binary_oarchive oa(sst);
+                BOOST_CHECK_EXCEPTION(boost_save(oa, w_type{p.first, symbol_fset{}}), std::invalid_argument,
+                                      [](const std::invalid_argument &iae) {
+                                          return boost::contains(
+                                              iae.what(), "an invalid symbol_set was passed as an argument during the "
+                                                          "Boost serialization of a packed divisor");
+                                      });
+            }
+            sst.str("");
+            sst.clear();
+            {
+                boost::archive::binary_oarchive oa(sst);
+                boost_save(oa, w_type{p.first, p.second});
+            }
+            d_type d(p.first);
+            {
+                boost::archive::binary_iarchive ia(sst);
+                const symbol_fset empty;
+                w_type w{d, empty};
+                BOOST_CHECK_EXCEPTION(boost_load(ia, w), std::invalid_argument, [](const std::invalid_argument &iae) {
+                    return boost::contains(iae.what(), "the packed divisor loaded from a Boost archive is not "
+                                                       "compatible with the supplied symbol set");
+                });
+                BOOST_CHECK_EQUAL(d.size(), 0u);
+            }
+        }
+        // Malformed data: a non-canonical factor and a zero exponent.
+        const symbol_fset ss{"x", "y"};
+        for (const auto &f : {std::make_pair(std::vector<T>{T(2), T(4)}, T(1)),
+                              std::make_pair(std::vector<T>{T(1), T(2)}, T(0))}) {
+            std::stringstream sst;
+            {
+                boost::archive::binary_oarchive oa(sst);
+                small_vector<packed_divisor_p_type<T>> c;
+                c.push_back(packed_divisor_p_type<T>{kronecker_array<T>::encode(f.first), f.second});
+                boost_save(oa, c);
+            }
+            d_type d;
+            {
+                boost::archive::binary_iarchive ia(sst);
+                w_type w{d, ss};
+                BOOST_CHECK_EXCEPTION(boost_load(ia, w), std::invalid_argument, [](const std::invalid_argument &iae) {
+                    return boost::contains(iae.what(), "the packed divisor loaded from a Boost archive failed internal "
+                                                       "consistency checks");
+                });
+            }
+            BOOST_CHECK(d == d_type{});
+        }
+    }
+};
+
+BOOST_AUTO_TEST_CASE(packed_divisor_boost_s11n_test)
+{
+    tuple_for_each(value_types{}, boost_s11n_tester{});
+}
+
+#endif
+
+#if defined(PIRANHA_WITH_MSGPACK)
+
+template <typename T>
+static inline void msgpack_round_trip(const T &d, const symbol_fset &s, msgpack_format f)
+{
+    msgpack::sbuffer sbuf;
+    msgpack::packer<msgpack::sbuffer> p(sbuf);
+    d.msgpack_pack(p, f, s);
+    auto oh = msgpack::unpack(sbuf.data(), sbuf.size());
+    T retval;
+    retval.msgpack_convert(oh.get(), f, s);
+    BOOST_CHECK(retval == d);
+}
+
+struct msgpack_s11n_tester {
+    template <typename T>
+    void operator()(const T &) const
+    {
+        using d_type = packed_divisor<T>;
+        BOOST_CHECK((key_has_msgpack_pack<msgpack::sbuffer, d_type>::value));
+        BOOST_CHECK((key_has_msgpack_pack<msgpack::sbuffer, const d_type &>::value));
+        BOOST_CHECK((!key_has_msgpack_pack<msgpack::sbuffer &, const d_type &>::value));
+        BOOST_CHECK((!key_has_msgpack_pack<void, const d_type &>::value));
+        BOOST_CHECK((key_has_msgpack_convert<d_type>::value));
+        BOOST_CHECK((key_has_msgpack_convert<d_type &>::value));
+        BOOST_CHECK((!key_has_msgpack_convert<const d_type &>::value));
+        for (auto f : {msgpack_format::portable, msgpack_format::binary}) {
+            for (const auto &p : s11n_divisors<T>()) {
+                msgpack_round_trip(p.first, p.second, f);
+                if (p.first.size() == 0u) {
+                    continue;
+                }
+                {
+                    // Error handling with invalid symbol sets.
+                    msgpack::sbuffer sbuf;
+                    msgpack::packer<msgpack::sbuffer> pk(sbuf);
+                    BOOST_CHECK_EXCEPTION(p.first.msgpack_pack(pk, f, symbol_fset{}), std::invalid_argument,
+                                          [](const std::invalid_argument &iae) {
+                                              return boost::contains(
+                                                  iae.what(), "an invalid symbol_set was passed as an argument for "
+                                                              "the msgpack_pack() method of a packed divisor");
+                                          });
+                }
+                {
+                    msgpack::sbuffer sbuf;
+                    msgpack::packer<msgpack::sbuffer> pk(sbuf);
+                    p.first.msgpack_pack(pk, f, p.second);
+                    auto oh = msgpack::unpack(sbuf.data(), sbuf.size());
+                    d_type d(p.first);
+                    BOOST_CHECK_EXCEPTION(d.msgpack_convert(oh.get(), f, symbol_fset{}), std::invalid_argument,
+                                          [](const std::invalid_argument &iae) {
+                                              return boost::contains(iae.what(),
+                                                                     "the packed divisor loaded from a msgpack object "
+                                                                     "is not compatible with the supplied symbol set");
+                                          });
+                    BOOST_CHECK_EQUAL(d.size(), 0u);
+                }
+            }
+        }
+        // Malformed data: a non-canonical factor and a zero exponent.
+        const symbol_fset ss{"x", "y"};
+        for (const auto &fac : {std::make_pair(std::vector<T>{T(2), T(4)}, T(1)),
+                                std::make_pair(std::vector<T>{T(1), T(2)}, T(0))}) {
+            d_type dv;
+            msgpack::sbuffer sbuf;
+            msgpack::packer<msgpack::sbuffer> pk(sbuf);
+            pk.pack_array(1);
+            pk.pack_array(2);
+            msgpack_pack(pk, kronecker_array<T>::encode(fac.first), msgpack_format::binary);
+            msgpack_pack(pk, fac.second, msgpack_format::binary);
+            auto oh = msgpack::unpack(sbuf.data(), sbuf.size());
+            BOOST_CHECK_EXCEPTION(dv.msgpack_convert(oh.get(), msgpack_format::binary, ss), std::invalid_argument,
+                                  [](const std::invalid_argument &iae) {
+                                      return boost::contains(iae.what(), "the packed divisor loaded from a msgpack "
+                                                                         "object failed internal consistency checks");
+                                  });
+            BOOST_CHECK(dv == d_type{});
+        }
+    }
+};
+
+BOOST_AUTO_TEST_CASE(packed_divisor_msgpack_s11n_test)
+{
+    tuple_for_each(value_types{}, msgpack_s11n_tester{});
+}
+
+#endif
@@ -437,4 +437,22 @@ BOOST_AUTO_TEST_CASE(poisson_series_multiplier_test)
         settings::reset_n_threads();
         settings::reset_min_work_per_thread();
     }
+    // Larger products, checked against the single-threaded results.
+    {
+        using ps = poisson_series<polynomial<rational, monomial<short>>>;
+        ps x{"x"}, y{"y"}, z{"z"};
+        const auto a = (x + piranha::cos(x) + y * piranha::sin(x + 2 * y) + z * piranha::cos(y - z) + 1).pow(4);
+        const auto b = (y - piranha::sin(z) + x * piranha::cos(2 * x - y) / 3 + 2).pow(4);
+        settings::set_min_work_per_thread(1u);
+        settings::set_n_threads(1u);
+        const auto cmp = a * b;
+        for (unsigned nt = 2u; nt <= 4u; ++nt) {
+            settings::set_n_threads(nt);
+            BOOST_CHECK_EQUAL(a * b, cmp);
+            BOOST_CHECK_EQUAL(b * a, cmp);
+            BOOST_CHECK_EQUAL(a * b - b * a, 0);
+        }
+        settings::reset_n_threads();
+        settings::reset_min_work_per_thread();
+    }
 }
@@ -35,8 +35,11 @@ see https://www.gnu.org/licenses/. */
 
 #include <piranha/config.hpp>
 #include <piranha/integer.hpp>
+#include <piranha/kronecker_monomial.hpp>
+#include <piranha/math.hpp>
 #include <piranha/math/pow.hpp>
 #include <piranha/monomial.hpp>
+#include <piranha/rational.hpp>
 #include <piranha/s11n.hpp>
 
 using namespace piranha;
@@ -61,6 +64,117 @@ BOOST_AUTO_TEST_CASE(polynomial_truncation_pow_cache_test)
     BOOST_CHECK_EQUAL(piranha::pow(x + y + 1, 2), 2 * x + 1 + 2 * y + x * x + 2 * x * y);
 }
 
+// Power computed via repeated multiplications.
+template <typename P>
+static P naive_pow(const P &p, unsigned n)
+{
+    P retval{1};
+    for (unsigned i = 0u; i < n; ++i) {
+        retval *= p;
+    }
+    return retval;
+}
+
+struct fast_pow_tester {
+    template <typename P>
+    void operator()(const P &) const
+    {
+        P::unset_auto_truncate_degree();
+        P x{"x"}, y{"y"}, z{"z"}, e{"e"};
+        // Binomial expansion.
+        for (unsigned n = 0u; n < 12u; ++n) {
+            BOOST_CHECK_EQUAL((x + 2 * y).pow(n), naive_pow(x + 2 * y, n));
+            BOOST_CHECK_EQUAL((x - 1).pow(n), naive_pow(x - 1, n));
+            BOOST_CHECK_EQUAL((x * y - 3 * z * z).pow(n), naive_pow(x * y - 3 * z * z, n));
+            BOOST_CHECK_EQUAL((x + y + z).pow(n), naive_pow(x + y + z, n));
+        }
+        BOOST_CHECK_THROW((x + y).pow(-1), std::invalid_argument);
+        // Miller's recurrence, total degree.
+        const auto p0 = 1 + x + 2 * y - z * z, p1 = 3 - x * y * z + y * y;
+        for (int d = 0; d < 8; ++d) {
+            for (unsigned n = 0u; n < 6u; ++n) {
+                P::unset_auto_truncate_degree();
+                const auto r0 = naive_pow(p0, n), r1 = naive_pow(p1, n);
+                P::set_auto_truncate_degree(d);
+                BOOST_CHECK_EQUAL(p0.pow(n), math::truncate_degree(r0, d));
+                BOOST_CHECK_EQUAL(p1.pow(n), math::truncate_degree(r1, d));
+            }
+        }
+        // Negative exponents.
+        P::set_auto_truncate_degree(4);
+        BOOST_CHECK_EQUAL((1 + x).pow(-1), 1 - x + x * x - x * x * x + x * x * x * x);
+        BOOST_CHECK_EQUAL((1 - x - y).pow(-2) * (1 - x - y).pow(2), 1);
+        BOOST_CHECK_EQUAL((x + y + 1).pow(-3) * (x + y + 1).pow(3), 1);
+        // No constant term.
+        BOOST_CHECK_THROW((x + y).pow(-1), std::invalid_argument);
+        // Miller's recurrence, partial degree.
+        for (int d = 0; d < 6; ++d) {
+            for (unsigned n = 0u; n < 5u; ++n) {
+                P::unset_auto_truncate_degree();
+                const auto r0 = naive_pow(1 + e * x - e * e * y, n);
+                P::set_auto_truncate_degree(d, {"e"});
+                BOOST_CHECK_EQUAL((1 + e * x - e * e * y).pow(n), math::truncate_degree(r0, d, {"e"}));
+            }
+        }
+        // (1 + e * x)**-k, as in the expansions of celestial mechanics.
+        P::set_auto_truncate_degree(5, {"e"});
+        for (int k = 1; k < 5; ++k) {
+            BOOST_CHECK_EQUAL((1 + e * x).pow(-k) * (1 + e * x).pow(k), 1);
+        }
+        // The component of degree zero is not a constant, the default implementation is used.
+        BOOST_CHECK_EQUAL((1 + x + e).pow(2), 1 + 2 * x + x * x + 2 * e + 2 * e * x + e * e);
+        BOOST_CHECK_THROW((1 + x + e).pow(-1), std::invalid_argument);
+        P::unset_auto_truncate_degree();
+    }
+};
+
+BOOST_AUTO_TEST_CASE(polynomial_fast_pow_test)
+{
+    fast_pow_tester{}(polynomial<integer, monomial<int>>{});
+    fast_pow_tester{}(polynomial<rational, k_monomial>{});
+    // Non-invertible constant term with integral coefficients: the default implementation is used.
+    using p_type = polynomial<integer, k_monomial>;
+    p_type x{"x"};
+    p_type::set_auto_truncate_degree(3);
+    BOOST_CHECK_THROW((2 + x).pow(-1), std::invalid_argument);
+    BOOST_CHECK_EQUAL((2 + x).pow(3), 8 + 12 * x + 6 * x * x + x * x * x);
+    p_type::unset_auto_truncate_degree();
+    // With rational coefficients the constant term can be inverted.
+    using q_type = polynomial<rational, k_monomial>;
+    q_type qx{"x"};
+    q_type::set_auto_truncate_degree(3);
+    BOOST_CHECK_EQUAL((2 + qx).pow(-1), 1 / 2_q - qx / 4 + qx * qx / 8 - qx * qx * qx / 16);
+    q_type::unset_auto_truncate_degree();
+    // Inexact coefficient types always use the default implementation, and the fast algorithms
+    // never store their results in the pow cache.
+    using d_type = polynomial<double, k_monomial>;
+    d_type dx{"x"}, dy{"y"};
+    BOOST_CHECK_EQUAL((dx + 2 * dy).pow(7), naive_pow(dx + 2 * dy, 7u));
+    d_type::set_auto_truncate_degree(3);
+    BOOST_CHECK_THROW((1 + dx).pow(-1), std::invalid_argument);
+    d_type::unset_auto_truncate_degree();
+    // The fast algorithms share the pow cache.
+    p_type::clear_pow_cache();
+    BOOST_CHECK_EQUAL((x + 2).pow(5), naive_pow(x + 2, 5u));
+    auto st = p_type::get_pow_cache_stats();
+    BOOST_CHECK_EQUAL(st.hits, 0u);
+    BOOST_CHECK_EQUAL(st.misses, 1u);
+    BOOST_CHECK_EQUAL(st.entries, 1u);
+    BOOST_CHECK_EQUAL((x + 2).pow(5), naive_pow(x + 2, 5u));
+    BOOST_CHECK_EQUAL(p_type::get_pow_cache_stats().hits, 1u);
+    p_type::set_auto_truncate_degree(3);
+    BOOST_CHECK_EQUAL((1 + x - x * x).pow(4), math::truncate_degree(naive_pow(1 + x - x * x, 4u), 3));
+    BOOST_CHECK_EQUAL((1 + x - x * x).pow(4), math::truncate_degree(naive_pow(1 + x - x * x, 4u), 3));
+    st = p_type::get_pow_cache_stats();
+    BOOST_CHECK_EQUAL(st.hits, 1u);
+    BOOST_CHECK_EQUAL(st.misses, 1u);
+    // Negative powers are not cached.
+    BOOST_CHECK_EQUAL((1 + x).pow(-1), 1 - x + x * x - x * x * x);
+    BOOST_CHECK_EQUAL(p_type::get_pow_cache_stats().entries, 1u);
+    p_type::unset_auto_truncate_degree();
+    p_type::clear_pow_cache();
+}
+
 #if defined(PIRANHA_WITH_BOOST_S11N)
 
 BOOST_AUTO_TEST_CASE(polynomial_boost_s11n_test)
@@ -35,6 +35,7 @@ see https://www.gnu.org/licenses/. */
 #include <boost/mpl/vector.hpp>
 #include <cstddef>
 #include <cstdint>
+#include <initializer_list>
 #include <limits>
 #include <type_traits>
 
@@ -43,6 +44,7 @@ see https://www.gnu.org/licenses/. */
 #include <piranha/monomial.hpp>
 #include <piranha/rational.hpp>
 #include <piranha/settings.hpp>
+#include <piranha/tuning.hpp>
 
 using namespace piranha;
 
@@ -152,3 +154,38 @@ BOOST_AUTO_TEST_CASE(polynomial_multiplier_multiplier_finalise_test)
     }
     settings::reset_n_threads();
 }
+
+BOOST_AUTO_TEST_CASE(polynomial_multiplier_estimation_test)
+{
+    // Sketch-based estimation and cache of the estimates: the results must not change.
+    using pt1 = polynomial<integer, k_monomial>;
+    using pt2 = polynomial<rational, monomial<int>>;
+    settings::set_min_work_per_thread(1u);
+    pt1 x1("x"), y1("y"), z1("z"), t1("t");
+    pt2 x2("x"), y2("y"), z2("z"), t2("t");
+    const auto f1 = (1 + x1 + y1 + z1 + t1).pow(8), g1 = f1 + 1;
+    const auto f2 = (1 + x2 / 2 + y2 + z2 + t2).pow(6), g2 = f2 - 1;
+    const auto cmp1 = f1 * g1;
+    const auto cmp2 = f2 * g2;
+    for (auto sketch : {false, true}) {
+        for (auto cache : {false, true}) {
+            tuning::set_sketch_estimation(sketch);
+            tuning::set_estimate_cache(cache);
+            for (unsigned nt = 1u; nt <= 4u; ++nt) {
+                settings::set_n_threads(nt);
+                // Repeat the multiplications, so that the cached estimates (if any) are used.
+                for (int i = 0; i < 2; ++i) {
+                    BOOST_CHECK_EQUAL(f1 * g1, cmp1);
+                    BOOST_CHECK_EQUAL(g1 * f1, cmp1);
+                    BOOST_CHECK_EQUAL(f2 * g2, cmp2);
+                }
+            }
+            // Different operands with the same keys.
+            BOOST_CHECK_EQUAL((f1 + 2) * (g1 + 2), cmp1 + 2 * g1 + 2 * f1 + 4);
+        }
+    }
+    tuning::reset_sketch_estimation();
+    tuning::reset_estimate_cache();
+    settings::reset_n_threads();
+    settings::reset_min_work_per_thread();
+}
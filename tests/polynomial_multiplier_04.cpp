@@ -0,0 +1,431 @@
+/* Copyright 2009-2017 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#include <piranha/polynomial.hpp>
+
+#define BOOST_TEST_MODULE polynomial_multiplier_04_test
+#include <boost/test/included/unit_test.hpp>
+
+#include <boost/mpl/for_each.hpp>
+#include <boost/mpl/vector.hpp>
+#include <cstdio>
+#include <fstream>
+#include <initializer_list>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <piranha/integer.hpp>
+#include <piranha/kronecker_monomial.hpp>
+#include <piranha/monomial.hpp>
+#include <piranha/rational.hpp>
+#include <piranha/s11n.hpp>
+#include <piranha/series_multiplier.hpp>
+#include <piranha/settings.hpp>
+#include <piranha/thread_pool.hpp>
+#include <piranha/tuning.hpp>
+
+using namespace piranha;
+
+using cf_types = boost::mpl::vector<double, integer, rational>;
+using k_types = boost::mpl::vector<k_monomial, kronecker_monomial<int>>;
+
+// Compare the results of the dense and sparse Kronecker multiplication algorithms.
+struct dense_tester {
+    template <typename Cf>
+    struct runner {
+        template <typename Key>
+        void operator()(const Key &)
+        {
+            if (std::is_same<Cf, double>::value
+                && (!std::numeric_limits<double>::is_iec559 || std::numeric_limits<double>::digits < 53)) {
+                return;
+            }
+            using p_type = polynomial<Cf, Key>;
+            p_type x("x"), y("y"), z("z"), t("t");
+            // A few products whose packed exponents fill a good part of the
+            // box defined by the minimum/maximum exponents of the result.
+            // Univariate.
+            p_type f1, g1;
+            for (int i = 0; i < 300; ++i) {
+                f1 += x.pow(i);
+                g1 += (i % 7 - 3) * x.pow(i);
+            }
+            // Bivariate with negative exponents and cancellations.
+            auto f2 = (x + y + x.pow(-1)).pow(15), g2 = (x - y + x.pow(-1)).pow(15);
+            // fateman1-like.
+            auto f3 = (1 + x + y + z + t).pow(10), g3 = f3 + 1;
+            // A sparse product, which should not trigger the dense algorithm.
+            auto f4 = (x.pow(10) + y.pow(-10) + z.pow(5)).pow(5), g4 = (x - y.pow(10) + z.pow(-5)).pow(5);
+            const p_type fs[] = {f1, f2, f3, f4}, gs[] = {g1, g2, g3, g4};
+            for (auto i = 0u; i < 4u; ++i) {
+                // Compute the result with the sparse algorithm.
+                tuning::set_dense_multiplication(false);
+                settings::set_n_threads(1u);
+                const auto cmp = fs[i] * gs[i];
+                tuning::set_dense_multiplication(true);
+                for (auto nt = 1u; nt <= 4u; ++nt) {
+                    settings::set_n_threads(nt);
+                    BOOST_CHECK(fs[i] * gs[i] == cmp);
+                    BOOST_CHECK(gs[i] * fs[i] == cmp);
+                }
+            }
+            // Complete cancellation.
+            settings::set_n_threads(1u);
+            BOOST_CHECK_EQUAL(f2 * g2 - g2 * f2, 0);
+            BOOST_CHECK_EQUAL((x + y).pow(15) * (x - y).pow(15), (x * x - y * y).pow(15));
+            settings::set_n_threads(3u);
+            BOOST_CHECK_EQUAL((x + y).pow(15) * (x - y).pow(15), (x * x - y * y).pow(15));
+        }
+    };
+    template <typename Cf>
+    void operator()(const Cf &)
+    {
+        boost::mpl::for_each<k_types>(runner<Cf>());
+    }
+};
+
+BOOST_AUTO_TEST_CASE(polynomial_multiplier_dense_test)
+{
+    // Make sure the estimation, and thus the dense algorithm, kicks in for small operands as well.
+    tuning::set_estimate_threshold(1u);
+    boost::mpl::for_each<cf_types>(dense_tester());
+    tuning::reset_estimate_threshold();
+    tuning::reset_dense_multiplication();
+    settings::reset_n_threads();
+}
+
+// Check the Kronecker multiplication of mp++ coefficients of various sizes (machine integer
+// accumulation, 128-bit accumulation and mp++ accumulation) against the multiplication with
+// non-Kronecker keys.
+struct small_cf_tester {
+    template <typename Cf>
+    struct runner {
+        template <typename Key>
+        void operator()(const Key &)
+        {
+            using p_type = polynomial<Cf, Key>;
+            using pm_type = polynomial<Cf, monomial<int>>;
+            // Convert a polynomial with monomial keys into a polynomial with Kronecker keys.
+            auto to_k = [](const pm_type &p) {
+                p_type retval;
+                retval.set_symbol_set(p.get_symbol_set());
+                for (const auto &t : p._container()) {
+                    retval.insert(typename p_type::term_type(t.m_cf, Key(t.m_key.begin(), t.m_key.end())));
+                }
+                return retval;
+            };
+            pm_type x("x"), y("y"), z("z");
+            // Coefficients below 2**31, 2**62 and above 2**64.
+            const Cf cs[] = {Cf(integer(1) << 30) - 17, Cf(integer(1) << 61) + 5, Cf(integer(1) << 100) - 3};
+            for (const auto &c : cs) {
+                // Dense product.
+                const auto f1 = c * (x + y + 2 * z + 1).pow(8) - 1, g1 = (x - c * y + z - 3).pow(8) / 3;
+                // Sparse product.
+                const auto f2 = (c * x.pow(10) - y.pow(-10) + z.pow(5)).pow(4),
+                           g2 = (x - c * y.pow(10) - 2 * z.pow(-5)).pow(4);
+                const pm_type fs[] = {f1, f2}, gs[] = {g1, g2};
+                for (auto i = 0u; i < 2u; ++i) {
+                    settings::set_n_threads(1u);
+                    const auto cmp = to_k(fs[i] * gs[i]);
+                    const auto fk = to_k(fs[i]), gk = to_k(gs[i]);
+                    for (auto dense : {false, true}) {
+                        tuning::set_dense_multiplication(dense);
+                        for (auto nt = 1u; nt <= 3u; ++nt) {
+                            settings::set_n_threads(nt);
+                            BOOST_CHECK(fk * gk == cmp);
+                            BOOST_CHECK(gk * fk == cmp);
+                        }
+                    }
+                }
+                // Cancellations.
+                const auto fk = to_k(c * (x + y).pow(10)), gk = to_k(c * (x - y).pow(10));
+                BOOST_CHECK(fk * gk == to_k(c * c * (x * x - y * y).pow(10)));
+                BOOST_CHECK(fk * gk - gk * fk == 0);
+            }
+            settings::set_n_threads(1u);
+        }
+    };
+    template <typename Cf>
+    void operator()(const Cf &)
+    {
+        boost::mpl::for_each<k_types>(runner<Cf>());
+    }
+};
+
+BOOST_AUTO_TEST_CASE(polynomial_multiplier_small_cf_test)
+{
+    tuning::set_estimate_threshold(1u);
+    boost::mpl::for_each<boost::mpl::vector<integer, rational>>(small_cf_tester());
+    tuning::reset_estimate_threshold();
+    tuning::reset_dense_multiplication();
+    settings::reset_n_threads();
+}
+
+// Compare the results of the heap and hash-based Kronecker multiplication algorithms.
+struct heap_tester {
+    template <typename Cf>
+    struct runner {
+        template <typename Key>
+        void operator()(const Key &)
+        {
+            using p_type = polynomial<Cf, Key>;
+            p_type x("x"), y("y"), z("z"), t("t");
+            // Very sparse products.
+            p_type f1, g1;
+            for (int i = 0; i < 100; ++i) {
+                f1 += (i % 5 + 1) * x.pow((i * 37) % 31) * y.pow((i * 53) % 29 - 10) * z.pow(i % 7);
+                g1 += (i % 3 - 1) * x.pow((i * 17) % 23) * y.pow(i % 11) * t.pow(i % 7);
+            }
+            const auto f2 = (x.pow(10) + y.pow(-10) + z.pow(5) + 1).pow(4),
+                       g2 = (x - y.pow(10) + z.pow(-5) + t).pow(4);
+            // Products with cancellations.
+            const auto f3 = x + y, g3 = x - y;
+            const auto f4 = (x + y + z).pow(3), g4 = (x - y + 2 * z).pow(2);
+            const p_type fs[] = {f1, f2, f3, f4}, gs[] = {g1, g2, g3, g4};
+            settings::set_n_threads(1u);
+            for (auto i = 0u; i < 4u; ++i) {
+                tuning::set_heap_multiplication_threshold(std::numeric_limits<unsigned long>::max());
+                const auto cmp = fs[i] * gs[i];
+                tuning::set_heap_multiplication_threshold(0u);
+                BOOST_CHECK(fs[i] * gs[i] == cmp);
+                BOOST_CHECK(gs[i] * fs[i] == cmp);
+            }
+            BOOST_CHECK_EQUAL(f3 * g3, x * x - y * y);
+            BOOST_CHECK_EQUAL((x + y) * (x - y) - (x - y) * (x + y), 0);
+            tuning::reset_heap_multiplication_threshold();
+        }
+    };
+    template <typename Cf>
+    void operator()(const Cf &)
+    {
+        boost::mpl::for_each<k_types>(runner<Cf>());
+    }
+};
+
+BOOST_AUTO_TEST_CASE(polynomial_multiplier_heap_test)
+{
+    tuning::set_estimate_threshold(1u);
+    boost::mpl::for_each<cf_types>(heap_tester());
+    tuning::reset_estimate_threshold();
+    settings::reset_n_threads();
+}
+
+// Compare the results of the sparse Kronecker multiplication with and without the open-addressing
+// accumulation.
+struct oa_tester {
+    template <typename Cf>
+    struct runner {
+        template <typename Key>
+        void operator()(const Key &)
+        {
+            using p_type = polynomial<Cf, Key>;
+            p_type x("x"), y("y"), z("z"), t("t");
+            const auto f1 = (x.pow(10) + y.pow(-10) + z.pow(5) + 1).pow(5), g1 = (x - y.pow(10) + z.pow(-5) + t).pow(5);
+            const auto f2 = (1 + x + y + z + t).pow(6), g2 = f2 + 1;
+            const auto f3 = (x + y).pow(10), g3 = (x - y).pow(10);
+            const p_type fs[] = {f1, f2, f3}, gs[] = {g1, g2, g3};
+            settings::set_n_threads(1u);
+            for (auto i = 0u; i < 3u; ++i) {
+                tuning::set_open_addressing_multiplication(false);
+                const auto cmp = fs[i] * gs[i];
+                tuning::set_open_addressing_multiplication(true);
+                BOOST_CHECK(fs[i] * gs[i] == cmp);
+                BOOST_CHECK(gs[i] * fs[i] == cmp);
+            }
+            BOOST_CHECK_EQUAL(f3 * g3, (x * x - y * y).pow(10));
+            BOOST_CHECK_EQUAL(f3 * g3 - g3 * f3, 0);
+            // The open-addressing accumulation is not used in multi-threaded mode.
+            settings::set_n_threads(3u);
+            BOOST_CHECK_EQUAL(f3 * g3, (x * x - y * y).pow(10));
+            tuning::reset_open_addressing_multiplication();
+        }
+    };
+    template <typename Cf>
+    void operator()(const Cf &)
+    {
+        boost::mpl::for_each<k_types>(runner<Cf>());
+    }
+};
+
+BOOST_AUTO_TEST_CASE(polynomial_multiplier_oa_test)
+{
+    tuning::set_estimate_threshold(1u);
+    // Disable the dense and heap algorithms, so that the sparse algorithm is always used.
+    tuning::set_dense_multiplication(false);
+    tuning::set_heap_multiplication_threshold(std::numeric_limits<unsigned long>::max());
+    boost::mpl::for_each<cf_types>(oa_tester());
+    tuning::reset_estimate_threshold();
+    tuning::reset_dense_multiplication();
+    tuning::reset_heap_multiplication_threshold();
+    settings::reset_n_threads();
+}
+
+// Check the sparse Kronecker multiplication with the NUMA placement of the threads.
+struct numa_tester {
+    template <typename Cf>
+    struct runner {
+        template <typename Key>
+        void operator()(const Key &)
+        {
+            using p_type = polynomial<Cf, Key>;
+            p_type x("x"), y("y"), z("z"), t("t");
+            const auto f1 = (x.pow(10) + y.pow(-10) + z.pow(5) + 1).pow(5), g1 = (x - y.pow(10) + z.pow(-5) + t).pow(5);
+            const auto f2 = (1 + x + y + z + t).pow(8), g2 = f2 + 1;
+            const p_type fs[] = {f1, f2}, gs[] = {g1, g2};
+            for (auto i = 0u; i < 2u; ++i) {
+                settings::set_n_threads(1u);
+                const auto cmp = fs[i] * gs[i];
+                for (auto nt = 2u; nt <= 4u; ++nt) {
+                    settings::set_n_threads(nt);
+                    BOOST_CHECK(fs[i] * gs[i] == cmp);
+                    BOOST_CHECK(gs[i] * fs[i] == cmp);
+                }
+            }
+        }
+    };
+    template <typename Cf>
+    void operator()(const Cf &)
+    {
+        boost::mpl::for_each<k_types>(runner<Cf>());
+    }
+};
+
+BOOST_AUTO_TEST_CASE(polynomial_multiplier_numa_test)
+{
+    tuning::set_estimate_threshold(1u);
+    tuning::set_dense_multiplication(false);
+    tuning::set_heap_multiplication_threshold(std::numeric_limits<unsigned long>::max());
+    settings::set_thread_binding(true);
+    thread_pool::set_numa_placement(true);
+    boost::mpl::for_each<cf_types>(numa_tester());
+    thread_pool::set_numa_placement(false);
+    settings::set_thread_binding(false);
+    tuning::reset_estimate_threshold();
+    tuning::reset_dense_multiplication();
+    tuning::reset_heap_multiplication_threshold();
+    settings::reset_n_threads();
+}
+
+static std::random_device rd;
+
+// Check the streaming multiplication: the partial results must have disjoint and increasing ranges of
+// Kronecker codes, and their sum must be equal to the result of the in-memory multiplication.
+struct streaming_tester {
+    template <typename Cf>
+    struct runner {
+        template <typename Key>
+        void operator()(const Key &)
+        {
+            using p_type = polynomial<Cf, Key>;
+            using sm_type = series_multiplier<p_type>;
+            p_type x("x"), y("y"), z("z"), t("t");
+            p_type f1, g1;
+            for (int i = 0; i < 100; ++i) {
+                f1 += (i % 5 + 1) * x.pow((i * 37) % 31) * y.pow((i * 53) % 29 - 10) * z.pow(i % 7);
+                g1 += (i % 3 - 1) * x.pow((i * 17) % 23) * y.pow(i % 11) * z.pow(i % 5);
+            }
+            const auto f2 = (x + y + t + 1).pow(6), g2 = (x - y + t - 1).pow(6);
+            // NOTE: the operands of the multiplier must have the same symbol set.
+            const p_type fs[] = {f1, f2, x + y, x}, gs[] = {g1, g2, x - y, x - x};
+            for (auto i = 0u; i < 4u; ++i) {
+                const auto cmp = fs[i] * gs[i];
+                for (auto max_terms : {1u, 7u, 100u, 100000u}) {
+                    p_type sum;
+                    sum.set_symbol_set(cmp.get_symbol_set());
+                    std::vector<p_type> parts;
+                    sm_type(fs[i], gs[i])._streaming_multiplication([&parts](p_type &p) { parts.push_back(p); },
+                                                                     max_terms);
+                    for (decltype(parts.size()) j = 0u; j < parts.size(); ++j) {
+                        BOOST_CHECK(parts[j].size() >= 1u);
+                        BOOST_CHECK(parts[j].size() <= max_terms);
+                        if (j + 1u < parts.size()) {
+                            BOOST_CHECK(parts[j].size() == max_terms);
+                            for (const auto &t1 : parts[j]._container()) {
+                                for (const auto &t2 : parts[j + 1u]._container()) {
+                                    BOOST_CHECK(t1.m_key.get_int() < t2.m_key.get_int());
+                                }
+                            }
+                        }
+                        sum += parts[j];
+                    }
+                    BOOST_CHECK(sum == cmp);
+                    BOOST_CHECK(parts.empty() == cmp.empty());
+                }
+                BOOST_CHECK_THROW(sm_type(fs[i], gs[i])._streaming_multiplication([](p_type &) {}, 0u),
+                                  std::invalid_argument);
+            }
+            // Out-of-core multiplication.
+            std::vector<data_format> dfs;
+#if defined(PIRANHA_WITH_BOOST_S11N)
+            dfs.push_back(data_format::boost_binary);
+#endif
+#if defined(PIRANHA_WITH_MSGPACK)
+            dfs.push_back(data_format::msgpack_binary);
+#endif
+            for (auto df : dfs) {
+                const std::string prefix = PIRANHA_BINARY_TESTS_DIR "/" + std::to_string(rd());
+                // Operands with different symbol sets.
+                const auto names = p_type::out_of_core_multiplication(f1, x + y, prefix, 50u, df, compression::none);
+                BOOST_CHECK(!names.empty());
+                p_type sum;
+                for (decltype(names.size()) j = 0u; j < names.size(); ++j) {
+                    BOOST_CHECK(names[j] == prefix + "." + std::to_string(j));
+                    // The temporary file has been renamed.
+                    BOOST_CHECK(!std::ifstream(names[j] + ".part"));
+                    p_type part;
+                    load_file(part, names[j], df, compression::none);
+                    BOOST_CHECK(part.size() <= 50u);
+                    sum += part;
+                    std::remove(names[j].c_str());
+                }
+                BOOST_CHECK(sum == f1 * (x + y));
+                BOOST_CHECK(
+                    p_type::out_of_core_multiplication(x, p_type{}, prefix, 50u, df, compression::none).empty());
+                BOOST_CHECK_THROW(p_type::out_of_core_multiplication(f1, x + y, prefix + "/nonexistent/foo", 50u, df,
+                                                                     compression::none),
+                                  std::runtime_error);
+            }
+        }
+    };
+    template <typename Cf>
+    void operator()(const Cf &)
+    {
+        boost::mpl::for_each<k_types>(runner<Cf>());
+    }
+};
+
+BOOST_AUTO_TEST_CASE(polynomial_multiplier_streaming_test)
+{
+    settings::set_n_threads(1u);
+    boost::mpl::for_each<cf_types>(streaming_tester());
+    settings::reset_n_threads();
+}
@@ -33,6 +33,7 @@ see https://www.gnu.org/licenses/. */
 
 #include <boost/mpl/for_each.hpp>
 #include <boost/mpl/vector.hpp>
+#include <initializer_list>
 #include <stdexcept>
 #include <string>
 #include <tuple>
@@ -188,3 +189,29 @@ BOOST_AUTO_TEST_CASE(polynomial_truncation_main_test)
 {
     boost::mpl::for_each<cf_types>(main_tester());
 }
+
+// Truncated multiplications large enough to go through the Kronecker multiplication routines, checked
+// against the truncation of the untruncated products.
+BOOST_AUTO_TEST_CASE(polynomial_truncation_kronecker_test)
+{
+    using pt = polynomial<integer, k_monomial>;
+    pt x{"x"}, y{"y"}, z{"z"}, t{"t"};
+    const auto f = (x + y + z * z * 2 + t * t * t * 3 + 1).pow(8);
+    const auto g = (1 - x + y * y - z + 2 * t).pow(8);
+    const auto fg = f * g;
+    settings::set_min_work_per_thread(1u);
+    for (unsigned nt = 1u; nt <= 4u; ++nt) {
+        settings::set_n_threads(nt);
+        for (int deg : {-1, 0, 5, 17, 30}) {
+            pt::set_auto_truncate_degree(deg);
+            BOOST_CHECK_EQUAL(f * g, fg.truncate_degree(deg));
+            BOOST_CHECK_EQUAL(g * f, fg.truncate_degree(deg));
+            pt::set_auto_truncate_degree(deg, {"x", "t"});
+            BOOST_CHECK_EQUAL(f * g, fg.truncate_degree(deg, {"x", "t"}));
+            BOOST_CHECK_EQUAL(g * f, fg.truncate_degree(deg, {"x", "t"}));
+        }
+        pt::unset_auto_truncate_degree();
+    }
+    settings::reset_n_threads();
+    settings::reset_min_work_per_thread();
+}
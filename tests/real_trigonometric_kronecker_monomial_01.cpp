@@ -31,6 +31,7 @@ see https://www.gnu.org/licenses/. */
 #define BOOST_TEST_MODULE real_trigonometric_kronecker_monomial_01_test
 #include <boost/test/included/unit_test.hpp>
 
+#include <algorithm>
 #include <array>
 #include <boost/algorithm/string/predicate.hpp>
 #include <cmath>
@@ -38,6 +39,7 @@ see https://www.gnu.org/licenses/. */
 #include <initializer_list>
 #include <iostream>
 #include <limits>
+#include <random>
 #include <set>
 #include <sstream>
 #include <stdexcept>
@@ -1764,3 +1766,70 @@ BOOST_AUTO_TEST_CASE(rtkm_comparison_test)
 {
     tuple_for_each(int_types{}, comparison_tester{});
 }
+
+struct multiply_packed_tester {
+    template <typename T>
+    void operator()(const T &) const
+    {
+        using k_type = real_trigonometric_kronecker_monomial<T>;
+        using term_type = term<integer, k_type>;
+        using ka = kronecker_array<T>;
+        std::array<term_type, 2u> res1, res2;
+        auto checker = [&res1, &res2](const term_type &t1, const term_type &t2, const symbol_fset &ss) {
+            k_type::multiply(res1, t1, t2, ss);
+            k_type::multiply_packed(res2, t1, t2, ss);
+            BOOST_CHECK(res1[0u].m_key == res2[0u].m_key);
+            BOOST_CHECK(res1[1u].m_key == res2[1u].m_key);
+            BOOST_CHECK_EQUAL(res1[0u].m_cf, res2[0u].m_cf);
+            BOOST_CHECK_EQUAL(res1[1u].m_cf, res2[1u].m_cf);
+        };
+        // Empty keys.
+        checker(term_type{integer(2), k_type{}}, term_type{integer(3), k_type{}}, symbol_fset{});
+        // Test all the flavour combinations, with results requiring canonicalisation.
+        const symbol_fset ss{"x", "y", "z"};
+        if (ka::get_limits().size() <= 3u) {
+            return;
+        }
+        const auto &M = std::get<0u>(ka::get_limits()[3u]);
+        for (auto f1 : {true, false}) {
+            if (*std::min_element(M.begin(), M.end()) < T(3)) {
+                break;
+            }
+            for (auto f2 : {true, false}) {
+                term_type t1{integer(2), k_type{1, -1, 0}}, t2{integer(-3), k_type{0, 1, 1}};
+                t1.m_key.set_flavour(f1);
+                t2.m_key.set_flavour(f2);
+                checker(t1, t2, ss);
+                checker(t2, t1, ss);
+                t2.m_key = k_type{1, -1, 0};
+                t2.m_key.set_flavour(f2);
+                checker(t1, t2, ss);
+                t2.m_key = k_type{2, -1, 1};
+                t2.m_key.set_flavour(f2);
+                checker(t1, t2, ss);
+                checker(t2, t1, ss);
+            }
+        }
+        // Random testing within the limits.
+        std::mt19937 rng;
+        for (int n = 0; n < 1000; ++n) {
+            std::vector<T> v1, v2;
+            for (auto i = 0u; i < 3u; ++i) {
+                const auto lim = static_cast<int>(M[i] / 2);
+                std::uniform_int_distribution<int> dist(-lim, lim);
+                v1.push_back(static_cast<T>(dist(rng)));
+                v2.push_back(static_cast<T>(dist(rng)));
+            }
+            term_type t1{integer(n), k_type(v1.begin(), v1.end(), n % 2 == 0)},
+                t2{integer(n + 1), k_type(v2.begin(), v2.end(), n % 3 == 0)};
+            t1.m_key.canonicalise(ss);
+            t2.m_key.canonicalise(ss);
+            checker(t1, t2, ss);
+        }
+    }
+};
+
+BOOST_AUTO_TEST_CASE(rtkm_multiply_packed_test)
+{
+    tuple_for_each(int_types{}, multiply_packed_tester{});
+}
@@ -31,7 +31,9 @@ see https://www.gnu.org/licenses/. */
 #define BOOST_TEST_MODULE runtime_info_test
 #include <boost/test/included/unit_test.hpp>
 
+#include <algorithm>
 #include <iostream>
+#include <set>
 
 #include <piranha/memory.hpp>
 #include <piranha/settings.hpp>
@@ -57,3 +59,23 @@ BOOST_AUTO_TEST_CASE(runtime_info_settings_test)
                 || runtime_info::get_hardware_concurrency() == 0u);
     BOOST_CHECK_EQUAL(runtime_info::get_cache_line_size(), settings::get_cache_line_size());
 }
+
+BOOST_AUTO_TEST_CASE(runtime_info_numa_topology_test)
+{
+    const auto topology = runtime_info::get_numa_topology();
+    std::cout << "NUMA nodes: " << topology.size() << '\n';
+    // The nodes are not empty, they contain processors in ascending order,
+    // and each processor belongs to a single node.
+    std::set<unsigned> procs;
+    for (const auto &node : topology) {
+        BOOST_CHECK(!node.empty());
+        BOOST_CHECK(std::is_sorted(node.begin(), node.end()));
+        for (const auto &p : node) {
+            BOOST_CHECK(procs.insert(p).second);
+        }
+    }
+    const auto hc = runtime_info::get_hardware_concurrency();
+    if (hc != 0u) {
+        BOOST_CHECK(procs.size() <= hc);
+    }
+}
@@ -1236,23 +1236,25 @@ BOOST_AUTO_TEST_CASE(s11n_test_get_cdf_from_filename)
                 == std::make_pair(compression::zlib, data_format::msgpack_portable));
     BOOST_CHECK(get_cdf_from_filename("foo.bz2.boostb")
                 == std::make_pair(compression::none, data_format::boost_binary));
+    BOOST_CHECK(get_cdf_from_filename("foo.flatb") == std::make_pair(compression::none, data_format::flat_binary));
+    BOOST_CHECK(get_cdf_from_filename("foo.flatb.gz") == std::make_pair(compression::gzip, data_format::flat_binary));
     BOOST_CHECK_EXCEPTION(get_cdf_from_filename("foo"), std::invalid_argument, [](const std::invalid_argument &iae) {
         return boost::contains(iae.what(), "unable to deduce the data format from the filename 'foo'. The filename "
-                                           "must end with one of ['.boostb','.boostp','.mpackb','.mpackp'], "
+                                           "must end with one of ['.boostb','.boostp','.mpackb','.mpackp','.flatb'], "
                                            "optionally followed by one of ['.bz2','gz','zip'].");
     });
     BOOST_CHECK_EXCEPTION(
         get_cdf_from_filename("foo.bz2"), std::invalid_argument, [](const std::invalid_argument &iae) {
             return boost::contains(iae.what(),
                                    "unable to deduce the data format from the filename 'foo.bz2'. The filename "
-                                   "must end with one of ['.boostb','.boostp','.mpackb','.mpackp'], "
+                                   "must end with one of ['.boostb','.boostp','.mpackb','.mpackp','.flatb'], "
                                    "optionally followed by one of ['.bz2','gz','zip'].");
         });
     BOOST_CHECK_EXCEPTION(
         get_cdf_from_filename("foo.mpackb.bz2.bz2"), std::invalid_argument, [](const std::invalid_argument &iae) {
             return boost::contains(
                 iae.what(), "unable to deduce the data format from the filename 'foo.mpackb.bz2.bz2'. The filename "
-                            "must end with one of ['.boostb','.boostp','.mpackb','.mpackp'], "
+                            "must end with one of ['.boostb','.boostp','.mpackb','.mpackp','.flatb'], "
                             "optionally followed by one of ['.bz2','gz','zip'].");
         });
 }
@@ -32,10 +32,13 @@ see https://www.gnu.org/licenses/. */
 #include <boost/test/included/unit_test.hpp>
 
 #include <cstdio>
+#include <fstream>
 #include <initializer_list>
+#include <ios>
 #include <iostream>
 #include <random>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 
 #include <piranha/config.hpp>
@@ -49,6 +52,7 @@ see https://www.gnu.org/licenses/. */
 #include <piranha/exceptions.hpp>
 #include <piranha/integer.hpp>
 #include <piranha/is_cf.hpp>
+#include <piranha/kronecker_monomial.hpp>
 #include <piranha/math/pow.hpp>
 #include <piranha/monomial.hpp>
 #include <piranha/poisson_series.hpp>
@@ -393,3 +397,40 @@ BOOST_AUTO_TEST_CASE(series_msgpack_s11n_test_01)
 }
 
 #endif
+
+BOOST_AUTO_TEST_CASE(series_flat_s11n_test)
+{
+    // The flat format is available without including mapped_series.hpp.
+    using p_type = polynomial<double, k_monomial>;
+    p_type x{"x"}, y{"y"};
+    const auto p = piranha::pow(x - 2 * y + 1, 6);
+    tmp_file file;
+    save_file(p, file.m_path, data_format::flat_binary, compression::none);
+    p_type ret;
+    load_file(ret, file.m_path, data_format::flat_binary, compression::none);
+    BOOST_CHECK_EQUAL(ret, p);
+    // Corrupt the byte order tag, which follows the 8-byte magic string.
+    {
+        std::fstream f(file.m_path, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(8);
+        f.put('\x7f');
+    }
+    BOOST_CHECK_EXCEPTION(load_file(ret, file.m_path, data_format::flat_binary, compression::none),
+                          std::invalid_argument, [](const std::invalid_argument &ia) {
+                              return boost::contains(ia.what(), "different byte order");
+                          });
+    BOOST_CHECK_EQUAL(ret, p);
+    // A number of terms overflowing the layout computation.
+    save_file(p, file.m_path, data_format::flat_binary, compression::none);
+    {
+        std::fstream f(file.m_path, std::ios::in | std::ios::out | std::ios::binary);
+        // NOTE: the number of terms is the last field of the 64-byte header.
+        f.seekp(56);
+        const char ff[8] = {'\xff', '\xff', '\xff', '\xff', '\xff', '\xff', '\xff', '\x7f'};
+        f.write(ff, 8);
+    }
+    BOOST_CHECK_EXCEPTION(load_file(ret, file.m_path, data_format::flat_binary, compression::none),
+                          std::invalid_argument, [](const std::invalid_argument &ia) {
+                              return boost::contains(ia.what(), "number of terms is not consistent");
+                          });
+}
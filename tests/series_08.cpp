@@ -40,6 +40,7 @@ see https://www.gnu.org/licenses/. */
 #include <thread>
 #include <tuple>
 #include <type_traits>
+#include <vector>
 
 #include <mp++/config.hpp>
 #include <mp++/exceptions.hpp>
@@ -65,6 +66,7 @@ see https://www.gnu.org/licenses/. */
 #include <piranha/series_multiplier.hpp>
 #include <piranha/settings.hpp>
 #include <piranha/symbol_utils.hpp>
+#include <piranha/tuning.hpp>
 #include <piranha/type_traits.hpp>
 
 using namespace piranha;
@@ -531,3 +533,92 @@ BOOST_AUTO_TEST_CASE(series_pow_test)
     p_type3::clear_pow_cache();
 #endif
 }
+
+BOOST_AUTO_TEST_CASE(series_pow_cache_test)
+{
+    using p_type = g_series_type<integer, int>;
+    p_type::clear_pow_cache();
+    auto st = p_type::get_pow_cache_stats();
+    BOOST_CHECK_EQUAL(st.hits, 0u);
+    BOOST_CHECK_EQUAL(st.misses, 0u);
+    BOOST_CHECK_EQUAL(st.evictions, 0u);
+    BOOST_CHECK_EQUAL(st.entries, 0u);
+    BOOST_CHECK_EQUAL(st.memory, 0u);
+    const p_type x{"x"}, y{"y"};
+    const auto f = x + y + 1, g = x - y;
+    // Hits and misses.
+    BOOST_CHECK_EQUAL(f.pow(3), f * f * f);
+    st = p_type::get_pow_cache_stats();
+    BOOST_CHECK_EQUAL(st.hits, 0u);
+    BOOST_CHECK_EQUAL(st.misses, 1u);
+    BOOST_CHECK_EQUAL(st.entries, 1u);
+    BOOST_CHECK(st.memory > 0u);
+    BOOST_CHECK_EQUAL(f.pow(2), f * f);
+    BOOST_CHECK_EQUAL(f.pow(3), f * f * f);
+    BOOST_CHECK_EQUAL(p_type{f}.pow(1), f);
+    st = p_type::get_pow_cache_stats();
+    BOOST_CHECK_EQUAL(st.hits, 3u);
+    BOOST_CHECK_EQUAL(st.misses, 1u);
+    BOOST_CHECK_EQUAL(g.pow(2), g * g);
+    st = p_type::get_pow_cache_stats();
+    BOOST_CHECK_EQUAL(st.misses, 2u);
+    BOOST_CHECK_EQUAL(st.entries, 2u);
+    // Concurrent exponentiations of the same and of different series.
+    p_type::clear_pow_cache();
+    const p_type bases[] = {f, g, x + 2 * y, f};
+    std::vector<p_type> cmp;
+    for (const auto &b : bases) {
+        p_type tmp{1};
+        for (int i = 0; i < 10; ++i) {
+            tmp *= b;
+        }
+        cmp.push_back(tmp);
+    }
+    std::vector<p_type> res(8u);
+    std::vector<std::thread> threads;
+    for (auto i = 0u; i < 8u; ++i) {
+        threads.emplace_back([i, &res, &bases]() { res[i] = bases[i % 4u].pow(10 - static_cast<int>(i / 4u)); });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    for (auto i = 0u; i < 4u; ++i) {
+        BOOST_CHECK_EQUAL(res[i], cmp[i]);
+        BOOST_CHECK_EQUAL(res[i + 4u] * bases[i], cmp[i]);
+    }
+    st = p_type::get_pow_cache_stats();
+    BOOST_CHECK_EQUAL(st.hits + st.misses, 8u);
+    BOOST_CHECK_EQUAL(st.entries, 3u);
+    // Memory limit.
+    p_type::clear_pow_cache();
+    tuning::set_pow_cache_max_memory(1u);
+    BOOST_CHECK_EQUAL(f.pow(4), f * f * f * f);
+    st = p_type::get_pow_cache_stats();
+    BOOST_CHECK_EQUAL(st.entries, 0u);
+    BOOST_CHECK_EQUAL(st.memory, 0u);
+    BOOST_CHECK(st.evictions > 0u);
+    BOOST_CHECK_EQUAL(f.pow(4), f * f * f * f);
+    BOOST_CHECK_EQUAL(p_type::get_pow_cache_stats().misses, 2u);
+    tuning::reset_pow_cache_max_memory();
+    // Set a limit which can accommodate only the powers of f up to the third: computing the third power of f
+    // will evict the powers of g, which are less recently used.
+    p_type::clear_pow_cache();
+    f.pow(3);
+    const auto mem_f3 = p_type::get_pow_cache_stats().memory;
+    p_type::clear_pow_cache();
+    f.pow(2);
+    g.pow(2);
+    tuning::set_pow_cache_max_memory(static_cast<unsigned long>(mem_f3));
+    f.pow(2);
+    BOOST_CHECK_EQUAL(p_type::get_pow_cache_stats().entries, 2u);
+    f.pow(3);
+    st = p_type::get_pow_cache_stats();
+    BOOST_CHECK_EQUAL(st.entries, 1u);
+    BOOST_CHECK_EQUAL(st.evictions, 1u);
+    BOOST_CHECK_EQUAL(st.memory, mem_f3);
+    BOOST_CHECK_EQUAL(f.pow(3), f * f * f);
+    BOOST_CHECK_EQUAL(p_type::get_pow_cache_stats().hits, 2u);
+    tuning::reset_pow_cache_max_memory();
+    p_type::clear_pow_cache();
+    BOOST_CHECK_EQUAL(p_type::get_pow_cache_stats().entries, 0u);
+}
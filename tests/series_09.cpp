@@ -0,0 +1,320 @@
+/* Copyright 2009-2017 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#include <piranha/series.hpp>
+
+#define BOOST_TEST_MODULE series_09_test
+#include <boost/test/included/unit_test.hpp>
+
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
+
+#include <piranha/integer.hpp>
+#include <piranha/kronecker_monomial.hpp>
+#include <piranha/math.hpp>
+#include <piranha/monomial.hpp>
+#include <piranha/poisson_series.hpp>
+#include <piranha/polynomial.hpp>
+#include <piranha/rational.hpp>
+#include <piranha/settings.hpp>
+#include <piranha/symbol_utils.hpp>
+
+using namespace piranha;
+
+// Compute p1 + p2 and p1 - p2, using all the overloads of the merging algorithm.
+template <typename P>
+static void merge_checker(const P &p1, const P &p2)
+{
+    settings::reset_min_work_per_thread();
+    const auto add = p1 + p2, sub = p1 - p2, sub_r = p2 - p1;
+    settings::set_min_work_per_thread(1u);
+    for (unsigned nt = 1u; nt <= 4u; ++nt) {
+        settings::set_n_threads(nt);
+        // Copy merging.
+        BOOST_CHECK_EQUAL(p1 + p2, add);
+        BOOST_CHECK_EQUAL(p1 - p2, sub);
+        BOOST_CHECK_EQUAL(p2 - p1, sub_r);
+        auto tmp(p1);
+        tmp += p2;
+        BOOST_CHECK_EQUAL(tmp, add);
+        tmp = p1;
+        tmp -= p2;
+        BOOST_CHECK_EQUAL(tmp, sub);
+        // Move merging, with and without swapping of the containers.
+        tmp = p1;
+        auto tmp2(p2);
+        tmp += std::move(tmp2);
+        BOOST_CHECK_EQUAL(tmp, add);
+        tmp = p1;
+        tmp2 = p2;
+        tmp -= std::move(tmp2);
+        BOOST_CHECK_EQUAL(tmp, sub);
+        tmp = p2;
+        tmp2 = p1;
+        tmp -= std::move(tmp2);
+        BOOST_CHECK_EQUAL(tmp, sub_r);
+        tmp = P{};
+        tmp2 = p1;
+        tmp -= std::move(tmp2);
+        BOOST_CHECK_EQUAL(tmp, -p1);
+        // Total cancellation.
+        tmp = p1;
+        tmp -= p1;
+        BOOST_CHECK_EQUAL(tmp.size(), 0u);
+        tmp = p1;
+        tmp2 = -p1;
+        tmp += std::move(tmp2);
+        BOOST_CHECK_EQUAL(tmp.size(), 0u);
+        // Self merging.
+        tmp = p1;
+        tmp += tmp;
+        BOOST_CHECK_EQUAL(tmp, 2 * p1);
+        tmp -= tmp;
+        BOOST_CHECK_EQUAL(tmp.size(), 0u);
+    }
+    settings::reset_n_threads();
+    settings::reset_min_work_per_thread();
+}
+
+BOOST_AUTO_TEST_CASE(series_parallel_merge_test)
+{
+    {
+        using p_type = polynomial<integer, k_monomial>;
+        p_type x{"x"}, y{"y"}, z{"z"};
+        const auto p1 = (x + y - 2 * z + 1).pow(10), p2 = (x - y + z - 3).pow(8);
+        merge_checker(p1, p2);
+        merge_checker(p2, p1);
+        // Partial cancellation.
+        merge_checker(p1, p1 + p2);
+        // Different symbol sets.
+        merge_checker(p1, (x + y).pow(12));
+        // Small series.
+        merge_checker(x + 1, y - 1);
+        merge_checker(p1, x);
+    }
+    {
+        using p_type = polynomial<rational, monomial<int>>;
+        p_type x{"x"}, y{"y"}, z{"z"};
+        const auto p1 = (x / 3 + y - z + 1).pow(9), p2 = (x - y / 2 + z).pow(9);
+        merge_checker(p1, p2);
+        merge_checker(p1, p1 * 3 - p2);
+    }
+}
+
+// Check negation, division by a scalar and trimming, with different numbers of threads.
+template <typename P, typename T>
+static void map_checker(const P &p, const T &x)
+{
+    settings::reset_min_work_per_thread();
+    const auto neg = -p, div = p / x, trimmed = p.trim();
+    settings::set_min_work_per_thread(1u);
+    for (unsigned nt = 1u; nt <= 4u; ++nt) {
+        settings::set_n_threads(nt);
+        BOOST_CHECK_EQUAL(-p, neg);
+        auto tmp(p);
+        tmp.negate();
+        BOOST_CHECK_EQUAL(tmp, neg);
+        tmp.negate();
+        BOOST_CHECK_EQUAL(tmp, p);
+        BOOST_CHECK_EQUAL(p / x, div);
+        tmp /= x;
+        BOOST_CHECK_EQUAL(tmp, div);
+        const auto tr = p.trim();
+        BOOST_CHECK_EQUAL(tr, trimmed);
+        BOOST_CHECK(tr.get_symbol_set() == trimmed.get_symbol_set());
+    }
+    settings::reset_n_threads();
+    settings::reset_min_work_per_thread();
+}
+
+BOOST_AUTO_TEST_CASE(series_parallel_map_test)
+{
+    {
+        using p_type = polynomial<integer, k_monomial>;
+        p_type x{"x"}, y{"y"}, z{"z"};
+        const auto p = (x + y - 2 * z + 1).pow(10);
+        map_checker(p, 3);
+        // The integral division zeroes out some of the coefficients.
+        map_checker(p, integer(1000));
+        auto tmp(p);
+        settings::set_min_work_per_thread(1u);
+        settings::set_n_threads(4u);
+        tmp /= integer(1000000000);
+        BOOST_CHECK_EQUAL(tmp.size(), 0u);
+        settings::reset_n_threads();
+        settings::reset_min_work_per_thread();
+        // Trimming of an unused symbol.
+        p_type w{"w"};
+        map_checker(p + w - w, 2);
+        map_checker(x, 2);
+    }
+    {
+        using p_type = polynomial<rational, monomial<int>>;
+        p_type x{"x"}, y{"y"}, z{"z"};
+        const auto p = (x / 3 + y - z + 1).pow(9);
+        map_checker(p, 7);
+        map_checker(p, rational(-2, 5));
+        // Trimming of an unused symbol.
+        p_type w{"w"};
+        map_checker(p + w - w, 3);
+    }
+}
+
+// Run f() with different numbers of threads, and check that the result is the same as the one obtained
+// with the default settings.
+template <typename F>
+static void termwise_checker(const F &f)
+{
+    settings::reset_min_work_per_thread();
+    const auto res = f();
+    settings::set_min_work_per_thread(1u);
+    for (unsigned nt = 1u; nt <= 4u; ++nt) {
+        settings::set_n_threads(nt);
+        BOOST_CHECK_EQUAL(f(), res);
+    }
+    settings::reset_n_threads();
+    settings::reset_min_work_per_thread();
+}
+
+BOOST_AUTO_TEST_CASE(series_parallel_termwise_test)
+{
+    {
+        using p_type = polynomial<rational, monomial<int>>;
+        p_type x{"x"}, y{"y"}, z{"z"};
+        const auto p = (x / 3 + y - z + 1).pow(9);
+        termwise_checker([&p]() { return p.partial("x"); });
+        termwise_checker([&p]() { return p.partial("t"); });
+        termwise_checker([&p]() { return p.integrate("y"); });
+        termwise_checker([&p]() { return p.integrate("t"); });
+        termwise_checker([&p]() { return p.subs(symbol_fmap<rational>{{"x", rational(1, 2)}}); });
+        termwise_checker([&p, &y]() { return p.subs(symbol_fmap<p_type>{{"x", y + 1}, {"z", y}}); });
+        termwise_checker([&p]() { return p.ipow_subs("y", integer(2), rational(-3)); });
+        // Polynomial coefficients.
+        using p_type2 = polynomial<p_type, monomial<int>>;
+        p_type2 a{"a"}, b{"b"};
+        const auto q = (a + b * x - y / 2).pow(6);
+        termwise_checker([&q]() { return q.partial("x"); });
+        termwise_checker([&q]() { return q.partial("a"); });
+        termwise_checker([&q]() { return q.integrate("b"); });
+    }
+    {
+        using ps_type = poisson_series<polynomial<rational, monomial<int>>>;
+        ps_type x{"x"}, y{"y"}, z{"z"};
+        const auto p = (x + piranha::cos(y) - piranha::sin(x - z) + 1).pow(7);
+        termwise_checker([&p]() { return p.partial("x"); });
+        termwise_checker([&p]() { return p.t_subs("x", rational(3, 5), rational(4, 5)); });
+        termwise_checker([&p, &z]() { return p.t_subs("y", piranha::cos(z), piranha::sin(z)); });
+    }
+}
+
+// With floating-point coefficients, the results must be identical to the serial ones as well.
+template <typename F>
+static void termwise_fp_checker(const F &f)
+{
+    settings::set_n_threads(1u);
+    const auto res = f();
+    settings::set_min_work_per_thread(1u);
+    for (unsigned nt : {1u, 2u, 4u}) {
+        settings::set_n_threads(nt);
+        BOOST_CHECK(f() == res);
+    }
+    settings::reset_n_threads();
+    settings::reset_min_work_per_thread();
+}
+
+BOOST_AUTO_TEST_CASE(series_parallel_termwise_fp_test)
+{
+    using p_type = polynomial<double, monomial<int>>;
+    p_type x{"x"}, y{"y"}, z{"z"};
+    const auto p = (x / 3. + .1 * y - z / 7. + 1.1).pow(12);
+    termwise_fp_checker([&p]() { return p.partial("x"); });
+    termwise_fp_checker([&p]() { return p.partial("z"); });
+    termwise_fp_checker([&p]() { return p.integrate("y"); });
+    termwise_fp_checker([&p]() { return p.integrate("t"); });
+    // Substitutions accumulate many terms into the same keys.
+    termwise_fp_checker([&p]() { return p.subs(symbol_fmap<double>{{"x", .3}}); });
+    termwise_fp_checker([&p]() { return p.subs(symbol_fmap<double>{{"x", .3}, {"z", -1.7}}); });
+    termwise_fp_checker([&p, &y]() { return p.subs(symbol_fmap<p_type>{{"x", y / 3. - .1}}); });
+    termwise_fp_checker([&p]() { return p.ipow_subs("y", integer(2), .7); });
+    using ps_type = poisson_series<polynomial<double, monomial<int>>>;
+    ps_type a{"a"}, b{"b"};
+    const auto q = (a / 3. + piranha::cos(b) - piranha::sin(a - b) / 5. + 1.).pow(7);
+    termwise_fp_checker([&q]() { return q.partial("a"); });
+    termwise_fp_checker([&q]() { return q.t_subs("a", .6, .8); });
+}
+
+// Substitution computed term by term.
+template <typename P, typename F>
+static auto termwise_subs(const P &p, const F &f) -> decltype(f(p))
+{
+    decltype(f(p)) retval(0);
+    for (const auto &t : p._container()) {
+        P tmp;
+        tmp.set_symbol_set(p.get_symbol_set());
+        tmp.insert(t);
+        retval += f(tmp);
+    }
+    return retval;
+}
+
+template <typename P>
+static void grouped_subs_tester()
+{
+    P x{"x"}, y{"y"}, z{"z"};
+    const auto p = (x / 3 + y - z + 1).pow(9) + (x - y * z).pow(4);
+    // Substitution of series, the powers are shared among the terms.
+    const auto s0 = p.subs(symbol_fmap<P>{{"x", y + 1}});
+    BOOST_CHECK_EQUAL(s0, ((y + 1) / 3 + y - z + 1).pow(9) + (y + 1 - y * z).pow(4));
+    BOOST_CHECK_EQUAL(s0, termwise_subs(p, [&y](const P &q) { return q.subs(symbol_fmap<P>{{"x", y + 1}}); }));
+    const auto s1 = p.subs(symbol_fmap<P>{{"x", y + 1}, {"z", x - y}});
+    BOOST_CHECK_EQUAL(s1, ((y + 1) / 3 + y - (x - y) + 1).pow(9) + (y + 1 - y * (x - y)).pow(4));
+    // Numerical substitution.
+    BOOST_CHECK_EQUAL(p.subs(symbol_fmap<rational>{{"y", rational(1, 2)}, {"z", rational(-2)}}),
+                      termwise_subs(p, [](const P &q) {
+                          return q.subs(symbol_fmap<rational>{{"y", rational(1, 2)}, {"z", rational(-2)}});
+                      }));
+    // Symbols not in the series.
+    BOOST_CHECK_EQUAL(p.subs(symbol_fmap<P>{{"t", y}}), p);
+    // Integral power substitution.
+    BOOST_CHECK_EQUAL(p.ipow_subs("y", integer(2), z + x),
+                      termwise_subs(p, [&x, &z](const P &q) { return q.ipow_subs("y", integer(2), z + x); }));
+    BOOST_CHECK_EQUAL(p.ipow_subs("z", integer(-1), rational(3)),
+                      termwise_subs(p, [](const P &q) { return q.ipow_subs("z", integer(-1), rational(3)); }));
+    BOOST_CHECK_EQUAL(p.ipow_subs("t", integer(2), x), p);
+    BOOST_CHECK_THROW(p.ipow_subs("x", integer(0), x), std::invalid_argument);
+    // Consistency with multiple threads.
+    termwise_checker([&p, &x, &y]() { return p.subs(symbol_fmap<P>{{"x", y - 1}, {"y", x * x}}); });
+    termwise_checker([&p, &x]() { return p.ipow_subs("z", integer(3), x - 2); });
+}
+
+BOOST_AUTO_TEST_CASE(series_grouped_subs_test)
+{
+    grouped_subs_tester<polynomial<rational, monomial<int>>>();
+    grouped_subs_tester<polynomial<rational, k_monomial>>();
+}
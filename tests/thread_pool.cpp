@@ -32,6 +32,7 @@ see https://www.gnu.org/licenses/. */
 #include <boost/test/included/unit_test.hpp>
 
 #include <algorithm>
+#include <atomic>
 #include <boost/algorithm/string/predicate.hpp>
 #include <chrono>
 #include <limits>
@@ -326,6 +327,56 @@ BOOST_AUTO_TEST_CASE(thread_pool_test)
     BOOST_CHECK(thread_pool::size() != 0u);
 }
 
+BOOST_AUTO_TEST_CASE(thread_pool_numa_placement_test)
+{
+    const unsigned initial_size = thread_pool::size();
+    BOOST_CHECK(!thread_pool::get_numa_placement());
+    BOOST_CHECK_EXCEPTION(
+        thread_pool::get_numa_node(initial_size), std::invalid_argument,
+        [](const std::invalid_argument &e) { return boost::contains(e.what(), "the thread pool contains only "); });
+    // Without binding, all threads are reported to be on the first node.
+    thread_pool::set_numa_placement(true);
+    thread_pool::set_numa_placement(true);
+    BOOST_CHECK(thread_pool::get_numa_placement());
+    for (unsigned i = 0u; i < initial_size; ++i) {
+        BOOST_CHECK_EQUAL(thread_pool::get_numa_node(i), 0u);
+    }
+    const auto topology = runtime_info::get_numa_topology();
+#if !defined(__APPLE_CC__)
+    thread_pool::set_binding(true);
+    // Threads are assigned to the nodes in ascending order, and each
+    // thread is bound to a processor of its node.
+    unsigned prev_node = 0u;
+    for (unsigned i = 0u; i < initial_size; ++i) {
+        const auto node = thread_pool::get_numa_node(i);
+        BOOST_CHECK(node >= prev_node || i >= runtime_info::get_hardware_concurrency());
+        prev_node = node;
+        if (topology.empty()) {
+            BOOST_CHECK_EQUAL(node, 0u);
+            continue;
+        }
+        BOOST_CHECK(node < topology.size());
+        const auto res = thread_pool::enqueue(i, []() { return bound_proc(); }).get();
+        if (res.first) {
+            BOOST_CHECK(std::find(topology[node].begin(), topology[node].end(), res.second) != topology[node].end());
+        }
+    }
+    // Resizing keeps the placement.
+    thread_pool::resize(initial_size + 1u);
+    BOOST_CHECK(thread_pool::get_numa_placement());
+    BOOST_CHECK(thread_pool::get_binding());
+    thread_pool::set_numa_placement(false);
+    for (unsigned i = 0u; i < thread_pool::size(); ++i) {
+        BOOST_CHECK_EQUAL(thread_pool::get_numa_node(i), 0u);
+    }
+    BOOST_CHECK(thread_pool::enqueue(0, []() { return bound_proc(); }).get() == std::make_pair(true, 0u));
+    thread_pool::set_binding(false);
+    thread_pool::resize(initial_size);
+#endif
+    thread_pool::set_numa_placement(false);
+    BOOST_CHECK(!thread_pool::get_numa_placement());
+}
+
 BOOST_AUTO_TEST_CASE(thread_pool_future_list_test)
 {
     thread_pool::resize(10u);
@@ -395,8 +446,10 @@ BOOST_AUTO_TEST_CASE(thread_pool_use_threads_test)
     auto f1 = thread_pool::enqueue(0u, []() { return thread_pool::use_threads(100u, 3u); });
     auto f2 = thread_pool::enqueue(0u, []() { return thread_pool::use_threads(100u, 1u); });
     auto f3 = thread_pool::enqueue(0u, []() { return thread_pool::use_threads(100u, 0u); });
-    BOOST_CHECK_EQUAL(f1.get(), 1u);
-    BOOST_CHECK_EQUAL(f2.get(), 1u);
+    // From within the pool, the number of threads depends on how many threads are idle.
+    const auto n1 = f1.get(), n2 = f2.get();
+    BOOST_CHECK(n1 >= 1u && n1 <= 4u);
+    BOOST_CHECK(n2 >= 1u && n2 <= 4u);
     BOOST_CHECK_THROW(f3.get(), std::invalid_argument);
     thread_pool::resize(1u);
     BOOST_CHECK(thread_pool::use_threads(100u, 3u) == 1u);
@@ -415,7 +468,81 @@ BOOST_AUTO_TEST_CASE(thread_pool_use_threads_test)
     auto f7 = thread_pool::enqueue(0u, []() { return thread_pool::use_threads(integer(100u), integer(3u)); });
     auto f8 = thread_pool::enqueue(0u, []() { return thread_pool::use_threads(integer(100u), integer(1u)); });
     auto f9 = thread_pool::enqueue(0u, []() { return thread_pool::use_threads(integer(100u), integer(0u)); });
-    BOOST_CHECK_EQUAL(f7.get(), 1u);
-    BOOST_CHECK_EQUAL(f8.get(), 1u);
+    const auto n7 = f7.get(), n8 = f8.get();
+    BOOST_CHECK(n7 >= 1u && n7 <= 4u);
+    BOOST_CHECK(n8 >= 1u && n8 <= 4u);
     BOOST_CHECK_THROW(f9.get(), std::invalid_argument);
+    // Nested parallelism: once the other threads are idle, a task running in the pool can fan out.
+    auto f10 = thread_pool::enqueue(0u, []() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        return thread_pool::use_threads(100u, 1u);
+    });
+    BOOST_CHECK_EQUAL(f10.get(), 4u);
+    // The minimum work per thread is still honoured.
+    auto f11 = thread_pool::enqueue(0u, []() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        return thread_pool::use_threads(100u, 30u);
+    });
+    BOOST_CHECK_EQUAL(f11.get(), 3u);
+}
+
+BOOST_AUTO_TEST_CASE(thread_pool_submit_test)
+{
+    thread_pool::resize(4u);
+    // Tasks with uneven costs.
+    std::atomic<unsigned> counter(0u);
+    future_list<void> f1;
+    for (unsigned i = 0u; i < 200u; ++i) {
+        f1.push_back(thread_pool::submit([i, &counter]() {
+            if (i % 17u == 0u) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+            counter += i;
+        }));
+    }
+    f1.wait_all();
+    f1.get_all();
+    BOOST_CHECK_EQUAL(counter.load(), 199u * 200u / 2u);
+    // Exceptions are transported via the futures.
+    auto f2 = thread_pool::submit([]() { throw std::runtime_error("error"); });
+    BOOST_CHECK_THROW(f2.get(), std::runtime_error);
+    // Nested parallelism: tasks submitting and waiting on subtasks must not deadlock,
+    // even if the number of waiting tasks is larger than the number of threads.
+    auto nested = [&counter](unsigned n) {
+        future_list<void> fl;
+        for (unsigned i = 0u; i < n; ++i) {
+            fl.push_back(thread_pool::submit([&counter]() { ++counter; }));
+        }
+        fl.wait_all();
+        fl.get_all();
+    };
+    counter = 0u;
+    future_list<void> f3;
+    for (unsigned i = 0u; i < 16u; ++i) {
+        f3.push_back(thread_pool::submit(nested, 50u));
+    }
+    f3.wait_all();
+    f3.get_all();
+    BOOST_CHECK_EQUAL(counter.load(), 16u * 50u);
+    // The same with a single thread in the pool.
+    thread_pool::resize(1u);
+    counter = 0u;
+    future_list<void> f4;
+    for (unsigned i = 0u; i < 4u; ++i) {
+        f4.push_back(thread_pool::submit(nested, 10u));
+    }
+    f4.wait_all();
+    f4.get_all();
+    BOOST_CHECK_EQUAL(counter.load(), 40u);
+    // Submitted and pinned tasks can be mixed.
+    thread_pool::resize(3u);
+    counter = 0u;
+    future_list<void> f5;
+    for (unsigned i = 0u; i < 30u; ++i) {
+        f5.push_back(thread_pool::enqueue(i % 3u, nested, 5u));
+    }
+    f5.wait_all();
+    f5.get_all();
+    BOOST_CHECK_EQUAL(counter.load(), 150u);
+    thread_pool::resize(4u);
 }
@@ -89,3 +89,132 @@ BOOST_AUTO_TEST_CASE(tuning_estimation_threshold_test)
     tuning::reset_estimate_threshold();
     BOOST_CHECK_EQUAL(tuning::get_estimate_threshold(), 200u);
 }
+
+BOOST_AUTO_TEST_CASE(tuning_dense_multiplication_test)
+{
+    BOOST_CHECK(tuning::get_dense_multiplication());
+    tuning::set_dense_multiplication(false);
+    BOOST_CHECK(!tuning::get_dense_multiplication());
+    std::thread t1([]() noexcept {
+        while (!tuning::get_dense_multiplication()) {
+        }
+    });
+    std::thread t2([]() noexcept { tuning::set_dense_multiplication(true); });
+    t1.join();
+    t2.join();
+    BOOST_CHECK(tuning::get_dense_multiplication());
+    tuning::set_dense_multiplication(false);
+    BOOST_CHECK(!tuning::get_dense_multiplication());
+    tuning::reset_dense_multiplication();
+    BOOST_CHECK(tuning::get_dense_multiplication());
+}
+
+BOOST_AUTO_TEST_CASE(tuning_heap_multiplication_threshold_test)
+{
+    BOOST_CHECK_EQUAL(tuning::get_heap_multiplication_threshold(), 16777216ul);
+    tuning::set_heap_multiplication_threshold(512u);
+    BOOST_CHECK_EQUAL(tuning::get_heap_multiplication_threshold(), 512u);
+    std::thread t1([]() noexcept {
+        while (tuning::get_heap_multiplication_threshold() != 1024u) {
+        }
+    });
+    std::thread t2([]() noexcept { tuning::set_heap_multiplication_threshold(1024u); });
+    t1.join();
+    t2.join();
+    BOOST_CHECK_EQUAL(tuning::get_heap_multiplication_threshold(), 1024u);
+    tuning::reset_heap_multiplication_threshold();
+    BOOST_CHECK_EQUAL(tuning::get_heap_multiplication_threshold(), 16777216ul);
+}
+
+BOOST_AUTO_TEST_CASE(tuning_open_addressing_multiplication_test)
+{
+    BOOST_CHECK(!tuning::get_open_addressing_multiplication());
+    tuning::set_open_addressing_multiplication(true);
+    BOOST_CHECK(tuning::get_open_addressing_multiplication());
+    std::thread t1([]() noexcept {
+        while (tuning::get_open_addressing_multiplication()) {
+        }
+    });
+    std::thread t2([]() noexcept { tuning::set_open_addressing_multiplication(false); });
+    t1.join();
+    t2.join();
+    BOOST_CHECK(!tuning::get_open_addressing_multiplication());
+    tuning::set_open_addressing_multiplication(true);
+    BOOST_CHECK(tuning::get_open_addressing_multiplication());
+    tuning::reset_open_addressing_multiplication();
+    BOOST_CHECK(!tuning::get_open_addressing_multiplication());
+}
+
+BOOST_AUTO_TEST_CASE(tuning_sketch_estimation_test)
+{
+    BOOST_CHECK(!tuning::get_sketch_estimation());
+    tuning::set_sketch_estimation(true);
+    BOOST_CHECK(tuning::get_sketch_estimation());
+    std::thread t1([]() noexcept {
+        while (tuning::get_sketch_estimation()) {
+        }
+    });
+    std::thread t2([]() noexcept { tuning::set_sketch_estimation(false); });
+    t1.join();
+    t2.join();
+    BOOST_CHECK(!tuning::get_sketch_estimation());
+    tuning::set_sketch_estimation(true);
+    BOOST_CHECK(tuning::get_sketch_estimation());
+    tuning::reset_sketch_estimation();
+    BOOST_CHECK(!tuning::get_sketch_estimation());
+}
+
+BOOST_AUTO_TEST_CASE(tuning_estimate_cache_test)
+{
+    BOOST_CHECK(!tuning::get_estimate_cache());
+    tuning::set_estimate_cache(true);
+    BOOST_CHECK(tuning::get_estimate_cache());
+    std::thread t1([]() noexcept {
+        while (tuning::get_estimate_cache()) {
+        }
+    });
+    std::thread t2([]() noexcept { tuning::set_estimate_cache(false); });
+    t1.join();
+    t2.join();
+    BOOST_CHECK(!tuning::get_estimate_cache());
+    tuning::set_estimate_cache(true);
+    BOOST_CHECK(tuning::get_estimate_cache());
+    tuning::reset_estimate_cache();
+    BOOST_CHECK(!tuning::get_estimate_cache());
+}
+
+BOOST_AUTO_TEST_CASE(tuning_node_arena_test)
+{
+    BOOST_CHECK(!tuning::get_node_arena());
+    tuning::set_node_arena(true);
+    BOOST_CHECK(tuning::get_node_arena());
+    std::thread t1([]() noexcept {
+        while (tuning::get_node_arena()) {
+        }
+    });
+    std::thread t2([]() noexcept { tuning::set_node_arena(false); });
+    t1.join();
+    t2.join();
+    BOOST_CHECK(!tuning::get_node_arena());
+    tuning::set_node_arena(true);
+    BOOST_CHECK(tuning::get_node_arena());
+    tuning::reset_node_arena();
+    BOOST_CHECK(!tuning::get_node_arena());
+}
+
+BOOST_AUTO_TEST_CASE(tuning_pow_cache_max_memory_test)
+{
+    BOOST_CHECK_EQUAL(tuning::get_pow_cache_max_memory(), 1073741824ul);
+    tuning::set_pow_cache_max_memory(512u);
+    BOOST_CHECK_EQUAL(tuning::get_pow_cache_max_memory(), 512u);
+    std::thread t1([]() noexcept {
+        while (tuning::get_pow_cache_max_memory() != 1024u) {
+        }
+    });
+    std::thread t2([]() noexcept { tuning::set_pow_cache_max_memory(1024u); });
+    t1.join();
+    t2.join();
+    BOOST_CHECK_EQUAL(tuning::get_pow_cache_max_memory(), 1024u);
+    tuning::reset_pow_cache_max_memory();
+    BOOST_CHECK_EQUAL(tuning::get_pow_cache_max_memory(), 1073741824ul);
+}